@@ -0,0 +1,117 @@
+#include "pch.h"
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+#include "DepthKernels.h"
+
+// The SIMD kernels against their scalar twins. This file is also built on its own with the
+// AVX2 and the scalar kernels forced (OrderbookTest/CMakeLists.txt), so every build of
+// DepthKernels.cpp is checked, not only the one -march=native picks.
+
+namespace
+{
+    struct Ladder
+    {
+        std::vector<Price> prices_;
+        std::vector<Quantity> quantities_;
+    };
+
+    // Lengths around the 8- and 16-lane blocks and their unrolled pairs, up to well past 2x16.
+    const std::size_t LadderLengths[] = { 0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 47, 48, 63, 64, 65, 100, 257, 1000 };
+
+    Ladder MakeLadder(std::mt19937& rng, std::size_t count, bool hugeQuantities)
+    {
+        // |price| <= 1e6 and count <= 1000 keep every notional sum within int64.
+        std::uniform_int_distribution<Price> price{ -1'000'000, 1'000'000 };
+        std::uniform_int_distribution<Quantity> small{ 1, 1'000 };
+        std::uniform_int_distribution<Quantity> huge{ std::numeric_limits<Quantity>::max() - 1'000, std::numeric_limits<Quantity>::max() };
+
+        Ladder ladder;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            ladder.prices_.push_back(price(rng));
+            ladder.quantities_.push_back(hugeQuantities ? huge(rng) : small(rng));
+        }
+        return ladder;
+    }
+
+    bool KernelIsaRuns()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        if (std::strcmp(DepthKernelIsa(), "AVX-512") == 0)
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq");
+        if (std::strcmp(DepthKernelIsa(), "AVX2") == 0)
+            return __builtin_cpu_supports("avx2");
+#endif
+        return true;
+    }
+}
+
+TEST(DepthKernelTests, SumsMatchScalar)
+{
+    if (!KernelIsaRuns())
+        GTEST_SKIP() << DepthKernelIsa() << " kernels built, not supported by this CPU";
+
+    std::mt19937 rng{ 49 };
+    for (const bool huge : { false, true })
+    {
+        for (const std::size_t count : LadderLengths)
+        {
+            // Arrange
+            const Ladder ladder = MakeLadder(rng, count, huge);
+            const Price* prices = ladder.prices_.data();
+            const Quantity* quantities = ladder.quantities_.data();
+
+            // Act & Assert
+            SCOPED_TRACE(testing::Message() << DepthKernelIsa() << " count " << count << (huge ? " huge" : ""));
+            EXPECT_EQ(SumQuantities(quantities, count), SumQuantitiesScalar(quantities, count));
+            EXPECT_EQ(SumNotional(prices, quantities, count), SumNotionalScalar(prices, quantities, count));
+        }
+    }
+}
+
+TEST(DepthKernelTests, ThresholdMatchesScalar)
+{
+    if (!KernelIsaRuns())
+        GTEST_SKIP() << DepthKernelIsa() << " kernels built, not supported by this CPU";
+
+    std::mt19937 rng{ 4949 };
+    for (const bool huge : { false, true })
+    {
+        for (const std::size_t count : LadderLengths)
+        {
+            // Arrange
+            const Ladder ladder = MakeLadder(rng, count, huge);
+            const Quantity* quantities = ladder.quantities_.data();
+            const std::uint64_t total = SumQuantitiesScalar(quantities, count);
+
+            // Nothing, everything, more than everything, exact block edges from the back
+            // (and one past them), and random targets in between.
+            std::vector<std::uint64_t> targets{ 0, 1, total, total + 1 };
+            std::uint64_t suffix = 0;
+            for (std::size_t levels = 1; levels <= count; ++levels)
+            {
+                suffix += quantities[count - levels];
+                if (levels % 8 == 0 || levels % 8 == 1)
+                {
+                    targets.push_back(suffix);
+                    targets.push_back(suffix + 1);
+                }
+            }
+            std::uniform_int_distribution<std::uint64_t> anywhere{ 0, total };
+            for (int i = 0; i < 32; ++i)
+                targets.push_back(anywhere(rng));
+
+            // Act & Assert
+            for (const std::uint64_t target : targets)
+            {
+                SCOPED_TRACE(testing::Message() << DepthKernelIsa() << " count " << count << " target " << target);
+                const DepthThreshold kernel = FindDepthThreshold(quantities, count, target);
+                const DepthThreshold scalar = FindDepthThresholdScalar(quantities, count, target);
+                EXPECT_EQ(kernel.levels_, scalar.levels_);
+                EXPECT_EQ(kernel.cumulative_, scalar.cumulative_);
+            }
+        }
+    }
+}
@@ -1,6 +1,18 @@
 #include "pch.h"
+#include <algorithm>
 #include <charconv>
+#include <unistd.h>
+#include "Backpressure.h"
+#include "FixCodec.h"
+#include "L2Book.h"
+#include "L3Book.h"
+#include "LatencyHistogram.h"
+#include "MatchingEngine.h"
+#include "OrderEntry.h"
 #include "Orderbook.h"
+#include "RiskStage.h"
+#include "Telemetry.h"
+#include "Workload.h"
 
 namespace googletest = ::testing;
 
@@ -199,23 +211,9 @@ public:
 };
 
 
-class OrderbookTestsFixture : public googletest::TestWithParam<const char*> 
-{
-private:
-    const static inline std::filesystem::path Root{ std::filesystem::current_path() };
-    const static inline std::filesystem::path TestFolder{ "TestFiles" };
-public:
-    const static inline std::filesystem::path TestFolderPath{ Root / TestFolder };
-};
-
-TEST_P(OrderbookTestsFixture, OrderbookTestSuite)
+template<typename Book>
+void Replay(Book& orderbook, const Informations& actions)
 {
-    // Arrange
-    const auto file = std::filesystem::path(TEST_DATA_DIR) / GetParam();
-
-    InputHandler handler;
-    const auto [actions, result] = handler.GetInformations(file);
-
     auto GetOrder = [](const Information& action)
     {
         return std::make_shared<Order>(
@@ -237,8 +235,6 @@ TEST_P(OrderbookTestsFixture, OrderbookTestSuite)
         };
     };
     
-    // Act
-    Orderbook orderbook;
     for (const auto& action : actions)
     {
         switch (action.type_)
@@ -262,8 +258,184 @@ TEST_P(OrderbookTestsFixture, OrderbookTestSuite)
             throw std::logic_error("Unsupported Action.");
         }
     }
+}
+
+// Level by level, best first: the same prices with the same total quantities.
+void ExpectSameLevels(const OrderbookLevelInfos& actual, const OrderbookLevelInfos& expected)
+{
+    const auto expectSide = [](const LevelInfos& actualLevels, const LevelInfos& expectedLevels)
+    {
+        ASSERT_EQ(actualLevels.size(), expectedLevels.size());
+        for (std::size_t i = 0; i < expectedLevels.size(); ++i)
+        {
+            EXPECT_EQ(actualLevels[i].price_, expectedLevels[i].price_) << "level " << i;
+            EXPECT_EQ(actualLevels[i].quantity_, expectedLevels[i].quantity_) << "level " << i;
+        }
+    };
+    expectSide(actual.GetBids(), expected.GetBids());
+    expectSide(actual.GetAsks(), expected.GetAsks());
+}
+
+class OrderbookTestsFixture : public googletest::TestWithParam<const char*> 
+{
+private:
+    const static inline std::filesystem::path Root{ std::filesystem::current_path() };
+    const static inline std::filesystem::path TestFolder{ "TestFiles" };
+public:
+    const static inline std::filesystem::path TestFolderPath{ Root / TestFolder };
+};
+
+TEST_P(OrderbookTestsFixture, OrderbookTestSuite)
+{
+    // Arrange
+    const auto file = std::filesystem::path(TEST_DATA_DIR) / GetParam();
+
+    InputHandler handler;
+    const auto [actions, result] = handler.GetInformations(file);
+
+    // Act
+    Orderbook orderbook;
+    Replay(orderbook, actions);
+
+    // Assert
+    const auto& orderbookInfos = orderbook.GetOrderInfos();
+    ASSERT_EQ(orderbook.Size(), result.allCount_);
+    ASSERT_EQ(orderbookInfos.GetBids().size(), result.bidCount_);
+    ASSERT_EQ(orderbookInfos.GetAsks().size(), result.askCount_);
+}
+
+template<typename Policy>
+void ExpectReplayResult(const Informations& actions, const Result& result)
+{
+    BasicOrderbook<Policy> orderbook;
+    Replay(orderbook, actions);
+
+    const auto& orderbookInfos = orderbook.GetOrderInfos();
+    EXPECT_EQ(orderbook.Size(), result.allCount_);
+    EXPECT_EQ(orderbookInfos.GetBids().size(), result.bidCount_);
+    EXPECT_EQ(orderbookInfos.GetAsks().size(), result.askCount_);
+}
+
+TEST_P(OrderbookTestsFixture, PolicyReplay)
+{
+    // Arrange
+    const auto file = std::filesystem::path(TEST_DATA_DIR) / GetParam();
+
+    InputHandler handler;
+    const auto [actions, result] = handler.GetInformations(file);
+
+    // Act, Assert
+    ExpectReplayResult<PooledOrderbookPolicy>(actions, result);
+    ExpectReplayResult<FlatLevelsOrderbookPolicy>(actions, result);
+    ExpectReplayResult<FlatOrderbookPolicy>(actions, result);
+}
+
+TEST_P(OrderbookTestsFixture, LevelDeltaReplay)
+{
+    // Arrange
+    const auto file = std::filesystem::path(TEST_DATA_DIR) / GetParam();
+
+    InputHandler handler;
+    const auto [actions, result] = handler.GetInformations(file);
+
+    // Act
+    LevelDeltas deltas;
+    Orderbook orderbook;
+    orderbook.SetLevelDeltaSink(&deltas);
+    Replay(orderbook, actions);
+
+    L2Book book;
+    for (const auto& delta : deltas)
+        book.Apply(delta);
+
+    // Assert
+    ExpectSameLevels(book.GetOrderInfos(), orderbook.GetOrderInfos());
+}
+
+TEST_P(OrderbookTestsFixture, L3Replay)
+{
+    // Arrange
+    const auto file = std::filesystem::path(TEST_DATA_DIR) / GetParam();
+
+    InputHandler handler;
+    const auto [actions, result] = handler.GetInformations(file);
+
+    // Act
+    L3Encoder encoder;
+    Orderbook orderbook;
+    orderbook.SetL3Sink(&encoder);
+    Replay(orderbook, actions);
+
+    L3Book book;
+    const auto bytes = encoder.Bytes();
+    const auto consumed = book.Apply(bytes);
+
+    // Assert
+    ASSERT_EQ(consumed, bytes.size());
+    ASSERT_EQ(book.Messages(), encoder.Sequence());
+    ASSERT_EQ(book.Gaps(), 0u);
+    ASSERT_EQ(book.UnknownOrders(), 0u);
+    ASSERT_EQ(book.PositionMismatches(), 0u);
+    ASSERT_EQ(book.Size(), orderbook.Size());
+    ExpectSameLevels(book.GetOrderInfos(), orderbook.GetOrderInfos());
+}
+
+TEST_P(OrderbookTestsFixture, FixReplay)
+{
+    // Arrange
+    const auto file = std::filesystem::path(TEST_DATA_DIR) / GetParam();
+
+    InputHandler handler;
+    const auto [actions, result] = handler.GetInformations(file);
+
+    FixEncoder encoder{ "CLIENT", "BOOK" };
+    std::string bytes;
+    for (const auto& action : actions)
+    {
+        switch (action.type_)
+        {
+        case ActionType::Add:
+            bytes += encoder.NewOrderSingle(action.orderId_, action.side_, action.orderType_, action.price_, action.quantity_, "XYZ");
+            break;
+        case ActionType::Cancel:
+            bytes += encoder.OrderCancelRequest(action.orderId_ + 1000, action.orderId_, action.side_, "XYZ");
+            break;
+        case ActionType::Modify:
+            bytes += encoder.OrderCancelReplaceRequest(action.orderId_ + 1000, action.orderId_, action.side_,
+                action.orderType_, action.price_, action.quantity_, "XYZ");
+            break;
+        }
+    }
+
+    // Act
+    Orderbook orderbook;
+    FixDecoder decoder;
+    FixMessage message;
+    std::string_view rest{ bytes };
+    std::size_t decoded{ };
+    while (!rest.empty())
+    {
+        const auto status = decoder.Decode(rest, message);
+        ASSERT_EQ(status.status_, FixStatus::Ok);
+        ASSERT_EQ(message.seqNum_, ++decoded);
+        rest.remove_prefix(status.size_);
+
+        switch (message.type_)
+        {
+        case FixMsgType::NewOrderSingle:
+            orderbook.AddOrder(message.ToOrder());
+            break;
+        case FixMsgType::OrderCancelRequest:
+            orderbook.CancelOrder(message.origClOrdId_);
+            break;
+        default:
+            orderbook.ModifyOrder(message.ToOrderModify());
+            break;
+        }
+    }
 
     // Assert
+    ASSERT_EQ(decoded, actions.size());
     const auto& orderbookInfos = orderbook.GetOrderInfos();
     ASSERT_EQ(orderbook.Size(), result.allCount_);
     ASSERT_EQ(orderbookInfos.GetBids().size(), result.bidCount_);
@@ -279,3 +451,687 @@ INSTANTIATE_TEST_CASE_P(Tests, OrderbookTestsFixture, googletest::ValuesIn({
     "Modify_Side.txt",
     "Match_Market.txt"
 }));
+
+TEST(BackpressureTests, CreditWindowAndReturnBatch)
+{
+    // Arrange
+    Backpressure credits{ 8, {}, 64 };
+    Backpressure degenerate{ 0, {}, 0 };
+
+    // Act
+    for (int i = 0; i < 8; ++i)
+    {
+        credits.wait_if_needed();
+        credits.increment();
+    }
+    const auto full = credits.in_flight();
+    for (int i = 0; i < 3; ++i)
+        credits.decrement();
+    const auto belowBatch = credits.returned();
+    credits.decrement();
+    const auto oneBatch = credits.returned();
+    credits.decrement();
+    credits.flush();
+    credits.flush();
+    credits.wait_if_needed();
+    credits.increment();
+
+    // Assert
+    EXPECT_EQ(credits.limit(), 8u);
+    EXPECT_EQ(credits.return_batch(), 4u);
+    EXPECT_EQ(degenerate.limit(), 1u);
+    EXPECT_EQ(degenerate.return_batch(), 1u);
+    EXPECT_EQ(full, 8u);
+    EXPECT_EQ(belowBatch, 0u);
+    EXPECT_EQ(oneBatch, 4u);
+    EXPECT_EQ(credits.returned(), 5u);
+    EXPECT_EQ(credits.sent(), 9u);
+    EXPECT_EQ(credits.in_flight(), 4u);
+    EXPECT_EQ(credits.wait_calls(), 0u);
+}
+
+TEST(MatchingEngineTests, WeightedAdaptiveBursts)
+{
+    // Arrange: both rings are filled before the engine starts, so every round sees the same
+    // backlog. Bursts are clamp(backlog / active, 4, 32); channel 1 gets twice channel 0's.
+    auto rings = std::make_unique<OrderRingBuffer[]>(2);
+    Backpressure credits0{ 1024 };
+    Backpressure credits1{ 1024 };
+    std::vector<ProducerChannel> channels{ { &rings[0], &credits0, 1 }, { &rings[1], &credits1, 2 } };
+    for (OrderId id = 1; id <= 100; ++id)
+    {
+        ASSERT_TRUE(rings[0].push(EngineEvent::MakeCancel(id)));
+        ASSERT_TRUE(rings[1].push(EngineEvent::MakeCancel(id)));
+    }
+    auto engine = std::make_unique<MatchingEngine>(channels, 4);
+
+    // Act
+    engine->start();
+    while (engine->QueueStats(0).events + engine->QueueStats(1).events < 200)
+        std::this_thread::yield();
+    engine->stop();
+
+    // Assert: channel 0 drains 32, 32, 32, 4; channel 1 drains 64, 36.
+    const auto light = engine->QueueStats(0);
+    const auto heavy = engine->QueueStats(1);
+    EXPECT_EQ(light.weight, 1u);
+    EXPECT_EQ(light.events, 100u);
+    EXPECT_EQ(light.visits, 4u);
+    EXPECT_EQ(heavy.weight, 2u);
+    EXPECT_EQ(heavy.events, 100u);
+    EXPECT_EQ(heavy.visits, 2u);
+}
+
+// One producer (id 1) with a cancel lane, driven from the test thread. Events pushed before
+// start() are seen in one round: the lane first, then the ring.
+struct LaneEngine
+{
+    static constexpr std::uint32_t Producer = 1;
+
+    std::unique_ptr<OrderRingBuffer> ring_ = std::make_unique<OrderRingBuffer>();
+    std::unique_ptr<CancelLane> lane_ = std::make_unique<CancelLane>();
+    Backpressure credits_{ 1024 };
+    std::vector<ProducerChannel> channels_;
+    std::unique_ptr<MatchingEngine> engine_;
+
+    LaneEngine()
+    {
+        ProducerChannel channel;
+        channel.queue = ring_.get();
+        channel.backpressure = &credits_;
+        channel.cancelLane = lane_.get();
+        channel.producerId = Producer;
+        channels_.push_back(channel);
+        engine_ = std::make_unique<MatchingEngine>(channels_, 4);
+    }
+
+    static OrderId Id(std::uint32_t producer, std::uint32_t sequence)
+    {
+        return (static_cast<OrderId>(producer) << 32) | sequence;
+    }
+
+    void Add(OrderId id)
+    {
+        while (!ring_->push(EngineEvent::MakeAdd(std::make_shared<Order>(OrderType::GoodTillCancel, id, Side::Buy, 100, 10))))
+            std::this_thread::yield();
+    }
+
+    void Cancel(OrderId id)
+    {
+        while (!lane_->push(CancelRequest{ id }))
+            std::this_thread::yield();
+    }
+
+    void WaitForRing(std::uint64_t events) const
+    {
+        while (engine_->QueueStats(0).events < events)
+            std::this_thread::yield();
+    }
+
+    void WaitForLane(std::uint64_t events) const
+    {
+        while (engine_->QueueStats(0).laneEvents < events)
+            std::this_thread::yield();
+    }
+};
+
+TEST(CancelLaneTests, OvertakingCancelDropsQueuedAdd)
+{
+    // Arrange
+    LaneEngine lane;
+    lane.Add(LaneEngine::Id(1, 1));
+    lane.Add(LaneEngine::Id(1, 2));
+    lane.Cancel(LaneEngine::Id(1, 1));
+
+    // Act
+    lane.engine_->start();
+    lane.WaitForRing(2);
+    lane.engine_->stop();
+
+    // Assert
+    const auto stats = lane.engine_->QueueStats(0);
+    EXPECT_EQ(stats.laneEvents, 1u);
+    EXPECT_EQ(stats.overtakenAdds, 1u);
+    EXPECT_EQ(lane.engine_->OrderCount(), 1u);
+}
+
+TEST(CancelLaneTests, CancelForAddedOrderIsPlainCancel)
+{
+    // Arrange
+    LaneEngine lane;
+    lane.Add(LaneEngine::Id(1, 1));
+    lane.Add(LaneEngine::Id(1, 2));
+    lane.engine_->start();
+    lane.WaitForRing(2);
+
+    // Act
+    lane.Cancel(LaneEngine::Id(1, 1));
+    lane.WaitForLane(1);
+    lane.Add(LaneEngine::Id(1, 3));
+    lane.WaitForRing(3);
+    lane.engine_->stop();
+
+    // Assert
+    EXPECT_EQ(lane.engine_->QueueStats(0).overtakenAdds, 0u);
+    EXPECT_EQ(lane.engine_->OrderCount(), 2u);
+}
+
+TEST(CancelLaneTests, ForeignIdIsNeverTombstoned)
+{
+    // Arrange: producer 2's id arriving on producer 1's lane cannot be ordered against
+    // producer 1's adds.
+    LaneEngine lane;
+    lane.Cancel(LaneEngine::Id(2, 7));
+    lane.Add(LaneEngine::Id(2, 7));
+    lane.Add(LaneEngine::Id(1, 1));
+
+    // Act
+    lane.engine_->start();
+    lane.WaitForRing(2);
+    lane.engine_->stop();
+
+    // Assert
+    EXPECT_EQ(lane.engine_->QueueStats(0).overtakenAdds, 0u);
+    EXPECT_EQ(lane.engine_->OrderCount(), 2u);
+}
+
+TEST(CancelLaneTests, PurgeKeepsTombstonesAheadOfTheAddStream)
+{
+    // Arrange: ten tombstones the add stream then passes (their adds were given up), and
+    // enough pending ones to reach the cap.
+    LaneEngine lane;
+    lane.engine_->start();
+    for (std::uint32_t sequence = 10; sequence < 20; ++sequence)
+        lane.Cancel(LaneEngine::Id(1, sequence));
+    lane.WaitForLane(10);
+    lane.Add(LaneEngine::Id(1, 20));
+    lane.WaitForRing(1);
+    for (std::uint32_t i = 0; i < MatchingEngine::MaxTombstones - 10; ++i)
+        lane.Cancel(LaneEngine::Id(1, 1000 + i));
+    lane.WaitForLane(MatchingEngine::MaxTombstones);
+
+    // Act: one more tombstone purges the passed ones.
+    lane.Cancel(LaneEngine::Id(1, 999));
+    lane.WaitForLane(MatchingEngine::MaxTombstones + 1);
+    lane.Add(LaneEngine::Id(1, 15));
+    lane.Add(LaneEngine::Id(1, 999));
+    lane.Add(LaneEngine::Id(1, 1000));
+    lane.WaitForRing(4);
+    lane.engine_->stop();
+
+    // Assert: 15 lost its tombstone and is booked; 999 and 1000 kept theirs.
+    EXPECT_EQ(lane.engine_->QueueStats(0).overtakenAdds, 2u);
+    EXPECT_EQ(lane.engine_->OrderCount(), 2u);
+}
+
+TEST(LatencyHistogramTests, BucketEdges)
+{
+    // Arrange
+    constexpr std::size_t Last = LatencyHistogram::BucketCount - 1;
+    constexpr std::uint64_t LastLowest = std::uint64_t{ 255 } << 32;
+
+    // Act & Assert: linear below 128, then 128 buckets per power of two.
+    EXPECT_EQ(LatencyHistogram::bucket_index(127), 127u);
+    EXPECT_EQ(LatencyHistogram::bucket_index(128), 128u);
+    EXPECT_EQ(LatencyHistogram::bucket_lowest(128), 128u);
+    EXPECT_EQ(LatencyHistogram::bucket_highest(128), 128u);
+    EXPECT_EQ(LatencyHistogram::bucket_index(255), 255u);
+    EXPECT_EQ(LatencyHistogram::bucket_index(256), 256u);
+    EXPECT_EQ(LatencyHistogram::bucket_index(257), 256u);
+    EXPECT_EQ(LatencyHistogram::bucket_lowest(256), 256u);
+    EXPECT_EQ(LatencyHistogram::bucket_highest(256), 257u);
+
+    // Everything from the last bucket's lower edge up, however large, lands in it.
+    EXPECT_EQ(LatencyHistogram::bucket_index(LastLowest - 1), Last - 1);
+    EXPECT_EQ(LatencyHistogram::bucket_index(LastLowest), Last);
+    EXPECT_EQ(LatencyHistogram::bucket_index(std::uint64_t{ 1 } << LatencyHistogram::MaxValueBits), Last);
+    EXPECT_EQ(LatencyHistogram::bucket_index(~std::uint64_t{ 0 }), Last);
+    EXPECT_EQ(LatencyHistogram::bucket_lowest(Last), LastLowest);
+    EXPECT_EQ(LatencyHistogram::bucket_highest(Last), ~std::uint64_t{ 0 });
+
+    // Buckets tile the range with no gaps or overlaps.
+    for (std::size_t i = 0; i < Last; ++i)
+    {
+        ASSERT_EQ(LatencyHistogram::bucket_index(LatencyHistogram::bucket_lowest(i)), i);
+        ASSERT_EQ(LatencyHistogram::bucket_index(LatencyHistogram::bucket_highest(i)), i);
+        ASSERT_EQ(LatencyHistogram::bucket_lowest(i + 1), LatencyHistogram::bucket_highest(i) + 1);
+    }
+}
+
+TEST(LatencyHistogramTests, QuantilesWithinRelativeError)
+{
+    // Arrange
+    constexpr std::uint64_t Count = 100'000;
+    LatencyHistogram histogram;
+    LatencyHistogram empty;
+    for (std::uint64_t value = 1; value <= Count; ++value)
+        histogram.record(value);
+
+    // Act & Assert: a quantile is its sample's bucket upper edge, at most 1/128 above it.
+    for (const double q : { 0.01, 0.1, 0.5, 0.9, 0.99, 0.999 })
+    {
+        const auto exact = static_cast<std::uint64_t>(q * Count + 0.5);
+        const auto reported = histogram.quantile(q);
+        EXPECT_GE(reported, exact) << q;
+        EXPECT_LE(reported - exact, exact / LatencyHistogram::SubBucketCount) << q;
+    }
+    EXPECT_EQ(histogram.quantile(0.0), 1u);
+    EXPECT_EQ(histogram.quantile(1.0), Count);
+    EXPECT_EQ(histogram.count(), Count);
+    EXPECT_EQ(histogram.sum(), Count * (Count + 1) / 2);
+    EXPECT_EQ(histogram.min(), 1u);
+    EXPECT_EQ(histogram.max(), Count);
+    EXPECT_EQ(empty.quantile(0.5), 0u);
+}
+
+TEST(LatencyHistogramTests, MergeAndSubtract)
+{
+    // Arrange
+    LatencyHistogram first;
+    LatencyHistogram second;
+    first.record(10);
+    first.record(20);
+    second.record(1000);
+    second.record(5);
+
+    // Act
+    first.merge(second);
+    const LatencyHistogram snapshot{ first };
+    first.record(300);
+    first.record(400);
+    LatencyHistogram interval{ first };
+    interval.subtract(snapshot);
+    LatencyHistogram nothing{ snapshot };
+    nothing.subtract(snapshot);
+
+    // Assert
+    EXPECT_EQ(snapshot.count(), 4u);
+    EXPECT_EQ(snapshot.sum(), 1035u);
+    EXPECT_EQ(snapshot.min(), 5u);
+    EXPECT_EQ(snapshot.max(), 1000u);
+    EXPECT_EQ(snapshot.quantile(1.0), 1000u);
+
+    // The interval's min/max are the edges of its lowest and highest buckets: 300 is in
+    // [300, 301] and 400 in [400, 401].
+    EXPECT_EQ(interval.count(), 2u);
+    EXPECT_EQ(interval.sum(), 700u);
+    EXPECT_EQ(interval.min(), 300u);
+    EXPECT_EQ(interval.max(), 401u);
+    EXPECT_EQ(interval.quantile(0.5), 301u);
+
+    EXPECT_EQ(nothing.count(), 0u);
+    EXPECT_EQ(nothing.min(), 0u);
+    EXPECT_EQ(nothing.max(), 0u);
+}
+
+TEST(WorkloadTests, FullLiveSetCancelsWithoutCancelWeight)
+{
+    // Arrange
+    WorkloadConfig config = MakeWorkload(WorkloadPreset::Uniform);
+    config.targetLiveOrders = true;
+    config.addWeight = 9.0;
+    config.cancelWeight = 0.0;
+    config.modifyWeight = 1.0;
+    WorkloadGenerator generator(config, 1);
+
+    // Act
+    std::size_t cancels = 0;
+    std::size_t largest = 0;
+    for (std::size_t i = 0; i < 2 * WorkloadGenerator::MaxLiveOrders; ++i)
+    {
+        cancels += generator.next().op == OrderOp::Cancel;
+        largest = std::max(largest, generator.live_orders());
+    }
+
+    // Assert
+    EXPECT_GT(cancels, 0u);
+    EXPECT_EQ(largest, WorkloadGenerator::MaxLiveOrders);
+}
+
+TEST(TelemetryTests, ReaderSeesWriterLayout)
+{
+    // Arrange
+    const std::string name = "obtest_telemetry_" + std::to_string(getpid());
+    const TelemetryRegion writer = TelemetryRegion::Create(name, 3);
+    if (!writer.shared())
+        GTEST_SKIP() << "no /dev/shm segment";
+    TelemetryAdd(writer.engine().events, 11);
+    TelemetryAdd(writer.channel(2).adds, 7);
+    writer.channel(2).producerId = 5;
+    writer.stages().queue.record(100);
+
+    const auto offset = [](const TelemetryRegion& region, const void* part)
+    {
+        return static_cast<std::size_t>(static_cast<const char*>(part) - reinterpret_cast<const char*>(&region.header()));
+    };
+
+    for (const bool tracing : { false, true })
+    {
+        // The stage histograms are always laid out; the flag only says whether they are fed.
+        writer.header().flags = tracing ? TelemetryFlagTracing : 0;
+
+        // Act
+        std::string error;
+        const TelemetryRegion reader = TelemetryRegion::Open(name, &error);
+
+        // Assert
+        SCOPED_TRACE(tracing ? "tracing" : "no tracing");
+        ASSERT_TRUE(reader.valid()) << error;
+        EXPECT_EQ(reader.header().version, TelemetryVersion);
+        EXPECT_EQ(reader.header().flags & TelemetryFlagTracing, tracing ? TelemetryFlagTracing : 0u);
+        EXPECT_EQ(reader.channel_count(), 3u);
+        EXPECT_EQ(reader.header().totalBytes, TelemetryRegion::BytesFor(3));
+
+        const std::size_t engine = offset(reader, &reader.engine());
+        const std::size_t stages = offset(reader, &reader.stages());
+        const std::size_t channels = offset(reader, &reader.channel(0));
+        EXPECT_EQ(engine, sizeof(TelemetryHeader));
+        EXPECT_EQ(stages, engine + sizeof(EngineTelemetry));
+        EXPECT_GE(channels, stages + sizeof(StageLatency));
+        EXPECT_EQ(channels % 64, 0u);
+        EXPECT_EQ(offset(reader, &reader.channel(2)), channels + 2 * sizeof(ChannelTelemetry));
+        EXPECT_EQ(stages, offset(writer, &writer.stages()));
+
+        EXPECT_EQ(reader.engine().events.load(), 11u);
+        EXPECT_EQ(reader.channel(2).adds.load(), 7u);
+        EXPECT_EQ(reader.channel(2).producerId, 5u);
+        EXPECT_EQ(reader.stages().queue.count(), 1u);
+        EXPECT_EQ(reader.stages().queue.max(), 100u);
+    }
+}
+
+TEST(RiskStageTests, ReportsReleaseExposure)
+{
+    // Arrange: the test plays producer 1 and the engine. Adds and the modify are queued
+    // before the stage starts; reports go in once they have been checked.
+    const auto id = [](std::uint32_t sequence) { return (OrderId{ 1 } << 32) | sequence; };
+    auto ring = std::make_unique<OrderRingBuffer>();
+    Backpressure credits{ 1024 };
+    ProducerChannel channel;
+    channel.queue = ring.get();
+    channel.backpressure = &credits;
+    channel.producerId = 1;
+    std::vector<ProducerChannel> inputs{ channel };
+
+    RiskLimitTable limits;
+    RiskLimits accountLimits;
+    accountLimits.maxOrderQuantity = 20;
+    limits.set(1, accountLimits);
+    RiskStage risk{ inputs, limits };
+
+    ASSERT_TRUE(ring->push(EngineEvent::MakeAdd(std::make_shared<Order>(OrderType::GoodTillCancel, id(1), Side::Buy, 100, 10))));
+    ASSERT_TRUE(ring->push(EngineEvent::MakeAdd(std::make_shared<Order>(OrderType::GoodTillCancel, id(2), Side::Buy, 100, 50))));
+    ASSERT_TRUE(ring->push(EngineEvent::MakeAdd(std::make_shared<Order>(OrderType::GoodTillCancel, id(3), Side::Sell, 101, 5))));
+    // Shrinks order 1 to 4 before the engine has reported on it.
+    ASSERT_TRUE(ring->push(EngineEvent::MakeModify(OrderModify{ id(1), Side::Buy, 100, 4 })));
+
+    // Act
+    risk.start();
+    while (risk.accepted() + risk.rejected() < 4)
+        std::this_thread::yield();
+
+    // A fill of order 1's first incarnation, still in flight when it was modified: it is
+    // charged to the modified order and releases what is left of it.
+    ASSERT_TRUE(risk.reports().push({ id(1), 6, Side::Buy, ExecutionReportType::Fill }));
+    // A fill for an order the stage does not track (here: never seen) only moves the position.
+    ASSERT_TRUE(risk.reports().push({ id(99), 2, Side::Sell, ExecutionReportType::Fill }));
+    // Order 3's add was dropped by the engine after a lane cancel overtook it; the engine
+    // closes it, and closes it again for the cancel itself.
+    ASSERT_TRUE(risk.reports().push({ id(3), 0, Side::Sell, ExecutionReportType::Closed }));
+    ASSERT_TRUE(risk.reports().push({ id(3), 0, Side::Sell, ExecutionReportType::Closed }));
+    risk.stop();
+
+    // Assert
+    const RiskAccountStats& account = risk.account(1);
+    EXPECT_EQ(risk.accepted(), 3u);
+    EXPECT_EQ(risk.rejected(), 1u);
+    EXPECT_EQ(account.accepted.load(), 3u);
+    EXPECT_EQ(account.rejected.load(), 1u);
+    EXPECT_EQ(account.openNotional.load(), 0);
+    EXPECT_EQ(account.openBuyQuantity.load(), 0);
+    EXPECT_EQ(account.openSellQuantity.load(), 0);
+    EXPECT_EQ(account.position.load(), 4);
+}
+
+TEST(OrderEntryTests, DecodeValidatesFields)
+{
+    // Arrange
+    struct Case
+    {
+        OrderEntryType type;
+        OrderType orderType;
+        Price price;
+        Quantity quantity;
+        bool valid;
+    };
+    const Case cases[] = {
+        { OrderEntryType::New, OrderType::GoodTillCancel, 100, 0, false },
+        { OrderEntryType::New, OrderType::GoodTillCancel, 100, 1, true },
+        { OrderEntryType::New, OrderType::GoodTillCancel, 0, 10, false },
+        { OrderEntryType::New, OrderType::FillAndKill, -5, 10, false },
+        { OrderEntryType::New, OrderType::Market, 0, 10, true },
+        { OrderEntryType::Modify, OrderType::GoodTillCancel, 100, 0, false },
+        { OrderEntryType::Modify, OrderType::GoodTillCancel, 100, 1, true },
+        { OrderEntryType::Modify, OrderType::GoodTillCancel, 0, 10, false },
+        { OrderEntryType::Modify, OrderType::GoodTillCancel, -1, 10, false },
+        { OrderEntryType::Cancel, OrderType::GoodTillCancel, 0, 0, true },
+    };
+    const std::uint32_t producerId = 3;
+    const std::uint32_t clientOrderId = 0x80000001u;
+
+    for (std::size_t i = 0; i < std::size(cases); ++i)
+    {
+        SCOPED_TRACE(i);
+        const Case& c = cases[i];
+        std::uint8_t buffer[OrderEntryMaxSize];
+        const std::uint8_t* end = c.type == OrderEntryType::New
+            ? EncodeNewOrder(buffer, c.orderType, clientOrderId, Side::Sell, c.price, c.quantity, 9)
+            : c.type == OrderEntryType::Modify
+            ? EncodeModifyOrder(buffer, clientOrderId, Side::Sell, c.price, c.quantity, 9)
+            : EncodeCancelOrder(buffer, clientOrderId, 9);
+        const auto length = static_cast<std::size_t>(end - buffer);
+
+        // Act
+        OrderEntryRequest request;
+        bool bad = false;
+        const auto partial = DecodeOrderEntry(buffer, length - 1, producerId, request, bad);
+        const bool partialBad = bad;
+        const auto size = DecodeOrderEntry(buffer, length, producerId, request, bad);
+
+        // Assert
+        EXPECT_EQ(partial, 0u);
+        EXPECT_FALSE(partialBad);
+        EXPECT_EQ(size, length);
+        EXPECT_FALSE(bad);
+        EXPECT_EQ(request.valid, c.valid);
+        EXPECT_EQ(request.clientOrderId, clientOrderId);
+        EXPECT_EQ(request.tag, 9u);
+        EXPECT_EQ(request.event.orderId, (OrderId{ producerId } << 32) | clientOrderId);
+        const EngineEventType type = c.type == OrderEntryType::New ? EngineEventType::Add
+                                   : c.type == OrderEntryType::Modify ? EngineEventType::Modify
+                                   : EngineEventType::Cancel;
+        EXPECT_EQ(request.event.type, type);
+        if (c.type != OrderEntryType::Cancel)
+        {
+            EXPECT_EQ(request.event.order_side(), Side::Sell);
+            EXPECT_EQ(request.event.price, c.price);
+            EXPECT_EQ(request.event.quantity, c.quantity);
+        }
+        if (c.type == OrderEntryType::New)
+        {
+            EXPECT_EQ(request.event.order_type(), c.orderType);
+        }
+    }
+}
+
+TEST(OrderEntryTests, UnknownTypeCannotResynchronise)
+{
+    // Arrange
+    std::uint8_t buffer[OrderEntryMaxSize];
+    EncodeCancelOrder(buffer, 1, 9);
+    buffer[0] = 'X';
+    OrderEntryRequest request;
+    bool bad = false;
+
+    // Act
+    const auto unknown = DecodeOrderEntry(buffer, OrderEntryCancelSize, 3, request, bad);
+    const bool unknownBad = bad;
+    buffer[0] = static_cast<std::uint8_t>(OrderEntryType::Ack);
+    const auto ack = DecodeOrderEntry(buffer, OrderEntryCancelSize, 3, request, bad);
+
+    // Assert
+    EXPECT_EQ(unknown, 0u);
+    EXPECT_TRUE(unknownBad);
+    EXPECT_EQ(ack, 0u);
+    EXPECT_TRUE(bad);
+}
+
+TEST(FixCodecTests, ExecutionReportAndFraming)
+{
+    // Arrange
+    FixEncoder encoder{ "BOOK", "CLIENT", 2 };
+    encoder.SetSendingTime("20240102-09:30:00.000");
+    FixExecutionReport report;
+    report.orderId_ = 7;
+    report.clOrdId_ = 7;
+    report.execId_ = 1;
+    report.execType_ = FixExecType::Trade;
+    report.ordStatus_ = FixOrdStatus::PartiallyFilled;
+    report.side_ = Side::Sell;
+    report.lastQty_ = 3;
+    report.lastPx_ = 10125;
+    report.leavesQty_ = 7;
+    report.cumQty_ = 3;
+    report.avgPx_ = 10125;
+
+    // Act
+    std::string message{ encoder.ExecutionReport(report, "XYZ") };
+    std::replace(message.begin(), message.end(), FixSoh, '|');
+
+    // Assert
+    EXPECT_EQ(message, "8=FIX.4.4|9=126|35=8|49=BOOK|56=CLIENT|34=1|52=20240102-09:30:00.000|37=7|11=7|17=1|150=F|39=1|"
+                       "55=XYZ|54=2|32=3|31=101.25|151=7|14=3|6=101.25|10=008|");
+
+    FixEncoder client{ "CLIENT", "BOOK", 2 };
+    const std::string order{ client.NewOrderSingle(42, Side::Buy, OrderType::FillAndKill, 9950, 5, "XYZ") };
+    FixDecoder decoder{ 2 };
+    FixMessage decoded;
+    EXPECT_EQ(decoder.Decode(std::string_view{ order }.substr(0, order.size() - 1), decoded).status_, FixStatus::Incomplete);
+
+    const auto result = decoder.Decode(order, decoded);
+    ASSERT_EQ(result.status_, FixStatus::Ok);
+    EXPECT_EQ(result.size_, order.size());
+    EXPECT_EQ(decoded.clOrdId_, 42u);
+    EXPECT_EQ(decoded.orderType_, OrderType::FillAndKill);
+    EXPECT_EQ(decoded.price_, 9950);
+    EXPECT_EQ(decoded.quantity_, 5u);
+    EXPECT_EQ(decoded.symbol_, "XYZ");
+
+    std::string corrupt{ order };
+    corrupt[corrupt.find("38=5") + 3] = '6';
+    EXPECT_EQ(decoder.Decode(corrupt, decoded).status_, FixStatus::BadChecksum);
+}
+
+TEST(FixCodecTests, QuantityAndLimitPriceMustBePositive)
+{
+    // Arrange
+    FixEncoder client{ "CLIENT", "BOOK", 2 };
+    FixDecoder decoder{ 2 };
+    FixMessage decoded;
+    const auto decode = [&](std::string_view message) { return decoder.Decode(message, decoded); };
+
+    // Act
+    const auto zeroQuantity = decode(client.NewOrderSingle(1, Side::Buy, OrderType::GoodTillCancel, 9950, 0, "XYZ"));
+    const auto zeroReplaceQuantity = decode(client.OrderCancelReplaceRequest(2, 1, Side::Buy, OrderType::GoodTillCancel, 9950, 0, "XYZ"));
+    const auto zeroPrice = decode(client.NewOrderSingle(3, Side::Sell, OrderType::GoodTillCancel, 0, 5, "XYZ"));
+    const auto negativePrice = decode(client.NewOrderSingle(4, Side::Sell, OrderType::FillAndKill, -125, 5, "XYZ"));
+    const auto negativeReplacePrice = decode(client.OrderCancelReplaceRequest(5, 4, Side::Sell, OrderType::GoodTillCancel, -1, 5, "XYZ"));
+    const auto market = decode(client.NewOrderSingle(6, Side::Buy, OrderType::Market, 0, 5, "XYZ"));
+
+    // Assert
+    EXPECT_EQ(zeroQuantity.status_, FixStatus::BadValue);
+    EXPECT_EQ(zeroQuantity.tag_, 38u);
+    EXPECT_EQ(zeroReplaceQuantity.status_, FixStatus::BadValue);
+    EXPECT_EQ(zeroReplaceQuantity.tag_, 38u);
+    EXPECT_EQ(zeroPrice.status_, FixStatus::BadValue);
+    EXPECT_EQ(zeroPrice.tag_, 44u);
+    EXPECT_EQ(negativePrice.status_, FixStatus::BadValue);
+    EXPECT_EQ(negativePrice.tag_, 44u);
+    EXPECT_EQ(negativeReplacePrice.status_, FixStatus::BadValue);
+    EXPECT_EQ(negativeReplacePrice.tag_, 44u);
+    EXPECT_EQ(market.status_, FixStatus::Ok);
+}
+
+TEST(DepthQueryTests, LadderQueries)
+{
+    // Arrange
+    Orderbook orderbook;
+    orderbook.AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, 1, Side::Sell, 104, 20));
+    orderbook.AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, 2, Side::Sell, 101, 10));
+    orderbook.AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, 3, Side::Sell, 102, 5));
+    orderbook.AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, 4, Side::Buy, 99, 7));
+
+    // Act
+    const auto depth = orderbook.DepthTo(Side::Sell, 103);
+    const auto levels = orderbook.LevelsToFill(Side::Sell, 16);
+    const auto fill = orderbook.EstimateFill(Side::Sell, 20);
+    const auto all = orderbook.EstimateFill(Side::Sell, 100);
+    orderbook.AddOrder(std::make_shared<Order>(OrderType::FillAndKill, 5, Side::Buy, 101, 4));
+
+    // Assert
+    EXPECT_EQ(depth, 15u);
+    EXPECT_EQ(levels.levels_, 3u);
+    EXPECT_EQ(levels.cumulative_, 35u);
+    EXPECT_EQ(fill.quantity_, 20u);
+    EXPECT_EQ(fill.notional_, 10 * 101 + 5 * 102 + 5 * 104);
+    EXPECT_EQ(fill.levels_, 3u);
+    EXPECT_EQ(all.quantity_, 35u);
+    EXPECT_EQ(orderbook.DepthTo(Side::Sell, 101), 6u);
+    EXPECT_EQ(orderbook.DepthTo(Side::Buy, 100), 0u);
+    EXPECT_EQ(orderbook.DepthTo(Side::Buy, 99), 7u);
+}
+
+template<typename Policy>
+void ExpectMassCancel()
+{
+    // Arrange
+    BasicOrderbook<Policy> orderbook;
+    orderbook.AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, 1, Side::Buy, 100, 10, 1));
+    orderbook.AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, 2, Side::Buy, 99, 10, 1));
+    orderbook.AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, 3, Side::Buy, 99, 5, 1));
+    orderbook.AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, 4, Side::Sell, 105, 10, 1));
+    orderbook.AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, 5, Side::Buy, 99, 7, 2));
+    orderbook.AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, 6, Side::Buy, 98, 3));
+    orderbook.AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, 7, Side::Sell, 100, 10));
+    orderbook.ModifyOrder(OrderModify{ 2, Side::Buy, 98, 8 });
+
+    // Act
+    OrderIds cancelled;
+    const auto bidsInRange = orderbook.MassCancel(MassCancelRequest::ForOwner(1).OnSide(Side::Buy).InRange(98, 99), &cancelled);
+    const auto infos = orderbook.GetOrderInfos();
+    const auto rest = orderbook.MassCancel(MassCancelRequest::ForOwner(1));
+    const auto again = orderbook.MassCancel(MassCancelRequest::ForOwner(1));
+    const auto ownerless = orderbook.MassCancel(MassCancelRequest::ForOwner(0));
+
+    // Assert
+    EXPECT_EQ(bidsInRange, 2u);
+    std::sort(cancelled.begin(), cancelled.end());
+    EXPECT_EQ(cancelled, (OrderIds{ 2, 3 }));
+    ASSERT_EQ(infos.GetBids().size(), 2u);
+    EXPECT_EQ(infos.GetBids()[0].quantity_, 7u);
+    EXPECT_EQ(infos.GetBids()[1].quantity_, 3u);
+    ASSERT_EQ(infos.GetAsks().size(), 1u);
+    EXPECT_EQ(rest, 1u);
+    EXPECT_EQ(again, 0u);
+    EXPECT_EQ(ownerless, 0u);
+    EXPECT_EQ(orderbook.Size(), 2u);
+    EXPECT_EQ(orderbook.DepthTo(Side::Buy, 98), 10u);
+    EXPECT_EQ(orderbook.DepthTo(Side::Sell, 200), 0u);
+    EXPECT_EQ(orderbook.GetOrderInfos(5).GetBids()[0].quantity_, 7u);
+}
+
+TEST(MassCancelTests, OwnerSideAndRange)
+{
+    ExpectMassCancel<DefaultOrderbookPolicy>();
+    ExpectMassCancel<FlatOrderbookPolicy>();
+}
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/Orderbook.dir/main.cpp.o"
+  "CMakeFiles/Orderbook.dir/main.cpp.o.d"
+  "Orderbook"
+  "Orderbook.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Orderbook.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,38 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/Benchmarks/BenchOptions.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/BenchOptions.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/BenchOptions.cpp.o.d"
+  "/root/repo/src/Benchmarks/BenchPrinter.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/BenchPrinter.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/BenchPrinter.cpp.o.d"
+  "/root/repo/src/Benchmarks/BookPolicies.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/BookPolicies.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/BookPolicies.cpp.o.d"
+  "/root/repo/src/Benchmarks/CancelPriority.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/CancelPriority.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/CancelPriority.cpp.o.d"
+  "/root/repo/src/Benchmarks/DeepBook.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/DeepBook.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/DeepBook.cpp.o.d"
+  "/root/repo/src/Benchmarks/DepthQueries.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/DepthQueries.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/DepthQueries.cpp.o.d"
+  "/root/repo/src/Benchmarks/DrainFairness.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/DrainFairness.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/DrainFairness.cpp.o.d"
+  "/root/repo/src/Benchmarks/FixThroughput.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/FixThroughput.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/FixThroughput.cpp.o.d"
+  "/root/repo/src/Benchmarks/FlowControl.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/FlowControl.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/FlowControl.cpp.o.d"
+  "/root/repo/src/Benchmarks/HugePageTlb.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/HugePageTlb.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/HugePageTlb.cpp.o.d"
+  "/root/repo/src/Benchmarks/IpcIngress.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/IpcIngress.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/IpcIngress.cpp.o.d"
+  "/root/repo/src/Benchmarks/L2Feed.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/L2Feed.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/L2Feed.cpp.o.d"
+  "/root/repo/src/Benchmarks/NumaPlacement.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/NumaPlacement.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/NumaPlacement.cpp.o.d"
+  "/root/repo/src/Benchmarks/Percentiles.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/Percentiles.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/Percentiles.cpp.o.d"
+  "/root/repo/src/Benchmarks/PerfCounters.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/PerfCounters.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/PerfCounters.cpp.o.d"
+  "/root/repo/src/Benchmarks/Priority.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/Priority.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/Priority.cpp.o.d"
+  "/root/repo/src/Benchmarks/SingleThreadLatency.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/SingleThreadLatency.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/SingleThreadLatency.cpp.o.d"
+  "/root/repo/src/Benchmarks/SystemInfo.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/SystemInfo.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/SystemInfo.cpp.o.d"
+  "/root/repo/src/Benchmarks/WaitStrategies.cpp" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/WaitStrategies.cpp.o" "gcc" "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/WaitStrategies.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_rel_build/CMakeFiles/orderbook_core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,47 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/BenchOptions.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/BenchOptions.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/BenchPrinter.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/BenchPrinter.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/BookPolicies.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/BookPolicies.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/CancelPriority.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/CancelPriority.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/DeepBook.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/DeepBook.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/DepthQueries.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/DepthQueries.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/DrainFairness.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/DrainFairness.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/FixThroughput.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/FixThroughput.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/FlowControl.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/FlowControl.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/HugePageTlb.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/HugePageTlb.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/IpcIngress.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/IpcIngress.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/L2Feed.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/L2Feed.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/NumaPlacement.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/NumaPlacement.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/Percentiles.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/Percentiles.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/PerfCounters.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/PerfCounters.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/Priority.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/Priority.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/SingleThreadLatency.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/SingleThreadLatency.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/SystemInfo.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/SystemInfo.cpp.o.d"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/WaitStrategies.cpp.o"
+  "CMakeFiles/OrderbookBenchmarks.dir/src/Benchmarks/WaitStrategies.cpp.o.d"
+  "OrderbookBenchmarks"
+  "OrderbookBenchmarks.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/OrderbookBenchmarks.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
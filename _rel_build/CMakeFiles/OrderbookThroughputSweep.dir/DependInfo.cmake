@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/Benchmarks/Percentiles.cpp" "CMakeFiles/OrderbookThroughputSweep.dir/src/Benchmarks/Percentiles.cpp.o" "gcc" "CMakeFiles/OrderbookThroughputSweep.dir/src/Benchmarks/Percentiles.cpp.o.d"
+  "/root/repo/src/Benchmarks/ThroughputSweep.cpp" "CMakeFiles/OrderbookThroughputSweep.dir/src/Benchmarks/ThroughputSweep.cpp.o" "gcc" "CMakeFiles/OrderbookThroughputSweep.dir/src/Benchmarks/ThroughputSweep.cpp.o.d"
+  "/root/repo/src/Benchmarks/ThroughputSweepMain.cpp" "CMakeFiles/OrderbookThroughputSweep.dir/src/Benchmarks/ThroughputSweepMain.cpp.o" "gcc" "CMakeFiles/OrderbookThroughputSweep.dir/src/Benchmarks/ThroughputSweepMain.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_rel_build/CMakeFiles/orderbook_core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
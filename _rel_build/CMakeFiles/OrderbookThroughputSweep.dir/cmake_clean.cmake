@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/OrderbookThroughputSweep.dir/src/Benchmarks/Percentiles.cpp.o"
+  "CMakeFiles/OrderbookThroughputSweep.dir/src/Benchmarks/Percentiles.cpp.o.d"
+  "CMakeFiles/OrderbookThroughputSweep.dir/src/Benchmarks/ThroughputSweep.cpp.o"
+  "CMakeFiles/OrderbookThroughputSweep.dir/src/Benchmarks/ThroughputSweep.cpp.o.d"
+  "CMakeFiles/OrderbookThroughputSweep.dir/src/Benchmarks/ThroughputSweepMain.cpp.o"
+  "CMakeFiles/OrderbookThroughputSweep.dir/src/Benchmarks/ThroughputSweepMain.cpp.o.d"
+  "OrderbookThroughputSweep"
+  "OrderbookThroughputSweep.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/OrderbookThroughputSweep.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/obgateway.dir/src/Tools/Gateway.cpp.o"
+  "CMakeFiles/obgateway.dir/src/Tools/Gateway.cpp.o.d"
+  "obgateway"
+  "obgateway.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/obgateway.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/obloadgen.dir/src/Tools/LoadGen.cpp.o"
+  "CMakeFiles/obloadgen.dir/src/Tools/LoadGen.cpp.o.d"
+  "obloadgen"
+  "obloadgen.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/obloadgen.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
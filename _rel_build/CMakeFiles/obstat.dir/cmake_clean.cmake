@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/obstat.dir/src/Tools/ObStat.cpp.o"
+  "CMakeFiles/obstat.dir/src/Tools/ObStat.cpp.o.d"
+  "obstat"
+  "obstat.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/obstat.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,40 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/concurrency/CpuTopology.cpp" "CMakeFiles/orderbook_core.dir/src/concurrency/CpuTopology.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/concurrency/CpuTopology.cpp.o.d"
+  "/root/repo/src/concurrency/L3Feed.cpp" "CMakeFiles/orderbook_core.dir/src/concurrency/L3Feed.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/concurrency/L3Feed.cpp.o.d"
+  "/root/repo/src/concurrency/LatencyHistogram.cpp" "CMakeFiles/orderbook_core.dir/src/concurrency/LatencyHistogram.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/concurrency/LatencyHistogram.cpp.o.d"
+  "/root/repo/src/concurrency/LevelDeltaFeed.cpp" "CMakeFiles/orderbook_core.dir/src/concurrency/LevelDeltaFeed.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/concurrency/LevelDeltaFeed.cpp.o.d"
+  "/root/repo/src/concurrency/MatchingEngine.cpp" "CMakeFiles/orderbook_core.dir/src/concurrency/MatchingEngine.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/concurrency/MatchingEngine.cpp.o.d"
+  "/root/repo/src/concurrency/MemoryRegion.cpp" "CMakeFiles/orderbook_core.dir/src/concurrency/MemoryRegion.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/concurrency/MemoryRegion.cpp.o.d"
+  "/root/repo/src/concurrency/NumaMemory.cpp" "CMakeFiles/orderbook_core.dir/src/concurrency/NumaMemory.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/concurrency/NumaMemory.cpp.o.d"
+  "/root/repo/src/concurrency/Producer.cpp" "CMakeFiles/orderbook_core.dir/src/concurrency/Producer.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/concurrency/Producer.cpp.o.d"
+  "/root/repo/src/concurrency/RiskStage.cpp" "CMakeFiles/orderbook_core.dir/src/concurrency/RiskStage.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/concurrency/RiskStage.cpp.o.d"
+  "/root/repo/src/concurrency/SharedMemory.cpp" "CMakeFiles/orderbook_core.dir/src/concurrency/SharedMemory.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/concurrency/SharedMemory.cpp.o.d"
+  "/root/repo/src/concurrency/ShmIngress.cpp" "CMakeFiles/orderbook_core.dir/src/concurrency/ShmIngress.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/concurrency/ShmIngress.cpp.o.d"
+  "/root/repo/src/concurrency/Telemetry.cpp" "CMakeFiles/orderbook_core.dir/src/concurrency/Telemetry.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/concurrency/Telemetry.cpp.o.d"
+  "/root/repo/src/concurrency/WaitStrategy.cpp" "CMakeFiles/orderbook_core.dir/src/concurrency/WaitStrategy.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/concurrency/WaitStrategy.cpp.o.d"
+  "/root/repo/src/concurrency/Workload.cpp" "CMakeFiles/orderbook_core.dir/src/concurrency/Workload.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/concurrency/Workload.cpp.o.d"
+  "/root/repo/src/core/DepthKernels.cpp" "CMakeFiles/orderbook_core.dir/src/core/DepthKernels.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/core/DepthKernels.cpp.o.d"
+  "/root/repo/src/core/DepthLadder.cpp" "CMakeFiles/orderbook_core.dir/src/core/DepthLadder.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/core/DepthLadder.cpp.o.d"
+  "/root/repo/src/core/FixCodec.cpp" "CMakeFiles/orderbook_core.dir/src/core/FixCodec.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/core/FixCodec.cpp.o.d"
+  "/root/repo/src/core/L2Book.cpp" "CMakeFiles/orderbook_core.dir/src/core/L2Book.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/core/L2Book.cpp.o.d"
+  "/root/repo/src/core/L3Book.cpp" "CMakeFiles/orderbook_core.dir/src/core/L3Book.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/core/L3Book.cpp.o.d"
+  "/root/repo/src/core/L3Codec.cpp" "CMakeFiles/orderbook_core.dir/src/core/L3Codec.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/core/L3Codec.cpp.o.d"
+  "/root/repo/src/core/Orderbook.cpp" "CMakeFiles/orderbook_core.dir/src/core/Orderbook.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/core/Orderbook.cpp.o.d"
+  "/root/repo/src/core/TimeUtils.cpp" "CMakeFiles/orderbook_core.dir/src/core/TimeUtils.cpp.o" "gcc" "CMakeFiles/orderbook_core.dir/src/core/TimeUtils.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,53 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/orderbook_core.dir/src/concurrency/CpuTopology.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/CpuTopology.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/L3Feed.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/L3Feed.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/LatencyHistogram.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/LatencyHistogram.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/LevelDeltaFeed.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/LevelDeltaFeed.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/MatchingEngine.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/MatchingEngine.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/MemoryRegion.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/MemoryRegion.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/NumaMemory.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/NumaMemory.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/Producer.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/Producer.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/RiskStage.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/RiskStage.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/SharedMemory.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/SharedMemory.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/ShmIngress.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/ShmIngress.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/Telemetry.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/Telemetry.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/WaitStrategy.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/WaitStrategy.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/Workload.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/concurrency/Workload.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/core/DepthKernels.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/core/DepthKernels.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/core/DepthLadder.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/core/DepthLadder.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/core/FixCodec.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/core/FixCodec.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/core/L2Book.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/core/L2Book.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/core/L3Book.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/core/L3Book.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/core/L3Codec.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/core/L3Codec.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/core/Orderbook.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/core/Orderbook.cpp.o.d"
+  "CMakeFiles/orderbook_core.dir/src/core/TimeUtils.cpp.o"
+  "CMakeFiles/orderbook_core.dir/src/core/TimeUtils.cpp.o.d"
+  "liborderbook_core.a"
+  "liborderbook_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/orderbook_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DepthKernelTest_avx2.dir/DepthKernelTest.cpp.o"
+  "CMakeFiles/DepthKernelTest_avx2.dir/DepthKernelTest.cpp.o.d"
+  "CMakeFiles/DepthKernelTest_avx2.dir/__/src/core/DepthKernels.cpp.o"
+  "CMakeFiles/DepthKernelTest_avx2.dir/__/src/core/DepthKernels.cpp.o.d"
+  "DepthKernelTest_avx2"
+  "DepthKernelTest_avx2.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DepthKernelTest_avx2.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,20 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/OrderbookTest/DepthKernelTest.cpp" "OrderbookTest/CMakeFiles/DepthKernelTest_scalar.dir/DepthKernelTest.cpp.o" "gcc" "OrderbookTest/CMakeFiles/DepthKernelTest_scalar.dir/DepthKernelTest.cpp.o.d"
+  "/root/repo/src/core/DepthKernels.cpp" "OrderbookTest/CMakeFiles/DepthKernelTest_scalar.dir/__/src/core/DepthKernels.cpp.o" "gcc" "OrderbookTest/CMakeFiles/DepthKernelTest_scalar.dir/__/src/core/DepthKernels.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DepthKernelTest_scalar.dir/DepthKernelTest.cpp.o"
+  "CMakeFiles/DepthKernelTest_scalar.dir/DepthKernelTest.cpp.o.d"
+  "CMakeFiles/DepthKernelTest_scalar.dir/__/src/core/DepthKernels.cpp.o"
+  "CMakeFiles/DepthKernelTest_scalar.dir/__/src/core/DepthKernels.cpp.o.d"
+  "DepthKernelTest_scalar"
+  "DepthKernelTest_scalar.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DepthKernelTest_scalar.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
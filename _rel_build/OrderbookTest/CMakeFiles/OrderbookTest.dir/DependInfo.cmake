@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/OrderbookTest/DepthKernelTest.cpp" "OrderbookTest/CMakeFiles/OrderbookTest.dir/DepthKernelTest.cpp.o" "gcc" "OrderbookTest/CMakeFiles/OrderbookTest.dir/DepthKernelTest.cpp.o.d"
+  "/root/repo/OrderbookTest/pch.cpp" "OrderbookTest/CMakeFiles/OrderbookTest.dir/pch.cpp.o" "gcc" "OrderbookTest/CMakeFiles/OrderbookTest.dir/pch.cpp.o.d"
+  "/root/repo/OrderbookTest/test.cpp" "OrderbookTest/CMakeFiles/OrderbookTest.dir/test.cpp.o" "gcc" "OrderbookTest/CMakeFiles/OrderbookTest.dir/test.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_rel_build/CMakeFiles/orderbook_core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
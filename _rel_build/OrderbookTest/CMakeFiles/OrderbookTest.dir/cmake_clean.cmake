@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/OrderbookTest.dir/DepthKernelTest.cpp.o"
+  "CMakeFiles/OrderbookTest.dir/DepthKernelTest.cpp.o.d"
+  "CMakeFiles/OrderbookTest.dir/pch.cpp.o"
+  "CMakeFiles/OrderbookTest.dir/pch.cpp.o.d"
+  "CMakeFiles/OrderbookTest.dir/test.cpp.o"
+  "CMakeFiles/OrderbookTest.dir/test.cpp.o.d"
+  "OrderbookTest"
+  "OrderbookTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/OrderbookTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/OrderbookTest
+# Build directory: /root/repo/_rel_build/OrderbookTest
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test([=[OrderbookTest]=] "/root/repo/_rel_build/OrderbookTest/OrderbookTest")
+set_tests_properties([=[OrderbookTest]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/OrderbookTest/CMakeLists.txt;21;add_test;/root/repo/OrderbookTest/CMakeLists.txt;0;")
+add_test([=[DepthKernelTest_scalar]=] "/root/repo/_rel_build/OrderbookTest/DepthKernelTest_scalar")
+set_tests_properties([=[DepthKernelTest_scalar]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/OrderbookTest/CMakeLists.txt;50;add_test;/root/repo/OrderbookTest/CMakeLists.txt;0;")
+add_test([=[DepthKernelTest_avx2]=] "/root/repo/_rel_build/OrderbookTest/DepthKernelTest_avx2")
+set_tests_properties([=[DepthKernelTest_avx2]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/OrderbookTest/CMakeLists.txt;50;add_test;/root/repo/OrderbookTest/CMakeLists.txt;0;")
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace benchmarks {
+
+enum class NumaMode : std::uint8_t {
+    Off,
+    Local,
+    Remote,
+    Compare
+};
+
+struct BenchOptions {
+    std::size_t iterations = 1'000'000;
+    NumaMode numa = NumaMode::Off;
+    std::size_t tlbBookOrders = 0;       // 0: huge-page dTLB benchmark off
+    std::size_t flowProducers = 0;       // 0: flow-control scaling benchmark off
+    std::size_t waitSamples = 0;         // 0: wait-strategy wake-up benchmark off
+    double fairnessSeconds = 0.0;        // 0: drain-fairness benchmark off
+    double cancelLaneSeconds = 0.0;      // 0: cancel-priority benchmark off
+    std::size_t deepBookOrders = 0;      // 0: deep-book scenarios off; else largest steady book
+    std::size_t ipcSamples = 0;          // 0: shared-memory ingress benchmark off
+    std::size_t l2Events = 0;            // 0: L2 market-data feed benchmark off
+    std::size_t fixMessages = 0;         // 0: FIX codec benchmark off
+    std::size_t policyEvents = 0;        // 0: Orderbook policy comparison off
+    std::size_t depthQueries = 0;        // 0: depth-query kernel benchmark off
+    std::size_t massCancelRounds = 0;    // 0: mass-cancel benchmark off
+};
+
+// Usage: OrderbookBenchmarks [iterations] [--numa=local|remote|compare] [--tlb[=orders]]
+//                            [--flow[=maxProducers]] [--wait[=samples]]
+//                            [--fairness[=seconds]] [--cancel-lane[=seconds]]
+//                            [--deep[=maxBookOrders]] [--ipc[=samples]]
+//                            [--l2[=events]] [--fix[=messages]]
+//                            [--policies[=events]] [--depth[=queries]]
+//                            [--mass-cancel[=rounds]]
+BenchOptions ParseBenchOptions(int argc, char** argv);
+
+}
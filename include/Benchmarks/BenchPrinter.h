@@ -5,6 +5,7 @@
 #include <string_view>
 
 #include "Percentiles.h"
+#include "PerfCounters.h"
 
 namespace benchmarks {
 
@@ -12,9 +13,22 @@ struct RingBufferStats {
     std::size_t ringBufferSizeBytes = 0;
     std::size_t messageSizeBytes = 0;
     std::size_t messagesPerCacheLine = 0;
+    const char* pageBacking = nullptr;   // what MemoryRegion obtained for the ring, if known
 };
 
 void PrintSetup(std::string_view benchName, const RingBufferStats& rbStats);
+// Which counter TscClock uses, its calibrated rate and the cost of an empty start()/stop()
+// pair, which every latency sample includes.
+void PrintTimestampClock();
 void PrintLatencyStats(std::string_view label, const LatencyPercentilesNs& pct);
+void PrintLatencyStats(std::string_view label, const LatencyHistogram& histogram);
+// Which hardware counters the latency lines below will carry, or why there are none.
+void PrintPerfCounterStatus();
+// Latency line followed by the counters divided over `ops` operations. The counters cover
+// the timed loop, so they include the timestamp reads around every sample. Nothing extra
+// is printed when the counters did not run.
+void PrintLatencyStats(std::string_view label, const LatencyPercentilesNs& pct,
+                       const PerfCounts& perf, std::uint64_t ops);
+void PrintLatencyStats(std::string_view label, const LatencyHistogram& histogram, const PerfCounts& perf);
 
 }
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+
+namespace benchmarks {
+
+// The same single-threaded scenarios on every compiled-in BasicOrderbook policy
+// (OrderbookPolicies.h): `events` ops of the Uniform, MarketMaker and Taker workloads, each
+// standing in for an instrument profile. Policies run interleaved, three passes each, and
+// report their fastest pass as ns/op; the end state of each book (size and levels) is
+// compared with the default build's.
+void RunBookPolicyBenchmark(std::size_t events);
+
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+namespace benchmarks {
+
+// Cancel-to-effect latency under saturation: one producer keeps its ring full of adds and
+// cancels the add it sent 64 adds earlier every third event, once with cancels in the ring
+// and once on the priority lane. Latency runs from enqueue until the engine has applied the
+// cancel (removed the order, or tombstoned an add still queued).
+void RunCancelPriorityBenchmark(double seconds);
+
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+namespace benchmarks {
+
+// Worst-case Orderbook paths on deep books, each with full percentile output and per-op
+// hardware counters (PrintPerfCounterStatus):
+//  - an aggressive order sweeping 1000 single-order levels (book rebuilt between samples)
+//  - a FillOrKill that walks a 10k-level book and is rejected (book unchanged)
+//  - a cancel in the middle of a 10k-order price level
+//  - a modify that moves the best bid through the best ask
+//  - random cancel + add pairs on a steady-state book of 1M and `maxBookOrders` orders
+// `samples` caps every scenario; the sweep and the FillOrKill use fewer.
+void RunDeepBookScenarios(std::size_t samples, std::size_t maxBookOrders);
+
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+namespace benchmarks {
+
+// Orderbook depth queries (DepthTo, LevelsToFill, EstimateFill) on ask ladders of 10 to
+// 10,000 levels, `queries` random queries each, three ways:
+//  - the scalar walk the book used before: ordered price levels plus a hash lookup of each
+//    level's total
+//  - scalar loops over the contiguous DepthLadder arrays
+//  - the SIMD kernels (DepthKernels.h) the book calls
+// Targets are uniform over the side's total depth, so a query reaches half-way down the
+// ladder on average. Results are cross-checked between the three.
+void RunDepthQueryBenchmark(std::size_t queries);
+
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+namespace benchmarks {
+
+// Skewed multi-producer load against a real MatchingEngine: two unthrottled producers and
+// two paced ones (one event every ~20 us), run once with equal channel weights and once with
+// the second hot producer weighted 3. Prints per-channel throughput and enqueue -> dequeue
+// latency so the effect of weights and empty-queue skipping is visible.
+void RunDrainFairnessBenchmark(double seconds);
+
+}
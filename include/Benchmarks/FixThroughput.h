@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+namespace benchmarks {
+
+// FIX 4.4 order entry (FixCodec.h) on one core. A MarketMaker workload of `messages` ops is
+// encoded as NewOrderSingle / OrderCancelRequest / OrderCancelReplaceRequest into a file,
+// which is read back whole and timed through:
+//  - decode only
+//  - decode and map to EngineEvents
+//  - decode, map and apply to an Orderbook
+// and, on the way out, encoding one ExecutionReport per message. Each stage runs three
+// passes and reports its fastest as messages/s.
+void RunFixCodecBenchmark(std::size_t messages);
+
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+namespace benchmarks {
+
+// Producer throughput for 1..maxProducers producers pushing into their own rings while one
+// consumer drains them, once with the old single shared in-flight counter and once with
+// per-producer credit windows (Backpressure). Each point runs for `seconds`.
+void RunFlowControlScaling(std::size_t maxProducers, double seconds);
+
+}
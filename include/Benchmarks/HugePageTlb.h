@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+namespace benchmarks {
+
+// Builds a resting book of `bookOrders` orders whose Order objects and shared_ptr control
+// blocks live in a RegionArena, once on 4 KiB pages and once on 2 MiB pages, then times
+// `probes` random cancels and reports dTLB misses per cancel for each backing.
+void RunHugePageTlbBenchmark(std::size_t bookOrders, std::size_t probes);
+
+}
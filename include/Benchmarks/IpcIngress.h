@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+
+namespace benchmarks {
+
+// Shared-memory ingress (ShmIngress.h), each part run with the other side first as a thread
+// in this process and then as a forked process that maps the same /dev/shm segments:
+//  - round trip of one WireEvent over a pair of WireRings (ping, echo, pong), `samples` times
+//  - a gateway pushing `samples` add/cancel events into a live engine's ingress ring as fast
+//    as it accepts them: events/s and the engine's sampled enqueue -> dequeue latency
+void RunIpcIngressBenchmark(std::size_t samples);
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+namespace benchmarks {
+
+// Engine-side cost of L2 market data (LevelDeltaFeed.h), on one thread: a MarketMaker
+// workload of `events` ops applied to a book in bursts of the engine's default size, with
+// the end-of-burst work of each mode timed together with the burst:
+//  - no market data (baseline)
+//  - every level change published as a delta
+//  - deltas conflated to one per touched level per burst
+//  - a top-N snapshot of both sides per burst, N = 5 and 20
+// Modes run interleaved, three passes each, and report their fastest pass.
+// The consumer side runs untimed between bursts, rebuilding an L2Book from the deltas; it is
+// checked against the book at the end.
+void RunL2FeedBenchmark(std::size_t events);
+
+}
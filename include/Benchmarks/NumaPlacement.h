@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Benchmarks/BenchOptions.h"
+
+namespace benchmarks {
+
+// Runs the ring round-trip and AddOrder benchmarks with their memory bound to the node of
+// the benchmark thread (local) and/or to a different node (remote).
+void RunNumaPlacementBenchmarks(std::size_t iterations, NumaMode mode);
+
+}
@@ -1,7 +1,8 @@
 #pragma once
 
 #include <cstdint>
-#include <vector>
+
+#include "LatencyHistogram.h"
 
 namespace benchmarks {
 
@@ -10,8 +11,12 @@ struct LatencyPercentilesNs {
     std::uint64_t p95 = 0;
     std::uint64_t p99 = 0;
     std::uint64_t p999 = 0;
+    std::uint64_t p9999 = 0;
+    std::uint64_t max = 0;
+    std::uint64_t mean = 0;
+    std::uint64_t count = 0;
 };
 
-LatencyPercentilesNs ComputeLatencyPercentilesNs(std::vector<std::uint64_t> samplesNs);
+LatencyPercentilesNs ComputeLatencyPercentilesNs(const LatencyHistogram& histogram);
 
 }
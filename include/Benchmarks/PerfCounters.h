@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace benchmarks {
+
+enum class PerfEvent : std::uint8_t {
+    DTlbLoadMisses,
+    DTlbStoreMisses,
+    Cycles,
+    Instructions,
+    L1DLoadMisses,
+    LlcMisses,
+    BranchMisses
+};
+
+inline constexpr std::size_t PerfEventCount = 7;
+
+const char* ToString(PerfEvent event) noexcept;
+
+// One Linux perf_event_open counter for the calling thread (user space only). valid() is
+// false when the kernel refuses it (perf_event_paranoid, containers, non-Linux); start/stop
+// are then no-ops and stop() returns 0.
+class PerfCounter {
+public:
+    explicit PerfCounter(PerfEvent event) noexcept;
+    ~PerfCounter();
+    PerfCounter(const PerfCounter&) = delete;
+    PerfCounter& operator=(const PerfCounter&) = delete;
+
+    bool valid() const noexcept { return fd_ >= 0; }
+    void start() noexcept;
+    std::uint64_t stop() noexcept;
+
+private:
+    int fd_ = -1;
+};
+
+// Totals read from a PerfCounterGroup. `valid` is false when no counter ran.
+struct PerfCounts {
+    bool valid = false;
+    bool scaled = false;                       // the PMU was shared, values are estimates
+    bool present[PerfEventCount] = {};
+    std::uint64_t values[PerfEventCount] = {};
+
+    bool has(PerfEvent e) const noexcept { return present[static_cast<std::size_t>(e)]; }
+    std::uint64_t get(PerfEvent e) const noexcept { return values[static_cast<std::size_t>(e)]; }
+};
+
+// Cycles, instructions, L1D load misses, LLC misses, branch misses and dTLB load misses,
+// opened as one perf group so they all cover the same instructions. Counters the kernel
+// or PMU refuses are left out; with none at all valid() is false and everything is a no-op.
+//
+// start()/stop() bracket one region; pause()/resume() leave untimed work (book rebuilds)
+// out of a region that is measured in pieces.
+class PerfCounterGroup {
+public:
+    PerfCounterGroup() noexcept;
+    ~PerfCounterGroup();
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    bool valid() const noexcept { return count_ > 0; }
+    void start() noexcept;
+    void pause() noexcept;
+    void resume() noexcept;
+    PerfCounts stop() noexcept;
+
+private:
+    static constexpr std::size_t MaxEvents = 6;
+
+    int fds_[MaxEvents] = { -1, -1, -1, -1, -1, -1 };
+    PerfEvent events_[MaxEvents] = {};
+    std::size_t count_ = 0;
+};
+
+// Why counters cannot be opened here (e.g. "perf_event_paranoid=3"), or nullptr when they can.
+const char* PerfUnavailableReason() noexcept;
+
+}
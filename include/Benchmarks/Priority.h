@@ -7,8 +7,14 @@ namespace benchmarks {
 struct PriorityResult {
     bool processPriorityRaised = false;
     bool threadPriorityRaised = false;
+    bool realtimeScheduling = false;  // calling thread moved to SCHED_FIFO
+    int realtimePriority = 0;
+    bool memoryLocked = false;        // mlockall(MCL_CURRENT | MCL_FUTURE) succeeded
 };
 
+// Linux: nice -20, SCHED_FIFO for the calling thread and mlockall; each step needs
+// CAP_SYS_NICE / CAP_IPC_LOCK (or matching rlimits) and is skipped silently otherwise.
+// macOS: nice -20 and the user-interactive QoS class.
 PriorityResult RaiseProcessAndThreadPriorityBestEffort() noexcept;
 
 }
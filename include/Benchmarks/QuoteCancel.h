@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+
+namespace benchmarks {
+
+// Pulling a market maker's quotes: 1000 resting orders of one owner (10 per level, 50 levels
+// a side) over a background book of other owners' orders, removed either by 1000 CancelOrder
+// calls or by one Orderbook::MassCancel. A second case pulls only the bids within 10 ticks of
+// the touch (100 orders). Each of `rounds` rounds re-quotes untimed and times one removal;
+// percentiles are per removal of the whole set, ns/order is the median over the orders removed.
+void RunMassCancelBenchmark(std::size_t rounds);
+
+}
@@ -2,15 +2,37 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 namespace benchmarks {
 
+struct HugePagePool {
+    std::uint64_t pageSizeKb = 0;
+    std::uint64_t total = 0;
+    std::uint64_t free = 0;
+};
+
 struct SystemInfo {
     std::uint32_t cpuCores = 0;
     std::uint64_t availableMemoryBytes = 0;
     std::size_t pageSizeBytes = 0;
+
+    // Filled where the platform exposes them (Linux: /proc and /sys); empty/0 otherwise.
+    std::uint64_t totalMemoryBytes = 0;
+    std::string cpuModel;
+    std::string kernel;
+    std::string frequencyGovernor;
+    std::uint32_t maxFrequencyMhz = 0;
+    std::uint64_t l1dCacheBytes = 0;
+    std::uint64_t l2CacheBytes = 0;
+    std::uint64_t l3CacheBytes = 0;
+    std::vector<HugePagePool> hugePagePools;
+    std::string transparentHugePages;
+    std::string isolatedCpus;        // /sys/devices/system/cpu/isolated
+    std::string nohzFullCpus;        // /sys/devices/system/cpu/nohz_full
 };
 
-SystemInfo QuerySystemInfo() noexcept;
+SystemInfo QuerySystemInfo();
 
 }
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "Percentiles.h"
+#include "WaitStrategy.h"
+#include "Workload.h"
+
+namespace benchmarks {
+
+// One configuration of the producer -> ring -> engine pipeline.
+//
+// The engine's ring type is fixed at compile time (OrderRingBuffer, 16384 slots), so a
+// smaller `ringSize` is modelled by never letting more than ringSize - 1 events be in flight:
+// the credit window is `creditFraction` of that. The slots past it are simply never touched.
+struct SweepPoint {
+    std::size_t producers = 1;
+    std::uint32_t burstSize = 64;
+    std::size_t ringSize = 16384;
+    double creditFraction = 0.9;
+    bool l3Feed = false;                  // engine publishes an L3 feed, rebuilt by a consumer thread
+    bool riskStage = false;               // a RiskStage thread sits between the producers and the engine
+
+    std::size_t CreditLimit() const;
+};
+
+struct SweepResult {
+    SweepPoint point;
+    WorkloadPreset workload = WorkloadPreset::Uniform;
+    double seconds = 0.0;                 // measured phase only
+    std::uint64_t events = 0;             // processed by the engine
+    double eventsPerSec = 0.0;
+    double producedPerSec = 0.0;
+    double idleRatio = 0.0;               // idle engine rounds / all rounds
+    std::uint64_t enqueueRetries = 0;     // full-ring push attempts, all producers
+    std::uint64_t creditWaits = 0;        // times a producer found its window closed
+    LatencyPercentilesNs queueLatency;    // sampled enqueue -> dequeue, all rings
+    double l3MessagesPerSec = 0.0;
+    double l3BytesPerSec = 0.0;
+    std::uint64_t l3Dropped = 0;          // messages in bursts the feed ring had no room for
+    std::uint64_t l3Errors = 0;           // rebuilt book disagrees with the feed or the engine's book
+    std::uint64_t riskRejected = 0;       // adds and modifies the risk stage dropped
+};
+
+struct SweepOptions {
+    std::vector<std::size_t> producers{ 1, 2, 4 };
+    std::vector<std::uint32_t> burstSizes{ 16, 64, 256 };
+    std::vector<std::size_t> ringSizes{ 1024, 4096, 16384 };
+    std::vector<double> creditFractions{ 0.5, 0.9 };
+    std::vector<bool> l3Feed{ false };
+    std::vector<bool> riskStage{ false };
+    double warmupSeconds = 0.5;
+    double measureSeconds = 2.0;
+    WaitStrategyKind wait = WaitStrategyKind::SpinYield;
+    WorkloadPreset workload = WorkloadPreset::Uniform;
+    std::string csvPath;                  // empty: no CSV file
+    std::string jsonPath;                 // empty: no JSON file
+};
+
+// Usage: OrderbookThroughputSweep [--producers=1,2,4] [--burst=16,64,256]
+//                                 [--ring=1024,4096,16384] [--credit=0.5,0.9]
+//                                 [--warmup=seconds] [--seconds=seconds]
+//                                 [--wait=spin|yield|park] [--workload=uniform|maker|taker]
+//                                 [--l3=off,on] [--risk=off,on] [--csv=path] [--json=path]
+SweepOptions ParseSweepOptions(int argc, char** argv);
+
+// Cartesian product of the option lists, producers outermost, risk stage innermost.
+std::vector<SweepPoint> ExpandSweep(const SweepOptions& opts);
+
+// Starts one engine and point.producers producers (plus a risk stage if asked), runs the warm-up phase, then reports
+// counter and histogram deltas over the measured phase only.
+SweepResult RunSweepPoint(const SweepPoint& point, const SweepOptions& opts);
+
+void PrintSweepHeader(std::ostream& out);
+void PrintSweepRow(std::ostream& out, const SweepResult& r);
+void WriteSweepCsv(std::ostream& out, const std::vector<SweepResult>& results);
+void WriteSweepJson(std::ostream& out, const std::vector<SweepResult>& results);
+
+}
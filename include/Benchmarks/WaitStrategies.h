@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+namespace benchmarks {
+
+// For each WaitStrategyKind: a waiter thread idles with the strategy while a waker on another
+// core publishes a timestamp every ~50 us and notifies. Reports publish-to-observe latency
+// percentiles and the waiter's CPU time as a share of wall time over `samples` wake-ups.
+void RunWaitStrategyBenchmark(std::size_t samples);
+
+}
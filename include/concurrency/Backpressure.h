@@ -1,32 +1,137 @@
 #pragma once
 #include <atomic>
-#include <thread>
+#include <cstddef>
+#include <cstdint>
 
-struct Backpressure {
-    std::atomic<size_t> count{0};
-    size_t limit;
+#include "WaitStrategy.h"
 
-    std::atomic<std::uint64_t> waitCalls{0};
-    std::atomic<std::uint64_t> waitSpins{0};
+// Credit window for one producer -> engine channel. The producer may have at most `limit`
+// events in flight. It counts what it sent on its own line and only reads the engine's
+// `returned_` line when its cached view says the window is exhausted. The engine tallies
+// consumed events locally and publishes them back in batches (every `returnBatch` events and
+// at the end of each burst), so neither side writes a line the other writes on the fast path
+// and no line is shared between producers.
+//
+// The window also carries the channel's wake-ups for SpinPark: a producer out of credits
+// parks on the window's own spot and flush() wakes it; increment() wakes the engine's spot
+// once the engine has attached it.
+class Backpressure {
+public:
+    explicit Backpressure(size_t limit, WaitStrategy wait = {}, size_t returnBatch = 64)
+        : limit_(limit ? limit : 1),
+          returnBatch_(ClampBatch(limit_, returnBatch)),
+          wait_(wait)
+    {}
 
-    explicit Backpressure(size_t l) : limit(l) {}
+    Backpressure(const Backpressure&) = delete;
+    Backpressure& operator=(const Backpressure&) = delete;
+
+    // ---- producer side ----
 
     void wait_if_needed() {
-        waitCalls.fetch_add(1, std::memory_order_relaxed);
+        if (sentLocal_ - returnedCache_ < limit_)
+            return;
+        returnedCache_ = returned_.load(std::memory_order_acquire);
+        if (sentLocal_ - returnedCache_ < limit_)
+            return;
+
+        waitCalls_.store(waitCalls_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
         uint32_t spins = 0;
-        while (count.load(std::memory_order_acquire) >= limit) {
-            waitSpins.fetch_add(1, std::memory_order_relaxed);
-
-            if (spins < 128) {
-                ++spins;
-                std::atomic_signal_fence(std::memory_order_seq_cst);
-            } else {
-                spins = 0;
-                std::this_thread::yield();
-            }
+        std::uint64_t waited = 0;
+        const auto hasCredit = [this] {
+            return sentLocal_ - returned_.load(std::memory_order_acquire) < limit_;
+        };
+        while (sentLocal_ - (returnedCache_ = returned_.load(std::memory_order_acquire)) >= limit_) {
+            ++waited;
+            wait_.idle(spins, &producerSpot_, hasCredit);
         }
+        waitSpins_.store(waitSpins_.load(std::memory_order_relaxed) + waited, std::memory_order_relaxed);
+    }
+
+    // Non-blocking form of wait_if_needed(), for a sender that has other work to do while
+    // the window is closed (RiskStage).
+    bool has_credit() {
+        if (sentLocal_ - returnedCache_ < limit_)
+            return true;
+        returnedCache_ = returned_.load(std::memory_order_acquire);
+        return sentLocal_ - returnedCache_ < limit_;
+    }
+
+    void increment() {
+        ++sentLocal_;
+        sent_.store(sentLocal_, std::memory_order_relaxed);
+        notify_consumer();
     }
 
-    void increment() { count.fetch_add(1, std::memory_order_acq_rel); }
-    void decrement() { count.fetch_sub(1, std::memory_order_acq_rel); }
-};
\ No newline at end of file
+    // Wakes a parked engine after publishing something that bypasses the window.
+    void notify_consumer() {
+        if (consumerSpot_)
+            wait_.notify(*consumerSpot_);
+    }
+
+    // ---- engine side ----
+
+    void decrement() {
+        if (++pendingReturn_ >= returnBatch_)
+            flush();
+    }
+
+    void flush() {
+        if (pendingReturn_ == 0)
+            return;
+        consumedLocal_ += pendingReturn_;
+        pendingReturn_ = 0;
+        returned_.store(consumedLocal_, std::memory_order_release);
+        wait_.notify(producerSpot_);
+    }
+
+    // Spot the engine parks on when every channel is empty. Set before the threads start.
+    void attach_consumer(ParkingSpot* spot) { consumerSpot_ = spot; }
+
+    // ---- observers (any thread, approximate) ----
+
+    size_t limit() const { return limit_; }
+    size_t return_batch() const { return returnBatch_; }
+    const WaitStrategy& wait_strategy() const { return wait_; }
+    std::uint64_t sent() const { return sent_.load(std::memory_order_relaxed); }
+    std::uint64_t returned() const { return returned_.load(std::memory_order_relaxed); }
+    std::uint64_t in_flight() const {
+        const std::uint64_t r = returned();
+        const std::uint64_t s = sent();
+        return s > r ? s - r : 0;
+    }
+    std::uint64_t wait_calls() const { return waitCalls_.load(std::memory_order_relaxed); }
+    std::uint64_t wait_spins() const { return waitSpins_.load(std::memory_order_relaxed); }
+
+private:
+    // A batch above half the window would leave the producer stalled on credits the engine
+    // is still holding back.
+    static size_t ClampBatch(size_t limit, size_t batch) {
+        const size_t maxBatch = limit / 2 ? limit / 2 : 1;
+        if (batch == 0)
+            return 1;
+        return batch > maxBatch ? maxBatch : batch;
+    }
+
+    const size_t limit_;
+    const size_t returnBatch_;
+    const WaitStrategy wait_;
+    ParkingSpot* consumerSpot_ = nullptr;
+
+    // Producer sleeps here when out of credits; its own line.
+    ParkingSpot producerSpot_;
+
+    // Engine-written, producer-read.
+    alignas(64) std::atomic<std::uint64_t> returned_{0};
+
+    // Engine-private.
+    alignas(64) std::uint64_t consumedLocal_ = 0;
+    std::uint64_t pendingReturn_ = 0;
+
+    // Producer-written; the atomics are only read by monitors.
+    alignas(64) std::uint64_t sentLocal_ = 0;
+    std::uint64_t returnedCache_ = 0;
+    std::atomic<std::uint64_t> sent_{0};
+    std::atomic<std::uint64_t> waitCalls_{0};   // calls that found the window exhausted
+    std::atomic<std::uint64_t> waitSpins_{0};
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+#include "SPSCRingBuffer.h"
+#include "Usings.h"
+
+// A cancel on the priority lane: just the id, plus an enqueue stamp for sampled requests.
+struct CancelRequest {
+    OrderId orderId = 0;
+    std::uint64_t enqueueNs = 0;
+};
+
+// Per-producer high-priority ring for cancels. The engine drains every lane before each
+// normal burst, so a cancel does not wait behind the adds queued ahead of it. Lane traffic
+// is not counted against the producer's credit window.
+using CancelLane = SPSCQueue<CancelRequest, 4096>;
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+#include <vector>
+
+struct CpuInfo {
+    std::uint32_t cpu = 0;
+    std::int32_t coreId = -1;
+    std::int32_t packageId = -1;
+    std::int32_t l3Id = -1;          // lowest cpu sharing this cpu's last-level cache
+    bool isolated = false;           // listed in /sys/devices/system/cpu/isolated (isolcpus=)
+    std::vector<std::uint32_t> smtSiblings; // includes cpu itself
+};
+
+struct CpuTopology {
+    std::vector<CpuInfo> cpus;       // online cpus this process may run on, ascending
+    bool fromSysfs = false;          // false: topology unknown, one core per cpu assumed
+
+    const CpuInfo* Find(std::uint32_t cpu) const;
+};
+
+// Parses the kernel cpu-list format ("0-3,8,10-11").
+std::vector<std::uint32_t> ParseCpuList(std::string_view list);
+
+// Reads /sys/devices/system/cpu on Linux; elsewhere falls back to hardware_concurrency().
+CpuTopology DiscoverCpuTopology();
+
+struct ThreadPlacement {
+    int engineCpu = -1;              // -1: leave unpinned
+    std::vector<int> producerCpus;
+    std::vector<std::uint32_t> reservedCpus; // engine's SMT siblings, kept idle
+};
+
+// Engine goes to an isolated physical core when one exists (otherwise the last core, away
+// from cpu 0's housekeeping). Producers fill whole cores on the engine's L3, then its
+// package, then the rest; the engine's SMT siblings are never handed out.
+ThreadPlacement PlanThreadPlacement(const CpuTopology& topology, std::size_t producerCount);
+
+void PrintThreadPlacement(std::ostream& os, const CpuTopology& topology, const ThreadPlacement& placement);
@@ -3,24 +3,32 @@
 #include <cstdint>
 
 #include "Usings.h"
+#include "MassCancel.h"
 #include "Order.h"
 #include "OrderModify.h"
+#include "Tracing.h"
 
 struct ShutdownEvent {};
 
 using EngineEventPayload =
-    std::variant<OrderPointer, OrderId, OrderModify, ShutdownEvent>;
+    std::variant<OrderPointer, OrderId, OrderModify, ShutdownEvent, MassCancelRequest>;
 
 enum class EngineEventType : uint8_t {
     Add,
     Cancel,
     Modify,
-    Shutdown
+    Shutdown,
+    MassCancel
 };
 
 struct EngineEvent {
     EngineEventType type;
     EngineEventPayload payload;
+    // ob::time::now_ns() at enqueue for the events a producer samples; 0 otherwise.
+    std::uint64_t enqueueNs = 0;
+#if OB_TRACING
+    EventTrace trace{};
+#endif
 
     static EngineEvent MakeAdd(OrderPointer o) {
         return { EngineEventType::Add, std::move(o) };
@@ -34,6 +42,10 @@ struct EngineEvent {
         return { EngineEventType::Modify, std::move(m) };
     }
 
+    static EngineEvent MakeMassCancel(MassCancelRequest request) {
+        return { EngineEventType::MassCancel, request };
+    }
+
     static EngineEvent MakeShutdown() {
         return { EngineEventType::Shutdown, ShutdownEvent{} };
     }
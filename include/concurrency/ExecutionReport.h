@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+#include "SPSCRingBuffer.h"
+#include "Side.h"
+#include "Usings.h"
+
+enum class ExecutionReportType : std::uint8_t {
+    Fill,       // `quantity` of the order traded
+    Closed      // the order is no longer in the book: cancelled, rejected, or fully filled
+};
+
+// What the engine tells an upstream stage (RiskStage) about the orders it applied. Fills are
+// reported for both sides of every trade, whatever path the aggressor came from; Closed
+// follows every cancel, and every add or modify whose order did not stay in the book.
+struct ExecutionReport {
+    OrderId orderId = 0;
+    Quantity quantity = 0;
+    Side side = Side::Buy;
+    ExecutionReportType type = ExecutionReportType::Fill;
+};
+
+using ExecutionReportRing = SPSCQueue<ExecutionReport, 65536>;
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "EngineEvent.h"
+#include "FixCodec.h"
+
+// The engine event for a decoded order-entry message: NewOrderSingle adds a new Order,
+// OrderCancelRequest cancels OrigClOrdID and OrderCancelReplaceRequest modifies it in place.
+inline EngineEvent ToEngineEvent(const FixMessage& message) {
+    switch (message.type_) {
+        case FixMsgType::OrderCancelRequest:
+            return EngineEvent::MakeCancel(message.origClOrdId_);
+        case FixMsgType::OrderCancelReplaceRequest:
+            return EngineEvent::MakeModify(message.ToOrderModify());
+        default:
+            return EngineEvent::MakeAdd(message.ToOrder());
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "L3Codec.h"
+
+// Outbound order-by-order market data. The engine's Orderbook encodes every order event into
+// encoder(); at the end of each burst the engine calls publish(), which copies the burst's
+// messages into a byte ring for one consumer. Messages are variable-length, so the ring is a
+// byte stream rather than an SPSCQueue of slots, and a burst becomes visible all at once.
+//
+// The engine never waits for the consumer: a burst that does not fit is dropped whole and
+// counted, and the consumer sees the gap in the sequence numbers.
+class L3Feed {
+public:
+    static constexpr std::size_t RingBytes = std::size_t{1} << 22;
+
+    L3Feed();
+    L3Feed(const L3Feed&) = delete;
+    L3Feed& operator=(const L3Feed&) = delete;
+
+    // Engine thread.
+    L3Encoder* encoder() noexcept { return &encoder_; }
+    void publish() noexcept;
+
+    // Consumer thread: copies up to `max` bytes into `out` and returns how many. Only whole
+    // bursts are ever readable, but `max` may cut a message: decode what is complete and keep
+    // the rest in front of the next read (L3Book::Apply returns what it consumed).
+    std::size_t read(std::uint8_t* out, std::size_t max) noexcept;
+
+    // Any thread.
+    std::uint64_t messages() const noexcept { return messages_.load(std::memory_order_relaxed); }
+    std::uint64_t bytes() const noexcept { return bytes_.load(std::memory_order_relaxed); }
+    std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    L3Encoder encoder_;
+    std::unique_ptr<std::uint8_t[]> ring_;
+
+    std::atomic<std::uint64_t> messages_{0};    // published, after drops
+    std::atomic<std::uint64_t> bytes_{0};
+    std::atomic<std::uint64_t> dropped_{0};     // messages in dropped bursts
+
+    // Byte counts since the start; the ring offset is the count modulo RingBytes.
+    alignas(64) std::atomic<std::uint64_t> tail_{0};     // engine
+    std::uint64_t headCache_ = 0;
+    alignas(64) std::atomic<std::uint64_t> head_{0};     // consumer
+    std::uint64_t tailCache_ = 0;
+};
@@ -0,0 +1,99 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-size log-linear (HDR-style) histogram of nanosecond values.
+//
+// Values below 2^SubBucketBits get one bucket each; above that every power of two is split
+// into 2^SubBucketBits equal buckets, so any recorded value is reported within 1/128 (<0.8%)
+// of itself. Values from 2^MaxValueBits (~18 minutes) up share the last bucket; max() stays
+// exact. 35 KiB per histogram regardless of how many samples are recorded.
+//
+// record() is for one writer thread and costs a clz, a shift and a few relaxed load/store
+// pairs, no locked instructions. Any thread may read concurrently (snapshots are approximate
+// while the writer runs) and fold histograms together with merge().
+class LatencyHistogram {
+public:
+    static constexpr unsigned SubBucketBits = 7;
+    static constexpr unsigned MaxValueBits = 40;
+    static constexpr std::size_t SubBucketCount = std::size_t{1} << SubBucketBits;
+    static constexpr std::size_t BucketCount = (MaxValueBits - SubBucketBits + 1) * SubBucketCount;
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram& other) { copy_from(other); }
+    LatencyHistogram& operator=(const LatencyHistogram& other) {
+        if (this != &other)
+            copy_from(other);
+        return *this;
+    }
+
+    static std::size_t bucket_index(std::uint64_t value) noexcept {
+        if (value < SubBucketCount)
+            return static_cast<std::size_t>(value);
+        const unsigned msb = 63u - static_cast<unsigned>(std::countl_zero(value));
+        if (msb >= MaxValueBits)
+            return BucketCount - 1;
+        const unsigned shift = msb - SubBucketBits;
+        const std::size_t sub = static_cast<std::size_t>(value >> shift) - SubBucketCount;
+        return (shift + 1) * SubBucketCount + sub;
+    }
+
+    static std::uint64_t bucket_lowest(std::size_t index) noexcept;
+    static std::uint64_t bucket_highest(std::size_t index) noexcept;
+
+    // ---- writer ----
+
+    void record(std::uint64_t value) noexcept { record_n(value, 1); }
+
+    void record_n(std::uint64_t value, std::uint64_t n) noexcept {
+        auto& bucket = counts_[bucket_index(value)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        count_.store(count_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        sum_.store(sum_.load(std::memory_order_relaxed) + value * n, std::memory_order_relaxed);
+        if (value > max_.load(std::memory_order_relaxed))
+            max_.store(value, std::memory_order_relaxed);
+        if (value < min_.load(std::memory_order_relaxed))
+            min_.store(value, std::memory_order_relaxed);
+    }
+
+    void reset() noexcept;
+
+    // Adds `other` into this histogram. This histogram must not be recorded into
+    // concurrently; `other` may be.
+    void merge(const LatencyHistogram& other) noexcept;
+
+    // Removes an earlier snapshot of the same histogram, leaving what was recorded since.
+    // min/max of the interval are then bucket-accurate rather than exact.
+    void subtract(const LatencyHistogram& earlier) noexcept;
+
+    // ---- readers ----
+
+    std::uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+    std::uint64_t sum() const noexcept { return sum_.load(std::memory_order_relaxed); }
+    std::uint64_t max() const noexcept { return max_.load(std::memory_order_relaxed); }
+    std::uint64_t min() const noexcept {
+        const std::uint64_t m = min_.load(std::memory_order_relaxed);
+        return m == NoMin ? 0 : m;
+    }
+    std::uint64_t mean() const noexcept {
+        const std::uint64_t n = count();
+        return n ? sum() / n : 0;
+    }
+
+    // Smallest recorded-bucket value v such that at least q of the samples are <= v,
+    // reported as the bucket's upper edge capped at max(). q in [0, 1]; 0 when empty.
+    std::uint64_t quantile(double q) const noexcept;
+
+private:
+    static constexpr std::uint64_t NoMin = ~std::uint64_t{0};
+
+    void copy_from(const LatencyHistogram& other) noexcept;
+
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+    std::atomic<std::uint64_t> min_{NoMin};
+    std::atomic<std::uint64_t> counts_[BucketCount] = {};
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "LevelDelta.h"
+#include "SPSCRingBuffer.h"
+
+using LevelDeltaRing = SPSCQueue<LevelDelta, 65536>;
+
+// Outbound L2 market data. The engine's Orderbook appends every level change to pending();
+// at the end of each burst the engine calls publish(), which numbers the deltas and pushes
+// them into an SPSC ring for one consumer (a book builder, a publisher thread).
+//
+// With conflation a burst publishes each touched level once, with its final totals, in the
+// order the levels were last touched; a level that changed and changed back is still
+// published. Bursts with more than ConflateSlots / 2 changes go out unconflated. The engine
+// never waits for the consumer: what does not fit in the ring is dropped and counted, and
+// the consumer sees the gap in the sequence numbers.
+class LevelDeltaFeed {
+public:
+    static constexpr std::size_t ConflateSlots = 4096;
+
+    explicit LevelDeltaFeed(bool conflate);
+    LevelDeltaFeed(const LevelDeltaFeed&) = delete;
+    LevelDeltaFeed& operator=(const LevelDeltaFeed&) = delete;
+
+    // Engine thread.
+    LevelDeltas* pending() noexcept { return &pending_; }
+    void publish() noexcept;
+
+    // Consumer thread.
+    bool pop(LevelDelta& out) noexcept { return ring_.pop(out); }
+
+    bool conflating() const noexcept { return conflate_; }
+    // Any thread. `changes` counts level changes the book reported; `published` those sent
+    // after conflation, of which `dropped` found the ring full.
+    std::uint64_t changes() const noexcept { return changes_.load(std::memory_order_relaxed); }
+    std::uint64_t published() const noexcept { return published_.load(std::memory_order_relaxed); }
+    std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    // Open-addressing set of the levels seen in this burst. Slots from earlier bursts carry
+    // an older generation, so nothing is cleared between bursts.
+    struct Slot {
+        std::uint64_t key = 0;
+        std::uint32_t generation = 0;
+    };
+
+    void conflate() noexcept;
+
+    bool conflate_;
+    std::uint32_t generation_ = 0;
+    std::uint64_t sequence_ = 0;
+    LevelDeltas pending_;
+    LevelDeltas conflated_;
+    std::vector<Slot> slots_;
+    std::atomic<std::uint64_t> changes_{0};
+    std::atomic<std::uint64_t> published_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    LevelDeltaRing ring_;
+};
@@ -2,41 +2,187 @@
 #include <vector>
 #include <thread>
 #include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_set>
 
 #include "Orderbook.h"
 #include "EngineEvent.h"
+#include "ExecutionReport.h"
 #include "SPSCRingBuffer.h"
 #include "Backpressure.h"
+#include "L3Feed.h"
+#include "LevelDeltaFeed.h"
 #include "OrderRingBuffer.h"
+#include "ProducerChannel.h"
+#include "ShmIngress.h"
+#include "WaitStrategy.h"
+#include "LatencyHistogram.h"
+#include "Telemetry.h"
+#include "Tracing.h"
+
+// Per-channel drain counters, readable from any thread while the engine runs.
+struct EngineQueueStats {
+    std::uint32_t weight = 1;
+    std::uint64_t events = 0;
+    std::uint64_t visits = 0;             // rounds in which the channel had work
+    std::uint64_t laneEvents = 0;         // cancels taken from the priority lane
+    std::uint64_t overtakenAdds = 0;      // adds dropped because their cancel arrived first
+};
 
 class MatchingEngine {
 public:
+    // Occupancy is tracked in one 64-bit mask; constructing an engine with more channels
+    // aborts.
+    static constexpr std::size_t MaxChannels = 64;
+    // Same bound for attached shared-memory ingress rings, which have their own mask.
+    static constexpr std::size_t MaxIngress = 64;
+    // How often the discovery thread looks for new ingress segments.
+    static constexpr std::uint64_t IngressScanIntervalMs = 100;
+    // Tombstones for lane cancels whose add is still queued are bounded by the adds in
+    // flight; past this, entries the add stream has already moved beyond are purged.
+    static constexpr std::size_t MaxTombstones = 1u << 16;
+
+    // Sampled telemetry fields (depths, book size, parks) are republished at most every
+    // PublishIntervalNs; the clock is only read every PublishCheckRounds rounds.
+    static constexpr std::uint64_t PublishIntervalNs = 10'000'000;
+    static constexpr std::uint64_t PublishCheckRounds = 64;
+
+    // Counters and histograms are written into `telemetry` (see Telemetry.h), which must have
+    // at least channels.size() channels and outlive the engine; without one the engine keeps
+    // a private block. A region that is not mapped, or too small, aborts.
     MatchingEngine(
-        std::vector<OrderRingBuffer*>& queues,
-        Backpressure& backpressure,
-        uint32_t burstSize = 64
+        std::vector<ProducerChannel>& channels,
+        uint32_t burstSize = 64,
+        int cpu = -1,
+        WaitStrategy wait = {},
+        const TelemetryRegion* telemetry = nullptr
     );
 
+    // Call before start(): from then on a side thread maps every ingress segment named
+    // IngressSegmentName(prefix, id) it finds in /dev/shm and hands it to the engine thread,
+    // which drains it like a channel until the gateway closes it (or exits) and it is empty.
+    void EnableIngress(std::string prefix);
+
+    // Call before start(): every level change is published to an L2 delta feed at the end
+    // of each burst, conflated to one delta per touched level if `conflate`. One consumer
+    // thread pops LevelDeltas().
+    void EnableLevelDeltas(bool conflate);
+
+    // Call before start(): every order event is encoded (L3Codec.h) and published to an L3
+    // feed at the end of each burst. One consumer thread reads L3Messages().
+    void EnableL3Feed();
+
+    // Call before start(): fills and order closes are pushed to `reports` (see
+    // ExecutionReport.h) for an upstream stage such as RiskStage, which must keep draining it
+    // while the engine runs. The engine waits for room rather than drop a report.
+    void EnableExecutionReports(ExecutionReportRing* reports);
+
     void start();
     void stop();
     void print() const;
 
-    uint32_t EventsProcessed() const { return eventsProcessed_; }
+    std::uint64_t EventsProcessed() const { return stats_->events.load(std::memory_order_relaxed); }
+    // Book figures are read directly: only call these once the engine has stopped. While it
+    // runs, Telemetry().engine() has their published values.
     std::uint64_t TotalOps() const { return orderbook_.TotalOps(); }
     std::size_t OrderCount() const { return orderbook_.Size(); }
-    std::uint64_t IdleLoops() const { return idleLoops_.load(std::memory_order_relaxed); }
+    std::uint64_t IdleLoops() const { return stats_->idleLoops.load(std::memory_order_relaxed); }
+    // Rounds that found at least one channel with work; with IdleLoops() gives the idle ratio.
+    std::uint64_t BusyRounds() const { return stats_->busyRounds.load(std::memory_order_relaxed); }
+    std::uint64_t Parks() const { return wake_.parks(); }
+    std::size_t ChannelCount() const { return channels_.size(); }
+    EngineQueueStats QueueStats(std::size_t channel) const;
+    // Live histograms (engine writes, any thread reads; copy to snapshot). Queue latency is
+    // enqueue -> dequeue of sampled ring events, cancel latency enqueue -> cancel applied
+    // for sampled cancels on either path.
+    const LatencyHistogram& QueueLatency(std::size_t channel) const { return state_[channel].stats->queueLatency; }
+    const LatencyHistogram& CancelLatency(std::size_t channel) const { return state_[channel].stats->cancelLatency; }
+#if OB_TRACING
+    // Every traced ring event, split by pipeline stage (see StageLatency).
+    const StageLatency& Stages() const { return *stages_; }
+#endif
+    const TelemetryRegion& Telemetry() const { return *telemetry_; }
+    // Null unless EnableLevelDeltas was called.
+    LevelDeltaFeed* LevelDeltas() const { return levelDeltas_.get(); }
+    // Null unless EnableL3Feed was called.
+    L3Feed* L3Messages() const { return l3Feed_.get(); }
 
 private:
+    // Engine-private lane bookkeeping and the op tallies of the visit in progress; the
+    // published counters are in `stats`.
+    struct alignas(64) ChannelState {
+        OrderId nextAddId = 0;                  // lowest id of this producer not yet added
+        std::unordered_set<OrderId> tombstones;
+        std::uint64_t adds = 0;
+        std::uint64_t cancels = 0;
+        std::uint64_t modifies = 0;
+        ChannelTelemetry* stats = nullptr;
+    };
+
     void run();
+    bool has_work() const;
+    void drain(std::size_t channel, std::uint32_t burst);
+    void drain_cancel_lanes();
+    void apply_lane_cancel(std::size_t channel, const CancelRequest& request);
+    void process(std::size_t channel, EngineEvent& event);
+    void record_cancel_latency(ChannelState& st, std::uint64_t enqueueNs);
+    void flush_op_counts(ChannelState& st);
+    void drain_ingress(std::size_t index, std::uint32_t burst);
+    void process_wire(const WireEvent& event);
+    void poll_ingress();
+    void discover_ingress();
+    void publish(std::uint64_t nowNs);
+    void report_execution(OrderId id, const Trades& trades);
+    void report_closed(OrderId id);
+    void report(const ExecutionReport& report);
+    void end_burst() {
+        if (levelDeltas_)
+            levelDeltas_->publish();
+        if (l3Feed_)
+            l3Feed_->publish();
+    }
+#if OB_TRACING
+    void record_trace(const EventTrace& trace, std::uint64_t dequeued,
+                      std::uint64_t dispatched, std::uint64_t matched);
+#endif
 
     Orderbook orderbook_;
-    std::vector<OrderRingBuffer*> queues_;
-    Backpressure& backpressure_;
+    std::vector<ProducerChannel> channels_;
+    std::vector<ChannelState> state_;
     uint32_t burstSize_;
-    uint32_t eventsProcessed_ = 0;
+    uint32_t maxBurst_;
+    bool hasCancelLanes_ = false;
+    int cpu_;
+    WaitStrategy wait_;
     uint32_t shutdownsReceived_ = 0;
+    std::uint64_t eventsLocal_ = 0;             // engine-thread copy of stats_->events
+
+    TelemetryRegion ownTelemetry_;
+    const TelemetryRegion* telemetry_;
+    EngineTelemetry* stats_ = nullptr;
+#if OB_TRACING
+    StageLatency* stages_ = nullptr;
+#endif
+
+    // Producers wake the engine here when it parks (SpinPark). Gateways in other processes
+    // cannot; a parked engine sees their events within the park timeout.
+    ParkingSpot wake_;
+
+    std::unique_ptr<LevelDeltaFeed> levelDeltas_;
+    std::unique_ptr<L3Feed> l3Feed_;
+    ExecutionReportRing* reports_ = nullptr;
+    OrderIds massCancelled_;                            // scratch for a MassCancel's reports
 
-    alignas(64) std::atomic<std::uint64_t> idleLoops_{0};
+    // Ingress rings are owned and mapped/unmapped by the discovery thread. It passes new ones
+    // to the engine thread through ingressAttach_ and gets finished ones back through
+    // ingressDetach_, so the engine thread never makes a syscall for them.
+    std::string ingressPrefix_;
+    std::vector<IngressRing*> ingress_;                 // engine thread
+    SPSCQueue<IngressRing*, 64> ingressAttach_;
+    SPSCQueue<IngressRing*, 64> ingressDetach_;
+    std::atomic<bool> discovering_ = false;
+    std::thread discoveryThread_;
 
     std::atomic<bool> running_ = false;
     std::thread engineThread_ = std::thread();
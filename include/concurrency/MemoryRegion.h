@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Page-level allocation for long-lived engine structures (rings, order pool slabs, book
+// arenas). A region is mmap'd, optionally bound to a NUMA node, optionally backed by 2 MiB
+// pages, and first-touched before it is handed out so no page fault lands on the hot path.
+//
+// Huge pages are tried in order: explicit hugetlbfs pages (MAP_HUGETLB, needs
+// vm.nr_hugepages), then transparent huge pages (2 MiB-aligned mapping + MADV_HUGEPAGE),
+// then ordinary pages. Every step degrades silently; backing() reports what was obtained.
+
+constexpr std::size_t kHugePageSize = 2u * 1024u * 1024u;
+
+enum class PageBacking : std::uint8_t {
+    Base,
+    TransparentHuge,
+    HugeTlb
+};
+
+const char* ToString(PageBacking backing) noexcept;
+
+struct RegionOptions {
+    int node = -1;              // NUMA node to bind to, -1 for no binding
+    bool hugePages = false;
+};
+
+struct HugePageSupport {
+    std::uint64_t hugeTlbTotal = 0;   // HugePages_Total
+    std::uint64_t hugeTlbFree = 0;    // HugePages_Free
+    std::uint64_t hugePageSizeBytes = 0;
+    const char* thpMode = "unavailable"; // always | madvise | never | unavailable
+};
+
+HugePageSupport QueryHugePageSupport() noexcept;
+
+class MemoryRegion {
+public:
+    MemoryRegion() = default;
+    MemoryRegion(const MemoryRegion&) = delete;
+    MemoryRegion& operator=(const MemoryRegion&) = delete;
+    MemoryRegion(MemoryRegion&& other) noexcept { swap(other); }
+    MemoryRegion& operator=(MemoryRegion&& other) noexcept { MemoryRegion(std::move(other)).swap(*this); return *this; }
+    ~MemoryRegion();
+
+    static MemoryRegion Allocate(std::size_t bytes, RegionOptions options = {}) noexcept;
+
+    void* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return bytes_; }
+    int node() const noexcept { return node_; }
+    bool bound() const noexcept { return bound_; }
+    PageBacking backing() const noexcept { return backing_; }
+
+    void* release() noexcept { void* p = data_; data_ = nullptr; bytes_ = 0; return p; }
+    static void Free(void* p, std::size_t bytes) noexcept;
+
+    void swap(MemoryRegion& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(bytes_, other.bytes_);
+        std::swap(node_, other.node_);
+        std::swap(bound_, other.bound_);
+        std::swap(backing_, other.backing_);
+    }
+
+private:
+    void* data_ = nullptr;
+    std::size_t bytes_ = 0;
+    int node_ = -1;
+    bool bound_ = false;
+    PageBacking backing_ = PageBacking::Base;
+};
+
+template<typename T>
+struct RegionDeleter {
+    std::size_t bytes = 0;
+
+    void operator()(T* p) const noexcept {
+        if (!p)
+            return;
+        p->~T();
+        MemoryRegion::Free(p, bytes);
+    }
+};
+
+template<typename T>
+using RegionPtr = std::unique_ptr<T, RegionDeleter<T>>;
+
+// Constructs T in its own region; the constructor runs on the caller's thread but the pages
+// it touches are already placed.
+template<typename T, typename... Args>
+RegionPtr<T> MakeInRegion(RegionOptions options, Args&&... args)
+{
+    static_assert(alignof(T) <= 4096, "regions are page aligned");
+
+    MemoryRegion region = MemoryRegion::Allocate(sizeof(T), options);
+    if (!region.data())
+        return RegionPtr<T>(nullptr, RegionDeleter<T>{});
+
+    const std::size_t bytes = region.size();
+    T* obj = new (region.release()) T(std::forward<Args>(args)...);
+    return RegionPtr<T>(obj, RegionDeleter<T>{bytes});
+}
+
+// MakeInRegion for structures the process cannot run without: if not even ordinary pages
+// can be mapped, says which structure and exits instead of handing back a null pointer.
+template<typename T, typename... Args>
+RegionPtr<T> MakeRequiredInRegion(const char* what, RegionOptions options, Args&&... args)
+{
+    RegionPtr<T> obj = MakeInRegion<T>(options, std::forward<Args>(args)...);
+    if (!obj) {
+        std::fprintf(stderr, "Could not map %zu bytes for %s\n", sizeof(T), what);
+        std::exit(EXIT_FAILURE);
+    }
+    return obj;
+}
+
+// Bump allocator over a chain of regions, for node-based containers (book levels, index
+// nodes) that would otherwise scatter across the heap. Memory is returned only when the
+// arena is destroyed; single-threaded by design.
+class RegionArena {
+public:
+    explicit RegionArena(std::size_t chunkBytes = 16 * kHugePageSize, RegionOptions options = { -1, true }) noexcept
+        : chunkBytes_(chunkBytes), options_(options) {}
+    RegionArena(const RegionArena&) = delete;
+    RegionArena& operator=(const RegionArena&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t align) noexcept;
+
+    std::size_t reservedBytes() const noexcept;
+    PageBacking backing() const noexcept;
+
+private:
+    struct Chunk {
+        MemoryRegion region;
+        std::size_t used = 0;
+    };
+
+    std::vector<Chunk> chunks_;
+    std::size_t chunkBytes_;
+    RegionOptions options_;
+};
+
+// std allocator adaptor over a RegionArena. deallocate() is a no-op; freed nodes are
+// reclaimed with the arena.
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(RegionArena& arena) noexcept : arena_(&arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(std::size_t n) {
+        void* p = arena_->allocate(n * sizeof(T), alignof(T));
+        if (!p) {
+#if defined(__cpp_exceptions)
+            throw std::bad_alloc();
+#else
+            std::abort();
+#endif
+        }
+        return static_cast<T*>(p);
+    }
+    void deallocate(T*, std::size_t) noexcept {}
+
+    RegionArena* arena() const noexcept { return arena_; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena_ == other.arena(); }
+
+private:
+    RegionArena* arena_;
+};
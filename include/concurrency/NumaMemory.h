@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+// NUMA node discovery and binding for long-lived engine structures (rings, order pools, the
+// book). Placement itself goes through MemoryRegion, which binds with mbind(2) before first
+// touch so it does not depend on which thread constructs the object. When NUMA is
+// unavailable (single node, non-Linux, or the syscall is refused) everything here degrades
+// to a no-op.
+
+int NumaNodeCount() noexcept;
+bool NumaAvailable() noexcept;                  // more than one node and mbind works
+int NumaNodeOfCpu(int cpu) noexcept;            // -1 if unknown or cpu < 0
+int CurrentNumaNode() noexcept;                 // node of the cpu the caller is running on
+
+// Sets the calling thread's default policy to prefer `node` for every later allocation
+// (heap growth, container nodes). node < 0 restores the system default policy.
+bool PreferNumaNodeForCurrentThread(int node) noexcept;
+
+// Binds an untouched mapping to `node`. Returns false if NUMA is unavailable or node < 0.
+bool BindMemoryToNumaNode(void* addr, std::size_t bytes, int node) noexcept;
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "OrderType.h"
+#include "ShmIngress.h"
+#include "Side.h"
+#include "Usings.h"
+
+// Binary order-entry protocol between TCP clients and obgateway. Every message starts with a
+// one-byte type followed by fixed fields for that type; there is no padding and no length
+// prefix. Fields are little-endian.
+//
+// client -> gateway
+//   'N' New     side u8, orderType u8, clientOrderId u32, price i32, quantity u32, tag u64   23 bytes
+//   'C' Cancel  clientOrderId u32, tag u64                                                   13 bytes
+//   'M' Modify  side u8, clientOrderId u32, price i32, quantity u32, tag u64                 22 bytes
+// gateway -> client
+//   'K' Ack     status u8, clientOrderId u32, tag u64                                        14 bytes
+//
+// A connection is one engine producer: the gateway gives it a producer id and the engine sees
+// OrderId (producerId << 32) | clientOrderId. `tag` is the client's and is echoed in the ack,
+// which is sent once the request is in the engine's ingress ring (or rejected). A New or
+// Modify needs a quantity above 0 and, unless it is a market New, a price above 0.
+static_assert(std::endian::native == std::endian::little, "order-entry messages are read in host order");
+
+enum class OrderEntryType : std::uint8_t {
+    New = 'N',
+    Cancel = 'C',
+    Modify = 'M',
+    Ack = 'K'
+};
+
+enum class AckStatus : std::uint8_t {
+    Accepted,       // queued for the engine
+    Rejected        // malformed: bad side, order type, quantity or price
+};
+
+inline constexpr std::size_t OrderEntryNewSize = 1 + 1 + 1 + 4 + 4 + 4 + 8;
+inline constexpr std::size_t OrderEntryCancelSize = 1 + 4 + 8;
+inline constexpr std::size_t OrderEntryModifySize = 1 + 1 + 4 + 4 + 4 + 8;
+inline constexpr std::size_t OrderEntryAckSize = 1 + 1 + 4 + 8;
+inline constexpr std::size_t OrderEntryMaxSize = OrderEntryNewSize;
+
+// Size of a client message of `type`, 0 for a type clients may not send.
+inline std::size_t OrderEntrySize(std::uint8_t type) noexcept {
+    switch (static_cast<OrderEntryType>(type)) {
+        case OrderEntryType::New:
+            return OrderEntryNewSize;
+        case OrderEntryType::Cancel:
+            return OrderEntryCancelSize;
+        case OrderEntryType::Modify:
+            return OrderEntryModifySize;
+        case OrderEntryType::Ack:
+            break;
+    }
+    return 0;
+}
+
+namespace order_entry {
+
+template<typename T>
+inline const std::uint8_t* Get(const std::uint8_t* p, T& value) noexcept {
+    std::memcpy(&value, p, sizeof(T));
+    return p + sizeof(T);
+}
+
+template<typename T>
+inline std::uint8_t* Put(std::uint8_t* p, T value) noexcept {
+    std::memcpy(p, &value, sizeof(T));
+    return p + sizeof(T);
+}
+
+}
+
+// One client message decoded straight into the event the engine's ingress ring carries.
+struct OrderEntryRequest {
+    WireEvent event;
+    std::uint32_t clientOrderId = 0;
+    std::uint64_t tag = 0;
+    bool valid = true;      // false: known type, but a field is out of range
+};
+
+// Decodes the client message at `p` (`size` bytes available) for the connection with
+// `producerId`. Returns its size, or 0 if `p` holds only part of one. A byte that starts no
+// known message returns 0 with `bad` set: the stream cannot be resynchronised.
+inline std::size_t DecodeOrderEntry(const std::uint8_t* p, std::size_t size, std::uint32_t producerId,
+                                    OrderEntryRequest& out, bool& bad) noexcept {
+    using order_entry::Get;
+    bad = false;
+    if (size == 0)
+        return 0;
+    const std::size_t length = OrderEntrySize(p[0]);
+    if (length == 0) {
+        bad = true;
+        return 0;
+    }
+    if (size < length)
+        return 0;
+
+    const auto type = static_cast<OrderEntryType>(p[0]);
+    const std::uint8_t* q = p + 1;
+    std::uint8_t side = 0;
+    std::uint8_t orderType = 0;
+    Price price = 0;
+    Quantity quantity = 0;
+
+    if (type != OrderEntryType::Cancel)
+        q = Get(q, side);
+    if (type == OrderEntryType::New)
+        q = Get(q, orderType);
+    q = Get(q, out.clientOrderId);
+    if (type != OrderEntryType::Cancel) {
+        q = Get(q, price);
+        q = Get(q, quantity);
+    }
+    Get(q, out.tag);
+
+    const OrderId id = (static_cast<OrderId>(producerId) << 32) | out.clientOrderId;
+    const bool market = type == OrderEntryType::New && orderType == static_cast<std::uint8_t>(OrderType::Market);
+    out.valid = side <= static_cast<std::uint8_t>(Side::Sell)
+             && orderType <= static_cast<std::uint8_t>(OrderType::Market)
+             && (type == OrderEntryType::Cancel || (quantity > 0 && (market || price > 0)));
+    switch (type) {
+        case OrderEntryType::New:
+            out.event = WireEvent::MakeAdd(static_cast<OrderType>(orderType), id, static_cast<Side>(side), price, quantity);
+            break;
+        case OrderEntryType::Cancel:
+            out.event = WireEvent::MakeCancel(id);
+            break;
+        default:
+            out.event = WireEvent::MakeModify(id, static_cast<Side>(side), price, quantity);
+            break;
+    }
+    return length;
+}
+
+// Client-side encoders; each writes one message at `p` and returns the byte after it.
+inline std::uint8_t* EncodeNewOrder(std::uint8_t* p, OrderType type, std::uint32_t clientOrderId, Side side,
+                                    Price price, Quantity quantity, std::uint64_t tag) noexcept {
+    using order_entry::Put;
+    p = Put(p, static_cast<std::uint8_t>(OrderEntryType::New));
+    p = Put(p, static_cast<std::uint8_t>(side));
+    p = Put(p, static_cast<std::uint8_t>(type));
+    p = Put(p, clientOrderId);
+    p = Put(p, price);
+    p = Put(p, quantity);
+    return Put(p, tag);
+}
+
+inline std::uint8_t* EncodeCancelOrder(std::uint8_t* p, std::uint32_t clientOrderId, std::uint64_t tag) noexcept {
+    using order_entry::Put;
+    p = Put(p, static_cast<std::uint8_t>(OrderEntryType::Cancel));
+    p = Put(p, clientOrderId);
+    return Put(p, tag);
+}
+
+inline std::uint8_t* EncodeModifyOrder(std::uint8_t* p, std::uint32_t clientOrderId, Side side, Price price,
+                                       Quantity quantity, std::uint64_t tag) noexcept {
+    using order_entry::Put;
+    p = Put(p, static_cast<std::uint8_t>(OrderEntryType::Modify));
+    p = Put(p, static_cast<std::uint8_t>(side));
+    p = Put(p, clientOrderId);
+    p = Put(p, price);
+    p = Put(p, quantity);
+    return Put(p, tag);
+}
+
+inline std::uint8_t* EncodeAck(std::uint8_t* p, AckStatus status, std::uint32_t clientOrderId, std::uint64_t tag) noexcept {
+    using order_entry::Put;
+    p = Put(p, static_cast<std::uint8_t>(OrderEntryType::Ack));
+    p = Put(p, static_cast<std::uint8_t>(status));
+    p = Put(p, clientOrderId);
+    return Put(p, tag);
+}
+
+// Decodes the ack at `p`; returns its size, or 0 if `p` holds only part of one.
+inline std::size_t DecodeAck(const std::uint8_t* p, std::size_t size, AckStatus& status,
+                             std::uint32_t& clientOrderId, std::uint64_t& tag) noexcept {
+    using order_entry::Get;
+    if (size < OrderEntryAckSize)
+        return 0;
+    std::uint8_t s = 0;
+    const std::uint8_t* q = Get(p + 1, s);
+    q = Get(q, clientOrderId);
+    Get(q, tag);
+    status = static_cast<AckStatus>(s);
+    return OrderEntryAckSize;
+}
@@ -14,14 +14,23 @@
 #include "OrderModify.h"
 #include "OrderRingBuffer.h"
 #include "Backpressure.h"
+#include "CancelLane.h"
+#include "ProducerChannel.h"
+#include "MemoryRegion.h"
+#include "WaitStrategy.h"
+#include "Workload.h"
 
 class Producer {
 public:
+    // Cancels go to `channel.cancelLane` when the channel has one, else through the ring.
+    // `workload` decides the op mix, prices, cancel targets and arrival pacing.
     Producer(
-        OrderRingBuffer& queue,
-        Backpressure& backpressure,
+        const ProducerChannel& channel,
         std::atomic<bool>& running,
-        uint32_t producer_id
+        uint32_t producer_id,
+        int cpu = -1,
+        WaitStrategy wait = {},
+        const WorkloadConfig& workload = MakeWorkload(WorkloadPreset::Uniform)
     );
 
     void run();
@@ -32,38 +41,49 @@ public:
 
 private:
     void produce_event();
-    uint32_t next_u32() noexcept;
+    void enqueue(EngineEvent& ev);
+    void enqueue_cancel(OrderId id);
+    bool sample_latency() noexcept;
+    void wait_for_arrival(std::uint64_t deadlineNs);
 
     struct OrderPool {
         static constexpr std::size_t FreelistSize = 1u << 16;
         static constexpr std::size_t PoolSize = FreelistSize - 1;
         using Storage = std::aligned_storage_t<sizeof(Order), alignof(Order)>;
 
-        OrderPool();
+        OrderPool(int node, WaitStrategy wait);
         ~OrderPool();
 
         Order* acquire() noexcept;
         void release(Order* p) noexcept;
 
-        std::unique_ptr<Storage[]> storage_;
+        MemoryRegion region_;
+        std::unique_ptr<Storage[]> heap_;   // only if the region could not be mapped
+        Storage* storage_;
+        WaitStrategy wait_;
         SPSCQueue<Order*, FreelistSize> freelist_;
     };
 
 private:
     OrderRingBuffer& queue_;
     Backpressure& backpressure_;
+    CancelLane* cancelLane_;
     std::atomic<bool>& running_;
     uint32_t producer_id_;
+    int cpu_;
+    WaitStrategy wait_;
 
-    uint32_t rng_state_;
-    uint64_t order_seq_ = 0;
+    WorkloadGenerator workload_;
 
-    std::shared_ptr<OrderPool> pool_;
+    // A paced producer that fell further behind than this (full ring, no credits) drops
+    // the missed arrivals instead of sending them back to back.
+    static constexpr std::uint64_t MaxPacingLagNs = 10'000'000;
+
+    // One event in this many carries an enqueue timestamp for the engine's per-queue latency.
+    static constexpr uint32_t LatencySampleEvery = 64;
+    uint32_t sampleCounter_ = 0;
 
-    static constexpr std::size_t IdRingSize = 1u << 12;
-    std::array<OrderId, IdRingSize> id_ring_{};
-    std::size_t id_ring_pos_ = 0;
-    std::size_t id_ring_count_ = 0;
+    std::shared_ptr<OrderPool> pool_;
 
     alignas(64) std::atomic<std::uint64_t> producedEvents_{0};
     alignas(64) std::atomic<std::uint64_t> poolWaitSpins_{0};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Backpressure.h"
+#include "CancelLane.h"
+#include "OrderRingBuffer.h"
+
+// Everything the engine needs to drain one producer: its ring, its credit window, its
+// optional cancel lane and its share of the engine. A channel with weight 2 is granted twice
+// the burst of a weight-1 channel each round while both have work.
+//
+// `producerId` is the high 32 bits of the OrderIds the producer issues (ids increase per
+// producer); the engine uses it to tell a lane cancel that overtook its own add from one
+// for an order that is already gone.
+struct ProducerChannel {
+    OrderRingBuffer* queue = nullptr;
+    Backpressure* backpressure = nullptr;
+    std::uint32_t weight = 1;
+    CancelLane* cancelLane = nullptr;
+    std::uint32_t producerId = 0;
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Backpressure.h"
+#include "EngineEvent.h"
+#include "ExecutionReport.h"
+#include "MemoryRegion.h"
+#include "OrderRingBuffer.h"
+#include "ProducerChannel.h"
+#include "WaitStrategy.h"
+
+// Pre-trade limits of one account. Notional is price * quantity in ticks; position is the
+// net filled quantity, and the limit applies to what it would be if every open order filled.
+struct RiskLimits {
+    std::int64_t maxOrderQuantity = std::numeric_limits<std::int64_t>::max();
+    std::int64_t maxOpenNotional = std::numeric_limits<std::int64_t>::max();
+    std::int64_t maxPosition = std::numeric_limits<std::int64_t>::max();
+};
+
+// Limits by account, readable by the risk thread while any other thread changes them. Each
+// limit is a separate relaxed atomic: an update is seen field by field, never torn within one.
+class RiskLimitTable {
+public:
+    static constexpr std::size_t MaxAccounts = 64;
+
+    void set(std::uint32_t account, const RiskLimits& limits) noexcept;
+    void set_all(const RiskLimits& limits) noexcept;
+    RiskLimits get(std::uint32_t account) const noexcept;
+
+private:
+    struct alignas(64) Entry {
+        std::atomic<std::int64_t> maxOrderQuantity{std::numeric_limits<std::int64_t>::max()};
+        std::atomic<std::int64_t> maxOpenNotional{std::numeric_limits<std::int64_t>::max()};
+        std::atomic<std::int64_t> maxPosition{std::numeric_limits<std::int64_t>::max()};
+    };
+
+    std::array<Entry, MaxAccounts> entries_;
+};
+
+// Risk-thread exposure of one account, published for monitors.
+struct alignas(64) RiskAccountStats {
+    std::atomic<std::int64_t> openNotional{0};
+    std::atomic<std::int64_t> openBuyQuantity{0};
+    std::atomic<std::int64_t> openSellQuantity{0};
+    std::atomic<std::int64_t> position{0};
+    std::atomic<std::uint64_t> accepted{0};
+    std::atomic<std::uint64_t> rejected{0};
+};
+
+// Pipeline stage between the producers' rings and the MatchingEngine. Each producer channel
+// gets an output channel of its own (same producer id, weight and cancel lane), so the
+// engine's fairness, shutdown and lane handling are unchanged; the engine is built with
+// outputs() instead of the producers' channels.
+//
+// An account is a producer: its id is the producer id, the high 32 bits of its OrderIds.
+// Adds and modifies that would break the account's limits are dropped here; cancels and
+// lane cancels always pass, since they only reduce exposure. Exposure is reserved when an
+// order is forwarded and released from the engine's ExecutionReports, which arrive
+// asynchronously: it is exact once the engine has caught up, except that a fill of an
+// order's earlier incarnation still in flight when it is modified is charged to the new one.
+class RiskStage {
+public:
+    RiskStage(std::vector<ProducerChannel>& inputs, const RiskLimitTable& limits, int cpu = -1,
+              WaitStrategy wait = {}, std::uint32_t burstSize = 64);
+    RiskStage(const RiskStage&) = delete;
+    RiskStage& operator=(const RiskStage&) = delete;
+
+    // Channels for the engine, and the ring it reports into (MatchingEngine::EnableExecutionReports).
+    std::vector<ProducerChannel>& outputs() { return outputs_; }
+    ExecutionReportRing& reports() { return *reports_; }
+
+    // Start after the engine (its constructor attaches to outputs()); stop after stopping
+    // the engine, which may be waiting for room in reports().
+    void start();
+    void stop();
+
+    const RiskAccountStats& account(std::uint32_t id) const { return stats_[id]; }
+    std::uint64_t accepted() const;
+    std::uint64_t rejected() const;
+
+private:
+    struct LiveOrder {
+        Side side;
+        Price price;
+        Quantity remaining;
+    };
+
+    // Risk-thread view of an account; stats_ mirrors it.
+    struct Account {
+        std::int64_t openNotional = 0;
+        std::int64_t openBuyQuantity = 0;
+        std::int64_t openSellQuantity = 0;
+        std::int64_t position = 0;
+        std::uint64_t accepted = 0;
+        std::uint64_t rejected = 0;
+    };
+
+    void run();
+    bool has_work() const;
+    std::size_t drain(std::size_t channel);
+    bool check(EngineEvent& event, std::uint32_t account);
+    bool admit(std::uint32_t account, OrderId id, Side side, Price price, Quantity quantity);
+    void forward(std::size_t channel, EngineEvent& event);
+    std::size_t drain_reports();
+    void apply_report(const ExecutionReport& report);
+    void release(LiveOrder& order, std::uint32_t account, Quantity quantity);
+    void publish(std::uint32_t account);
+
+    std::vector<ProducerChannel> inputs_;
+    std::vector<ProducerChannel> outputs_;
+    std::vector<RegionPtr<OrderRingBuffer>> rings_;
+    std::vector<RegionPtr<Backpressure>> credits_;
+    RegionPtr<ExecutionReportRing> reports_;
+
+    const RiskLimitTable& limits_;
+    int cpu_;
+    WaitStrategy wait_;
+    std::uint32_t burstSize_;
+
+    std::array<Account, RiskLimitTable::MaxAccounts> accounts_{};
+    std::array<RiskAccountStats, RiskLimitTable::MaxAccounts> stats_;
+    std::unordered_map<OrderId, LiveOrder> live_;
+
+    // Producers wake the stage here when it parks (SpinPark).
+    ParkingSpot wake_;
+    std::atomic<bool> running_ = false;
+    std::thread thread_;
+};
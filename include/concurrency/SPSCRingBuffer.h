@@ -7,6 +7,7 @@
 
 #if defined(__APPLE__) || defined(__unix__)
 #include <sys/mman.h>
+#include <unistd.h>
 #endif
 
 template<typename T, std::size_t Size>
@@ -23,7 +24,12 @@ public:
         volatile std::uint8_t* p =
             reinterpret_cast<volatile std::uint8_t*>(buffer_);
 
+#if defined(__APPLE__) || defined(__unix__)
+        const long ps = sysconf(_SC_PAGESIZE);
+        const std::size_t kPage = ps > 0 ? static_cast<std::size_t>(ps) : 4096;
+#else
         constexpr std::size_t kPage = 4096;
+#endif
         const std::size_t bytes = sizeof(buffer_);
         for (std::size_t i = 0; i < bytes; i += kPage) {
             p[i] = p[i];
@@ -43,9 +49,10 @@ public:
         const std::size_t next_tail =
             (current_tail + 1) & (Size - 1);
 
-        if (next_tail ==
-            head_.load(std::memory_order_acquire)) {
-            return false;
+        if (next_tail == headCache_) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (next_tail == headCache_)
+                return false;
         }
 
         buffer_[current_tail] = item;
@@ -61,9 +68,10 @@ public:
         const std::size_t next_tail =
             (current_tail + 1) & (Size - 1);
 
-        if (next_tail ==
-            head_.load(std::memory_order_acquire)) {
-            return false;
+        if (next_tail == headCache_) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (next_tail == headCache_)
+                return false;
         }
 
         buffer_[current_tail] = std::move(item);
@@ -76,9 +84,10 @@ public:
         const std::size_t current_head =
             head_.load(std::memory_order_relaxed);
 
-        if (current_head ==
-            tail_.load(std::memory_order_acquire)) {
-            return false;
+        if (current_head == tailCache_) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (current_head == tailCache_)
+                return false;
         }
 
         item = std::move(buffer_[current_head]);
@@ -89,6 +98,14 @@ public:
         return true;
     }
 
+    // Consumer only: items ready to pop. Refreshes the consumer's cached tail, so the pops
+    // that follow do not touch the producer's line until they catch up with it.
+    inline std::size_t available() noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        tailCache_ = tail_.load(std::memory_order_acquire);
+        return (tailCache_ - head) & (Size - 1);
+    }
+
     inline bool empty() const noexcept {
         return head_.load(std::memory_order_acquire) ==
                tail_.load(std::memory_order_acquire);
@@ -107,8 +124,12 @@ public:
     }
 
 private:
+    // Each side keeps a private copy of the other side's index next to its own and only
+    // reloads it when the copy says the queue is full (producer) or empty (consumer).
     alignas(64) std::atomic<std::size_t> head_{0};
+    std::size_t tailCache_ = 0;        // consumer-private
     alignas(64) std::atomic<std::size_t> tail_{0};
+    std::size_t headCache_ = 0;        // producer-private
 
     alignas(64) T buffer_[Size];
 };
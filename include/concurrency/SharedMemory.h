@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// One POSIX shared memory mapping (/dev/shm/<name>), or private anonymous memory when no name
+// is given. The creator unlinks the name when its mapping is destroyed; mappings other
+// processes already hold stay valid, nobody new can open it.
+//
+// Only position-independent data may be placed in a named mapping: every process maps it at
+// a different address, so no pointers, shared_ptr, std::variant of those, or vtables.
+class SharedMemory {
+public:
+    SharedMemory() = default;
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+    SharedMemory(SharedMemory&& other) noexcept { swap(other); }
+    SharedMemory& operator=(SharedMemory&& other) noexcept { SharedMemory(std::move(other)).swap(*this); return *this; }
+    ~SharedMemory();
+
+    // Zero-filled, read-write. A stale segment of the same name (a crashed run) is replaced.
+    static SharedMemory Create(std::string_view name, std::size_t bytes, std::string* error = nullptr) noexcept;
+    static SharedMemory Anonymous(std::size_t bytes) noexcept;
+    // Maps all of an existing segment; `error` says why when the result is invalid.
+    static SharedMemory Open(std::string_view name, bool writable, std::string* error = nullptr) noexcept;
+
+    bool valid() const noexcept { return data_ != nullptr; }
+    void* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return bytes_; }
+    const std::string& name() const noexcept { return name_; }   // empty when anonymous
+    bool owner() const noexcept { return owner_; }
+
+    void swap(SharedMemory& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(bytes_, other.bytes_);
+        std::swap(name_, other.name_);
+        std::swap(owner_, other.owner_);
+    }
+
+private:
+    void* data_ = nullptr;
+    std::size_t bytes_ = 0;
+    std::string name_;          // without the leading '/'
+    bool owner_ = false;
+};
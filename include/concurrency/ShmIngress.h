@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "EngineEvent.h"
+#include "OrderType.h"
+#include "SPSCRingBuffer.h"
+#include "SharedMemory.h"
+#include "Side.h"
+#include "Usings.h"
+
+// Ingress from other processes. A gateway process creates one ring segment
+// (/dev/shm/<prefix>.in.<producerId>) and pushes WireEvents into it; the engine finds the
+// segment by name, maps it and drains it next to its in-process channels.
+//
+// Everything in the segment is position independent: WireEvent is a plain value (no
+// shared_ptr, no variant), and SPSCQueue's indices are offsets, so the ring works at any
+// mapping address. The ring itself is the only flow control: its capacity bounds what a
+// gateway can have in flight, and a full ring is the gateway's backpressure signal.
+
+// One order-entry event as it crosses the process boundary. Trivially copyable, 32 bytes.
+struct WireEvent {
+    OrderId orderId = 0;
+    // ob::time::steady_now_ns() at enqueue for sampled events, 0 otherwise. The cycle counter
+    // is calibrated per process, so only the system-wide steady clock compares across them.
+    std::uint64_t enqueueNs = 0;
+    Price price = 0;
+    Quantity quantity = 0;
+    EngineEventType type = EngineEventType::Add;
+    std::uint8_t orderType = 0;     // OrderType, Add only
+    std::uint8_t side = 0;          // Side, Add and Modify
+
+    static WireEvent MakeAdd(OrderType type, OrderId id, Side side, Price price, Quantity quantity) {
+        WireEvent ev;
+        ev.type = EngineEventType::Add;
+        ev.orderType = static_cast<std::uint8_t>(type);
+        ev.orderId = id;
+        ev.side = static_cast<std::uint8_t>(side);
+        ev.price = price;
+        ev.quantity = quantity;
+        return ev;
+    }
+
+    static WireEvent MakeCancel(OrderId id) {
+        WireEvent ev;
+        ev.type = EngineEventType::Cancel;
+        ev.orderId = id;
+        return ev;
+    }
+
+    static WireEvent MakeModify(OrderId id, Side side, Price price, Quantity quantity) {
+        WireEvent ev;
+        ev.type = EngineEventType::Modify;
+        ev.orderId = id;
+        ev.side = static_cast<std::uint8_t>(side);
+        ev.price = price;
+        ev.quantity = quantity;
+        return ev;
+    }
+
+    OrderType order_type() const { return static_cast<OrderType>(orderType); }
+    Side order_side() const { return static_cast<Side>(side); }
+};
+
+static_assert(std::is_trivially_copyable_v<WireEvent>, "WireEvent must be a plain value");
+static_assert(sizeof(WireEvent) == 32, "WireEvent layout is part of the ingress version");
+
+using WireRing = SPSCQueue<WireEvent, 16384>;
+
+inline constexpr std::uint64_t IngressMagic = 0x3153'5247'4E49'424Full;    // "OBINGRS1"
+inline constexpr std::uint32_t IngressVersion = 1;
+
+enum class IngressState : std::uint32_t {
+    Open,
+    Closed      // the gateway sends nothing more; the engine detaches once the ring is empty
+};
+
+struct alignas(64) IngressHeader {
+    std::atomic<std::uint64_t> magic{0};    // stored (release) once the ring is constructed
+    std::uint32_t version = IngressVersion;
+    std::uint32_t producerId = 0;           // high 32 bits of the gateway's OrderIds
+    std::uint32_t weight = 1;               // drain share, as ProducerChannel::weight
+    std::int32_t pid = 0;
+    std::atomic<std::uint32_t> state{static_cast<std::uint32_t>(IngressState::Open)};
+};
+
+struct IngressSegment {
+    IngressHeader header;
+    WireRing ring;
+};
+
+// "<prefix>.in.<producerId>"
+std::string IngressSegmentName(std::string_view prefix, std::uint32_t producerId);
+
+// A segment found in /dev/shm. The inode tells a gateway's new segment from an earlier one
+// of the same name.
+struct IngressSegmentId {
+    std::string name;
+    std::uint64_t inode = 0;
+};
+
+// One mapped ingress segment: the gateway's (Create, owns and unlinks the name) or the
+// engine's (Attach).
+class IngressRing {
+public:
+    static IngressRing Create(std::string_view name, std::uint32_t producerId, std::uint32_t weight = 1,
+                              std::string* error = nullptr) noexcept;
+    // Read-write mapping of a gateway's segment; invalid, with `error` set, if it is missing,
+    // not yet constructed, or of another version or size.
+    static IngressRing Attach(std::string_view name, std::string* error = nullptr) noexcept;
+    // The ingress segments under /dev/shm that belong to `prefix`.
+    static std::vector<IngressSegmentId> Discover(std::string_view prefix);
+
+    bool valid() const noexcept { return memory_.valid(); }
+    const std::string& name() const noexcept { return memory_.name(); }
+    IngressHeader& header() const noexcept { return segment().header; }
+    WireRing& ring() const noexcept { return segment().ring; }
+
+    // Gateway side: no more events will be pushed.
+    void close() const noexcept {
+        header().state.store(static_cast<std::uint32_t>(IngressState::Closed), std::memory_order_release);
+    }
+    bool closed() const noexcept {
+        return header().state.load(std::memory_order_acquire) == static_cast<std::uint32_t>(IngressState::Closed);
+    }
+    // False once the gateway process has exited, whether or not it closed the ring.
+    bool writer_alive() const noexcept;
+
+private:
+    IngressSegment& segment() const noexcept { return *static_cast<IngressSegment*>(memory_.data()); }
+
+    SharedMemory memory_;
+};
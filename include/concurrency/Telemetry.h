@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "LatencyHistogram.h"
+#include "SharedMemory.h"
+#include "Tracing.h"
+
+// Engine telemetry block: the engine's counters, queue depths, backpressure stats and latency
+// histograms in one versioned layout that can live in a POSIX shared memory segment
+// (/dev/shm/<name>), so an external reader (obstat) can poll it at any rate without going
+// through the process.
+//
+// Every field has exactly one writer, which updates it with a relaxed load + store; readers
+// use relaxed loads. Counters only grow, so rates from two snapshots are exact; fields from
+// one snapshot may be a publish apart. The engine's working state (book, rings, lane
+// bookkeeping) is never in the segment, so a reader only shares the lines written to publish.
+//
+// Layout, every part 64-byte aligned:
+//   TelemetryHeader | EngineTelemetry | StageLatency | ChannelTelemetry[channelCount]
+// StageLatency stays empty unless the writer was built with OB_TRACING (TelemetryFlagTracing).
+// Any change to these structs must bump TelemetryVersion.
+
+inline constexpr std::uint64_t TelemetryMagic = 0x314D'454C'4554'424Full;   // "OBTELEM1"
+inline constexpr std::uint32_t TelemetryVersion = 4;
+inline constexpr std::uint32_t TelemetryFlagTracing = 1u << 0;
+
+enum class TelemetryState : std::uint32_t {
+    Starting,
+    Running,
+    Stopped
+};
+
+const char* ToString(TelemetryState state);
+
+// Single-writer counter update: no locked instruction.
+inline void TelemetryAdd(std::atomic<std::uint64_t>& counter, std::uint64_t n) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+inline void TelemetrySet(std::atomic<std::uint64_t>& field, std::uint64_t value) noexcept {
+    field.store(value, std::memory_order_relaxed);
+}
+
+struct alignas(64) TelemetryHeader {
+    std::atomic<std::uint64_t> magic{0};      // stored (release) once the layout is built
+    std::uint32_t version = TelemetryVersion;
+    std::uint32_t flags = 0;
+    std::uint64_t totalBytes = 0;
+    std::uint32_t channelCount = 0;
+    std::int32_t pid = 0;
+    std::uint64_t startNs = 0;                // steady clock; publishNs - startNs is uptime
+
+    std::atomic<std::uint32_t> state{static_cast<std::uint32_t>(TelemetryState::Starting)};
+    std::atomic<std::uint64_t> publishNs{0};  // steady clock of the engine's last publish
+};
+
+// Engine thread. idleLoops and busyRounds move every round; the rest at each publish or burst.
+struct alignas(64) EngineTelemetry {
+    std::atomic<std::uint64_t> events{0};         // every event applied, both paths
+    std::atomic<std::uint64_t> idleLoops{0};
+    std::atomic<std::uint64_t> busyRounds{0};
+    std::atomic<std::uint64_t> parks{0};
+    std::atomic<std::uint64_t> bookOps{0};        // Orderbook::TotalOps
+    std::atomic<std::uint64_t> orders{0};         // resting orders
+    std::atomic<std::uint64_t> publishes{0};
+    std::atomic<std::uint64_t> ingressRings{0};   // shared-memory rings attached now
+    std::atomic<std::uint64_t> ingressEvents{0};  // events taken from them, all time
+    std::atomic<std::uint64_t> levelChanges{0};   // L2 feed (LevelDeltaFeed), when enabled
+    std::atomic<std::uint64_t> levelDeltas{0};
+    std::atomic<std::uint64_t> levelDeltasDropped{0};
+    std::atomic<std::uint64_t> l3Messages{0};     // L3 feed (L3Feed), when enabled
+    std::atomic<std::uint64_t> l3Bytes{0};
+    std::atomic<std::uint64_t> l3Dropped{0};
+    // steady clock enqueue -> dequeue of sampled events from ingress rings.
+    LatencyHistogram ingressLatency;
+};
+
+struct alignas(64) ChannelTelemetry {
+    // Engine thread, once per drain visit; depth once per publish.
+    std::uint32_t producerId = 0;
+    std::uint32_t weight = 1;
+    std::atomic<std::uint64_t> events{0};
+    std::atomic<std::uint64_t> visits{0};         // rounds in which the channel had work
+    std::atomic<std::uint64_t> adds{0};
+    std::atomic<std::uint64_t> cancels{0};        // ring and lane
+    std::atomic<std::uint64_t> modifies{0};
+    std::atomic<std::uint64_t> laneEvents{0};     // cancels taken from the priority lane
+    std::atomic<std::uint64_t> overtakenAdds{0};  // adds dropped because their cancel arrived first
+    std::atomic<std::uint64_t> depth{0};          // ring depth
+
+    // Producer side, copied in periodically by the process's publisher thread so that
+    // readers never touch the producer's or the credit window's own lines.
+    alignas(64) std::atomic<std::uint64_t> produced{0};
+    std::atomic<std::uint64_t> enqueueRetries{0};
+    std::atomic<std::uint64_t> poolWaitSpins{0};
+    std::atomic<std::uint64_t> creditLimit{0};
+    std::atomic<std::uint64_t> creditsInFlight{0};
+    std::atomic<std::uint64_t> creditWaitCalls{0};
+    std::atomic<std::uint64_t> creditWaitSpins{0};
+
+    // Engine thread. Queue latency is enqueue -> dequeue of sampled ring events, cancel
+    // latency enqueue -> cancel applied for sampled cancels on either path.
+    alignas(64) LatencyHistogram queueLatency;
+    LatencyHistogram cancelLatency;
+};
+
+// Owns one mapped telemetry block. The creating process unlinks its segment on destruction;
+// a reader's mapping stays valid after that, it just sees the final state.
+class TelemetryRegion {
+public:
+    static std::size_t BytesFor(std::size_t channelCount) noexcept;
+
+    // Builds a zeroed block for `channelCount` channels. With a name it is /dev/shm/<name>,
+    // replacing any stale segment of that name; with an empty name, or if the segment
+    // cannot be created, it is private memory and shared() is false.
+    static TelemetryRegion Create(std::string_view name, std::size_t channelCount) noexcept;
+
+    // Maps an existing segment read-only. Invalid, with `error` set, if it is missing, still
+    // being built, or has a different magic, version or size.
+    static TelemetryRegion Open(std::string_view name, std::string* error = nullptr) noexcept;
+
+    bool valid() const noexcept { return memory_.valid(); }
+    bool shared() const noexcept { return !memory_.name().empty(); }
+    const std::string& name() const noexcept { return memory_.name(); }
+
+    TelemetryHeader& header() const noexcept { return *static_cast<TelemetryHeader*>(memory_.data()); }
+    EngineTelemetry& engine() const noexcept;
+    StageLatency& stages() const noexcept;
+    ChannelTelemetry& channel(std::size_t index) const noexcept;
+    std::size_t channel_count() const noexcept { return valid() ? header().channelCount : 0; }
+
+    void set_state(TelemetryState state) const noexcept {
+        header().state.store(static_cast<std::uint32_t>(state), std::memory_order_relaxed);
+    }
+
+private:
+    SharedMemory memory_;
+};
@@ -6,8 +6,13 @@
 #include <mach/mach.h>
 #include <mach/thread_policy.h>
 #include <pthread.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
 #endif
 
+// On Linux coreIndex is the logical CPU number as listed in /sys/devices/system/cpu.
+// On macOS it is only an affinity tag: threads with the same tag are kept together.
 inline bool PinCurrentThreadToCore(std::uint32_t coreIndex) noexcept
 {
 #if defined(__APPLE__)
@@ -23,8 +28,25 @@ inline bool PinCurrentThreadToCore(std::uint32_t coreIndex) noexcept
         THREAD_AFFINITY_POLICY_COUNT);
 
     return rc == KERN_SUCCESS;
+#elif defined(__linux__)
+    if (coreIndex >= CPU_SETSIZE)
+        return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(coreIndex, &set);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
 #else
     (void)coreIndex;
     return false;
 #endif
 }
+
+// Negative cpu means "leave the thread where the scheduler puts it".
+inline bool PinCurrentThreadToCpu(int cpu) noexcept
+{
+    if (cpu < 0)
+        return false;
+    return PinCurrentThreadToCore(static_cast<std::uint32_t>(cpu));
+}
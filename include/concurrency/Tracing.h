@@ -0,0 +1,44 @@
+#pragma once
+
+// Per-stage pipeline tracing. Off unless the build defines OB_TRACING=1 (CMake
+// -DORDERBOOK_TRACING=ON); when off, EngineEvent carries no extra fields and none of the
+// stamping or recording code is compiled, so the cost is zero.
+#ifndef OB_TRACING
+#define OB_TRACING 0
+#endif
+
+#include "LatencyHistogram.h"
+
+#if OB_TRACING
+#include <cstdint>
+
+#include "TimeUtils.h"
+
+// TscClock ticks, stamped by the producer. The engine stamps dequeue, dispatch into the book
+// and match completion itself; those never need to travel with the event.
+struct EventTrace {
+    std::uint64_t created = 0;     // producer started building the event
+    std::uint64_t enqueued = 0;    // last push attempt into the ring
+};
+
+inline std::uint64_t TraceStamp() noexcept {
+    return ob::time::TscClock::instance().now();
+}
+
+// Stamps come from different cores; a small negative skew is reported as 0.
+inline std::uint64_t TraceElapsedNs(std::uint64_t from, std::uint64_t to) noexcept {
+    return to > from ? ob::time::TscClock::instance().to_ns(to - from) : 0;
+}
+
+#endif
+
+// Written by the engine thread only; readers snapshot by copy. Defined in every build so the
+// telemetry layout does not depend on OB_TRACING; it is simply never recorded into when off.
+struct StageLatency {
+    LatencyHistogram produce;      // created -> enqueued: order build, credit and ring-full waits
+    LatencyHistogram queue;        // enqueued -> dequeued: time spent in OrderRingBuffer
+    LatencyHistogram dispatch;     // dequeued -> Orderbook call: credits, lane bookkeeping in the burst loop
+    LatencyHistogram match;        // Orderbook call -> returned
+    LatencyHistogram total;        // created -> matched
+};
+
@@ -0,0 +1,135 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// How a thread spends a poll that found nothing to do.
+//   BusySpin  - never leaves the core; `pause` between polls. Lowest wake latency, one full
+//               core per waiter.
+//   SpinYield - `spinLimit` pauses, then sched_yield. The previous hardcoded behaviour.
+//   SpinPark  - `spinLimit` pauses, then sleeps on a ParkingSpot (futex on Linux) until the
+//               other side calls notify(). Near-zero CPU when idle, wake-up costs a syscall.
+enum class WaitStrategyKind : std::uint8_t {
+    BusySpin,
+    SpinYield,
+    SpinPark
+};
+
+const char* ToString(WaitStrategyKind kind);
+bool ParseWaitStrategyKind(std::string_view name, WaitStrategyKind& out);   // spin|yield|park
+
+inline void CpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#else
+    asm volatile("" ::: "memory");
+#endif
+}
+
+// Eventcount a single consumer of a condition can sleep on. The waiter registers itself,
+// re-checks its condition and only then sleeps on the epoch; the notifier publishes its data,
+// fences and only enters the kernel when someone is registered. Either the waiter sees the
+// data or the notifier sees the waiter, so no wake-up is lost and notify() is a fence plus a
+// load when nobody sleeps.
+class alignas(64) ParkingSpot {
+public:
+    ParkingSpot() = default;
+    ParkingSpot(const ParkingSpot&) = delete;
+    ParkingSpot& operator=(const ParkingSpot&) = delete;
+
+    template<typename Ready>
+    void park(Ready&& ready) {
+        const std::uint32_t epoch = epoch_.load(std::memory_order_acquire);
+        sleepers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready())
+            sleep(epoch);
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) != 0)
+            wake();
+    }
+
+    std::uint64_t parks() const { return parks_.load(std::memory_order_relaxed); }
+    std::uint64_t wakes() const { return wakes_.load(std::memory_order_relaxed); }
+
+private:
+    void sleep(std::uint32_t epoch) noexcept;
+    void wake() noexcept;
+
+    std::atomic<std::uint32_t> epoch_{0};
+    std::atomic<std::uint32_t> sleepers_{0};
+    std::atomic<std::uint64_t> parks_{0};
+    std::atomic<std::uint64_t> wakes_{0};
+};
+
+// Chosen once at construction and copied into the engine, each producer and each credit
+// window, so every idle loop in a run behaves the same way.
+class WaitStrategy {
+public:
+    constexpr WaitStrategy(WaitStrategyKind kind = WaitStrategyKind::SpinYield, std::uint32_t spinLimit = 128)
+        : kind_(kind), spinLimit_(spinLimit)
+    {}
+
+    WaitStrategyKind kind() const { return kind_; }
+    std::uint32_t spin_limit() const { return spinLimit_; }
+    bool parks() const { return kind_ == WaitStrategyKind::SpinPark; }
+
+    // One unsuccessful poll. `spins` belongs to the caller and is reset to 0 after progress.
+    // `spot`/`ready` are only used by SpinPark; without a spot it degrades to yielding.
+    template<typename Ready>
+    void idle(std::uint32_t& spins, ParkingSpot* spot, Ready&& ready) const {
+        switch (kind_) {
+        case WaitStrategyKind::BusySpin:
+            CpuRelax();
+            return;
+
+        case WaitStrategyKind::SpinYield:
+            if (spins < spinLimit_) {
+                ++spins;
+                CpuRelax();
+                return;
+            }
+            spins = 0;
+            std::this_thread::yield();
+            return;
+
+        case WaitStrategyKind::SpinPark:
+            if (spins < spinLimit_) {
+                ++spins;
+                CpuRelax();
+                return;
+            }
+            // spins stays at the limit: until the caller makes progress, every poll parks.
+            if (spot)
+                spot->park(ready);
+            else
+                std::this_thread::yield();
+            return;
+        }
+    }
+
+    void idle(std::uint32_t& spins) const {
+        idle(spins, nullptr, [] { return true; });
+    }
+
+    // Publishing side: call after making the waiter's condition true.
+    void notify(ParkingSpot& spot) const {
+        if (parks())
+            spot.notify();
+    }
+
+private:
+    WaitStrategyKind kind_;
+    std::uint32_t spinLimit_;
+};
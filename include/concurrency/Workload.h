@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "OrderOp.h"
+#include "OrderType.h"
+#include "Side.h"
+#include "Usings.h"
+
+enum class ArrivalPacing : std::uint8_t {
+    Unpaced,    // as fast as the pipeline accepts (closed loop)
+    Poisson,    // exponential inter-arrival times at ratePerSec
+    Bursty      // on/off: bursts at burstFactor * ratePerSec, silent gaps, same average
+};
+
+enum class WorkloadPreset : std::uint8_t {
+    Uniform,        // the original generator: 1/3 each op, prices 90..110, random recent ids
+    MarketMaker,    // mostly passive quotes near the touch, heavy cancel/replace
+    Taker           // fewer quotes, a large share of aggressive orders walking the touch
+};
+
+const char* ToString(WorkloadPreset preset);
+const char* ToString(ArrivalPacing pacing);
+bool ParseWorkloadPreset(std::string_view name, WorkloadPreset& out);
+bool ParseArrivalPacing(std::string_view name, ArrivalPacing& out);
+
+// What one producer sends. Weights need not sum to anything; they are normalised.
+//
+// Passive prices sit `halfSpreadTicks` plus a geometric number of ticks (mean
+// `passiveDepthTicks`) away from a mid that random-walks one tick with probability
+// `midMoveProbability` per event. Aggressive orders are FillAndKill priced up to
+// `aggressiveDepthTicks` through the opposite touch, so they trade and never rest.
+struct WorkloadConfig {
+    double addWeight = 1.0;
+    double cancelWeight = 1.0;
+    double modifyWeight = 1.0;
+    double aggressiveFraction = 0.0;      // share of adds that cross the spread
+
+    Price startMid = 100;
+    Price minPrice = 1;
+    Price halfSpreadTicks = 1;
+    double passiveDepthTicks = 3.0;
+    Price aggressiveDepthTicks = 2;
+    double midMoveProbability = 0.0;
+
+    Quantity minQuantity = 1;
+    Quantity maxQuantity = 100;
+
+    // Cancels and modifies pick from orders this producer has resting (as far as it knows:
+    // fills by other flow are not reported back). Off: any recently issued id, live or not.
+    bool targetLiveOrders = true;
+
+    ArrivalPacing pacing = ArrivalPacing::Unpaced;
+    double ratePerSec = 1'000'000.0;
+    double burstFactor = 10.0;            // Bursty: rate inside a burst / average rate
+    double meanBurstEvents = 256.0;       // Bursty: mean events per burst
+
+    // Uniform reproduces the original random stream (uniform mix, uniform prices 90..110).
+    bool legacyPrices = false;
+};
+
+WorkloadConfig MakeWorkload(WorkloadPreset preset);
+
+// One operation to send. `id` is fresh for adds; for cancels and modifies it names the target.
+struct WorkloadOp {
+    OrderOp op = OrderOp::Add;
+    OrderType type = OrderType::GoodTillCancel;
+    OrderId id = 0;
+    Side side = Side::Buy;
+    Price price = 0;
+    Quantity quantity = 0;
+};
+
+// Per-producer, single-threaded and deterministic for a given seed. Ids are
+// (producerId << 32) | sequence, increasing, as the engine's cancel lane expects.
+class WorkloadGenerator {
+public:
+    // Bound on tracked resting orders; at the bound the next op is forced to a cancel.
+    static constexpr std::size_t MaxLiveOrders = 1u << 16;
+    // Without live targeting: how many recently issued ids cancels and modifies pick from.
+    static constexpr std::size_t RecentIds = 1u << 12;
+
+    WorkloadGenerator(const WorkloadConfig& config, std::uint32_t producerId);
+
+    WorkloadOp next();
+
+    // Nanoseconds from the previous arrival to the next one; 0 when unpaced.
+    std::uint64_t next_gap_ns();
+
+    const WorkloadConfig& config() const noexcept { return config_; }
+    Price mid() const noexcept { return mid_; }
+    std::size_t live_orders() const noexcept { return live_.size(); }
+
+private:
+    struct LiveOrder {
+        OrderId id;
+        Side side;
+    };
+
+    std::uint64_t next_u64() noexcept;
+    double next_unit() noexcept;                  // [0, 1)
+    std::uint32_t next_below(std::uint32_t n) noexcept;
+    Price geometric_ticks(double mean) noexcept;
+
+    void move_mid() noexcept;
+    Price passive_price(Side side) noexcept;
+    Price aggressive_price(Side side) noexcept;
+    Quantity next_quantity() noexcept;
+
+    WorkloadOp make_add();
+    bool pick_target(LiveOrder& out, bool remove);
+
+    WorkloadConfig config_;
+    std::uint32_t producerId_;
+    std::uint64_t rng_;
+    std::uint64_t seq_ = 0;
+    Price mid_;
+
+    double addCut_;                               // cumulative op weights in [0, 1]
+    double cancelCut_;
+
+    std::vector<LiveOrder> live_;                 // resting orders, or a ring of recent ids
+    std::size_t recentPos_ = 0;
+
+    std::uint64_t burstLeft_ = 0;                 // Bursty: arrivals left in the current burst
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Usings.h"
+
+// Kernels over one side's level arrays as DepthLadder keeps them: contiguous prices and
+// quantities, worst level first, so the best `k` levels are the last `k` elements. Each has
+// an AVX-512 (F+DQ) or AVX2 build, chosen at compile time, and a scalar twin that is also
+// the fallback; results are identical.
+
+// Where the running sum of quantities from the best level reaches a target.
+struct DepthThreshold
+{
+    std::size_t levels_{ };             // best levels taken; all of them if never reached
+    std::uint64_t cumulative_{ };       // their total quantity (>= target iff reached)
+};
+
+// "AVX-512", "AVX2" or "scalar": what the kernels below were compiled for.
+const char* DepthKernelIsa();
+
+// Total of quantities[0, count).
+std::uint64_t SumQuantities(const Quantity* quantities, std::size_t count);
+std::uint64_t SumQuantitiesScalar(const Quantity* quantities, std::size_t count);
+
+// Sum of prices[i] * quantities[i] over [0, count).
+std::int64_t SumNotional(const Price* prices, const Quantity* quantities, std::size_t count);
+std::int64_t SumNotionalScalar(const Price* prices, const Quantity* quantities, std::size_t count);
+
+// The fewest levels from the back of quantities[0, count) whose total reaches `target`.
+DepthThreshold FindDepthThreshold(const Quantity* quantities, std::size_t count, std::uint64_t target);
+DepthThreshold FindDepthThresholdScalar(const Quantity* quantities, std::size_t count, std::uint64_t target);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "DepthKernels.h"
+#include "Side.h"
+#include "Usings.h"
+
+// What taking `quantity_` from one side of the book would cost, level by level from the best.
+struct FillEstimate
+{
+    std::uint64_t quantity_{ };         // fillable, at most the quantity asked for
+    std::int64_t notional_{ };          // sum of price * quantity over the fills
+    std::size_t levels_{ };             // levels touched, the last one possibly in part
+
+    double Vwap() const { return quantity_ ? static_cast<double>(notional_) / static_cast<double>(quantity_) : 0.0; }
+};
+
+// One side's level totals as two parallel arrays (prices, quantities), worst level first so
+// that changes at the touch, the common case, append or pop at the back. The book keeps it
+// next to its levels; depth queries run the kernels of DepthKernels.h over it.
+class DepthLadder
+{
+public:
+    explicit DepthLadder(Side side) : side_{ side } { }
+
+    // The level's new total quantity; 0 removes it.
+    void Set(Price price, Quantity quantity);
+
+    // Resting quantity at `price` or better.
+    std::uint64_t DepthTo(Price price) const;
+    // The fewest best levels that hold `quantity`.
+    DepthThreshold LevelsFor(std::uint64_t quantity) const;
+    FillEstimate EstimateFill(std::uint64_t quantity) const;
+
+    Side GetSide() const { return side_; }
+    std::size_t LevelCount() const { return prices_.size(); }
+    const Price* Prices() const { return prices_.data(); }
+    const Quantity* Quantities() const { return quantities_.data(); }
+
+private:
+    // Number of levels worse than `price`: the index it has, or would be inserted at.
+    std::size_t Position(Price price) const;
+    bool Better(Price a, Price b) const { return side_ == Side::Buy ? a > b : a < b; }
+
+    std::vector<Price> prices_;
+    std::vector<Quantity> quantities_;
+    Side side_;
+};
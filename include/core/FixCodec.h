@@ -0,0 +1,170 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "Order.h"
+#include "OrderModify.h"
+#include "OrderType.h"
+#include "Side.h"
+#include "Usings.h"
+
+// FIX 4.4 tag=value order entry: NewOrderSingle (35=D), OrderCancelRequest (35=F) and
+// OrderCancelReplaceRequest (35=G) in, ExecutionReport (35=8) out.
+//
+// A message is framed by BodyLength (9) and checked against CheckSum (10); inside the body
+// the '=' and SOH delimiters are located with SIMD compares (SSE2/AVX2 or NEON) into two
+// bitmaps, and fields are walked from those. Values are parsed in place: the decoded
+// message refers into the input for its strings and nothing is allocated.
+//
+// ClOrdID (11) and OrigClOrdID (41) must be decimal numbers: they are the book's OrderIds.
+// A replace keeps the order's identity, so it is applied to OrigClOrdID. Prices are decimal
+// strings converted to ticks with `priceDecimals` implied decimals; a price finer than the
+// tick is rejected.
+//
+// Orders map to the book's types as OrdType (40) 1 -> Market, and OrdType 2 (limit) with
+// TimeInForce (59) 0 or absent -> GoodForDay, 1 -> GoodTillCancel, 3 -> FillAndKill,
+// 4 -> FillOrKill.
+
+inline constexpr char FixSoh = '\x01';
+inline constexpr std::size_t FixMaxMessageSize = 4096;
+
+enum class FixMsgType : char
+{
+    NewOrderSingle = 'D',
+    OrderCancelRequest = 'F',
+    OrderCancelReplaceRequest = 'G',
+    ExecutionReport = '8'
+};
+
+enum class FixStatus : std::uint8_t
+{
+    Ok,
+    Incomplete,         // more bytes are needed; nothing was consumed
+    Malformed,          // not a FIX 4.4 message, bad framing or longer than FixMaxMessageSize
+    BadChecksum,
+    Unsupported,        // well-formed, but not a message type or OrdType this decoder maps
+    MissingField,       // `tag` is required and absent
+    BadValue            // `tag` has a value that does not parse or is out of range
+};
+
+// One decoded order-entry message. The string views point into the decoded bytes.
+struct FixMessage
+{
+    FixMsgType type_{ FixMsgType::NewOrderSingle };
+    std::uint64_t seqNum_{ };
+    OrderId clOrdId_{ };
+    OrderId origClOrdId_{ };            // F and G only
+    Side side_{ Side::Buy };
+    OrderType orderType_{ OrderType::GoodForDay };
+    Price price_{ };
+    Quantity quantity_{ };
+    std::string_view senderCompId_;
+    std::string_view targetCompId_;
+    std::string_view symbol_;
+
+    // The id the book knows the order by: ClOrdID for a new order, OrigClOrdID otherwise.
+    OrderId TargetOrderId() const { return type_ == FixMsgType::NewOrderSingle ? clOrdId_ : origClOrdId_; }
+
+    OrderPointer ToOrder() const;
+    OrderModify ToOrderModify() const { return { origClOrdId_, side_, price_, quantity_ }; }
+};
+
+struct FixDecodeResult
+{
+    FixStatus status_{ FixStatus::Incomplete };
+    std::size_t size_{ };               // bytes of the message, when its framing was readable
+    std::uint32_t tag_{ };              // the offending tag for MissingField and BadValue
+};
+
+class FixDecoder
+{
+public:
+    explicit FixDecoder(int priceDecimals = 0);
+
+    // Decodes the message at the start of `bytes`. With Incomplete, wait for more bytes;
+    // with any other status `size_` bytes can be skipped to reach the next message, except
+    // for Malformed, where the stream cannot be trusted (size_ is then 0). A new order or
+    // replace needs an OrderQty above 0 and, unless it is a market order, a Price above 0.
+    FixDecodeResult Decode(std::string_view bytes, FixMessage& out) const;
+
+private:
+    int priceDecimals_;
+};
+
+enum class FixExecType : char
+{
+    New = '0',
+    Canceled = '4',
+    Replaced = '5',
+    Rejected = '8',
+    Trade = 'F'
+};
+
+enum class FixOrdStatus : char
+{
+    New = '0',
+    PartiallyFilled = '1',
+    Filled = '2',
+    Canceled = '4',
+    Rejected = '8'
+};
+
+struct FixExecutionReport
+{
+    OrderId orderId_{ };
+    OrderId clOrdId_{ };
+    std::uint64_t execId_{ };
+    FixExecType execType_{ FixExecType::New };
+    FixOrdStatus ordStatus_{ FixOrdStatus::New };
+    Side side_{ Side::Buy };
+    Quantity lastQty_{ };
+    Price lastPx_{ };
+    Quantity leavesQty_{ };
+    Quantity cumQty_{ };
+    Price avgPx_{ };
+};
+
+// Writes complete messages (header, BodyLength, CheckSum) into a buffer it owns; each view
+// it returns is valid until the next call. MsgSeqNum counts up from 1 per encoder.
+class FixEncoder
+{
+public:
+    FixEncoder(std::string_view senderCompId, std::string_view targetCompId, int priceDecimals = 0);
+
+    // SendingTime (52) for the messages that follow, e.g. "20240102-09:30:00.000". The caller
+    // refreshes it as often as its clock resolution needs.
+    void SetSendingTime(std::string_view sendingTime);
+
+    std::string_view ExecutionReport(const FixExecutionReport& report, std::string_view symbol);
+
+    // Client-side messages, for tests, benchmarks and load generators.
+    std::string_view NewOrderSingle(OrderId clOrdId, Side side, OrderType type, Price price, Quantity quantity,
+                                    std::string_view symbol);
+    std::string_view OrderCancelRequest(OrderId clOrdId, OrderId origClOrdId, Side side, std::string_view symbol);
+    std::string_view OrderCancelReplaceRequest(OrderId clOrdId, OrderId origClOrdId, Side side, OrderType type,
+                                               Price price, Quantity quantity, std::string_view symbol);
+
+    std::uint64_t SeqNum() const { return seqNum_; }
+
+private:
+    // Room before the body for "8=FIX.4.4|9=<len>|", written backwards once the length is known.
+    static constexpr std::size_t HeaderRoom = 32;
+
+    char* BeginBody(FixMsgType type);
+    std::string_view Finish(char* end);
+    char* PutPrice(char* p, std::uint32_t tag, Price price) const;
+    char* PutOrderType(char* p, OrderType type) const;
+
+    std::array<char, FixMaxMessageSize> buffer_{ };
+    std::array<char, 32> sender_{ };
+    std::array<char, 32> target_{ };
+    std::array<char, 32> sendingTime_{ };
+    std::size_t senderSize_{ };
+    std::size_t targetSize_{ };
+    std::size_t sendingTimeSize_{ };
+    int priceDecimals_;
+    std::uint64_t seqNum_{ };
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+
+#include "LevelDelta.h"
+#include "OrderbookLevelInfos.h"
+
+// Downstream price-level book rebuilt from LevelDeltas. Sequence numbers are checked: a
+// delta that skips ahead means some were lost, and the book cannot be trusted until it is
+// rebuilt from a snapshot.
+class L2Book
+{
+public:
+    void Apply(const LevelDelta& delta);
+    void Clear();
+
+    OrderbookLevelInfos GetOrderInfos() const;
+    OrderbookLevelInfos GetOrderInfos(std::size_t depth) const;
+
+    std::size_t LevelCount() const { return bids_.size() + asks_.size(); }
+    std::uint64_t LastSequence() const { return lastSequence_; }
+    std::uint64_t Gaps() const { return gaps_; }
+
+private:
+    struct Level
+    {
+        Quantity quantity_{ };
+        std::uint32_t count_{ };
+    };
+
+    std::map<Price, Level, std::greater<Price>> bids_;
+    std::map<Price, Level, std::less<Price>> asks_;
+    std::uint64_t lastSequence_{ 0 };
+    std::uint64_t gaps_{ 0 };
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <span>
+#include <unordered_map>
+
+#include "L3Codec.h"
+#include "OrderbookLevelInfos.h"
+
+// Downstream order-by-order book rebuilt from L3 messages. It keeps every order in its
+// level's queue and checks the feed as it goes: sequence gaps, messages for orders it does
+// not know, and adds whose queue position differs from where it placed the order all count
+// as errors.
+class L3Book
+{
+public:
+    // Applies the complete messages at the start of `bytes` and returns the bytes consumed;
+    // a partial message at the end is left for the next call.
+    std::size_t Apply(std::span<const std::uint8_t> bytes);
+    void Apply(const L3Message& message);
+
+    std::size_t Size() const { return orders_.size(); }
+    OrderbookLevelInfos GetOrderInfos() const;
+
+    std::uint64_t Messages() const { return messages_; }
+    std::uint64_t LastSequence() const { return lastSequence_; }
+    std::uint64_t Gaps() const { return gaps_; }
+    std::uint64_t UnknownOrders() const { return unknownOrders_; }
+    std::uint64_t PositionMismatches() const { return positionMismatches_; }
+
+private:
+    using Queue = std::list<OrderId>;
+
+    struct Entry
+    {
+        Side side_;
+        Price price_;
+        Quantity quantity_;
+        Queue::iterator location_;
+    };
+
+    void Rest(const L3Message& message);
+    void Remove(OrderId orderId, const Entry& entry);
+
+    std::map<Price, Queue, std::greater<Price>> bids_;
+    std::map<Price, Queue, std::less<Price>> asks_;
+    std::unordered_map<OrderId, Entry> orders_;
+
+    std::uint64_t messages_{ 0 };
+    std::uint64_t lastSequence_{ 0 };
+    std::uint64_t gaps_{ 0 };
+    std::uint64_t unknownOrders_{ 0 };
+    std::uint64_t positionMismatches_{ 0 };
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include "Side.h"
+#include "Usings.h"
+
+// Order-by-order (L3) market data in a compact binary encoding. Every message starts with a
+// one-byte type and an 8-byte sequence number, followed by fixed fields for its type; there
+// is no padding and no length prefix. Fields are little-endian.
+//
+//   'A' Add      side u8, orderId u64, price i32, quantity u32, position u32   30 bytes
+//   'U' Replace  same fields as Add: the order left its old level and rests   30 bytes
+//                here (ModifyOrder); its time priority is lost
+//   'X' Cancel   orderId u64                                                  17 bytes
+//   'E' Execute  orderId u64, quantity u32, price i32                         25 bytes
+//
+// `position` is the order's 0-based place in its price level's queue when it was added.
+// An execute reduces the order's open quantity; the order is gone once it reaches zero.
+static_assert(std::endian::native == std::endian::little, "L3 messages are written in host order");
+
+enum class L3MessageType : std::uint8_t
+{
+    Add = 'A',
+    Replace = 'U',
+    Cancel = 'X',
+    Execute = 'E'
+};
+
+inline constexpr std::size_t L3HeaderSize = 1 + 8;
+inline constexpr std::size_t L3AddSize = L3HeaderSize + 1 + 8 + 4 + 4 + 4;
+inline constexpr std::size_t L3CancelSize = L3HeaderSize + 8;
+inline constexpr std::size_t L3ExecuteSize = L3HeaderSize + 8 + 4 + 4;
+inline constexpr std::size_t L3MaxMessageSize = L3AddSize;
+
+// Size of a message of `type`, 0 for an unknown type.
+std::size_t L3MessageSize(std::uint8_t type);
+
+// One decoded message; fields a type does not carry are left zero.
+struct L3Message
+{
+    L3MessageType type_{ L3MessageType::Add };
+    std::uint64_t sequence_{ };
+    OrderId orderId_{ };
+    Side side_{ Side::Buy };
+    Price price_{ };
+    Quantity quantity_{ };
+    std::uint32_t position_{ };
+};
+
+// Decodes the message at the start of `bytes`. Returns its size, or 0 if `bytes` holds only
+// part of one or does not start with a known type.
+std::size_t L3Decode(std::span<const std::uint8_t> bytes, L3Message& out);
+
+// Writes messages back to back into one growing buffer and numbers them from 1. Clear()
+// empties the buffer and keeps its capacity and the sequence, so steady state does not
+// allocate.
+class L3Encoder
+{
+public:
+    explicit L3Encoder(std::size_t reserveBytes = 1 << 16);
+
+    void Add(OrderId orderId, Side side, Price price, Quantity quantity, std::uint32_t position)
+    {
+        WriteOrder(L3MessageType::Add, orderId, side, price, quantity, position);
+    }
+    void Replace(OrderId orderId, Side side, Price price, Quantity quantity, std::uint32_t position)
+    {
+        WriteOrder(L3MessageType::Replace, orderId, side, price, quantity, position);
+    }
+    void Cancel(OrderId orderId)
+    {
+        std::uint8_t* p = Begin(L3MessageType::Cancel, L3CancelSize);
+        Put(p, orderId);
+    }
+    void Execute(OrderId orderId, Quantity quantity, Price price)
+    {
+        std::uint8_t* p = Begin(L3MessageType::Execute, L3ExecuteSize);
+        p = Put(p, orderId);
+        p = Put(p, quantity);
+        Put(p, price);
+    }
+
+    std::span<const std::uint8_t> Bytes() const { return { bytes_.data(), size_ }; }
+    std::size_t Messages() const { return messages_; }
+    std::uint64_t Sequence() const { return sequence_; }
+    void Clear()
+    {
+        size_ = 0;
+        messages_ = 0;
+    }
+
+private:
+    template<typename T>
+    static std::uint8_t* Put(std::uint8_t* p, T value)
+    {
+        std::memcpy(p, &value, sizeof(T));
+        return p + sizeof(T);
+    }
+
+    std::uint8_t* Begin(L3MessageType type, std::size_t size)
+    {
+        if (size_ + size > bytes_.size())
+            bytes_.resize(bytes_.size() * 2);
+        std::uint8_t* p = bytes_.data() + size_;
+        size_ += size;
+        ++messages_;
+        p = Put(p, static_cast<std::uint8_t>(type));
+        return Put(p, ++sequence_);
+    }
+
+    void WriteOrder(L3MessageType type, OrderId orderId, Side side, Price price, Quantity quantity,
+                    std::uint32_t position)
+    {
+        std::uint8_t* p = Begin(type, L3AddSize);
+        p = Put(p, static_cast<std::uint8_t>(side));
+        p = Put(p, orderId);
+        p = Put(p, price);
+        p = Put(p, quantity);
+        Put(p, position);
+    }
+
+    std::vector<std::uint8_t> bytes_;
+    std::size_t size_{ 0 };
+    std::size_t messages_{ 0 };
+    std::uint64_t sequence_{ 0 };
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Side.h"
+#include "Usings.h"
+
+// One price level after a change. It carries the level's new totals, not the change itself,
+// so applying deltas in order (or only the last one per level) rebuilds the book's levels.
+// A delta with count 0 removes the level.
+struct LevelDelta
+{
+    std::uint64_t sequence_{ };     // assigned by the feed that publishes it, 0 until then
+    Price price_{ };
+    Quantity quantity_{ };
+    std::uint32_t count_{ };
+    Side side_{ Side::Buy };
+    bool endOfBurst_{ false };      // last delta of a burst: the book is consistent here
+};
+
+using LevelDeltas = std::vector<LevelDelta>;
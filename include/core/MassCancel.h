@@ -0,0 +1,48 @@
+#pragma once
+
+#include <limits>
+#include <optional>
+
+#include "Order.h"
+#include "Side.h"
+#include "Usings.h"
+
+// Every resting order of one owner, optionally only one side and an inclusive price range,
+// cancelled as one book operation (Orderbook::MassCancel). Built as
+// MassCancelRequest::ForOwner(owner), narrowed with OnSide and InRange.
+struct MassCancelRequest
+{
+    OwnerId ownerId_{ };
+    std::optional<Side> side_;          // empty: both sides
+    Price minPrice_{ std::numeric_limits<Price>::min() };
+    Price maxPrice_{ std::numeric_limits<Price>::max() };
+
+    static MassCancelRequest ForOwner(OwnerId ownerId)
+    {
+        MassCancelRequest request;
+        request.ownerId_ = ownerId;
+        return request;
+    }
+
+    MassCancelRequest OnSide(Side side) const
+    {
+        MassCancelRequest request{ *this };
+        request.side_ = side;
+        return request;
+    }
+
+    MassCancelRequest InRange(Price minPrice, Price maxPrice) const
+    {
+        MassCancelRequest request{ *this };
+        request.minPrice_ = minPrice;
+        request.maxPrice_ = maxPrice;
+        return request;
+    }
+
+    bool Matches(const Order& order) const
+    {
+        return (!side_ || order.GetSide() == *side_)
+            && order.GetPrice() >= minPrice_
+            && order.GetPrice() <= maxPrice_;
+    }
+};
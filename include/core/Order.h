@@ -1,6 +1,7 @@
 #pragma once
 
 #include <list>
+#include <memory>
 #include <cassert>
 
 #include "OrderType.h"
@@ -12,20 +13,30 @@
 class Order
 {
 public:
-    Order(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity)
+    Order(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity, OwnerId ownerId = 0)
         : orderType_{ orderType }
         , orderId_{ orderId }
         , side_{ side }
         , price_{ price }
         , initialQuantity_{ quantity }
         , remainingQuantity_{ quantity }
+        , ownerId_{ ownerId }
     { }
 
     Order(OrderId orderId, Side side, Quantity quantity)
         : Order(OrderType::Market, orderId, side, Constants::InvalidPrice, quantity)
     { }
 
+    // Neighbours in the book's list of this owner's resting orders; only the book sets them.
+    struct OwnerLinks
+    {
+        Order* prev_{ nullptr };
+        Order* next_{ nullptr };
+    };
+
     OrderId GetOrderId() const { return orderId_; }
+    OwnerId GetOwnerId() const { return ownerId_; }
+    OwnerLinks& GetOwnerLinks() { return ownerLinks_; }
     Side GetSide() const { return side_; }
     Price GetPrice() const { return price_; }
     OrderType GetOrderType() const { return orderType_; }
@@ -53,7 +64,7 @@ public:
         orderType_ = OrderType::GoodTillCancel;
     }
 
-    void Reset(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity)
+    void Reset(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity, OwnerId ownerId = 0)
     {
         orderType_ = orderType;
         orderId_ = orderId;
@@ -61,6 +72,8 @@ public:
         price_ = price;
         initialQuantity_ = quantity;
         remainingQuantity_ = quantity;
+        ownerId_ = ownerId;
+        ownerLinks_ = { };
     }
 
 private:
@@ -70,6 +83,8 @@ private:
     Price price_;
     Quantity initialQuantity_;
     Quantity remainingQuantity_;
+    OwnerId ownerId_;
+    OwnerLinks ownerLinks_;
 };
 
 using OrderPointer = std::shared_ptr<Order>;
@@ -17,9 +17,9 @@ public:
     Side GetSide() const { return side_; }
     Quantity GetQuantity() const { return quantity_; }
 
-    OrderPointer ToOrderPointer(OrderType type) const
+    OrderPointer ToOrderPointer(OrderType type, OwnerId ownerId = 0) const
     {
-        return std::make_shared<Order>(type, GetOrderId(), GetSide(), GetPrice(), GetQuantity());
+        return std::make_shared<Order>(type, GetOrderId(), GetSide(), GetPrice(), GetQuantity(), ownerId);
     }
 
 private:
@@ -1,18 +1,33 @@
 #pragma once
 
-#include <map>
+#include <functional>
 #include <unordered_map>
+#include <vector>
 
 #include "Usings.h"
+#include "DepthLadder.h"
+#include "L3Codec.h"
+#include "LevelDelta.h"
+#include "MassCancel.h"
 #include "Order.h"
 #include "OrderModify.h"
 #include "OrderbookLevelInfos.h"
+#include "OrderbookPolicies.h"
 #include "Trade.h"
-class Orderbook {
+
+// The book's containers come from `Policy` (OrderbookPolicies.h); Orderbook is the original
+// std::map / std::list / std::unordered_map build. The member functions are defined in
+// Orderbook.cpp and instantiated there for the policies it lists.
+template<typename Policy>
+class BasicOrderbook {
 private:
+    template<typename T>
+    using Allocator = typename Policy::template Allocator<T>;
+    using OrderQueue = typename Policy::template Queue<OrderPointer>;
+
     struct OrderEntry {
         OrderPointer order_{ nullptr };
-        OrderPointers::iterator location_;
+        typename OrderQueue::Handle location_{ };
     };
 
     struct LevelData {
@@ -21,42 +36,99 @@ private:
         enum class Action { Add, Remove, Match };
     };
 
-    std::unordered_map<Price, LevelData> bidData_;
-    std::unordered_map<Price, LevelData> askData_;
-    std::map<Price, OrderPointers, std::greater<Price>> bids_;
-    std::map<Price, OrderPointers, std::less<Price>> asks_;
-    std::unordered_map<OrderId, OrderEntry> orders_;
+    using LevelDataMap = std::unordered_map<Price, LevelData, std::hash<Price>, std::equal_to<Price>,
+                                            Allocator<std::pair<const Price, LevelData>>>;
+    // Head of each owner's intrusive list of resting orders (Order::OwnerLinks).
+    using OwnerHeads = std::unordered_map<OwnerId, Order*, std::hash<OwnerId>, std::equal_to<OwnerId>,
+                                          Allocator<std::pair<const OwnerId, Order*>>>;
+
+    // A level MassCancel removed orders from, settled once the pass is over.
+    struct TouchedLevel {
+        Side side_;
+        Price price_;
+        OrderQueue* orders_;
+        Quantity quantity_;
+        std::int32_t count_;
+        bool emptied_;
+    };
+
+    LevelDataMap bidData_;
+    LevelDataMap askData_;
+    typename Policy::template Levels<OrderQueue, std::greater<Price>> bids_;
+    typename Policy::template Levels<OrderQueue, std::less<Price>> asks_;
+    typename Policy::template Index<OrderEntry> orders_;
+    DepthLadder bidLadder_{ Side::Buy };
+    DepthLadder askLadder_{ Side::Sell };
+    OwnerHeads owners_;
+    std::vector<TouchedLevel> touched_;
 
     std::uint64_t addCount_{0};
     std::uint64_t cancelCount_{0};
     std::uint64_t modifyCount_{0};
     std::uint64_t executeCount_{0};
 
+    LevelDeltas* deltaSink_{ nullptr };
+    L3Encoder* l3Sink_{ nullptr };
+    bool l3Replacing_{ false };     // inside ModifyOrder: its cancel and add are one Replace
+
     void CancelOrderInternal(OrderId orderId);
     void OnOrderCancelled(OrderPointer order);
     void OnOrderAdded(OrderPointer order);
     void OnOrderMatched(Side side, Price price, Quantity quantity, bool isFullyFilled);
-    void UpdateLevelData(Side side, Price price, Quantity quantity, LevelData::Action action);
+    void LinkOwner(Order* order);
+    void UnlinkOwner(Order* order);
+    void UpdateLevelData(Side side, Price price, Quantity quantity, LevelData::Action action, std::int32_t orders = 1);
     bool CanFullyFill(Side side, Price price, Quantity quantity) const;
     bool CanMatch(Side side, Price price) const;
     Trades MatchOrders();
 
 public:
-    Orderbook() = default;
-    Orderbook(const Orderbook&) = delete;
-    void operator=(const Orderbook&) = delete;
-    Orderbook(Orderbook&&) = delete;
-    void operator=(Orderbook&&) = delete;
-    ~Orderbook() = default;
+    BasicOrderbook() = default;
+    BasicOrderbook(const BasicOrderbook&) = delete;
+    void operator=(const BasicOrderbook&) = delete;
+    BasicOrderbook(BasicOrderbook&&) = delete;
+    void operator=(BasicOrderbook&&) = delete;
+    ~BasicOrderbook() = default;
 
     Trades AddOrder(OrderPointer order);
     void CancelOrder(OrderId orderId);
     Trades ModifyOrder(OrderModify order);
+    // Cancels every resting order `request` matches in one pass over its owner's orders, with
+    // one level update per touched level. Cancelled ids are appended to `cancelled` if given.
+    // Orders without an owner (0) are never matched.
+    std::size_t MassCancel(const MassCancelRequest& request, OrderIds* cancelled = nullptr);
 
     std::size_t Size() const;
+    bool Contains(OrderId orderId) const { return orders_.contains(orderId); }
     OrderbookLevelInfos GetOrderInfos() const;
+    // The best `depth` levels per side from the level totals, without walking the orders.
+    OrderbookLevelInfos GetOrderInfos(std::size_t depth) const;
+
+    // Depth queries over one side's resting levels, best first, on the contiguous level
+    // totals the book keeps per side (DepthLadder.h). A buy order takes from Side::Sell.
+    const DepthLadder& GetDepthLadder(Side side) const { return side == Side::Buy ? bidLadder_ : askLadder_; }
+    // Quantity resting on `side` at `price` or better.
+    std::uint64_t DepthTo(Side side, Price price) const { return GetDepthLadder(side).DepthTo(price); }
+    // The fewest best levels of `side` that hold `quantity`.
+    DepthThreshold LevelsToFill(Side side, std::uint64_t quantity) const { return GetDepthLadder(side).LevelsFor(quantity); }
+    // Fillable quantity and VWAP of taking `quantity` from `side`, ignoring limit prices.
+    FillEstimate EstimateFill(Side side, std::uint64_t quantity) const { return GetDepthLadder(side).EstimateFill(quantity); }
+
+    // Every level change is appended to `sink` (nullptr: off) as the level's new totals.
+    // The owner drains it; the book only ever appends.
+    void SetLevelDeltaSink(LevelDeltas* sink) { deltaSink_ = sink; }
+    // Every order event (add, replace, cancel, execute) is encoded into `sink` (nullptr: off)
+    // as it happens. The owner drains it with L3Encoder::Bytes() and Clear().
+    void SetL3Sink(L3Encoder* sink) { l3Sink_ = sink; }
 
     std::uint64_t TotalOps() const {
         return addCount_ + cancelCount_ + modifyCount_ + executeCount_;
     }
-};
\ No newline at end of file
+};
+
+extern template class BasicOrderbook<DefaultOrderbookPolicy>;
+extern template class BasicOrderbook<PooledOrderbookPolicy>;
+extern template class BasicOrderbook<FlatLevelsOrderbookPolicy>;
+extern template class BasicOrderbook<FlatOrderbookPolicy>;
+
+using Orderbook = BasicOrderbook<DefaultOrderbookPolicy>;
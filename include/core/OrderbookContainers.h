@@ -0,0 +1,342 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Usings.h"
+
+// Containers an Orderbook can be built from (OrderbookPolicies.h). Each kind has one
+// interface, which the std-based defaults provide as they are:
+//
+//  Levels<Value, Compare, Allocator>  price -> Value, iterated best first (Compare order):
+//      operator[], at, erase(price), begin/end, rbegin (worst level), empty, size.
+//  Queue<T, Allocator>  the FIFO of one level. push_back returns a Handle that stays valid
+//      until that element is erased, also when the queue itself is moved:
+//      push_back, erase(Handle), front, pop_front, empty, size, begin/end.
+//  Index<Value, Allocator>  OrderId -> Value: contains, at, emplace, erase(id), size.
+
+template<typename Value, typename Compare, template<typename> class Allocator>
+using MapLevels = std::map<Price, Value, Compare, Allocator<std::pair<const Price, Value>>>;
+
+template<typename Value, template<typename> class Allocator>
+using HashIndex = std::unordered_map<OrderId, Value, std::hash<OrderId>, std::equal_to<OrderId>,
+                                     Allocator<std::pair<const OrderId, Value>>>;
+
+template<typename T, template<typename> class Allocator>
+class ListQueue
+{
+    using Items = std::list<T, Allocator<T>>;
+
+public:
+    using Handle = typename Items::iterator;
+    using const_iterator = typename Items::const_iterator;
+
+    Handle push_back(T value)
+    {
+        items_.push_back(std::move(value));
+        return std::prev(items_.end());
+    }
+    void erase(Handle handle) { items_.erase(handle); }
+    T& front() { return items_.front(); }
+    void pop_front() { items_.pop_front(); }
+    bool empty() const { return items_.empty(); }
+    std::size_t size() const { return items_.size(); }
+    const_iterator begin() const { return items_.begin(); }
+    const_iterator end() const { return items_.end(); }
+
+private:
+    Items items_;
+};
+
+// FIFO in a vector: erase leaves an empty T (a tombstone) that the front skips, so appends
+// and cancels touch one contiguous array instead of a list node each. T must test false
+// when empty (a pointer). The dead prefix is dropped once it is half the array; tombstones
+// behind a front order that never leaves stay until it does.
+template<typename T, template<typename> class Allocator>
+class TombstoneQueue
+{
+    using Slots = std::vector<T, Allocator<T>>;
+
+public:
+    using Handle = std::size_t;         // position since the queue was created
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+        const_iterator(typename Slots::const_iterator it, typename Slots::const_iterator end)
+            : it_{ it }
+            , end_{ end }
+        {
+            Skip();
+        }
+
+        reference operator*() const { return *it_; }
+        pointer operator->() const { return &*it_; }
+        const_iterator& operator++()
+        {
+            ++it_;
+            Skip();
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+        bool operator==(const const_iterator& other) const { return it_ == other.it_; }
+
+    private:
+        void Skip()
+        {
+            while (it_ != end_ && !*it_)
+                ++it_;
+        }
+
+        typename Slots::const_iterator it_;
+        typename Slots::const_iterator end_;
+    };
+
+    Handle push_back(T value)
+    {
+        slots_.push_back(std::move(value));
+        ++live_;
+        return base_ + slots_.size() - 1;
+    }
+
+    void erase(Handle handle)
+    {
+        slots_[handle - base_] = T{ };
+        --live_;
+        Advance();
+    }
+
+    T& front() { return slots_[head_]; }
+
+    void pop_front()
+    {
+        slots_[head_] = T{ };
+        --live_;
+        Advance();
+    }
+
+    bool empty() const { return live_ == 0; }
+    std::size_t size() const { return live_; }
+    const_iterator begin() const { return { slots_.begin() + static_cast<std::ptrdiff_t>(head_), slots_.end() }; }
+    const_iterator end() const { return { slots_.end(), slots_.end() }; }
+
+private:
+    void Advance()
+    {
+        while (head_ < slots_.size() && !slots_[head_])
+            ++head_;
+        if (head_ == slots_.size())
+        {
+            base_ += slots_.size();
+            slots_.clear();
+            head_ = 0;
+        }
+        else if (head_ >= 32 && head_ * 2 >= slots_.size())
+        {
+            slots_.erase(slots_.begin(), slots_.begin() + static_cast<std::ptrdiff_t>(head_));
+            base_ += head_;
+            head_ = 0;
+        }
+    }
+
+    Slots slots_;
+    std::size_t base_{ };
+    std::size_t head_{ };
+    std::size_t live_{ };
+};
+
+// Sorted vector of levels stored worst first, so the best level is at the back: matching
+// pops it without moving the others, and lookups scan from the touch. Suits books whose
+// activity is within some tens of levels of the touch; a deep ladder pays a shift per new level.
+template<typename Value, typename Compare, template<typename> class Allocator>
+class FlatLevels
+{
+    using Level = std::pair<Price, Value>;
+    using Storage = std::vector<Level, Allocator<Level>>;
+
+public:
+    using iterator = typename Storage::reverse_iterator;
+    using const_iterator = typename Storage::const_reverse_iterator;
+
+    Value& operator[](Price price)
+    {
+        const std::size_t i = Find(price);
+        if (i > 0 && levels_[i - 1].first == price)
+            return levels_[i - 1].second;
+        return levels_.emplace(levels_.begin() + static_cast<std::ptrdiff_t>(i), price, Value{ })->second;
+    }
+
+    Value& at(Price price)
+    {
+        const std::size_t i = Find(price);
+        assert(i > 0 && levels_[i - 1].first == price);
+        return levels_[i - 1].second;
+    }
+
+    void erase(Price price)
+    {
+        const std::size_t i = Find(price);
+        if (i > 0 && levels_[i - 1].first == price)
+            levels_.erase(levels_.begin() + static_cast<std::ptrdiff_t>(i - 1));
+    }
+
+    iterator begin() { return levels_.rbegin(); }
+    iterator end() { return levels_.rend(); }
+    const_iterator begin() const { return levels_.rbegin(); }
+    const_iterator end() const { return levels_.rend(); }
+    auto rbegin() const { return std::make_reverse_iterator(end()); }
+    bool empty() const { return levels_.empty(); }
+    std::size_t size() const { return levels_.size(); }
+
+private:
+    // One past the last level not better than `price`: levels [i, size) are better.
+    std::size_t Find(Price price) const
+    {
+        std::size_t i = levels_.size();
+        while (i > 0 && Compare{ }(levels_[i - 1].first, price))
+            --i;
+        return i;
+    }
+
+    Storage levels_;
+};
+
+// Open-addressing OrderId index: linear probing over one array with Fibonacci hashing and
+// backward-shift deletion, so there are no nodes and no tombstones. The largest OrderId
+// marks an empty slot and cannot be stored.
+template<typename Value, template<typename> class Allocator>
+class FlatIndex
+{
+    struct Slot
+    {
+        OrderId key_{ EmptyKey };
+        Value value_{ };
+    };
+
+public:
+    FlatIndex() { Rehash(MinCapacity); }
+
+    bool contains(OrderId id) const { return Find(id) != NotFound; }
+
+    Value& at(OrderId id)
+    {
+        const std::size_t i = Find(id);
+        assert(i != NotFound);
+        return slots_[i].value_;
+    }
+
+    const Value& at(OrderId id) const
+    {
+        const std::size_t i = Find(id);
+        assert(i != NotFound);
+        return slots_[i].value_;
+    }
+
+    bool emplace(OrderId id, Value value)
+    {
+        assert(id != EmptyKey);
+        if ((size_ + 1) * 4 > slots_.size() * 3)
+            Rehash(slots_.size() * 2);
+        for (std::size_t i = Home(id);; i = (i + 1) & mask_)
+        {
+            if (slots_[i].key_ == id)
+                return false;
+            if (slots_[i].key_ == EmptyKey)
+            {
+                slots_[i].key_ = id;
+                slots_[i].value_ = std::move(value);
+                ++size_;
+                return true;
+            }
+        }
+    }
+
+    std::size_t erase(OrderId id)
+    {
+        std::size_t i = Find(id);
+        if (i == NotFound)
+            return 0;
+        // Pull later entries of the run back into the hole while it lies on their probe path.
+        for (std::size_t j = i;;)
+        {
+            j = (j + 1) & mask_;
+            if (slots_[j].key_ == EmptyKey)
+                break;
+            const std::size_t home = Home(slots_[j].key_);
+            if (((j - home) & mask_) >= ((j - i) & mask_))
+            {
+                slots_[i] = std::move(slots_[j]);
+                i = j;
+            }
+        }
+        slots_[i] = Slot{ };
+        --size_;
+        return 1;
+    }
+
+    std::size_t size() const { return size_; }
+
+private:
+    static constexpr OrderId EmptyKey = std::numeric_limits<OrderId>::max();
+    static constexpr std::size_t NotFound = std::numeric_limits<std::size_t>::max();
+    static constexpr std::size_t MinCapacity = 64;
+
+    std::size_t Home(OrderId id) const
+    {
+        return static_cast<std::size_t>((id * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+
+    std::size_t Find(OrderId id) const
+    {
+        for (std::size_t i = Home(id);; i = (i + 1) & mask_)
+        {
+            if (slots_[i].key_ == id)
+                return i;
+            if (slots_[i].key_ == EmptyKey)
+                return NotFound;
+        }
+    }
+
+    void Rehash(std::size_t capacity)
+    {
+        std::vector<Slot, Allocator<Slot>> old(capacity);
+        old.swap(slots_);
+        mask_ = capacity - 1;
+        shift_ = 64 - static_cast<unsigned>(std::countr_zero(capacity));
+        for (Slot& slot : old)
+        {
+            if (slot.key_ == EmptyKey)
+                continue;
+            std::size_t i = Home(slot.key_);
+            while (slots_[i].key_ != EmptyKey)
+                i = (i + 1) & mask_;
+            slots_[i] = std::move(slot);
+        }
+    }
+
+    std::vector<Slot, Allocator<Slot>> slots_;
+    std::size_t mask_{ };
+    unsigned shift_{ };
+    std::size_t size_{ };
+};
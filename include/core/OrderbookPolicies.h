@@ -0,0 +1,35 @@
+#pragma once
+
+#include <memory>
+
+#include "OrderbookContainers.h"
+#include "PoolAllocator.h"
+
+// What a BasicOrderbook is built from: the price-level container, the FIFO of each level,
+// the OrderId index and the allocator every one of them (and the level totals) uses. Orders
+// themselves stay OrderPointers, which is what the engine and producers hand the book.
+template<template<typename, typename, template<typename> class> class LevelsT,
+         template<typename, template<typename> class> class QueueT,
+         template<typename, template<typename> class> class IndexT,
+         template<typename> class AllocatorT>
+struct OrderbookPolicy
+{
+    template<typename T>
+    using Allocator = AllocatorT<T>;
+    template<typename T>
+    using Queue = QueueT<T, AllocatorT>;
+    template<typename Value, typename Compare>
+    using Levels = LevelsT<Value, Compare, AllocatorT>;
+    template<typename Value>
+    using Index = IndexT<Value, AllocatorT>;
+};
+
+// The compiled-in combinations (instantiated in Orderbook.cpp):
+//  Default     std::map levels, std::list FIFOs, std::unordered_map index, heap nodes
+//  Pooled      the same containers with their nodes recycled through PoolAllocator
+//  FlatLevels  sorted-vector levels and an open-addressing index; list FIFOs on pooled nodes
+//  Flat        no node containers: vector levels, tombstone FIFOs, open-addressing index
+using DefaultOrderbookPolicy = OrderbookPolicy<MapLevels, ListQueue, HashIndex, std::allocator>;
+using PooledOrderbookPolicy = OrderbookPolicy<MapLevels, ListQueue, HashIndex, PoolAllocator>;
+using FlatLevelsOrderbookPolicy = OrderbookPolicy<FlatLevels, ListQueue, FlatIndex, PoolAllocator>;
+using FlatOrderbookPolicy = OrderbookPolicy<FlatLevels, TombstoneQueue, FlatIndex, std::allocator>;
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace pool_detail
+{
+
+// Free list of `Size`-byte nodes, one per thread, carved from 64 KiB blocks. Blocks are kept
+// for the life of the process: a node may be freed on another thread than the one that
+// allocated it (a book built on one thread and destroyed on another), and it then simply
+// joins that thread's list.
+template<std::size_t Size, std::size_t Align>
+class NodePool
+{
+public:
+    static void* Allocate()
+    {
+        State& state = GetState();
+        if (state.free_)
+        {
+            Node* node = state.free_;
+            state.free_ = node->next_;
+            return node;
+        }
+        if (state.next_ == state.end_)
+        {
+            char* block = static_cast<char*>(::operator new(BlockBytes, std::align_val_t{ Align }));
+            state.next_ = block;
+            state.end_ = block + BlockBytes / Size * Size;
+        }
+        void* node = state.next_;
+        state.next_ += Size;
+        return node;
+    }
+
+    static void Deallocate(void* p) noexcept
+    {
+        State& state = GetState();
+        Node* node = static_cast<Node*>(p);
+        node->next_ = state.free_;
+        state.free_ = node;
+    }
+
+private:
+    static constexpr std::size_t BlockBytes = 64 * 1024;
+
+    struct Node
+    {
+        Node* next_;
+    };
+
+    struct State
+    {
+        Node* free_{ nullptr };
+        char* next_{ nullptr };
+        char* end_{ nullptr };
+    };
+
+    static State& GetState()
+    {
+        static thread_local State state;
+        return state;
+    }
+};
+
+}
+
+// Stateless allocator for node-based containers (map and list nodes, hash nodes): single
+// objects are recycled through NodePool instead of the general heap, so a book that churns
+// orders reuses the same few cache-warm nodes. Arrays go to std::allocator.
+template<typename T>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    PoolAllocator() noexcept = default;
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept { }
+
+    T* allocate(std::size_t n)
+    {
+        if (n == 1)
+            return static_cast<T*>(Pool::Allocate());
+        return std::allocator<T>{ }.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        if (n == 1)
+            Pool::Deallocate(p);
+        else
+            std::allocator<T>{ }.deallocate(p, n);
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+
+private:
+    static constexpr std::size_t NodeAlign = std::max(alignof(T), alignof(void*));
+    static constexpr std::size_t NodeSize = (std::max(sizeof(T), sizeof(void*)) + NodeAlign - 1) / NodeAlign * NodeAlign;
+    using Pool = pool_detail::NodePool<NodeSize, NodeAlign>;
+};
@@ -1,6 +1,13 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <ctime>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 namespace ob::time {
 
@@ -21,4 +28,102 @@ inline std::string format_time(std::time_t t, const char* fmt = "%Y-%m-%d %H:%M:
     return buffer;
 }
 
+// Monotonic nanoseconds from steady_clock; only differences are meaningful.
+inline std::uint64_t steady_now_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Cycle-counter clock for latency measurement: rdtsc on x86, cntvct_el0 on arm64.
+//
+// Only used when the counter ticks at a constant rate and keeps ticking in deep C-states
+// (x86 invariant TSC, CPUID 0x80000007 EDX[8]; always true for the arm64 generic timer);
+// otherwise every call falls back to steady_clock nanoseconds and to_ns() is the identity.
+// The tick rate is calibrated against steady_clock once, on first use (~20 ms), so call
+// instance() before timing anything.
+//
+// now() is a bare counter read (~7 ns on x86, not ordered against neighbouring code) for
+// stamps. start()/stop() bracket a measured region: start() keeps earlier work from
+// drifting into the interval, stop() waits for the region's instructions to retire and
+// keeps later ones out of it.
+class TscClock {
+public:
+    static const TscClock& instance();
+
+    bool uses_counter() const noexcept { return counter_; }
+    bool invariant() const noexcept { return invariant_; }
+    double ticks_per_ns() const noexcept { return ticksPerNs_; }
+
+    std::uint64_t now() const noexcept {
+        return counter_ ? read_counter() : steady_now_ns();
+    }
+
+    std::uint64_t start() const noexcept {
+        if (!counter_)
+            return steady_now_ns();
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_lfence();
+        const std::uint64_t t = __rdtsc();
+        _mm_lfence();
+        return t;
+#elif defined(__aarch64__)
+        asm volatile("isb" ::: "memory");
+        return read_counter();
+#else
+        return read_counter();
+#endif
+    }
+
+    std::uint64_t stop() const noexcept {
+        if (!counter_)
+            return steady_now_ns();
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned aux;
+        const std::uint64_t t = __rdtscp(&aux);
+        _mm_lfence();
+        return t;
+#elif defined(__aarch64__)
+        asm volatile("isb" ::: "memory");
+        return read_counter();
+#else
+        return read_counter();
+#endif
+    }
+
+    // Fixed-point ticks -> ns: one 64x64->128 multiply and a shift.
+    std::uint64_t to_ns(std::uint64_t ticks) const noexcept {
+        return static_cast<std::uint64_t>((static_cast<unsigned __int128>(ticks) * mult_) >> Shift);
+    }
+
+    std::uint64_t now_ns() const noexcept { return to_ns(now()); }
+
+private:
+    static constexpr unsigned Shift = 32;
+
+    TscClock();
+
+    static std::uint64_t read_counter() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        std::uint64_t v;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+        return v;
+#else
+        return steady_now_ns();
+#endif
+    }
+
+    bool counter_ = false;
+    bool invariant_ = false;
+    double ticksPerNs_ = 1.0;
+    std::uint64_t mult_ = std::uint64_t{1} << Shift;
+};
+
+// Nanosecond stamp for cross-thread latency (producer enqueue -> engine dequeue). Invariant
+// TSCs are synchronised across cores, so stamps from different threads are comparable.
+inline std::uint64_t now_ns() noexcept {
+    return TscClock::instance().now_ns();
+}
+
 }
\ No newline at end of file
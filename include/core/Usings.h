@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 using Price = std::int32_t;
 using Quantity = std::uint32_t;
 using OrderId = std::uint64_t;
+using OwnerId = std::uint32_t;     // 0: no owner
 using OrderIds = std::vector<OrderId>;
@@ -4,51 +4,177 @@
 #include <memory>
 #include <thread>
 #include <vector>
-#include <iomanip>
+#include <string>
+#include <string_view>
+#include <cstdlib>
 
+#include "CpuTopology.h"
+#include "MemoryRegion.h"
+#include "NumaMemory.h"
 #include "Producer.h"
 #include "MatchingEngine.h"
 #include "Backpressure.h"
 #include "EngineEvent.h"
 #include "OrderRingBuffer.h"
-
-int main()
+#include "CancelLane.h"
+#include "ProducerChannel.h"
+#include "RiskStage.h"
+#include "Telemetry.h"
+#include "TimeUtils.h"
+#include "WaitStrategy.h"
+#include "Workload.h"
+
+// Usage: Orderbook [--wait=spin|yield|park] [--workload=uniform|maker|taker]
+//                  [--pacing=unpaced|poisson|bursty] [--rate=events/s per producer]
+//                  [--telemetry=name] [--ingress=prefix] [--risk]
+// Live statistics are published to /dev/shm/<name> (default "orderbook"); watch them with
+// `obstat --name=<name>`. Gateways in other processes are attached from the ingress rings
+// /dev/shm/<prefix>.in.<id> (default prefix "orderbook"; --ingress= turns discovery off).
+// --risk puts a pre-trade RiskStage thread between the producers and the engine.
+int main(int argc, char** argv)
 {
     std::ios::sync_with_stdio(false);
     std::cin.tie(nullptr);
 
+    WaitStrategyKind waitKind = WaitStrategyKind::SpinYield;
+    WorkloadPreset preset = WorkloadPreset::Uniform;
+    ArrivalPacing pacing = ArrivalPacing::Unpaced;
+    double rate = 0.0;
+    std::string telemetryName = "orderbook";
+    std::string ingressPrefix = "orderbook";
+    bool riskStage = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg.rfind("--wait=", 0) == 0 && ParseWaitStrategyKind(arg.substr(7), waitKind))
+            continue;
+        if (arg.rfind("--workload=", 0) == 0 && ParseWorkloadPreset(arg.substr(11), preset))
+            continue;
+        if (arg.rfind("--pacing=", 0) == 0 && ParseArrivalPacing(arg.substr(9), pacing))
+            continue;
+        if (arg.rfind("--rate=", 0) == 0) {
+            rate = std::atof(std::string(arg.substr(7)).c_str());
+            continue;
+        }
+        if (arg.rfind("--telemetry=", 0) == 0) {
+            telemetryName = std::string(arg.substr(12));
+            continue;
+        }
+        if (arg.rfind("--ingress=", 0) == 0) {
+            ingressPrefix = std::string(arg.substr(10));
+            continue;
+        }
+        if (arg == "--risk") {
+            riskStage = true;
+            continue;
+        }
+        std::cerr << "Ignoring unknown argument " << arg
+                  << " (expected --wait=spin|yield|park, --workload=uniform|maker|taker,"
+                  << " --pacing=unpaced|poisson|bursty, --rate=N, --telemetry=name, --ingress=prefix, --risk)\n";
+    }
+    const WaitStrategy wait(waitKind);
+    WorkloadConfig workload = MakeWorkload(preset);
+    workload.pacing = pacing;
+    if (rate > 0.0)
+        workload.ratePerSec = rate;
+
+    // Calibrate before any thread stamps an event.
+    const auto& clock = ob::time::TscClock::instance();
+
     std::atomic<bool> running{true};
 
     constexpr std::size_t kNumProducers = 1;
 
-    std::vector<OrderRingBuffer> queues_storage(kNumProducers);
-    std::vector<OrderRingBuffer*> queues;
+    const CpuTopology topology = DiscoverCpuTopology();
+    // The risk thread, if any, takes the slot after the last producer.
+    const ThreadPlacement placement = PlanThreadPlacement(topology, kNumProducers + (riskStage ? 1 : 0));
+    PrintThreadPlacement(std::cout, topology, placement);
+
+    const int engineNode = NumaNodeOfCpu(placement.engineCpu);
+    std::cout << "NUMA nodes: " << NumaNodeCount()
+              << (NumaAvailable() ? " (node binding on)" : " (node binding off)")
+              << ", engine node " << engineNode << "\n";
+    std::cout << "Wait strategy: " << ToString(wait.kind()) << "\n";
+    std::cout << "Workload: " << ToString(preset) << ", " << ToString(workload.pacing);
+    if (workload.pacing != ArrivalPacing::Unpaced)
+        std::cout << " at " << workload.ratePerSec << " ev/s per producer";
+    std::cout << "\n";
+    std::cout << "Latency stamps: " << (clock.uses_counter() ? "cycle counter" : "steady_clock") << "\n";
 
     std::cout << "Allocating queues...\n";
 
+    // Each ring is written mostly by its producer, so it is placed on the producer's node,
+    // on 2 MiB pages where available.
+    std::vector<RegionPtr<OrderRingBuffer>> queues_storage;
+    std::vector<OrderRingBuffer*> queues;
+    queues_storage.reserve(kNumProducers);
     queues.reserve(kNumProducers);
-    for (auto& q : queues_storage) {
-        queues.push_back(&q);
+    for (std::size_t i = 0; i < kNumProducers; ++i) {
+        queues_storage.push_back(MakeRequiredInRegion<OrderRingBuffer>("an order ring", { NumaNodeOfCpu(placement.producerCpus[i]), true }));
+        queues.push_back(queues_storage.back().get());
     }
 
     for (auto& q : queues_storage) {
-        q.prefault();
+        q->prefault();
     }
 
     constexpr std::size_t kRingSize = 16384;
     constexpr std::size_t kRingCapacity = kRingSize - 1;
-    constexpr std::size_t kTotalCapacity = kNumProducers * kRingCapacity;
-    Backpressure backpressure((kTotalCapacity * 9) / 10);
 
-    MatchingEngine engine(
-        queues,
-        backpressure,
-        64
+    // One credit window and one cancel lane per producer, next to its ring.
+    std::vector<RegionPtr<Backpressure>> credits;
+    std::vector<RegionPtr<CancelLane>> cancelLanes;
+    std::vector<ProducerChannel> channels;
+    credits.reserve(kNumProducers);
+    cancelLanes.reserve(kNumProducers);
+    channels.reserve(kNumProducers);
+    for (std::size_t i = 0; i < kNumProducers; ++i) {
+        const int node = NumaNodeOfCpu(placement.producerCpus[i]);
+        credits.push_back(MakeRequiredInRegion<Backpressure>("a credit window", { node, false }, (kRingCapacity * 9) / 10, wait));
+        cancelLanes.push_back(MakeRequiredInRegion<CancelLane>("a cancel lane", { node, false }));
+        cancelLanes.back()->prefault();
+
+        ProducerChannel channel;
+        channel.queue = queues[i];
+        channel.backpressure = credits.back().get();
+        channel.cancelLane = cancelLanes.back().get();
+        channel.producerId = static_cast<std::uint32_t>(i);
+        channels.push_back(channel);
+    }
+
+    const TelemetryRegion telemetry = TelemetryRegion::Create(telemetryName, kNumProducers);
+    if (telemetry.shared())
+        std::cout << "Telemetry: /dev/shm/" << telemetry.name() << " (obstat --name=" << telemetry.name() << ")\n";
+    else
+        std::cout << "Telemetry: private (could not create /dev/shm/" << telemetryName << ")\n";
+
+    RiskLimitTable riskLimits;
+    std::unique_ptr<RiskStage> risk;
+    if (riskStage) {
+        risk = std::make_unique<RiskStage>(channels, riskLimits, placement.producerCpus[kNumProducers], wait);
+        std::cout << "Risk stage: cpu " << placement.producerCpus[kNumProducers] << "\n";
+    }
+
+    auto enginePtr = MakeRequiredInRegion<MatchingEngine>("the matching engine",
+        { engineNode, false },
+        risk ? risk->outputs() : channels,
+        64,
+        placement.engineCpu,
+        wait,
+        &telemetry
     );
+    MatchingEngine& engine = *enginePtr;
+    if (!ingressPrefix.empty()) {
+        engine.EnableIngress(ingressPrefix);
+        std::cout << "Ingress: /dev/shm/" << ingressPrefix << ".in.<id>\n";
+    }
+    if (risk)
+        engine.EnableExecutionReports(&risk->reports());
 
     std::cout << "Starting engine...\n";
 
     engine.start();
+    if (risk)
+        risk->start();
 
     std::cout << "Starting producers...\n";
     std::vector<std::unique_ptr<Producer>> producers;
@@ -58,94 +184,32 @@ int main()
     producerThreads.reserve(kNumProducers);
 
     for (std::size_t i = 0; i < kNumProducers; ++i) {
-        producers.emplace_back(std::make_unique<Producer>(*queues[i], backpressure, running, static_cast<uint32_t>(i)));
+        producers.emplace_back(std::make_unique<Producer>(channels[i], running, static_cast<uint32_t>(i), placement.producerCpus[i], wait, workload));
         producerThreads.emplace_back(&Producer::run, producers.back().get());
     }
 
     const auto start = std::chrono::steady_clock::now();
 
-    std::atomic<bool> monitorRunning{true};
-    std::thread monitor([&] {
-        constexpr int kPeriodSeconds = 5;
-
-        auto lastTime = std::chrono::steady_clock::now();
-        std::uint64_t lastEvents = engine.EventsProcessed();
-        std::uint64_t lastOps = engine.TotalOps();
-        std::uint64_t lastIdle = engine.IdleLoops();
-        std::uint64_t lastBpWaitCalls = backpressure.waitCalls.load(std::memory_order_relaxed);
-        std::uint64_t lastBpWaitSpins = backpressure.waitSpins.load(std::memory_order_relaxed);
-
-        std::vector<std::uint64_t> lastProd;
-        std::vector<std::uint64_t> lastPool;
-        std::vector<std::uint64_t> lastRetry;
-        lastProd.resize(producers.size(), 0);
-        lastPool.resize(producers.size(), 0);
-        lastRetry.resize(producers.size(), 0);
-        for (std::size_t i = 0; i < producers.size(); ++i) {
-            lastProd[i] = producers[i]->ProducedEvents();
-            lastPool[i] = producers[i]->PoolWaitSpins();
-            lastRetry[i] = producers[i]->EnqueueRetries();
+    // The producer-side half of each channel's telemetry. Copied from here so that neither the
+    // engine nor an obstat reader ever touches a producer's or credit window's lines.
+    std::atomic<bool> publisherRunning{true};
+    auto publishProducerStats = [&] {
+        for (std::size_t i = 0; i < kNumProducers; ++i) {
+            ChannelTelemetry& stats = telemetry.channel(i);
+            TelemetrySet(stats.produced, producers[i]->ProducedEvents());
+            TelemetrySet(stats.enqueueRetries, producers[i]->EnqueueRetries());
+            TelemetrySet(stats.poolWaitSpins, producers[i]->PoolWaitSpins());
+            TelemetrySet(stats.creditLimit, credits[i]->limit());
+            TelemetrySet(stats.creditsInFlight, credits[i]->in_flight());
+            TelemetrySet(stats.creditWaitCalls, credits[i]->wait_calls());
+            TelemetrySet(stats.creditWaitSpins, credits[i]->wait_spins());
         }
-
-        while (monitorRunning.load(std::memory_order_relaxed)) {
-            std::this_thread::sleep_for(std::chrono::seconds(kPeriodSeconds));
-
-            const auto now = std::chrono::steady_clock::now();
-            const std::chrono::duration<double> dt = now - lastTime;
-            lastTime = now;
-
-            const std::uint64_t events = engine.EventsProcessed();
-            const std::uint64_t ops = engine.TotalOps();
-            const std::uint64_t idle = engine.IdleLoops();
-
-            const std::uint64_t dEvents = events - lastEvents;
-            const std::uint64_t dOps = ops - lastOps;
-            const std::uint64_t dIdle = idle - lastIdle;
-            lastEvents = events;
-            lastOps = ops;
-            lastIdle = idle;
-
-            std::uint64_t totalProd = 0;
-            std::uint64_t totalPool = 0;
-            std::uint64_t totalRetry = 0;
-            for (std::size_t i = 0; i < producers.size(); ++i) {
-                const auto p = producers[i]->ProducedEvents();
-                const auto pw = producers[i]->PoolWaitSpins();
-                const auto pr = producers[i]->EnqueueRetries();
-                totalProd += (p - lastProd[i]);
-                totalPool += (pw - lastPool[i]);
-                totalRetry += (pr - lastRetry[i]);
-                lastProd[i] = p;
-                lastPool[i] = pw;
-                lastRetry[i] = pr;
-            }
-
-            std::size_t qDepth = 0;
-            for (auto* q : queues) {
-                qDepth += q->size();
-            }
-
-            const auto bpWaitCalls = backpressure.waitCalls.load(std::memory_order_relaxed);
-            const auto bpWaitSpins = backpressure.waitSpins.load(std::memory_order_relaxed);
-            const auto dBpWaitCalls = bpWaitCalls - lastBpWaitCalls;
-            const auto dBpWaitSpins = bpWaitSpins - lastBpWaitSpins;
-            lastBpWaitCalls = bpWaitCalls;
-            lastBpWaitSpins = bpWaitSpins;
-
-            const double seconds = dt.count();
-            std::cout
-                << std::fixed << std::setprecision(2)
-                << "[mon] ev/s=" << (seconds > 0.0 ? (static_cast<double>(dEvents) / seconds) : 0.0)
-                << " ops/s=" << (seconds > 0.0 ? (static_cast<double>(dOps) / seconds) : 0.0)
-                << " prod/s=" << (seconds > 0.0 ? (static_cast<double>(totalProd) / seconds) : 0.0)
-                << " qDepth=" << qDepth << "/" << kTotalCapacity
-                << " orders=" << engine.OrderCount()
-                << " idle=" << dIdle
-                << " bpWaitCalls=" << dBpWaitCalls
-                << " bpWaitSpins=" << dBpWaitSpins
-                << " poolWaitSpins=" << totalPool
-                << " enqueueRetries=" << totalRetry
-                << "\n";
+    };
+    std::thread publisher([&] {
+        constexpr auto kPeriod = std::chrono::milliseconds(100);
+        while (publisherRunning.load(std::memory_order_relaxed)) {
+            publishProducerStats();
+            std::this_thread::sleep_for(kPeriod);
         }
     });
 
@@ -154,29 +218,29 @@ int main()
 
     running.store(false, std::memory_order_release);
 
-    for (auto* q : queues) {
-        uint32_t spins = 0;
-        while (!q->push(EngineEvent::MakeShutdown())) {
-            if (spins < 64) {
-                ++spins;
-                asm volatile("" ::: "memory");
-            } else {
-                spins = 0;
-                std::this_thread::yield();
-            }
-        }
-        backpressure.increment();
-    }
-
+    // Producers must be gone before main writes to their rings: each ring has one producer.
     for (auto& t : producerThreads) {
         t.join();
     }
 
-    monitorRunning.store(false, std::memory_order_relaxed);
-    if (monitor.joinable())
-        monitor.join();
+    for (std::size_t i = 0; i < kNumProducers; ++i) {
+        uint32_t spins = 0;
+        credits[i]->wait_if_needed();
+        while (!queues[i]->push(EngineEvent::MakeShutdown())) {
+            wait.idle(spins);
+        }
+        credits[i]->increment();
+    }
+
+    publisherRunning.store(false, std::memory_order_relaxed);
+    if (publisher.joinable())
+        publisher.join();
+    publishProducerStats();
 
+    // The engine first: it may be waiting for room in the risk stage's report ring.
     engine.stop();
+    if (risk)
+        risk->stop();
     const auto end = std::chrono::steady_clock::now();
     const std::chrono::duration<double> elapsed = end - start;
     engine.print();
@@ -187,6 +251,8 @@ int main()
     std::cout << "Elapsed seconds: " << seconds << "\n";
     std::cout << "Events/sec: " << eventsPerSec << "\n";
     std::cout << "Orderbook ops/sec: " << opsPerSec << "\n";
+    if (risk)
+        std::cout << "Risk accepted: " << risk->accepted() << ", rejected: " << risk->rejected() << "\n";
 
     std::cout << "Shutdown complete.\n";
     return 0;
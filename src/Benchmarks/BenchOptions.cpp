@@ -0,0 +1,198 @@
+#include "Benchmarks/BenchOptions.h"
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace benchmarks {
+
+namespace {
+bool ParseNumaMode(std::string_view value, NumaMode& out) {
+    if (value == "local")
+        out = NumaMode::Local;
+    else if (value == "remote")
+        out = NumaMode::Remote;
+    else if (value == "compare")
+        out = NumaMode::Compare;
+    else
+        return false;
+    return true;
+}
+}
+
+BenchOptions ParseBenchOptions(int argc, char** argv) {
+    BenchOptions opts;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+
+        if (arg.rfind("--numa=", 0) == 0) {
+            if (!ParseNumaMode(arg.substr(7), opts.numa))
+                std::cerr << "Unknown --numa mode '" << arg.substr(7) << "', expected local|remote|compare\n";
+            continue;
+        }
+        if (arg == "--numa") {
+            opts.numa = NumaMode::Compare;
+            continue;
+        }
+        if (arg == "--tlb") {
+            opts.tlbBookOrders = 10'000'000;
+            continue;
+        }
+        if (arg.rfind("--tlb=", 0) == 0) {
+            try {
+                opts.tlbBookOrders = static_cast<std::size_t>(std::stoull(std::string(arg.substr(6))));
+            } catch (...) {
+                std::cerr << "Bad --tlb order count '" << arg.substr(6) << "'\n";
+            }
+            continue;
+        }
+        if (arg == "--flow") {
+            const unsigned hc = std::thread::hardware_concurrency();
+            opts.flowProducers = hc > 1 ? hc - 1 : 1;
+            continue;
+        }
+        if (arg.rfind("--flow=", 0) == 0) {
+            try {
+                opts.flowProducers = static_cast<std::size_t>(std::stoull(std::string(arg.substr(7))));
+            } catch (...) {
+                std::cerr << "Bad --flow producer count '" << arg.substr(7) << "'\n";
+            }
+            continue;
+        }
+        if (arg == "--wait") {
+            opts.waitSamples = 20'000;
+            continue;
+        }
+        if (arg.rfind("--wait=", 0) == 0) {
+            try {
+                opts.waitSamples = static_cast<std::size_t>(std::stoull(std::string(arg.substr(7))));
+            } catch (...) {
+                std::cerr << "Bad --wait sample count '" << arg.substr(7) << "'\n";
+            }
+            continue;
+        }
+        if (arg == "--fairness") {
+            opts.fairnessSeconds = 2.0;
+            continue;
+        }
+        if (arg.rfind("--fairness=", 0) == 0) {
+            try {
+                opts.fairnessSeconds = std::stod(std::string(arg.substr(11)));
+            } catch (...) {
+                std::cerr << "Bad --fairness duration '" << arg.substr(11) << "'\n";
+            }
+            continue;
+        }
+        if (arg == "--cancel-lane") {
+            opts.cancelLaneSeconds = 2.0;
+            continue;
+        }
+        if (arg.rfind("--cancel-lane=", 0) == 0) {
+            try {
+                opts.cancelLaneSeconds = std::stod(std::string(arg.substr(14)));
+            } catch (...) {
+                std::cerr << "Bad --cancel-lane duration '" << arg.substr(14) << "'\n";
+            }
+            continue;
+        }
+        if (arg == "--deep") {
+            opts.deepBookOrders = 10'000'000;
+            continue;
+        }
+        if (arg.rfind("--deep=", 0) == 0) {
+            try {
+                opts.deepBookOrders = static_cast<std::size_t>(std::stoull(std::string(arg.substr(7))));
+            } catch (...) {
+                std::cerr << "Bad --deep order count '" << arg.substr(7) << "'\n";
+            }
+            continue;
+        }
+        if (arg == "--ipc") {
+            opts.ipcSamples = 100'000;
+            continue;
+        }
+        if (arg.rfind("--ipc=", 0) == 0) {
+            try {
+                opts.ipcSamples = static_cast<std::size_t>(std::stoull(std::string(arg.substr(6))));
+            } catch (...) {
+                std::cerr << "Bad --ipc sample count '" << arg.substr(6) << "'\n";
+            }
+            continue;
+        }
+        if (arg == "--l2") {
+            opts.l2Events = 1'000'000;
+            continue;
+        }
+        if (arg.rfind("--l2=", 0) == 0) {
+            try {
+                opts.l2Events = static_cast<std::size_t>(std::stoull(std::string(arg.substr(5))));
+            } catch (...) {
+                std::cerr << "Bad --l2 event count '" << arg.substr(5) << "'\n";
+            }
+            continue;
+        }
+        if (arg == "--fix") {
+            opts.fixMessages = 1'000'000;
+            continue;
+        }
+        if (arg.rfind("--fix=", 0) == 0) {
+            try {
+                opts.fixMessages = static_cast<std::size_t>(std::stoull(std::string(arg.substr(6))));
+            } catch (...) {
+                std::cerr << "Bad --fix message count '" << arg.substr(6) << "'\n";
+            }
+            continue;
+        }
+        if (arg == "--policies") {
+            opts.policyEvents = 1'000'000;
+            continue;
+        }
+        if (arg.rfind("--policies=", 0) == 0) {
+            try {
+                opts.policyEvents = static_cast<std::size_t>(std::stoull(std::string(arg.substr(11))));
+            } catch (...) {
+                std::cerr << "Bad --policies event count '" << arg.substr(11) << "'\n";
+            }
+            continue;
+        }
+        if (arg == "--depth") {
+            opts.depthQueries = 100'000;
+            continue;
+        }
+        if (arg.rfind("--depth=", 0) == 0) {
+            try {
+                opts.depthQueries = static_cast<std::size_t>(std::stoull(std::string(arg.substr(8))));
+            } catch (...) {
+                std::cerr << "Bad --depth query count '" << arg.substr(8) << "'\n";
+            }
+            continue;
+        }
+        if (arg == "--mass-cancel") {
+            opts.massCancelRounds = 1'000;
+            continue;
+        }
+        if (arg.rfind("--mass-cancel=", 0) == 0) {
+            try {
+                opts.massCancelRounds = static_cast<std::size_t>(std::stoull(std::string(arg.substr(14))));
+            } catch (...) {
+                std::cerr << "Bad --mass-cancel round count '" << arg.substr(14) << "'\n";
+            }
+            continue;
+        }
+        if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Ignoring unknown option " << arg << "\n";
+            continue;
+        }
+
+        try {
+            opts.iterations = static_cast<std::size_t>(std::stoull(std::string(arg)));
+        } catch (...) {
+        }
+    }
+
+    return opts;
+}
+
+}
@@ -2,6 +2,9 @@
 
 #include "Benchmarks/SystemInfo.h"
 
+#include "TimeUtils.h"
+
+#include <iomanip>
 #include <iostream>
 
 namespace benchmarks {
@@ -16,8 +19,23 @@ void PrintSetup(std::string_view benchName, const RingBufferStats& rbStats) {
     const SystemInfo sys = QuerySystemInfo();
 
     std::cout << benchName << "\n";
+    if (!sys.cpuModel.empty())
+        std::cout << "CPU model: " << sys.cpuModel << "\n";
+    if (!sys.kernel.empty())
+        std::cout << "Kernel: " << sys.kernel << "\n";
     std::cout << "CPU cores available: " << sys.cpuCores << "\n";
-    std::cout << "Available memory: " << bytes_to_mb(sys.availableMemoryBytes) << " MB\n";
+    if (!sys.frequencyGovernor.empty() || sys.maxFrequencyMhz)
+        std::cout << "Frequency governor: " << (sys.frequencyGovernor.empty() ? "n/a" : sys.frequencyGovernor)
+                  << ", max " << sys.maxFrequencyMhz << " MHz\n";
+    if (sys.l1dCacheBytes || sys.l2CacheBytes || sys.l3CacheBytes)
+        std::cout << "Caches: L1d " << sys.l1dCacheBytes / 1024 << " KB, L2 " << sys.l2CacheBytes / 1024
+                  << " KB, L3 " << sys.l3CacheBytes / 1024 << " KB\n";
+    std::cout << "Isolated cpus: " << (sys.isolatedCpus.empty() ? "none" : sys.isolatedCpus)
+              << ", nohz_full: " << (sys.nohzFullCpus.empty() ? "none" : sys.nohzFullCpus) << "\n";
+    std::cout << "Available memory: " << bytes_to_mb(sys.availableMemoryBytes) << " MB";
+    if (sys.totalMemoryBytes)
+        std::cout << " of " << bytes_to_mb(sys.totalMemoryBytes) << " MB";
+    std::cout << "\n";
 
     const double mb = static_cast<double>(rbStats.ringBufferSizeBytes) / (1024.0 * 1024.0);
     const std::uint64_t pages = sys.pageSizeBytes ? (rbStats.ringBufferSizeBytes / sys.pageSizeBytes) : 0;
@@ -26,16 +44,109 @@ void PrintSetup(std::string_view benchName, const RingBufferStats& rbStats) {
     std::cout << "Message size: " << rbStats.messageSizeBytes << " bytes\n";
     std::cout << "Messages per cache line: " << rbStats.messagesPerCacheLine << "\n";
     std::cout << "Page size: " << sys.pageSizeBytes << " bytes\n";
+
+    std::cout << "Huge pages:";
+    for (const auto& pool : sys.hugePagePools)
+        std::cout << " " << pool.pageSizeKb << " kB " << pool.free << "/" << pool.total << " free,";
+    std::cout << " THP " << (sys.transparentHugePages.empty() ? "unavailable" : sys.transparentHugePages) << "\n";
+    if (rbStats.pageBacking)
+        std::cout << "Ring buffer backing: " << rbStats.pageBacking << "\n";
     std::cout << "\n";
 }
 
+void PrintTimestampClock() {
+    const auto& clock = ob::time::TscClock::instance();
+
+    LatencyHistogram overhead;
+    for (int i = 0; i < 100000; ++i) {
+        const std::uint64_t t0 = clock.start();
+        const std::uint64_t t1 = clock.stop();
+        overhead.record(clock.to_ns(t1 - t0));
+    }
+
+    std::cout << "Timestamp clock: ";
+    if (clock.uses_counter())
+        std::cout << "cycle counter (invariant), " << clock.ticks_per_ns() << " ticks/ns";
+    else
+        std::cout << "steady_clock (no invariant cycle counter)";
+    std::cout << ", empty interval p50=" << overhead.quantile(0.5)
+              << " ns p99=" << overhead.quantile(0.99) << " ns\n";
+}
+
 void PrintLatencyStats(std::string_view label, const LatencyPercentilesNs& pct) {
     std::cout << label << " latency (ns): "
               << "p50=" << pct.p50
               << " p95=" << pct.p95
               << " p99=" << pct.p99
               << " p99.9=" << pct.p999
+              << " p99.99=" << pct.p9999
+              << " max=" << pct.max
               << "\n";
 }
 
+void PrintLatencyStats(std::string_view label, const LatencyHistogram& histogram) {
+    PrintLatencyStats(label, ComputeLatencyPercentilesNs(histogram));
+}
+
+void PrintPerfCounterStatus() {
+    std::cout << "Perf counters: ";
+    if (const char* reason = PerfUnavailableReason()) {
+        std::cout << "unavailable (" << reason << "), skipped\n";
+        return;
+    }
+    PerfCounterGroup group;
+    group.start();
+    const PerfCounts probe = group.stop();
+    if (!probe.valid) {
+        std::cout << "opened but not scheduled on the PMU, skipped\n";
+        return;
+    }
+    const char* sep = "";
+    for (std::size_t i = 0; i < PerfEventCount; ++i) {
+        if (probe.present[i]) {
+            std::cout << sep << ToString(static_cast<PerfEvent>(i));
+            sep = ", ";
+        }
+    }
+    std::cout << " (user space, per op)\n";
+}
+
+void PrintLatencyStats(std::string_view label, const LatencyPercentilesNs& pct,
+                       const PerfCounts& perf, std::uint64_t ops) {
+    PrintLatencyStats(label, pct);
+    if (!perf.valid || ops == 0)
+        return;
+
+    const double n = static_cast<double>(ops);
+    const auto perOp = [&](PerfEvent e) { return static_cast<double>(perf.get(e)) / n; };
+
+    const auto flags = std::cout.flags();
+    const auto precision = std::cout.precision();
+    std::cout << "  per op:" << std::fixed << std::setprecision(2);
+    if (perf.has(PerfEvent::Cycles))
+        std::cout << " cycles=" << perOp(PerfEvent::Cycles);
+    if (perf.has(PerfEvent::Instructions))
+        std::cout << " instr=" << perOp(PerfEvent::Instructions);
+    if (perf.has(PerfEvent::Cycles) && perf.has(PerfEvent::Instructions) && perf.get(PerfEvent::Cycles))
+        std::cout << " IPC=" << static_cast<double>(perf.get(PerfEvent::Instructions))
+                                    / static_cast<double>(perf.get(PerfEvent::Cycles));
+    if (perf.has(PerfEvent::L1DLoadMisses))
+        std::cout << " L1D-miss=" << perOp(PerfEvent::L1DLoadMisses);
+    if (perf.has(PerfEvent::LlcMisses))
+        std::cout << " LLC-miss=" << perOp(PerfEvent::LlcMisses);
+    if (perf.has(PerfEvent::BranchMisses))
+        std::cout << " br-miss=" << perOp(PerfEvent::BranchMisses);
+    if (perf.has(PerfEvent::DTlbLoadMisses))
+        std::cout << " dTLB-miss=" << perOp(PerfEvent::DTlbLoadMisses);
+    if (perf.scaled)
+        std::cout << " (multiplexed)";
+    std::cout << "\n";
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
+
+void PrintLatencyStats(std::string_view label, const LatencyHistogram& histogram, const PerfCounts& perf) {
+    PrintLatencyStats(label, ComputeLatencyPercentilesNs(histogram), perf, histogram.count());
+}
+
 }
@@ -0,0 +1,124 @@
+#include "Benchmarks/BookPolicies.h"
+
+#include "Orderbook.h"
+#include "TimeUtils.h"
+#include "Workload.h"
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace benchmarks {
+
+namespace {
+
+constexpr int kPasses = 3;
+
+struct PolicyResult {
+    std::uint64_t ns = 0;
+    std::size_t size = 0;
+    OrderbookLevelInfos levels{ {}, {} };
+};
+
+std::vector<WorkloadOp> MakeOps(WorkloadPreset preset, std::size_t events) {
+    WorkloadGenerator generator(MakeWorkload(preset), 1);
+    std::vector<WorkloadOp> ops(events);
+    for (auto& op : ops)
+        op = generator.next();
+    return ops;
+}
+
+template<typename Policy>
+PolicyResult RunPolicy(const std::vector<WorkloadOp>& ops) {
+    const auto& clock = ob::time::TscClock::instance();
+
+    // Orders are built untimed: in the engine they arrive ready-made from the producers.
+    std::vector<OrderPointer> orders(ops.size());
+    for (std::size_t i = 0; i < ops.size(); ++i) {
+        if (ops[i].op == OrderOp::Add)
+            orders[i] = std::make_shared<Order>(ops[i].type, ops[i].id, ops[i].side, ops[i].price, ops[i].quantity);
+    }
+
+    PolicyResult result;
+    auto ob = std::make_unique<BasicOrderbook<Policy>>();
+    const std::uint64_t t0 = clock.start();
+    for (std::size_t i = 0; i < ops.size(); ++i) {
+        const WorkloadOp& op = ops[i];
+        switch (op.op) {
+        case OrderOp::Add:
+            (void)ob->AddOrder(std::move(orders[i]));
+            break;
+        case OrderOp::Cancel:
+            ob->CancelOrder(op.id);
+            break;
+        case OrderOp::Modify:
+            (void)ob->ModifyOrder(OrderModify{ op.id, op.side, op.price, op.quantity });
+            break;
+        }
+    }
+    result.ns = clock.to_ns(clock.stop() - t0);
+    result.size = ob->Size();
+    result.levels = ob->GetOrderInfos();
+    return result;
+}
+
+bool SameLevels(const LevelInfos& a, const LevelInfos& b) {
+    if (a.size() != b.size())
+        return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i].price_ != b[i].price_ || a[i].quantity_ != b[i].quantity_)
+            return false;
+    }
+    return true;
+}
+
+void PrintPolicy(const char* label, const PolicyResult& r, const PolicyResult& baseline, std::size_t events) {
+    const double perOp = static_cast<double>(r.ns) / static_cast<double>(events);
+    const double basePerOp = static_cast<double>(baseline.ns) / static_cast<double>(events);
+    const bool same = r.size == baseline.size
+        && SameLevels(r.levels.GetBids(), baseline.levels.GetBids())
+        && SameLevels(r.levels.GetAsks(), baseline.levels.GetAsks());
+    std::cout << "  " << std::left << std::setw(12) << label << std::right << std::fixed << std::setprecision(1)
+              << std::setw(8) << perOp << " ns/op  " << std::setprecision(2) << std::setw(6)
+              << (perOp > 0.0 ? basePerOp / perOp : 0.0) << "x default"
+              << "  book: " << r.size << " orders" << (same ? "" : "  (DIFFERS from default)") << "\n";
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+void RunProfile(WorkloadPreset preset, std::size_t events) {
+    const std::vector<WorkloadOp> ops = MakeOps(preset, events);
+    std::cout << ToString(preset) << ":\n";
+
+    PolicyResult standard, pooled, flatLevels, flat;
+    auto keepFastest = [](PolicyResult& best, PolicyResult run, int pass) {
+        if (pass == 0 || run.ns < best.ns)
+            best = std::move(run);
+    };
+    for (int pass = 0; pass < kPasses; ++pass) {
+        keepFastest(standard, RunPolicy<DefaultOrderbookPolicy>(ops), pass);
+        keepFastest(pooled, RunPolicy<PooledOrderbookPolicy>(ops), pass);
+        keepFastest(flatLevels, RunPolicy<FlatLevelsOrderbookPolicy>(ops), pass);
+        keepFastest(flat, RunPolicy<FlatOrderbookPolicy>(ops), pass);
+    }
+
+    PrintPolicy("Default", standard, standard, events);
+    PrintPolicy("Pooled", pooled, standard, events);
+    PrintPolicy("FlatLevels", flatLevels, standard, events);
+    PrintPolicy("Flat", flat, standard, events);
+}
+
+}
+
+void RunBookPolicyBenchmark(std::size_t events) {
+    if (events == 0)
+        return;
+
+    std::cout << "Orderbook policies: " << events << " ops per workload, single thread\n";
+    RunProfile(WorkloadPreset::Uniform, events);
+    RunProfile(WorkloadPreset::MarketMaker, events);
+    RunProfile(WorkloadPreset::Taker, events);
+}
+
+}
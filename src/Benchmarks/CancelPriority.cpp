@@ -0,0 +1,127 @@
+#include "Benchmarks/CancelPriority.h"
+
+#include "Backpressure.h"
+#include "CancelLane.h"
+#include "CpuTopology.h"
+#include "EngineEvent.h"
+#include "MatchingEngine.h"
+#include "MemoryRegion.h"
+#include "NumaMemory.h"
+#include "OrderRingBuffer.h"
+#include "ProducerChannel.h"
+#include "ThreadPinning.h"
+#include "TimeUtils.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+namespace benchmarks {
+
+namespace {
+
+constexpr std::size_t kWindow = ((16384 - 1) * 9) / 10;
+constexpr std::uint64_t kCancelLag = 64;
+
+void FloodLoop(const ProducerChannel& channel, std::atomic<bool>& running) {
+    auto& ring = *channel.queue;
+    auto& credits = *channel.backpressure;
+    const OrderId base = static_cast<OrderId>(channel.producerId) << 32;
+
+    auto push = [&](EngineEvent ev) {
+        credits.wait_if_needed();
+        while (!ring.push(ev))
+            std::this_thread::yield();
+        credits.increment();
+    };
+
+    std::uint64_t seq = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        for (int k = 0; k < 2; ++k) {
+            // Bids below any ask: they rest, so the book holds everything not cancelled.
+            push(EngineEvent::MakeAdd(std::make_shared<Order>(
+                OrderType::GoodTillCancel, base | seq, Side::Buy, Price{100 - static_cast<Price>(seq % 50)}, Quantity{1})));
+            ++seq;
+        }
+        if (seq <= kCancelLag)
+            continue;
+
+        const OrderId target = base | (seq - kCancelLag);
+        const std::uint64_t now = ob::time::now_ns();
+        if (channel.cancelLane) {
+            while (!channel.cancelLane->push(CancelRequest{ target, now }))
+                std::this_thread::yield();
+            credits.notify_consumer();
+        } else {
+            EngineEvent ev = EngineEvent::MakeCancel(target);
+            ev.enqueueNs = now;
+            push(std::move(ev));
+        }
+    }
+}
+
+void RunConfig(bool useLane, double seconds, const ThreadPlacement& placement) {
+    const int node = NumaNodeOfCpu(placement.producerCpus[0]);
+    auto ring = MakeRequiredInRegion<OrderRingBuffer>("an order ring", { node, true });
+    ring->prefault();
+    auto credits = MakeRequiredInRegion<Backpressure>("a credit window", { node, false }, kWindow);
+    auto lane = MakeRequiredInRegion<CancelLane>("a cancel lane", { node, false });
+
+    ProducerChannel channel;
+    channel.queue = ring.get();
+    channel.backpressure = credits.get();
+    channel.cancelLane = useLane ? lane.get() : nullptr;
+    channel.producerId = 1;
+    std::vector<ProducerChannel> channels{ channel };
+
+    auto engine = MakeRequiredInRegion<MatchingEngine>("the matching engine",
+                                                       { NumaNodeOfCpu(placement.engineCpu), false },
+                                                       channels, 64, placement.engineCpu);
+    engine->start();
+
+    std::atomic<bool> running{true};
+    std::thread producer([&] {
+        PinCurrentThreadToCpu(placement.producerCpus[0]);
+        FloodLoop(channel, running);
+    });
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running.store(false, std::memory_order_relaxed);
+    producer.join();
+    engine->stop();
+
+    const EngineQueueStats q = engine->QueueStats(0);
+    const LatencyHistogram& lat = engine->CancelLatency(0);
+    std::cout << std::left << std::setw(14) << (useLane ? "priority lane" : "ring")
+              << std::right << std::setw(10) << lat.count()
+              << std::setw(13) << lat.quantile(0.50)
+              << std::setw(13) << lat.quantile(0.99)
+              << std::setw(13) << lat.quantile(0.9999)
+              << std::setw(13) << lat.max()
+              << std::setw(14) << q.overtakenAdds
+              << std::setw(14) << engine->OrderCount() << "\n";
+}
+
+}
+
+void RunCancelPriorityBenchmark(double seconds) {
+    const CpuTopology topology = DiscoverCpuTopology();
+    const ThreadPlacement placement = PlanThreadPlacement(topology, 1);
+
+    std::cout << "Cancel priority: saturated producer, 2 adds : 1 cancel (target " << kCancelLag
+              << " adds back), " << seconds << " s per configuration\n";
+    std::cout << std::left << std::setw(14) << "cancel path"
+              << std::right << std::setw(10) << "cancels"
+              << std::setw(13) << "p50 ns" << std::setw(13) << "p99 ns"
+              << std::setw(13) << "p99.99 ns" << std::setw(13) << "max ns"
+              << std::setw(14) << "overtaken" << std::setw(14) << "resting" << "\n";
+
+    RunConfig(false, seconds, placement);
+    RunConfig(true, seconds, placement);
+}
+
+}
@@ -0,0 +1,296 @@
+#include "Benchmarks/DeepBook.h"
+
+#include "Benchmarks/BenchPrinter.h"
+#include "Benchmarks/PerfCounters.h"
+
+#include "LatencyHistogram.h"
+#include "Orderbook.h"
+#include "TimeUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace benchmarks {
+
+namespace {
+
+constexpr std::size_t kSweepLevels = 1'000;
+constexpr std::size_t kDeepLevels = 10'000;
+constexpr std::size_t kDeepLevelOrders = 10'000;
+constexpr std::size_t kSteadyLevelsPerSide = 10'000;
+constexpr std::size_t kMaxSweepSamples = 2'000;     // each rebuilds 1000 levels
+constexpr std::size_t kMaxFokSamples = 10'000;      // each walks 10k levels
+
+OrderPointer MakeOrder(OrderType type, OrderId id, Side side, Price price, Quantity qty) {
+    return std::make_shared<Order>(type, id, side, price, qty);
+}
+
+std::uint64_t NextRandom(std::uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// One resting ask per level at 101..100+kSweepLevels; a FillAndKill buy for all of it takes
+// every level in one call. The asks are put back, untimed, before each sample.
+LatencyHistogram RunLevelSweep(std::size_t samples, PerfCounts& counters) {
+    const auto& clock = ob::time::TscClock::instance();
+    LatencyHistogram latency;
+    Orderbook ob;
+    OrderId nextId = 1;
+
+    // Only the timed calls are counted; the rebuilds run with the group paused.
+    PerfCounterGroup perf;
+    perf.start();
+    perf.pause();
+    for (std::size_t s = 0; s < samples; ++s) {
+        for (std::size_t level = 0; level < kSweepLevels; ++level)
+            (void)ob.AddOrder(MakeOrder(OrderType::GoodTillCancel, nextId++, Side::Sell,
+                                        static_cast<Price>(101 + level), Quantity{1}));
+
+        auto taker = MakeOrder(OrderType::FillAndKill, nextId++, Side::Buy,
+                               static_cast<Price>(100 + kSweepLevels), static_cast<Quantity>(kSweepLevels));
+        perf.resume();
+        const std::uint64_t t0 = clock.start();
+        const Trades trades = ob.AddOrder(std::move(taker));
+        const std::uint64_t t1 = clock.stop();
+        perf.pause();
+        latency.record(clock.to_ns(t1 - t0));
+
+        if (trades.size() != kSweepLevels)
+            std::cout << "  (sweep filled " << trades.size() << " levels, expected " << kSweepLevels << ")\n";
+    }
+    counters = perf.stop();
+    return latency;
+}
+
+// A FillOrKill for one more than the whole book: CanFullyFill walks every level before
+// rejecting it, and the book is left as it was, so no rebuild is needed.
+LatencyHistogram RunFokDeepBook(std::size_t samples, PerfCounts& counters) {
+    const auto& clock = ob::time::TscClock::instance();
+    LatencyHistogram latency;
+    Orderbook ob;
+
+    for (std::size_t level = 0; level < kDeepLevels; ++level)
+        (void)ob.AddOrder(MakeOrder(OrderType::GoodTillCancel, OrderId{level + 1}, Side::Sell,
+                                    static_cast<Price>(101 + level), Quantity{1}));
+
+    OrderId nextId = kDeepLevels + 1;
+    PerfCounterGroup perf;
+    perf.start();
+    perf.pause();
+    for (std::size_t s = 0; s < samples; ++s) {
+        auto fok = MakeOrder(OrderType::FillOrKill, nextId++, Side::Buy,
+                             static_cast<Price>(100 + kDeepLevels), static_cast<Quantity>(kDeepLevels + 1));
+        perf.resume();
+        const std::uint64_t t0 = clock.start();
+        (void)ob.AddOrder(std::move(fok));
+        const std::uint64_t t1 = clock.stop();
+        perf.pause();
+        latency.record(clock.to_ns(t1 - t0));
+    }
+    counters = perf.stop();
+    return latency;
+}
+
+// kDeepLevelOrders bids at one price. Each sample cancels whichever order is currently in
+// the middle of the queue, then re-adds it (untimed) at the back so the depth stays put.
+LatencyHistogram RunCancelMidLevel(std::size_t samples, PerfCounts& counters) {
+    const auto& clock = ob::time::TscClock::instance();
+    LatencyHistogram latency;
+    Orderbook ob;
+
+    std::vector<OrderPointer> orders;
+    std::vector<OrderId> queueOrder;
+    orders.reserve(kDeepLevelOrders);
+    queueOrder.reserve(kDeepLevelOrders);
+    for (std::size_t i = 0; i < kDeepLevelOrders; ++i) {
+        orders.push_back(MakeOrder(OrderType::GoodTillCancel, OrderId{i + 1}, Side::Buy, Price{100}, Quantity{1}));
+        queueOrder.push_back(OrderId{i + 1});
+        (void)ob.AddOrder(orders.back());
+    }
+
+    PerfCounterGroup perf;
+    perf.start();
+    perf.pause();
+    for (std::size_t s = 0; s < samples; ++s) {
+        const auto mid = queueOrder.begin() + static_cast<std::ptrdiff_t>(queueOrder.size() / 2);
+        const OrderId id = *mid;
+
+        perf.resume();
+        const std::uint64_t t0 = clock.start();
+        ob.CancelOrder(id);
+        const std::uint64_t t1 = clock.stop();
+        perf.pause();
+        latency.record(clock.to_ns(t1 - t0));
+
+        queueOrder.erase(mid);
+        queueOrder.push_back(id);
+        (void)ob.AddOrder(orders[id - 1]);
+    }
+    counters = perf.stop();
+    return latency;
+}
+
+// Ten orders on each of 1000 levels per side, plus one bid alone at the best bid. Each
+// sample modifies that bid up to the best ask, where it trades against the front order;
+// both are put back (new objects, same prices) untimed.
+LatencyHistogram RunCrossingModify(std::size_t samples, PerfCounts& counters) {
+    constexpr std::size_t kLevels = 1'000;
+    constexpr std::size_t kOrdersPerLevel = 10;
+    constexpr Price kBestBid = 1'000;
+    constexpr Price kBestAsk = 1'001;
+
+    const auto& clock = ob::time::TscClock::instance();
+    LatencyHistogram latency;
+    Orderbook ob;
+    OrderId nextId = 1;
+
+    for (std::size_t level = 0; level < kLevels; ++level) {
+        for (std::size_t k = 0; k < kOrdersPerLevel; ++k) {
+            (void)ob.AddOrder(MakeOrder(OrderType::GoodTillCancel, nextId++, Side::Buy,
+                                        static_cast<Price>(kBestBid - 1 - static_cast<Price>(level)), Quantity{1}));
+            (void)ob.AddOrder(MakeOrder(OrderType::GoodTillCancel, nextId++, Side::Sell,
+                                        static_cast<Price>(kBestAsk + static_cast<Price>(level)), Quantity{1}));
+        }
+    }
+
+    const OrderId moverId = nextId++;
+    (void)ob.AddOrder(MakeOrder(OrderType::GoodTillCancel, moverId, Side::Buy, kBestBid, Quantity{1}));
+
+    PerfCounterGroup perf;
+    perf.start();
+    perf.pause();
+    for (std::size_t s = 0; s < samples; ++s) {
+        const OrderModify modify{ moverId, Side::Buy, kBestAsk, Quantity{1} };
+
+        perf.resume();
+        const std::uint64_t t0 = clock.start();
+        const Trades trades = ob.ModifyOrder(modify);
+        const std::uint64_t t1 = clock.stop();
+        perf.pause();
+        latency.record(clock.to_ns(t1 - t0));
+
+        if (trades.size() != 1)
+            std::cout << "  (modify produced " << trades.size() << " trades, expected 1)\n";
+
+        (void)ob.AddOrder(MakeOrder(OrderType::GoodTillCancel, nextId++, Side::Sell, kBestAsk, Quantity{1}));
+        (void)ob.AddOrder(MakeOrder(OrderType::GoodTillCancel, moverId, Side::Buy, kBestBid, Quantity{1}));
+    }
+    counters = perf.stop();
+    return latency;
+}
+
+struct SteadyResult {
+    LatencyHistogram add;
+    LatencyHistogram cancel;
+    PerfCounts addPerf;
+    PerfCounts cancelPerf;
+    double buildSeconds = 0.0;
+};
+
+// `bookOrders` resting orders over kSteadyLevelsPerSide levels per side (bids 1..L, asks
+// L+1..2L, never crossing). Each sample cancels a random live order and adds a new one at
+// a random level on the same side, so size and shape stay constant.
+SteadyResult RunSteadyState(std::size_t bookOrders, std::size_t samples) {
+    const auto& clock = ob::time::TscClock::instance();
+    SteadyResult result;
+    Orderbook ob;
+
+    struct Live {
+        OrderId id;
+        Side side;
+    };
+    std::vector<Live> live;
+    live.reserve(bookOrders);
+
+    const auto priceFor = [](Side side, std::size_t level) {
+        return side == Side::Buy ? static_cast<Price>(1 + level)
+                                 : static_cast<Price>(kSteadyLevelsPerSide + 1 + level);
+    };
+
+    const auto buildStart = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < bookOrders; ++i) {
+        const Side side = (i & 1) ? Side::Sell : Side::Buy;
+        const OrderId id = OrderId{i + 1};
+        (void)ob.AddOrder(MakeOrder(OrderType::GoodTillCancel, id, side,
+                                    priceFor(side, (i >> 1) % kSteadyLevelsPerSide), Quantity{1}));
+        live.push_back({ id, side });
+    }
+    result.buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - buildStart).count();
+
+    std::uint64_t rng = 0x9E3779B97F4A7C15ull;
+    OrderId nextId = bookOrders + 1;
+    PerfCounterGroup addPerf;
+    PerfCounterGroup cancelPerf;
+    addPerf.start();
+    addPerf.pause();
+    cancelPerf.start();
+    cancelPerf.pause();
+    for (std::size_t s = 0; s < samples; ++s) {
+        const std::size_t victim = static_cast<std::size_t>(NextRandom(rng) % live.size());
+        const Live target = live[victim];
+
+        cancelPerf.resume();
+        std::uint64_t t0 = clock.start();
+        ob.CancelOrder(target.id);
+        std::uint64_t t1 = clock.stop();
+        cancelPerf.pause();
+        result.cancel.record(clock.to_ns(t1 - t0));
+
+        const OrderId id = nextId++;
+        auto order = MakeOrder(OrderType::GoodTillCancel, id, target.side,
+                               priceFor(target.side, static_cast<std::size_t>(NextRandom(rng) % kSteadyLevelsPerSide)),
+                               Quantity{1});
+        addPerf.resume();
+        t0 = clock.start();
+        (void)ob.AddOrder(std::move(order));
+        t1 = clock.stop();
+        addPerf.pause();
+        result.add.record(clock.to_ns(t1 - t0));
+
+        live[victim] = { id, target.side };
+    }
+    result.addPerf = addPerf.stop();
+    result.cancelPerf = cancelPerf.stop();
+    return result;
+}
+
+}
+
+void RunDeepBookScenarios(std::size_t samples, std::size_t maxBookOrders) {
+    std::cout << "Deep-book scenarios\n";
+
+    PerfCounts perf;
+    LatencyHistogram latency = RunLevelSweep(std::min(samples, kMaxSweepSamples), perf);
+    PrintLatencyStats("Sweep " + std::to_string(kSweepLevels) + " levels (FillAndKill)", latency, perf);
+    latency = RunFokDeepBook(std::min(samples, kMaxFokSamples), perf);
+    PrintLatencyStats("FillOrKill rejected on " + std::to_string(kDeepLevels) + "-level book", latency, perf);
+    latency = RunCancelMidLevel(samples, perf);
+    PrintLatencyStats("Cancel mid-queue of " + std::to_string(kDeepLevelOrders) + "-order level", latency, perf);
+    latency = RunCrossingModify(samples, perf);
+    PrintLatencyStats("Modify crossing the spread", latency, perf);
+
+    std::vector<std::size_t> sizes;
+    if (maxBookOrders > 1'000'000)
+        sizes.push_back(1'000'000);
+    if (maxBookOrders)
+        sizes.push_back(maxBookOrders);
+
+    for (const std::size_t orders : sizes) {
+        const SteadyResult r = RunSteadyState(orders, samples);
+        std::cout << "[steady-state book, " << orders << " orders, built in "
+                  << r.buildSeconds << " s]\n";
+        PrintLatencyStats("Steady-state AddOrder (" + std::to_string(orders) + ")", r.add, r.addPerf);
+        PrintLatencyStats("Steady-state CancelOrder (" + std::to_string(orders) + ")", r.cancel, r.cancelPerf);
+    }
+    std::cout << "\n";
+}
+
+}
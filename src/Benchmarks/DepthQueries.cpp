@@ -0,0 +1,207 @@
+#include "Benchmarks/DepthQueries.h"
+
+#include "DepthKernels.h"
+#include "DepthLadder.h"
+#include "Orderbook.h"
+#include "TimeUtils.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace benchmarks {
+
+namespace {
+
+constexpr Price kBestAsk = 101;
+constexpr int kPasses = 3;
+
+std::uint64_t NextRandom(std::uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// The ask side as the book used to hold it: ordered levels, totals in a hash map by price.
+struct LevelWalk {
+    std::map<Price, std::uint32_t, std::less<Price>> levels;    // value: order count
+    std::unordered_map<Price, Quantity> totals;
+
+    std::uint64_t DepthTo(Price price) const {
+        std::uint64_t sum = 0;
+        for (const auto& [level, count] : levels) {
+            if (level > price)
+                break;
+            sum += totals.find(level)->second;
+        }
+        return sum;
+    }
+
+    std::size_t LevelsFor(std::uint64_t quantity) const {
+        std::uint64_t sum = 0;
+        std::size_t taken = 0;
+        for (const auto& [level, count] : levels) {
+            if (sum >= quantity)
+                break;
+            sum += totals.find(level)->second;
+            ++taken;
+        }
+        return taken;
+    }
+
+    std::int64_t FillNotional(std::uint64_t quantity) const {
+        std::int64_t notional = 0;
+        for (const auto& [level, count] : levels) {
+            if (quantity == 0)
+                break;
+            const std::uint64_t take = std::min<std::uint64_t>(quantity, totals.find(level)->second);
+            notional += static_cast<std::int64_t>(level) * static_cast<std::int64_t>(take);
+            quantity -= take;
+        }
+        return notional;
+    }
+};
+
+// The same queries as DepthLadder, with the scalar kernels.
+struct ScalarLadder {
+    const DepthLadder* ladder;
+
+    std::uint64_t DepthTo(Price price) const {
+        const Price* prices = ladder->Prices();
+        const std::size_t count = ladder->LevelCount();
+        const auto first = static_cast<std::size_t>(
+            std::lower_bound(prices, prices + count, price, std::greater<Price>{}) - prices);
+        return SumQuantitiesScalar(ladder->Quantities() + first, count - first);
+    }
+
+    std::size_t LevelsFor(std::uint64_t quantity) const {
+        return FindDepthThresholdScalar(ladder->Quantities(), ladder->LevelCount(), quantity).levels_;
+    }
+
+    std::int64_t FillNotional(std::uint64_t quantity) const {
+        const std::size_t count = ladder->LevelCount();
+        const DepthThreshold threshold = FindDepthThresholdScalar(ladder->Quantities(), count, quantity);
+        if (threshold.levels_ == 0)
+            return 0;
+        const std::size_t last = count - threshold.levels_;
+        const std::uint64_t before = threshold.cumulative_ - ladder->Quantities()[last];
+        const std::uint64_t fromLast = std::min<std::uint64_t>(ladder->Quantities()[last], quantity - before);
+        return SumNotionalScalar(ladder->Prices() + last + 1, ladder->Quantities() + last + 1, threshold.levels_ - 1)
+             + static_cast<std::int64_t>(ladder->Prices()[last]) * static_cast<std::int64_t>(fromLast);
+    }
+};
+
+struct BookQueries {
+    const Orderbook* book;
+
+    std::uint64_t DepthTo(Price price) const { return book->DepthTo(Side::Sell, price); }
+    std::size_t LevelsFor(std::uint64_t quantity) const { return book->LevelsToFill(Side::Sell, quantity).levels_; }
+    std::int64_t FillNotional(std::uint64_t quantity) const { return book->EstimateFill(Side::Sell, quantity).notional_; }
+};
+
+struct Query {
+    Price price;
+    std::uint64_t quantity;
+};
+
+struct Timings {
+    double depthNs = 0.0;
+    double levelsNs = 0.0;
+    double vwapNs = 0.0;
+    std::uint64_t check = 0;            // folded results, compared across implementations
+};
+
+template<typename Impl>
+Timings Time(const Impl& impl, const std::vector<Query>& queries) {
+    const auto& clock = ob::time::TscClock::instance();
+    Timings best;
+    for (int pass = 0; pass < kPasses; ++pass) {
+        std::uint64_t check = 0;
+
+        std::uint64_t t0 = clock.start();
+        for (const Query& q : queries)
+            check = check * 31 + impl.DepthTo(q.price);
+        const double depthNs = static_cast<double>(clock.to_ns(clock.stop() - t0));
+
+        t0 = clock.start();
+        for (const Query& q : queries)
+            check = check * 31 + impl.LevelsFor(q.quantity);
+        const double levelsNs = static_cast<double>(clock.to_ns(clock.stop() - t0));
+
+        t0 = clock.start();
+        for (const Query& q : queries)
+            check = check * 31 + static_cast<std::uint64_t>(impl.FillNotional(q.quantity));
+        const double vwapNs = static_cast<double>(clock.to_ns(clock.stop() - t0));
+
+        const double n = static_cast<double>(queries.size());
+        if (pass == 0 || depthNs / n < best.depthNs)
+            best.depthNs = depthNs / n;
+        if (pass == 0 || levelsNs / n < best.levelsNs)
+            best.levelsNs = levelsNs / n;
+        if (pass == 0 || vwapNs / n < best.vwapNs)
+            best.vwapNs = vwapNs / n;
+        best.check = check;
+    }
+    return best;
+}
+
+void PrintTimings(const char* label, const Timings& t, const Timings& walk) {
+    std::cout << "    " << std::left << std::setw(14) << label << std::right << std::fixed << std::setprecision(1)
+              << "depth-to " << std::setw(8) << t.depthNs << " ns"
+              << "   levels-to-fill " << std::setw(8) << t.levelsNs << " ns"
+              << "   vwap " << std::setw(8) << t.vwapNs << " ns"
+              << (t.check == walk.check ? "" : "   (results DIFFER from the walk)") << "\n";
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+void RunLadder(std::size_t levels, std::size_t queryCount) {
+    std::uint64_t rng = 0x9E3779B97F4A7C15ull ^ levels;
+    auto book = std::make_unique<Orderbook>();
+    LevelWalk walk;
+    std::uint64_t total = 0;
+    OrderId nextId = 1;
+    for (std::size_t i = 0; i < levels; ++i) {
+        const auto price = static_cast<Price>(kBestAsk + static_cast<Price>(i));
+        const auto quantity = static_cast<Quantity>(1 + NextRandom(rng) % 100);
+        (void)book->AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, nextId++, Side::Sell, price, quantity));
+        walk.levels.emplace(price, 1);
+        walk.totals.emplace(price, quantity);
+        total += quantity;
+    }
+
+    std::vector<Query> queries(queryCount);
+    for (auto& q : queries) {
+        q.price = static_cast<Price>(kBestAsk + static_cast<Price>(NextRandom(rng) % levels));
+        q.quantity = 1 + NextRandom(rng) % total;
+    }
+
+    const Timings walked = Time(walk, queries);
+    const Timings scalar = Time(ScalarLadder{ &book->GetDepthLadder(Side::Sell) }, queries);
+    const Timings simd = Time(BookQueries{ book.get() }, queries);
+
+    std::cout << "  " << levels << " levels:\n";
+    PrintTimings("map + hash", walked, walked);
+    PrintTimings("ladder scalar", scalar, walked);
+    PrintTimings("ladder kernel", simd, walked);
+}
+
+}
+
+void RunDepthQueryBenchmark(std::size_t queries) {
+    if (queries == 0)
+        return;
+
+    std::cout << "Depth queries: " << queries << " random queries per ladder, kernels built for "
+              << DepthKernelIsa() << ", ns per query\n";
+    for (const std::size_t levels : { 10, 100, 1'000, 10'000 })
+        RunLadder(levels, queries);
+}
+
+}
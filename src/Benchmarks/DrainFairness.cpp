@@ -0,0 +1,136 @@
+#include "Benchmarks/DrainFairness.h"
+
+#include "Backpressure.h"
+#include "CpuTopology.h"
+#include "EngineEvent.h"
+#include "MatchingEngine.h"
+#include "MemoryRegion.h"
+#include "NumaMemory.h"
+#include "OrderRingBuffer.h"
+#include "ProducerChannel.h"
+#include "ThreadPinning.h"
+#include "TimeUtils.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace benchmarks {
+
+namespace {
+
+constexpr std::size_t kChannels = 4;
+constexpr std::size_t kHotChannels = 2;
+constexpr std::size_t kWindow = ((16384 - 1) * 9) / 10;
+constexpr auto kPacedInterval = std::chrono::microseconds(20);
+
+void Push(OrderRingBuffer& ring, Backpressure& credits, EngineEvent ev) {
+    credits.wait_if_needed();
+    while (!ring.push(ev))
+        std::this_thread::yield();
+    credits.increment();
+}
+
+// Adds one resting order and cancels it again, so the book stays tiny and the engine's cost
+// per event is roughly constant over the run.
+void HotLoop(OrderRingBuffer& ring, Backpressure& credits, std::uint32_t producer, std::atomic<bool>& running) {
+    std::uint64_t seq = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        const OrderId id = (static_cast<OrderId>(producer) << 32) | static_cast<OrderId>(++seq);
+        EngineEvent add = EngineEvent::MakeAdd(std::make_shared<Order>(
+            OrderType::GoodTillCancel, id, Side::Buy, Price{100}, Quantity{1}));
+        if ((seq & 15) == 0)
+            add.enqueueNs = ob::time::now_ns();
+        Push(ring, credits, std::move(add));
+        Push(ring, credits, EngineEvent::MakeCancel(id));
+    }
+}
+
+void PacedLoop(OrderRingBuffer& ring, Backpressure& credits, std::uint32_t producer, std::atomic<bool>& running) {
+    std::uint64_t seq = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_for(kPacedInterval);
+        EngineEvent ev = EngineEvent::MakeCancel((static_cast<OrderId>(producer) << 32) | static_cast<OrderId>(++seq));
+        ev.enqueueNs = ob::time::now_ns();
+        Push(ring, credits, std::move(ev));
+    }
+}
+
+void RunConfig(const std::array<std::uint32_t, kChannels>& weights, double seconds, const ThreadPlacement& placement) {
+    std::vector<RegionPtr<OrderRingBuffer>> rings;
+    std::vector<RegionPtr<Backpressure>> credits;
+    std::vector<ProducerChannel> channels;
+    for (std::size_t i = 0; i < kChannels; ++i) {
+        const int node = NumaNodeOfCpu(placement.producerCpus[i]);
+        rings.push_back(MakeRequiredInRegion<OrderRingBuffer>("an order ring", { node, true }));
+        rings.back()->prefault();
+        credits.push_back(MakeRequiredInRegion<Backpressure>("a credit window", { node, false }, kWindow));
+        channels.push_back({ rings.back().get(), credits.back().get(), weights[i] });
+    }
+
+    auto engine = MakeRequiredInRegion<MatchingEngine>("the matching engine",
+                                                       { NumaNodeOfCpu(placement.engineCpu), false },
+                                                       channels, 64, placement.engineCpu);
+    engine->start();
+
+    std::atomic<bool> running{true};
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < kChannels; ++i) {
+        threads.emplace_back([&, i] {
+            PinCurrentThreadToCpu(placement.producerCpus[i]);
+            const auto id = static_cast<std::uint32_t>(i + 1);
+            if (i < kHotChannels)
+                HotLoop(*rings[i], *credits[i], id, running);
+            else
+                PacedLoop(*rings[i], *credits[i], id, running);
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running.store(false, std::memory_order_relaxed);
+    for (auto& t : threads)
+        t.join();
+    engine->stop();
+
+    std::cout << std::left << std::setw(9) << "channel" << std::setw(7) << "load"
+              << std::right << std::setw(7) << "weight" << std::setw(14) << "events/s"
+              << std::setw(12) << "p50 ns" << std::setw(12) << "p99 ns"
+              << std::setw(12) << "p99.99 ns" << std::setw(12) << "max ns" << "\n";
+    for (std::size_t i = 0; i < kChannels; ++i) {
+        const EngineQueueStats q = engine->QueueStats(i);
+        const LatencyHistogram& lat = engine->QueueLatency(i);
+        std::cout << std::left << std::setw(9) << i << std::setw(7) << (i < kHotChannels ? "hot" : "paced")
+                  << std::right << std::setw(7) << q.weight
+                  << std::setw(14) << std::fixed << std::setprecision(0) << (static_cast<double>(q.events) / seconds)
+                  << std::setw(12) << lat.quantile(0.50)
+                  << std::setw(12) << lat.quantile(0.99)
+                  << std::setw(12) << lat.quantile(0.9999)
+                  << std::setw(12) << lat.max() << "\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+}
+
+void RunDrainFairnessBenchmark(double seconds) {
+    const CpuTopology topology = DiscoverCpuTopology();
+    const ThreadPlacement placement = PlanThreadPlacement(topology, kChannels);
+
+    std::cout << "Drain fairness: " << kHotChannels << " unthrottled + " << (kChannels - kHotChannels)
+              << " paced producers (1 event / " << kPacedInterval.count() << " us), "
+              << seconds << " s per configuration\n";
+
+    std::cout << "\nEqual weights\n";
+    RunConfig({ 1, 1, 1, 1 }, seconds, placement);
+
+    std::cout << "\nChannel 1 weighted 3\n";
+    RunConfig({ 1, 3, 1, 1 }, seconds, placement);
+}
+
+}
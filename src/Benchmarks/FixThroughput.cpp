@@ -0,0 +1,223 @@
+#include "Benchmarks/FixThroughput.h"
+
+#include "FixCodec.h"
+#include "FixIngress.h"
+#include "Orderbook.h"
+#include "TimeUtils.h"
+#include "Workload.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace benchmarks {
+
+namespace {
+
+constexpr int kPasses = 3;
+constexpr std::string_view kSymbol = "XYZ";
+constexpr std::string_view kSendingTime = "20240102-09:30:00.000";
+
+enum class Stage {
+    Decode,
+    Map,
+    Apply
+};
+
+struct StageResult {
+    std::uint64_t ns = 0;
+    std::uint64_t messages = 0;
+    std::uint64_t rejected = 0;         // not FixStatus::Ok; should be 0
+    std::uint64_t check = 0;            // keeps the work observable
+};
+
+// One message per workload op. Cancels and replaces carry a fresh ClOrdID and name the
+// order in OrigClOrdID, as a FIX client would.
+std::string MakeFixFile(std::size_t messages) {
+    WorkloadGenerator generator(MakeWorkload(WorkloadPreset::MarketMaker), 1);
+    FixEncoder encoder("CLIENT", "BOOK");
+    encoder.SetSendingTime(kSendingTime);
+    OrderId nextClOrdId = OrderId{ 1 } << 48;
+
+    std::string bytes;
+    bytes.reserve(messages * 128);
+    for (std::size_t i = 0; i < messages; ++i) {
+        const WorkloadOp op = generator.next();
+        switch (op.op) {
+        case OrderOp::Add:
+            bytes += encoder.NewOrderSingle(op.id, op.side, op.type, op.price, op.quantity, kSymbol);
+            break;
+        case OrderOp::Cancel:
+            bytes += encoder.OrderCancelRequest(nextClOrdId++, op.id, op.side, kSymbol);
+            break;
+        case OrderOp::Modify:
+            bytes += encoder.OrderCancelReplaceRequest(nextClOrdId++, op.id, op.side, op.type, op.price,
+                                                       op.quantity, kSymbol);
+            break;
+        }
+    }
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "orderbook_fix_benchmark.fix";
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    std::ifstream in(path, std::ios::binary);
+    std::string file{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    return file;
+}
+
+void Apply(Orderbook& ob, EngineEvent& event) {
+    switch (event.type) {
+    case EngineEventType::Add:
+        (void)ob.AddOrder(std::move(std::get<OrderPointer>(event.payload)));
+        break;
+    case EngineEventType::Cancel:
+        ob.CancelOrder(std::get<OrderId>(event.payload));
+        break;
+    case EngineEventType::Modify:
+        (void)ob.ModifyOrder(std::get<OrderModify>(event.payload));
+        break;
+    case EngineEventType::MassCancel:
+        (void)ob.MassCancel(std::get<MassCancelRequest>(event.payload));
+        break;
+    case EngineEventType::Shutdown:
+        break;
+    }
+}
+
+StageResult RunStage(std::string_view file, Stage stage) {
+    const auto& clock = ob::time::TscClock::instance();
+    const FixDecoder decoder;
+    StageResult result;
+    Orderbook ob;
+    FixMessage message;
+
+    const std::uint64_t t0 = clock.start();
+    std::string_view rest = file;
+    while (!rest.empty()) {
+        const FixDecodeResult decoded = decoder.Decode(rest, message);
+        if (decoded.size_ == 0)
+            break;
+        rest.remove_prefix(decoded.size_);
+        ++result.messages;
+        if (decoded.status_ != FixStatus::Ok) {
+            ++result.rejected;
+            continue;
+        }
+        if (stage == Stage::Decode) {
+            result.check += message.TargetOrderId() + message.quantity_;
+            continue;
+        }
+        EngineEvent event = ToEngineEvent(message);
+        if (stage == Stage::Map)
+            result.check += static_cast<std::uint64_t>(event.type) + event.payload.index();
+        else
+            Apply(ob, event);
+    }
+    result.ns = clock.to_ns(clock.stop() - t0);
+    result.check += ob.Size();
+    return result;
+}
+
+// One ExecutionReport per message: an ack for adds and replaces, a cancel ack for cancels.
+// The reports are built from the decoded file up front; only the encoding is timed.
+std::vector<FixExecutionReport> MakeReports(std::string_view file) {
+    const FixDecoder decoder;
+    FixMessage message;
+    std::vector<FixExecutionReport> reports;
+    std::string_view rest = file;
+    while (!rest.empty()) {
+        const FixDecodeResult decoded = decoder.Decode(rest, message);
+        if (decoded.size_ == 0)
+            break;
+        rest.remove_prefix(decoded.size_);
+
+        FixExecutionReport& report = reports.emplace_back();
+        report.orderId_ = message.TargetOrderId();
+        report.clOrdId_ = message.clOrdId_;
+        report.execId_ = reports.size();
+        report.side_ = message.side_;
+        report.leavesQty_ = message.quantity_;
+        switch (message.type_) {
+        case FixMsgType::OrderCancelRequest:
+            report.execType_ = FixExecType::Canceled;
+            report.ordStatus_ = FixOrdStatus::Canceled;
+            break;
+        case FixMsgType::OrderCancelReplaceRequest:
+            report.execType_ = FixExecType::Replaced;
+            break;
+        default:
+            break;
+        }
+    }
+    return reports;
+}
+
+StageResult RunEncode(const std::vector<FixExecutionReport>& reports) {
+    const auto& clock = ob::time::TscClock::instance();
+    FixEncoder encoder("BOOK", "CLIENT");
+    encoder.SetSendingTime(kSendingTime);
+    StageResult result;
+
+    const std::uint64_t t0 = clock.start();
+    for (const FixExecutionReport& report : reports)
+        result.check += encoder.ExecutionReport(report, kSymbol).size();
+    result.ns = clock.to_ns(clock.stop() - t0);
+    result.messages = reports.size();
+    return result;
+}
+
+void PrintStage(const char* label, const StageResult& r) {
+    const double seconds = static_cast<double>(r.ns) / 1e9;
+    std::cout << "  " << std::left << std::setw(30) << label << std::right << std::fixed << std::setprecision(0)
+              << std::setw(12) << (seconds > 0.0 ? static_cast<double>(r.messages) / seconds : 0.0) << " msgs/s"
+              << std::setprecision(1) << std::setw(10)
+              << (r.messages ? static_cast<double>(r.ns) / static_cast<double>(r.messages) : 0.0) << " ns/msg";
+    std::cout.unsetf(std::ios::floatfield);
+    if (r.rejected)
+        std::cout << "  (" << r.rejected << " not decoded)";
+    std::cout << "\n";
+}
+
+}
+
+void RunFixCodecBenchmark(std::size_t messages) {
+    if (messages == 0)
+        return;
+
+    const std::string file = MakeFixFile(messages);
+    const std::vector<FixExecutionReport> reports = MakeReports(file);
+    std::cout << "FIX 4.4 codec: " << messages << " MarketMaker messages (D/F/G), " << file.size() << " bytes, "
+              << std::fixed << std::setprecision(1) << static_cast<double>(file.size()) / static_cast<double>(messages)
+              << " bytes/msg, one core\n";
+    std::cout.unsetf(std::ios::floatfield);
+
+    StageResult decode, map, apply, encode;
+    auto keepFastest = [](StageResult& best, const StageResult& run, int pass) {
+        if (pass == 0 || run.ns < best.ns)
+            best = run;
+    };
+    for (int pass = 0; pass < kPasses; ++pass) {
+        keepFastest(decode, RunStage(file, Stage::Decode), pass);
+        keepFastest(map, RunStage(file, Stage::Map), pass);
+        keepFastest(apply, RunStage(file, Stage::Apply), pass);
+        keepFastest(encode, RunEncode(reports), pass);
+    }
+
+    PrintStage("Decode", decode);
+    PrintStage("Decode + EngineEvent", map);
+    PrintStage("Decode + EngineEvent + book", apply);
+    PrintStage("Encode ExecutionReport", encode);
+}
+
+}
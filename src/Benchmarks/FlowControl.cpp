@@ -0,0 +1,198 @@
+#include "Benchmarks/FlowControl.h"
+
+#include "Backpressure.h"
+#include "CpuTopology.h"
+#include "EngineEvent.h"
+#include "MemoryRegion.h"
+#include "NumaMemory.h"
+#include "OrderRingBuffer.h"
+#include "ThreadPinning.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace benchmarks {
+
+namespace {
+
+constexpr std::size_t kRingCapacity = 16384 - 1;
+constexpr std::size_t kWindowPerProducer = (kRingCapacity * 9) / 10;
+constexpr std::uint32_t kBurst = 64;
+
+// The pre-credit design, kept as the baseline: one counter for every producer, incremented
+// per message by producers and decremented per message by the consumer.
+struct SharedCounterBackpressure {
+    std::atomic<size_t> count{0};
+    size_t limit;
+
+    explicit SharedCounterBackpressure(size_t l) : limit(l) {}
+
+    void wait_if_needed() {
+        uint32_t spins = 0;
+        while (count.load(std::memory_order_acquire) >= limit) {
+            if (spins < 128) {
+                ++spins;
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+            } else {
+                spins = 0;
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void increment() { count.fetch_add(1, std::memory_order_acq_rel); }
+    void decrement() { count.fetch_sub(1, std::memory_order_acq_rel); }
+};
+
+struct SharedPolicy {
+    explicit SharedPolicy(std::size_t producers)
+        : counter(kWindowPerProducer * producers) {}
+
+    SharedCounterBackpressure& producer(std::size_t) { return counter; }
+    void consumed(std::size_t) { counter.decrement(); }
+    void burst_done(std::size_t) {}
+
+    SharedCounterBackpressure counter;
+};
+
+struct CreditPolicy {
+    explicit CreditPolicy(std::size_t producers) {
+        credits.reserve(producers);
+        for (std::size_t i = 0; i < producers; ++i)
+            credits.push_back(MakeRequiredInRegion<Backpressure>("a credit window", {}, kWindowPerProducer));
+    }
+
+    Backpressure& producer(std::size_t i) { return *credits[i]; }
+    void consumed(std::size_t i) { credits[i]->decrement(); }
+    void burst_done(std::size_t i) { credits[i]->flush(); }
+
+    std::vector<RegionPtr<Backpressure>> credits;
+};
+
+struct PointResult {
+    double producedPerSec = 0.0;
+    double consumedPerSec = 0.0;
+};
+
+template<typename Policy>
+PointResult RunPoint(std::size_t producers, double seconds, const ThreadPlacement& placement) {
+    std::vector<RegionPtr<OrderRingBuffer>> rings;
+    rings.reserve(producers);
+    for (std::size_t i = 0; i < producers; ++i) {
+        rings.push_back(MakeRequiredInRegion<OrderRingBuffer>("an order ring", { NumaNodeOfCpu(placement.producerCpus[i]), true }));
+        rings.back()->prefault();
+    }
+
+    Policy policy(producers);
+    std::atomic<bool> producing{true};
+    std::atomic<bool> consuming{true};
+    std::atomic<std::size_t> ready{0};
+
+    struct alignas(64) Counter { std::uint64_t value = 0; };
+    std::vector<Counter> produced(producers);
+    std::uint64_t consumed = 0;
+
+    std::thread consumer([&] {
+        PinCurrentThreadToCpu(placement.engineCpu);
+        EngineEvent ev;
+        std::size_t index = 0;
+        while (consuming.load(std::memory_order_acquire)) {
+            std::uint32_t n = 0;
+            while (n < kBurst && rings[index]->pop(ev)) {
+                ++n;
+                policy.consumed(index);
+            }
+            policy.burst_done(index);
+            consumed += n;
+            if (n == 0)
+                std::this_thread::yield();
+            index = index + 1 == producers ? 0 : index + 1;
+        }
+    });
+
+    std::vector<std::thread> threads;
+    threads.reserve(producers);
+    for (std::size_t i = 0; i < producers; ++i) {
+        threads.emplace_back([&, i] {
+            PinCurrentThreadToCpu(placement.producerCpus[i]);
+            auto& bp = policy.producer(i);
+            auto& ring = *rings[i];
+            std::uint64_t n = 0;
+            ready.fetch_add(1, std::memory_order_acq_rel);
+            while (ready.load(std::memory_order_acquire) < producers)
+                std::this_thread::yield();
+            while (producing.load(std::memory_order_relaxed)) {
+                EngineEvent ev = EngineEvent::MakeCancel(static_cast<OrderId>(n));
+                bp.wait_if_needed();
+                while (!ring.push(ev)) {
+                    if (!producing.load(std::memory_order_relaxed))
+                        break;
+                    std::this_thread::yield();
+                }
+                bp.increment();
+                ++n;
+            }
+            produced[i].value = n;
+        });
+    }
+
+    while (ready.load(std::memory_order_acquire) < producers)
+        std::this_thread::yield();
+    const auto t0 = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    producing.store(false, std::memory_order_release);
+    for (auto& t : threads)
+        t.join();
+    const auto t1 = std::chrono::steady_clock::now();
+
+    consuming.store(false, std::memory_order_release);
+    consumer.join();
+
+    const double elapsed = std::chrono::duration<double>(t1 - t0).count();
+    PointResult r;
+    std::uint64_t total = 0;
+    for (const auto& c : produced)
+        total += c.value;
+    r.producedPerSec = elapsed > 0.0 ? static_cast<double>(total) / elapsed : 0.0;
+    r.consumedPerSec = elapsed > 0.0 ? static_cast<double>(consumed) / elapsed : 0.0;
+    return r;
+}
+
+}
+
+void RunFlowControlScaling(std::size_t maxProducers, double seconds) {
+    if (maxProducers == 0)
+        maxProducers = 1;
+
+    const CpuTopology topology = DiscoverCpuTopology();
+    const ThreadPlacement placement = PlanThreadPlacement(topology, maxProducers);
+    PrintThreadPlacement(std::cout, topology, placement);
+
+    std::cout << "\nFlow control scaling: " << seconds << " s per point, window "
+              << kWindowPerProducer << " events per producer\n";
+    std::cout << std::left << std::setw(10) << "producers"
+              << std::right << std::setw(18) << "shared ev/s"
+              << std::setw(18) << "credits ev/s"
+              << std::setw(10) << "ratio" << "\n";
+
+    for (std::size_t p = 1; p <= maxProducers; ++p) {
+        const PointResult shared = RunPoint<SharedPolicy>(p, seconds, placement);
+        const PointResult credits = RunPoint<CreditPolicy>(p, seconds, placement);
+
+        std::cout << std::left << std::setw(10) << p
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(18) << shared.producedPerSec
+                  << std::setw(18) << credits.producedPerSec
+                  << std::setprecision(2)
+                  << std::setw(10) << (shared.producedPerSec > 0.0 ? credits.producedPerSec / shared.producedPerSec : 0.0)
+                  << "\n";
+    }
+    std::cout << "\n";
+}
+
+}
@@ -0,0 +1,123 @@
+#include "Benchmarks/HugePageTlb.h"
+
+#include "Benchmarks/BenchPrinter.h"
+#include "Benchmarks/Percentiles.h"
+#include "Benchmarks/PerfCounters.h"
+
+#include "MemoryRegion.h"
+#include "Orderbook.h"
+#include "TimeUtils.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace benchmarks {
+
+namespace {
+
+constexpr std::size_t kLevelsPerSide = 10'000;
+constexpr std::size_t kArenaChunkBytes = 64 * kHugePageSize;
+
+struct TlbResult {
+    LatencyPercentilesNs latency;
+    std::uint64_t loadMisses = 0;
+    std::uint64_t storeMisses = 0;
+    bool countersValid = false;
+    PageBacking backing = PageBacking::Base;
+    std::size_t arenaBytes = 0;
+};
+
+std::uint64_t NextRandom(std::uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+TlbResult RunOnce(std::size_t bookOrders, std::size_t probes, bool hugePages) {
+    TlbResult result;
+    RegionArena arena(kArenaChunkBytes, { -1, hugePages });
+    ArenaAllocator<Order> alloc(arena);
+
+    {
+        Orderbook ob;
+
+        // Bids at 1..L and asks at L+1..2L never cross, so every order rests.
+        for (std::size_t i = 0; i < bookOrders; ++i) {
+            const bool buy = (i & 1) == 0;
+            const std::size_t level = (i >> 1) % kLevelsPerSide;
+            const Price price = buy ? static_cast<Price>(1 + level)
+                                    : static_cast<Price>(kLevelsPerSide + 1 + level);
+
+            Order* raw = alloc.allocate(1);
+            new (raw) Order(OrderType::GoodTillCancel, OrderId{i + 1}, buy ? Side::Buy : Side::Sell, price, Quantity{1});
+            (void)ob.AddOrder(OrderPointer(raw, [](Order* p) { p->~Order(); }, alloc));
+        }
+
+        std::vector<OrderId> ids;
+        ids.reserve(probes);
+        std::uint64_t rng = 0x9E3779B97F4A7C15ull;
+        for (std::size_t i = 0; i < probes; ++i)
+            ids.push_back(OrderId{1 + NextRandom(rng) % bookOrders});
+
+        const auto& clock = ob::time::TscClock::instance();
+
+        LatencyHistogram samples;
+
+        PerfCounter loads(PerfEvent::DTlbLoadMisses);
+        PerfCounter stores(PerfEvent::DTlbStoreMisses);
+        result.countersValid = loads.valid() && stores.valid();
+
+        loads.start();
+        stores.start();
+        for (std::size_t i = 0; i < probes; ++i) {
+            const std::uint64_t t0 = clock.start();
+            ob.CancelOrder(ids[i]);
+            const std::uint64_t t1 = clock.stop();
+            samples.record(clock.to_ns(t1 - t0));
+        }
+        result.loadMisses = loads.stop();
+        result.storeMisses = stores.stop();
+
+        result.latency = ComputeLatencyPercentilesNs(samples);
+    }
+
+    result.backing = arena.backing();
+    result.arenaBytes = arena.reservedBytes();
+    return result;
+}
+
+void Report(const char* label, const TlbResult& r, std::size_t probes) {
+    std::cout << label << ": order arena " << (r.arenaBytes >> 20) << " MB on " << ToString(r.backing) << "\n";
+    PrintLatencyStats(std::string("  Random CancelOrder (") + label + ")", r.latency);
+    if (r.countersValid && probes) {
+        std::cout << "  dTLB misses/op: load=" << static_cast<double>(r.loadMisses) / static_cast<double>(probes)
+                  << " store=" << static_cast<double>(r.storeMisses) / static_cast<double>(probes) << "\n";
+    } else {
+        std::cout << "  dTLB misses/op: n/a (perf_event_open not permitted)\n";
+    }
+}
+
+}
+
+void RunHugePageTlbBenchmark(std::size_t bookOrders, std::size_t probes) {
+    if (probes > bookOrders)
+        probes = bookOrders;
+
+    std::cout << "Huge-page dTLB benchmark: " << bookOrders << " resting orders over "
+              << kLevelsPerSide << " levels/side, " << probes << " random cancels\n";
+    std::cout << "(Orders and control blocks come from the arena; book containers use the heap. "
+                 "Run with GLIBC_TUNABLES=glibc.malloc.hugetlb=1 to put those on THP as well.)\n";
+
+    const TlbResult base = RunOnce(bookOrders, probes, false);
+    Report("base pages", base, probes);
+
+    const TlbResult huge = RunOnce(bookOrders, probes, true);
+    Report("huge pages", huge, probes);
+    std::cout << "\n";
+}
+
+}
@@ -0,0 +1,277 @@
+#include "Benchmarks/IpcIngress.h"
+
+#include "Benchmarks/BenchPrinter.h"
+#include "Benchmarks/Percentiles.h"
+
+#include "CpuTopology.h"
+#include "LatencyHistogram.h"
+#include "MatchingEngine.h"
+#include "ShmIngress.h"
+#include "ThreadPinning.h"
+#include "TimeUtils.h"
+#include "WaitStrategy.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace benchmarks {
+
+namespace {
+
+constexpr std::uint64_t kSampleEvery = 64;
+constexpr auto kAttachTimeout = std::chrono::seconds(5);
+constexpr auto kRunTimeout = std::chrono::seconds(120);
+
+// Both sides poll with yields: the two may share a core.
+const WaitStrategy kWait(WaitStrategyKind::SpinYield);
+
+// Start gate between the parent and a gateway, in MAP_SHARED memory so that a forked child
+// sees the parent's stores.
+struct Gate {
+    static constexpr std::uint32_t Wait = 0;
+    static constexpr std::uint32_t Run = 1;
+    static constexpr std::uint32_t Abort = 2;
+
+    std::atomic<std::uint32_t> go{Wait};
+    std::atomic<std::uint64_t> startNs{0};
+};
+
+Gate* MapGate() {
+    void* p = mmap(nullptr, sizeof(Gate), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? nullptr : new (p) Gate();
+}
+
+std::string SegmentPrefix(const char* part) {
+    return "ob-bench-" + std::to_string(getpid()) + "-" + part;
+}
+
+// Echo side of the round trip. Attaches by name rather than using inherited mappings, so in
+// the child the rings sit at different addresses than in the parent.
+void Echo(const std::string& pingName, const std::string& pongName, int cpu) {
+    PinCurrentThreadToCpu(cpu);
+    IngressRing ping = IngressRing::Attach(pingName);
+    IngressRing pong = IngressRing::Attach(pongName);
+    if (!ping.valid() || !pong.valid())
+        return;
+
+    WireEvent ev;
+    for (;;) {
+        std::uint32_t spins = 0;
+        while (!ping.ring().pop(ev))
+            kWait.idle(spins);
+        while (!pong.ring().push(ev))
+            kWait.idle(spins);
+        if (ev.type == EngineEventType::Shutdown)
+            return;
+    }
+}
+
+LatencyHistogram PingPong(IngressRing& ping, IngressRing& pong, std::size_t samples, int cpu) {
+    PinCurrentThreadToCpu(cpu);
+    const auto& clock = ob::time::TscClock::instance();
+    LatencyHistogram rtt;
+
+    WireEvent ev = WireEvent::MakeCancel(0);
+    WireEvent back;
+    for (std::size_t i = 0; i < samples; ++i) {
+        ev.orderId = i;
+        std::uint32_t spins = 0;
+        const std::uint64_t t0 = clock.start();
+        while (!ping.ring().push(ev))
+            kWait.idle(spins);
+        while (!pong.ring().pop(back))
+            kWait.idle(spins);
+        const std::uint64_t t1 = clock.stop();
+        rtt.record(clock.to_ns(t1 - t0));
+    }
+
+    WireEvent stop;
+    stop.type = EngineEventType::Shutdown;
+    std::uint32_t spins = 0;
+    while (!ping.ring().push(stop))
+        kWait.idle(spins);
+    while (!pong.ring().pop(back))
+        kWait.idle(spins);
+    return rtt;
+}
+
+void RunRoundTrip(bool crossProcess, std::size_t samples, const ThreadPlacement& placement) {
+    const std::string prefix = SegmentPrefix(crossProcess ? "rtt-proc" : "rtt-thread");
+    const std::string pingName = IngressSegmentName(prefix, 0);
+    const std::string pongName = IngressSegmentName(prefix, 1);
+    IngressRing ping = IngressRing::Create(pingName, 0);
+    IngressRing pong = IngressRing::Create(pongName, 1);
+    if (!ping.valid() || !pong.valid()) {
+        std::cout << "Ingress round trip: cannot create /dev/shm segments, skipped\n";
+        return;
+    }
+
+    const int echoCpu = placement.producerCpus.empty() ? -1 : placement.producerCpus[0];
+    LatencyHistogram rtt;
+    if (crossProcess) {
+        const pid_t child = fork();
+        if (child < 0) {
+            std::cout << "Ingress round trip, process: fork failed, skipped\n";
+            return;
+        }
+        if (child == 0) {
+            Echo(pingName, pongName, echoCpu);
+            _exit(0);
+        }
+        rtt = PingPong(ping, pong, samples, placement.engineCpu);
+        waitpid(child, nullptr, 0);
+    } else {
+        std::thread echo(Echo, pingName, pongName, echoCpu);
+        rtt = PingPong(ping, pong, samples, placement.engineCpu);
+        echo.join();
+    }
+
+    PrintLatencyStats(crossProcess ? "Ingress round trip, process" : "Ingress round trip, thread",
+                      ComputeLatencyPercentilesNs(rtt));
+}
+
+// Adds a resting bid, then cancels it: the book stays small and every event does book work.
+void Gateway(const std::string& name, std::size_t events, Gate& gate, int cpu) {
+    PinCurrentThreadToCpu(cpu);
+    IngressRing ring = IngressRing::Create(name, 1);
+    if (!ring.valid())
+        return;
+
+    std::uint32_t spins = 0;
+    std::uint32_t go = Gate::Wait;
+    while ((go = gate.go.load(std::memory_order_acquire)) == Gate::Wait)
+        kWait.idle(spins);
+    if (go == Gate::Abort) {
+        ring.close();
+        return;
+    }
+    gate.startNs.store(ob::time::steady_now_ns(), std::memory_order_release);
+
+    const OrderId base = OrderId{1} << 32;
+    for (std::size_t i = 0; i < events; ++i) {
+        const OrderId id = base | (i & ~std::size_t{1});
+        WireEvent ev = (i & 1)
+            ? WireEvent::MakeCancel(id)
+            : WireEvent::MakeAdd(OrderType::GoodTillCancel, id, Side::Buy, Price{100 - static_cast<Price>(i % 50)}, Quantity{1});
+        if (i % kSampleEvery == 0)
+            ev.enqueueNs = ob::time::steady_now_ns();
+        spins = 0;
+        while (!ring.ring().push(ev))
+            kWait.idle(spins);
+    }
+    ring.close();
+}
+
+void RunEngineIngress(bool crossProcess, std::size_t events, const ThreadPlacement& placement) {
+    const char* label = crossProcess ? "Engine ingress, process gateway" : "Engine ingress, thread gateway";
+    const std::string prefix = SegmentPrefix(crossProcess ? "eng-proc" : "eng-thread");
+    const std::string name = IngressSegmentName(prefix, 1);
+    const int gatewayCpu = placement.producerCpus.empty() ? -1 : placement.producerCpus[0];
+
+    Gate* gate = MapGate();
+    if (!gate) {
+        std::cout << label << ": cannot map the start gate, skipped\n";
+        return;
+    }
+
+    // Fork before the engine's threads exist: the child must not inherit a lock one of
+    // them holds.
+    pid_t child = -1;
+    std::thread gatewayThread;
+    if (crossProcess) {
+        child = fork();
+        if (child < 0) {
+            std::cout << label << ": fork failed, skipped\n";
+            munmap(gate, sizeof(Gate));
+            return;
+        }
+        if (child == 0) {
+            Gateway(name, events, *gate, gatewayCpu);
+            _exit(0);
+        }
+    } else {
+        gatewayThread = std::thread(Gateway, name, events, std::ref(*gate), gatewayCpu);
+    }
+
+    std::vector<ProducerChannel> noChannels;
+    MatchingEngine engine(noChannels, 64, placement.engineCpu, kWait);
+    engine.EnableIngress(prefix);
+    engine.start();
+    const EngineTelemetry& stats = engine.Telemetry().engine();
+
+    // Measure from the first push, not from discovery (up to IngressScanIntervalMs).
+    const auto deadline = std::chrono::steady_clock::now() + kAttachTimeout;
+    bool attached = false;
+    while (!(attached = stats.ingressRings.load(std::memory_order_relaxed) > 0)
+           && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    std::uint64_t endNs = 0;
+    bool finished = false;
+    if (attached) {
+        gate->go.store(Gate::Run, std::memory_order_release);
+        const auto runDeadline = std::chrono::steady_clock::now() + kRunTimeout;
+        while (!(finished = stats.ingressEvents.load(std::memory_order_relaxed) >= events)
+               && std::chrono::steady_clock::now() < runDeadline)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        endNs = ob::time::steady_now_ns();
+        if (!finished)
+            std::cout << label << ": engine took only " << stats.ingressEvents.load(std::memory_order_relaxed)
+                      << " of " << events << " events, skipped\n";
+    } else {
+        std::cout << label << ": engine did not attach the ring, skipped\n";
+        gate->go.store(Gate::Abort, std::memory_order_release);
+    }
+    // A gateway that cannot finish would block on its full ring forever.
+    if (!finished && child > 0)
+        kill(child, SIGKILL);
+
+    if (gatewayThread.joinable())
+        gatewayThread.join();
+    if (child > 0)
+        waitpid(child, nullptr, 0);
+    engine.stop();
+
+    if (finished) {
+        const std::uint64_t startNs = gate->startNs.load(std::memory_order_acquire);
+        const double seconds = endNs > startNs ? static_cast<double>(endNs - startNs) / 1e9 : 0.0;
+        PrintLatencyStats(std::string(label) + " enqueue->dequeue", ComputeLatencyPercentilesNs(stats.ingressLatency));
+        std::cout << "  events/s: " << std::fixed << std::setprecision(0)
+                  << (seconds > 0.0 ? static_cast<double>(events) / seconds : 0.0) << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+    }
+    munmap(gate, sizeof(Gate));
+}
+
+}
+
+void RunIpcIngressBenchmark(std::size_t samples) {
+    if (samples == 0)
+        return;
+
+    const CpuTopology topology = DiscoverCpuTopology();
+    const ThreadPlacement placement = PlanThreadPlacement(topology, 1);
+
+    std::cout << "Shared-memory ingress: " << samples << " samples, " << sizeof(WireEvent)
+              << "-byte WireEvent, " << sizeof(IngressSegment) << "-byte ring segment\n";
+
+    RunRoundTrip(false, samples, placement);
+    RunRoundTrip(true, samples, placement);
+    RunEngineIngress(false, samples, placement);
+    RunEngineIngress(true, samples, placement);
+}
+
+}
@@ -0,0 +1,180 @@
+#include "Benchmarks/L2Feed.h"
+
+#include "Benchmarks/BenchPrinter.h"
+#include "Benchmarks/Percentiles.h"
+
+#include "L2Book.h"
+#include "LatencyHistogram.h"
+#include "LevelDeltaFeed.h"
+#include "Orderbook.h"
+#include "TimeUtils.h"
+#include "Workload.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace benchmarks {
+
+namespace {
+
+constexpr std::size_t kBurst = 64;      // MatchingEngine's default burstSize
+constexpr int kPasses = 3;              // modes are interleaved; each keeps its fastest pass
+
+enum class FeedMode {
+    None,
+    Deltas,
+    Conflated,
+    Snapshot
+};
+
+struct ModeResult {
+    LatencyHistogram burstNs;
+    std::uint64_t totalNs = 0;
+    std::uint64_t records = 0;          // deltas, or levels in the snapshots
+    std::uint64_t dropped = 0;
+    bool rebuilt = true;                // L2Book matches the book at the end
+};
+
+std::vector<WorkloadOp> MakeOps(std::size_t events) {
+    WorkloadGenerator generator(MakeWorkload(WorkloadPreset::MarketMaker), 1);
+    std::vector<WorkloadOp> ops(events);
+    for (auto& op : ops)
+        op = generator.next();
+    return ops;
+}
+
+bool SameLevels(const LevelInfos& a, const LevelInfos& b) {
+    if (a.size() != b.size())
+        return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i].price_ != b[i].price_ || a[i].quantity_ != b[i].quantity_)
+            return false;
+    }
+    return true;
+}
+
+ModeResult RunMode(const std::vector<WorkloadOp>& ops, FeedMode mode, std::size_t depth) {
+    const auto& clock = ob::time::TscClock::instance();
+    ModeResult result;
+    Orderbook ob;
+
+    // Orders are built untimed: in the engine they arrive ready-made from the producers.
+    std::vector<OrderPointer> orders(ops.size());
+    for (std::size_t i = 0; i < ops.size(); ++i) {
+        if (ops[i].op == OrderOp::Add)
+            orders[i] = std::make_shared<Order>(ops[i].type, ops[i].id, ops[i].side, ops[i].price, ops[i].quantity);
+    }
+
+    std::unique_ptr<LevelDeltaFeed> feed;
+    if (mode == FeedMode::Deltas || mode == FeedMode::Conflated) {
+        feed = std::make_unique<LevelDeltaFeed>(mode == FeedMode::Conflated);
+        ob.SetLevelDeltaSink(feed->pending());
+    }
+    L2Book book;
+    std::size_t snapshotLevels = 0;
+
+    for (std::size_t begin = 0; begin < ops.size(); begin += kBurst) {
+        const std::size_t end = std::min(ops.size(), begin + kBurst);
+
+        const std::uint64_t t0 = clock.start();
+        for (std::size_t i = begin; i < end; ++i) {
+            const WorkloadOp& op = ops[i];
+            switch (op.op) {
+            case OrderOp::Add:
+                (void)ob.AddOrder(std::move(orders[i]));
+                break;
+            case OrderOp::Cancel:
+                ob.CancelOrder(op.id);
+                break;
+            case OrderOp::Modify:
+                (void)ob.ModifyOrder(OrderModify{ op.id, op.side, op.price, op.quantity });
+                break;
+            }
+        }
+        if (feed) {
+            feed->publish();
+        } else if (mode == FeedMode::Snapshot) {
+            const OrderbookLevelInfos snapshot = ob.GetOrderInfos(depth);
+            snapshotLevels += snapshot.GetBids().size() + snapshot.GetAsks().size();
+        }
+        const std::uint64_t t1 = clock.stop();
+
+        const std::uint64_t ns = clock.to_ns(t1 - t0);
+        result.burstNs.record(ns);
+        result.totalNs += ns;
+
+        if (feed) {
+            LevelDelta delta;
+            while (feed->pop(delta))
+                book.Apply(delta);
+        }
+    }
+
+    if (feed) {
+        result.records = feed->published();
+        result.dropped = feed->dropped();
+        const OrderbookLevelInfos expected = ob.GetOrderInfos();
+        const OrderbookLevelInfos rebuilt = book.GetOrderInfos();
+        result.rebuilt = book.Gaps() == 0
+            && SameLevels(expected.GetBids(), rebuilt.GetBids())
+            && SameLevels(expected.GetAsks(), rebuilt.GetAsks());
+    } else {
+        result.records = snapshotLevels;
+    }
+    return result;
+}
+
+void PrintMode(const std::string& label, const ModeResult& r, const ModeResult& baseline,
+               std::size_t events, std::size_t recordBytes, bool feed) {
+    const double perEvent = static_cast<double>(r.totalNs) / static_cast<double>(events);
+    const double basePerEvent = static_cast<double>(baseline.totalNs) / static_cast<double>(events);
+    const double bursts = static_cast<double>((events + kBurst - 1) / kBurst);
+
+    PrintLatencyStats(label + ", per burst", ComputeLatencyPercentilesNs(r.burstNs));
+    std::cout << std::fixed << std::setprecision(2)
+              << "  ns/event: " << perEvent
+              << " (" << std::showpos << (perEvent - basePerEvent) << std::noshowpos << " vs no market data)"
+              << "  records/burst: " << static_cast<double>(r.records) / bursts
+              << "  bytes/burst: " << static_cast<double>(r.records * recordBytes) / bursts
+              << "\n";
+    std::cout.unsetf(std::ios::floatfield);
+    if (feed)
+        std::cout << "  dropped: " << r.dropped << "  rebuilt L2 matches book: " << (r.rebuilt ? "yes" : "NO") << "\n";
+}
+
+}
+
+void RunL2FeedBenchmark(std::size_t events) {
+    if (events == 0)
+        return;
+
+    const std::vector<WorkloadOp> ops = MakeOps(events);
+    std::cout << "L2 market data: " << events << " MarketMaker events in bursts of " << kBurst
+              << ", " << sizeof(LevelDelta) << "-byte LevelDelta\n";
+
+    ModeResult none, deltas, conflated, top5, top20;
+    auto keepFastest = [](ModeResult& best, ModeResult run, int pass) {
+        if (pass == 0 || run.totalNs < best.totalNs)
+            best = std::move(run);
+    };
+    for (int pass = 0; pass < kPasses; ++pass) {
+        keepFastest(none, RunMode(ops, FeedMode::None, 0), pass);
+        keepFastest(deltas, RunMode(ops, FeedMode::Deltas, 0), pass);
+        keepFastest(conflated, RunMode(ops, FeedMode::Conflated, 0), pass);
+        keepFastest(top5, RunMode(ops, FeedMode::Snapshot, 5), pass);
+        keepFastest(top20, RunMode(ops, FeedMode::Snapshot, 20), pass);
+    }
+
+    PrintMode("No market data", none, none, events, 0, false);
+    PrintMode("Level deltas", deltas, none, events, sizeof(LevelDelta), true);
+    PrintMode("Level deltas, conflated", conflated, none, events, sizeof(LevelDelta), true);
+    PrintMode("Top-5 snapshot", top5, none, events, sizeof(LevelInfo), false);
+    PrintMode("Top-20 snapshot", top20, none, events, sizeof(LevelInfo), false);
+}
+
+}
@@ -0,0 +1,134 @@
+#include "Benchmarks/NumaPlacement.h"
+
+#include "Benchmarks/BenchPrinter.h"
+#include "Benchmarks/Percentiles.h"
+
+#include "EngineEvent.h"
+#include "MemoryRegion.h"
+#include "NumaMemory.h"
+#include "OrderRingBuffer.h"
+#include "Orderbook.h"
+#include "ThreadPinning.h"
+#include "TimeUtils.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace benchmarks {
+
+namespace {
+
+int CurrentCpu() {
+#if defined(__linux__)
+    return ::sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+LatencyPercentilesNs RunRingRoundTrip(std::size_t iterations, int node) {
+    auto q = MakeRequiredInRegion<OrderRingBuffer>("an order ring", { node, false });
+    q->prefault();
+
+    const auto& clock = ob::time::TscClock::instance();
+
+    LatencyHistogram samples;
+
+    EngineEvent ev = EngineEvent::MakeCancel(OrderId{1});
+    EngineEvent out;
+
+    for (std::size_t i = 0; i < iterations; ++i) {
+        ev = EngineEvent::MakeCancel(static_cast<OrderId>(i));
+
+        const std::uint64_t t0 = clock.start();
+        while (!q->push(ev)) {
+        }
+        while (!q->pop(out)) {
+        }
+        const std::uint64_t t1 = clock.stop();
+
+        samples.record(clock.to_ns(t1 - t0));
+    }
+
+    return ComputeLatencyPercentilesNs(samples);
+}
+
+// The book and its orders are allocated while the thread prefers `node`, so map/hash nodes
+// and control blocks land there; the histogram lives on the stack, on the local node.
+LatencyPercentilesNs RunOrderbookAdd(std::size_t iterations, int node) {
+    const auto& clock = ob::time::TscClock::instance();
+    LatencyHistogram samples;
+
+    PreferNumaNodeForCurrentThread(node);
+    {
+        auto ob = MakeRequiredInRegion<Orderbook>("the order book", { node, false });
+
+        std::vector<OrderPointer> orders;
+        orders.reserve(iterations);
+        for (std::size_t i = 0; i < iterations; ++i) {
+            orders.push_back(std::make_shared<Order>(OrderType::GoodTillCancel,
+                                                     OrderId{i + 1},
+                                                     (i & 1) ? Side::Buy : Side::Sell,
+                                                     (i & 1) ? Price{100 - static_cast<Price>(i % 50)}
+                                                             : Price{101 + static_cast<Price>(i % 50)},
+                                                     Quantity{1}));
+        }
+
+        for (std::size_t i = 0; i < iterations; ++i) {
+            const std::uint64_t t0 = clock.start();
+            (void)ob->AddOrder(orders[i]);
+            const std::uint64_t t1 = clock.stop();
+
+            samples.record(clock.to_ns(t1 - t0));
+        }
+    }
+    PreferNumaNodeForCurrentThread(-1);
+
+    return ComputeLatencyPercentilesNs(samples);
+}
+
+void RunAt(std::size_t iterations, const char* label, int node) {
+    std::cout << "[" << label << ", memory on node " << node << "]\n";
+    PrintLatencyStats(std::string("SPSC push+pop round-trip (") + label + ")", RunRingRoundTrip(iterations, node));
+    PrintLatencyStats(std::string("Orderbook AddOrder (") + label + ")", RunOrderbookAdd(iterations, node));
+}
+
+}
+
+void RunNumaPlacementBenchmarks(std::size_t iterations, NumaMode mode) {
+    if (mode == NumaMode::Off)
+        return;
+
+    // Stay on one cpu so "local" keeps meaning the same node for the whole run.
+    const int cpu = CurrentCpu();
+    PinCurrentThreadToCpu(cpu);
+
+    const int nodes = NumaNodeCount();
+    const int localNode = CurrentNumaNode();
+    const int remoteNode = (nodes > 1 && localNode >= 0) ? (localNode + 1) % nodes : -1;
+
+    std::cout << "NUMA placement benchmark\n";
+    std::cout << "Benchmark cpu: " << cpu << ", local node: " << localNode
+              << ", nodes: " << nodes
+              << ", binding: " << (NumaAvailable() ? "mbind" : "unavailable (first-touch only)") << "\n";
+
+    if (mode == NumaMode::Local || mode == NumaMode::Compare)
+        RunAt(iterations, "local", localNode);
+
+    if (mode == NumaMode::Remote || mode == NumaMode::Compare) {
+        if (remoteNode < 0 || !NumaAvailable())
+            std::cout << "Remote placement skipped: needs at least two NUMA nodes and mbind support\n";
+        else
+            RunAt(iterations, "remote", remoteNode);
+    }
+    std::cout << "\n";
+}
+
+}
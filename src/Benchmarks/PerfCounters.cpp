@@ -0,0 +1,216 @@
+#include "Benchmarks/PerfCounters.h"
+
+#include <cstdio>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace benchmarks {
+
+namespace {
+#if defined(__linux__)
+bool Describe(PerfEvent event, perf_event_attr& attr) noexcept {
+    auto cache = [&](std::uint64_t id, std::uint64_t op) {
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = id | (op << 8) | (static_cast<std::uint64_t>(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16);
+    };
+    auto hardware = [&](std::uint64_t id) {
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = id;
+    };
+
+    switch (event) {
+    case PerfEvent::DTlbLoadMisses:  cache(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ); return true;
+    case PerfEvent::DTlbStoreMisses: cache(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_WRITE); return true;
+    case PerfEvent::Cycles:          hardware(PERF_COUNT_HW_CPU_CYCLES); return true;
+    case PerfEvent::Instructions:    hardware(PERF_COUNT_HW_INSTRUCTIONS); return true;
+    case PerfEvent::L1DLoadMisses:   cache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ); return true;
+    case PerfEvent::LlcMisses:       hardware(PERF_COUNT_HW_CACHE_MISSES); return true;
+    case PerfEvent::BranchMisses:    hardware(PERF_COUNT_HW_BRANCH_MISSES); return true;
+    }
+    return false;
+}
+
+int Open(PerfEvent event, int groupFd, bool leader) noexcept {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.disabled = leader ? 1 : 0;            // members follow the leader's enable state
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    if (leader)
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    if (!Describe(event, attr))
+        return -1;
+
+    const long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0);
+    return fd >= 0 ? static_cast<int>(fd) : -1;
+}
+#endif
+}
+
+const char* ToString(PerfEvent event) noexcept {
+    switch (event) {
+    case PerfEvent::DTlbLoadMisses:  return "dTLB-load-misses";
+    case PerfEvent::DTlbStoreMisses: return "dTLB-store-misses";
+    case PerfEvent::Cycles:          return "cycles";
+    case PerfEvent::Instructions:    return "instructions";
+    case PerfEvent::L1DLoadMisses:   return "L1-dcache-load-misses";
+    case PerfEvent::LlcMisses:       return "LLC-misses";
+    case PerfEvent::BranchMisses:    return "branch-misses";
+    }
+    return "unknown";
+}
+
+PerfCounter::PerfCounter(PerfEvent event) noexcept {
+#if defined(__linux__)
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    if (!Describe(event, attr))
+        return;
+
+    const long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    fd_ = fd >= 0 ? static_cast<int>(fd) : -1;
+#else
+    (void)event;
+#endif
+}
+
+PerfCounter::~PerfCounter() {
+#if defined(__linux__)
+    if (fd_ >= 0)
+        ::close(fd_);
+#endif
+}
+
+void PerfCounter::start() noexcept {
+#if defined(__linux__)
+    if (fd_ < 0)
+        return;
+    ::ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+    ::ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+std::uint64_t PerfCounter::stop() noexcept {
+#if defined(__linux__)
+    if (fd_ < 0)
+        return 0;
+    ::ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+    std::uint64_t value = 0;
+    if (::read(fd_, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value)))
+        return 0;
+    return value;
+#else
+    return 0;
+#endif
+}
+
+// The first event that opens leads the group; cycles and instructions come first because
+// they use fixed counters and leave the general ones to the miss events.
+PerfCounterGroup::PerfCounterGroup() noexcept {
+#if defined(__linux__)
+    constexpr PerfEvent kEvents[MaxEvents] = {
+        PerfEvent::Cycles, PerfEvent::Instructions, PerfEvent::L1DLoadMisses,
+        PerfEvent::LlcMisses, PerfEvent::BranchMisses, PerfEvent::DTlbLoadMisses
+    };
+    for (const PerfEvent event : kEvents) {
+        const int fd = Open(event, count_ ? fds_[0] : -1, count_ == 0);
+        if (fd < 0)
+            continue;
+        fds_[count_] = fd;
+        events_[count_] = event;
+        ++count_;
+    }
+#endif
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+#if defined(__linux__)
+    for (std::size_t i = count_; i-- > 0;)
+        ::close(fds_[i]);
+#endif
+}
+
+void PerfCounterGroup::start() noexcept {
+#if defined(__linux__)
+    if (!count_)
+        return;
+    ::ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+void PerfCounterGroup::pause() noexcept {
+#if defined(__linux__)
+    if (count_)
+        ::ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+void PerfCounterGroup::resume() noexcept {
+#if defined(__linux__)
+    if (count_)
+        ::ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+PerfCounts PerfCounterGroup::stop() noexcept {
+    PerfCounts out;
+#if defined(__linux__)
+    if (!count_)
+        return out;
+    ::ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, one value per member.
+    std::uint64_t buf[3 + MaxEvents] = {};
+    const ssize_t want = static_cast<ssize_t>((3 + count_) * sizeof(std::uint64_t));
+    if (::read(fds_[0], buf, sizeof(buf)) < want || buf[0] != count_)
+        return out;
+
+    const std::uint64_t enabled = buf[1];
+    const std::uint64_t running = buf[2];
+    if (running == 0)
+        return out;                            // never got onto the PMU
+    out.valid = true;
+    out.scaled = running < enabled;
+    const double scale = out.scaled ? static_cast<double>(enabled) / static_cast<double>(running) : 1.0;
+    for (std::size_t i = 0; i < count_; ++i) {
+        const auto e = static_cast<std::size_t>(events_[i]);
+        out.present[e] = true;
+        out.values[e] = static_cast<std::uint64_t>(static_cast<double>(buf[3 + i]) * scale);
+    }
+#endif
+    return out;
+}
+
+const char* PerfUnavailableReason() noexcept {
+#if defined(__linux__)
+    static char reason[64] = {};
+    PerfCounter probe(PerfEvent::Cycles);
+    if (probe.valid())
+        return nullptr;
+
+    int paranoid = 0;
+    if (std::FILE* f = std::fopen("/proc/sys/kernel/perf_event_paranoid", "r")) {
+        if (std::fscanf(f, "%d", &paranoid) != 1)
+            paranoid = 0;
+        std::fclose(f);
+    }
+    if (paranoid > 2)
+        std::snprintf(reason, sizeof(reason), "perf_event_paranoid=%d", paranoid);
+    else
+        std::snprintf(reason, sizeof(reason), "no hardware PMU access");
+    return reason;
+#else
+    return "not Linux";
+#endif
+}
+
+}
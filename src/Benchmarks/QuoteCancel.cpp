@@ -0,0 +1,136 @@
+#include "Benchmarks/QuoteCancel.h"
+
+#include "Benchmarks/Percentiles.h"
+#include "LatencyHistogram.h"
+#include "MassCancel.h"
+#include "Orderbook.h"
+#include "TimeUtils.h"
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace benchmarks {
+
+namespace {
+
+constexpr OwnerId kQuoter = 7;
+constexpr Price kMid = 10'000;
+constexpr Price kQuoteLevels = 50;      // per side
+constexpr int kQuotesPerLevel = 10;
+constexpr Price kBackgroundLevels = 100;
+constexpr int kBackgroundPerLevel = 5;
+constexpr Price kNearTicks = 10;
+
+struct Quote {
+    OrderId id;
+    Side side;
+    Price price;
+};
+
+// Bids below kMid, asks from kMid + 1, so nothing crosses.
+void AddBackground(Orderbook& book, OrderId& nextId) {
+    for (Price level = 0; level < kBackgroundLevels; ++level) {
+        for (int i = 0; i < kBackgroundPerLevel; ++i) {
+            (void)book.AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, nextId++, Side::Buy,
+                                                        kMid - level, 10));
+            (void)book.AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, nextId++, Side::Sell,
+                                                        kMid + 1 + level, 10));
+        }
+    }
+}
+
+std::vector<Quote> AddQuotes(Orderbook& book, OrderId& nextId) {
+    std::vector<Quote> quotes;
+    quotes.reserve(2 * kQuoteLevels * kQuotesPerLevel);
+    for (Price level = 0; level < kQuoteLevels; ++level) {
+        for (int i = 0; i < kQuotesPerLevel; ++i) {
+            for (const Side side : { Side::Buy, Side::Sell }) {
+                const Price price = side == Side::Buy ? kMid - level : kMid + 1 + level;
+                const OrderId id = nextId++;
+                (void)book.AddOrder(std::make_shared<Order>(OrderType::GoodTillCancel, id, side, price, 5, kQuoter));
+                quotes.push_back({ id, side, price });
+            }
+        }
+    }
+    return quotes;
+}
+
+struct CaseResult {
+    LatencyHistogram latency;
+    std::size_t removed = 0;            // per round
+    bool consistent = true;             // book back to its background after every round
+};
+
+template<typename Remove>
+CaseResult RunCase(std::size_t rounds, Remove&& remove) {
+    const auto& clock = ob::time::TscClock::instance();
+    auto book = std::make_unique<Orderbook>();
+    OrderId nextId = 1;
+    AddBackground(*book, nextId);
+
+    CaseResult result;
+    for (std::size_t round = 0; round < rounds; ++round) {
+        const std::size_t before = book->Size();
+        const std::vector<Quote> quotes = AddQuotes(*book, nextId);
+
+        const std::uint64_t t0 = clock.start();
+        remove(*book, quotes);
+        result.latency.record(clock.to_ns(clock.stop() - t0));
+
+        // The rest of the quotes go untimed so every round starts from the same book.
+        result.removed = before + quotes.size() - book->Size();
+        book->MassCancel(MassCancelRequest::ForOwner(kQuoter));
+        result.consistent = result.consistent && book->Size() == before;
+    }
+    return result;
+}
+
+void PrintCase(const char* label, const CaseResult& r) {
+    const LatencyPercentilesNs p = ComputeLatencyPercentilesNs(r.latency);
+    const double perOrder = r.removed ? static_cast<double>(p.p50) / static_cast<double>(r.removed) : 0.0;
+    std::cout << "    " << std::left << std::setw(30) << label << std::right
+              << std::setw(5) << r.removed << " orders  p50 " << std::setw(8) << p.p50
+              << " ns  p99 " << std::setw(8) << p.p99 << " ns  " << std::fixed << std::setprecision(1)
+              << std::setw(6) << perOrder << " ns/order" << (r.consistent ? "" : "  (book NOT restored)") << "\n";
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+bool IsNearBid(const Quote& q) {
+    return q.side == Side::Buy && q.price > kMid - kNearTicks;
+}
+
+}
+
+void RunMassCancelBenchmark(std::size_t rounds) {
+    if (rounds == 0)
+        return;
+
+    std::cout << "Mass cancel: " << rounds << " rounds, " << 2 * kQuoteLevels * kQuotesPerLevel
+              << " quotes of one owner over " << 2 * kBackgroundLevels * kBackgroundPerLevel
+              << " background orders\n";
+
+    std::cout << "  all quotes:\n";
+    PrintCase("CancelOrder per quote", RunCase(rounds, [](Orderbook& book, const std::vector<Quote>& quotes) {
+        for (const Quote& q : quotes)
+            book.CancelOrder(q.id);
+    }));
+    PrintCase("MassCancel(owner)", RunCase(rounds, [](Orderbook& book, const std::vector<Quote>&) {
+        book.MassCancel(MassCancelRequest::ForOwner(kQuoter));
+    }));
+
+    std::cout << "  bids within " << kNearTicks << " ticks of the touch:\n";
+    PrintCase("CancelOrder per quote", RunCase(rounds, [](Orderbook& book, const std::vector<Quote>& quotes) {
+        for (const Quote& q : quotes) {
+            if (IsNearBid(q))
+                book.CancelOrder(q.id);
+        }
+    }));
+    PrintCase("MassCancel(owner, bid, range)", RunCase(rounds, [](Orderbook& book, const std::vector<Quote>&) {
+        book.MassCancel(MassCancelRequest::ForOwner(kQuoter).OnSide(Side::Buy).InRange(kMid - kNearTicks + 1, kMid));
+    }));
+}
+
+}
@@ -1,20 +1,38 @@
+#include "Benchmarks/BenchOptions.h"
 #include "Benchmarks/BenchPrinter.h"
+#include "Benchmarks/BookPolicies.h"
+#include "Benchmarks/CancelPriority.h"
+#include "Benchmarks/DeepBook.h"
+#include "Benchmarks/DepthQueries.h"
+#include "Benchmarks/DrainFairness.h"
+#include "Benchmarks/FixThroughput.h"
+#include "Benchmarks/FlowControl.h"
+#include "Benchmarks/HugePageTlb.h"
+#include "Benchmarks/IpcIngress.h"
+#include "Benchmarks/L2Feed.h"
+#include "Benchmarks/NumaPlacement.h"
 #include "Benchmarks/Percentiles.h"
+#include "Benchmarks/PerfCounters.h"
 #include "Benchmarks/Priority.h"
+#include "Benchmarks/QuoteCancel.h"
+#include "Benchmarks/WaitStrategies.h"
 
 #include "EngineEvent.h"
+#include "MemoryRegion.h"
 #include "OrderRingBuffer.h"
 #include "Orderbook.h"
+#include "TimeUtils.h"
 
 #include <chrono>
 #include <cstdint>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace {
 
-benchmarks::RingBufferStats MakeOrderRingBufferStats() {
+benchmarks::RingBufferStats MakeOrderRingBufferStats(PageBacking backing) {
     benchmarks::RingBufferStats s;
     s.messageSizeBytes = sizeof(EngineEvent);
     s.ringBufferSizeBytes = sizeof(EngineEvent) * static_cast<std::size_t>(16384);
@@ -22,15 +40,16 @@ benchmarks::RingBufferStats MakeOrderRingBufferStats() {
     s.messagesPerCacheLine = s.messageSizeBytes ? (kCacheLine / s.messageSizeBytes) : 0;
     if (s.messagesPerCacheLine == 0)
         s.messagesPerCacheLine = 1;
+    s.pageBacking = ToString(backing);
     return s;
 }
 
-benchmarks::LatencyPercentilesNs RunSingleThreadQueueRoundTripLatency(std::size_t iterations) {
-    OrderRingBuffer q;
+benchmarks::LatencyPercentilesNs RunSingleThreadQueueRoundTripLatency(OrderRingBuffer& q, std::size_t iterations, benchmarks::PerfCounts& counters) {
     q.prefault();
 
-    std::vector<std::uint64_t> samples;
-    samples.reserve(iterations);
+    const auto& clock = ob::time::TscClock::instance();
+
+    LatencyHistogram samples;
 
     EngineEvent ev = EngineEvent::MakeCancel(OrderId{1});
     EngineEvent out;
@@ -42,24 +61,26 @@ benchmarks::LatencyPercentilesNs RunSingleThreadQueueRoundTripLatency(std::size_
         }
     }
 
+    benchmarks::PerfCounterGroup perf;
+    perf.start();
     for (std::size_t i = 0; i < iterations; ++i) {
         ev = EngineEvent::MakeCancel(static_cast<OrderId>(i));
 
-        const auto t0 = std::chrono::steady_clock::now();
+        const std::uint64_t t0 = clock.start();
         while (!q.push(ev)) {
         }
         while (!q.pop(out)) {
         }
-        const auto t1 = std::chrono::steady_clock::now();
+        const std::uint64_t t1 = clock.stop();
 
-        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
-        samples.push_back(static_cast<std::uint64_t>(ns));
+        samples.record(clock.to_ns(t1 - t0));
     }
+    counters = perf.stop();
 
-    return benchmarks::ComputeLatencyPercentilesNs(std::move(samples));
+    return benchmarks::ComputeLatencyPercentilesNs(samples);
 }
 
-benchmarks::LatencyPercentilesNs RunSingleThreadOrderbookAddLatency(std::size_t iterations) {
+benchmarks::LatencyPercentilesNs RunSingleThreadOrderbookAddLatency(std::size_t iterations, benchmarks::PerfCounts& counters) {
     Orderbook ob;
 
     std::vector<Order> storage;
@@ -78,26 +99,29 @@ benchmarks::LatencyPercentilesNs RunSingleThreadOrderbookAddLatency(std::size_t
         orders.emplace_back(OrderPointer(&storage[i], [](Order*) {}));
     }
 
-    std::vector<std::uint64_t> samples;
-    samples.reserve(iterations);
+    const auto& clock = ob::time::TscClock::instance();
+
+    LatencyHistogram samples;
 
     for (std::size_t i = 0; i < 1000 && i < iterations; ++i) {
         (void)ob.AddOrder(orders[i]);
     }
 
+    benchmarks::PerfCounterGroup perf;
+    perf.start();
     for (std::size_t i = 0; i < iterations; ++i) {
-        const auto t0 = std::chrono::steady_clock::now();
+        const std::uint64_t t0 = clock.start();
         (void)ob.AddOrder(orders[i]);
-        const auto t1 = std::chrono::steady_clock::now();
+        const std::uint64_t t1 = clock.stop();
 
-        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
-        samples.push_back(static_cast<std::uint64_t>(ns));
+        samples.record(clock.to_ns(t1 - t0));
     }
+    counters = perf.stop();
 
-    return benchmarks::ComputeLatencyPercentilesNs(std::move(samples));
+    return benchmarks::ComputeLatencyPercentilesNs(samples);
 }
 
-benchmarks::LatencyPercentilesNs RunSingleThreadOrderbookCancelLatency(std::size_t iterations) {
+benchmarks::LatencyPercentilesNs RunSingleThreadOrderbookCancelLatency(std::size_t iterations, benchmarks::PerfCounts& counters) {
     Orderbook ob;
 
     std::vector<Order> storage;
@@ -120,23 +144,26 @@ benchmarks::LatencyPercentilesNs RunSingleThreadOrderbookCancelLatency(std::size
         (void)ob.AddOrder(orders[i]);
     }
 
-    std::vector<std::uint64_t> samples;
-    samples.reserve(iterations);
+    const auto& clock = ob::time::TscClock::instance();
+
+    LatencyHistogram samples;
 
+    benchmarks::PerfCounterGroup perf;
+    perf.start();
     for (std::size_t i = 0; i < iterations; ++i) {
         const OrderId id = OrderId{i + 1};
-        const auto t0 = std::chrono::steady_clock::now();
+        const std::uint64_t t0 = clock.start();
         ob.CancelOrder(id);
-        const auto t1 = std::chrono::steady_clock::now();
+        const std::uint64_t t1 = clock.stop();
 
-        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
-        samples.push_back(static_cast<std::uint64_t>(ns));
+        samples.record(clock.to_ns(t1 - t0));
     }
+    counters = perf.stop();
 
-    return benchmarks::ComputeLatencyPercentilesNs(std::move(samples));
+    return benchmarks::ComputeLatencyPercentilesNs(samples);
 }
 
-benchmarks::LatencyPercentilesNs RunSingleThreadOrderbookModifyLatency(std::size_t iterations) {
+benchmarks::LatencyPercentilesNs RunSingleThreadOrderbookModifyLatency(std::size_t iterations, benchmarks::PerfCounts& counters) {
     Orderbook ob;
 
     std::vector<Order> storage;
@@ -159,53 +186,130 @@ benchmarks::LatencyPercentilesNs RunSingleThreadOrderbookModifyLatency(std::size
         (void)ob.AddOrder(orders[i]);
     }
 
-    std::vector<std::uint64_t> samples;
-    samples.reserve(iterations);
+    const auto& clock = ob::time::TscClock::instance();
 
+    LatencyHistogram samples;
+
+    benchmarks::PerfCounterGroup perf;
+    perf.start();
     for (std::size_t i = 0; i < iterations; ++i) {
         const OrderId id = OrderId{i + 1};
         OrderModify mod{id, Side::Buy, Price{101}, Quantity{1}};
 
-        const auto t0 = std::chrono::steady_clock::now();
+        const std::uint64_t t0 = clock.start();
         (void)ob.ModifyOrder(mod);
-        const auto t1 = std::chrono::steady_clock::now();
+        const std::uint64_t t1 = clock.stop();
 
-        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
-        samples.push_back(static_cast<std::uint64_t>(ns));
+        samples.record(clock.to_ns(t1 - t0));
     }
+    counters = perf.stop();
 
-    return benchmarks::ComputeLatencyPercentilesNs(std::move(samples));
+    return benchmarks::ComputeLatencyPercentilesNs(samples);
 }
 
 }
 
 int main(int argc, char** argv) {
-    std::size_t iterations = 1'000'000;
-    if (argc >= 2) {
-        try {
-            iterations = static_cast<std::size_t>(std::stoull(argv[1]));
-        } catch (...) {
-        }
-    }
+    const benchmarks::BenchOptions opts = benchmarks::ParseBenchOptions(argc, argv);
+    const std::size_t iterations = opts.iterations;
 
     const auto pr = benchmarks::RaiseProcessAndThreadPriorityBestEffort();
     std::cout << "Process priority raised: " << (pr.processPriorityRaised ? "true" : "false") << "\n";
-    std::cout << "Thread priority raised: " << (pr.threadPriorityRaised ? "true" : "false") << "\n\n";
+    std::cout << "Thread priority raised: " << (pr.threadPriorityRaised ? "true" : "false") << "\n";
+    std::cout << "Realtime scheduling: " << (pr.realtimeScheduling ? "SCHED_FIFO " + std::to_string(pr.realtimePriority) : std::string("no")) << "\n";
+    std::cout << "Memory locked (mlockall): " << (pr.memoryLocked ? "true" : "false") << "\n\n";
+
+    // Sized like a ring in main: allocated on 2 MiB pages when the system provides them.
+    MemoryRegion ringRegion = MemoryRegion::Allocate(sizeof(OrderRingBuffer), { -1, true });
+    if (!ringRegion.data()) {
+        std::cerr << "Could not map " << sizeof(OrderRingBuffer) << " bytes for the ring\n";
+        return 1;
+    }
+    OrderRingBuffer* ring = new (ringRegion.data()) OrderRingBuffer();
 
-    const auto stats = MakeOrderRingBufferStats();
+    const auto stats = MakeOrderRingBufferStats(ringRegion.backing());
     benchmarks::PrintSetup("Single-thread latency benchmark", stats);
+    benchmarks::PrintTimestampClock();
+    benchmarks::PrintPerfCounterStatus();
 
-    const auto pct = RunSingleThreadQueueRoundTripLatency(iterations);
-    benchmarks::PrintLatencyStats("SPSC push+pop round-trip", pct);
+    benchmarks::PerfCounts perf;
+    const auto pct = RunSingleThreadQueueRoundTripLatency(*ring, iterations, perf);
+    ring->~OrderRingBuffer();
+    benchmarks::PrintLatencyStats("SPSC push+pop round-trip", pct, perf, iterations);
 
-    const auto addPct = RunSingleThreadOrderbookAddLatency(iterations);
-    benchmarks::PrintLatencyStats("Orderbook AddOrder", addPct);
+    const auto addPct = RunSingleThreadOrderbookAddLatency(iterations, perf);
+    benchmarks::PrintLatencyStats("Orderbook AddOrder", addPct, perf, iterations);
 
-    const auto cancelPct = RunSingleThreadOrderbookCancelLatency(iterations);
-    benchmarks::PrintLatencyStats("Orderbook CancelOrder", cancelPct);
+    const auto cancelPct = RunSingleThreadOrderbookCancelLatency(iterations, perf);
+    benchmarks::PrintLatencyStats("Orderbook CancelOrder", cancelPct, perf, iterations);
 
-    const auto modifyPct = RunSingleThreadOrderbookModifyLatency(iterations);
-    benchmarks::PrintLatencyStats("Orderbook ModifyOrder", modifyPct);
+    const auto modifyPct = RunSingleThreadOrderbookModifyLatency(iterations, perf);
+    benchmarks::PrintLatencyStats("Orderbook ModifyOrder", modifyPct, perf, iterations);
+
+    if (opts.numa != benchmarks::NumaMode::Off) {
+        std::cout << "\n";
+        benchmarks::RunNumaPlacementBenchmarks(iterations, opts.numa);
+    }
+
+    if (opts.tlbBookOrders) {
+        std::cout << "\n";
+        benchmarks::RunHugePageTlbBenchmark(opts.tlbBookOrders, iterations);
+    }
+
+    if (opts.flowProducers) {
+        std::cout << "\n";
+        benchmarks::RunFlowControlScaling(opts.flowProducers, 1.0);
+    }
+
+    if (opts.waitSamples) {
+        std::cout << "\n";
+        benchmarks::RunWaitStrategyBenchmark(opts.waitSamples);
+    }
+
+    if (opts.fairnessSeconds > 0.0) {
+        std::cout << "\n";
+        benchmarks::RunDrainFairnessBenchmark(opts.fairnessSeconds);
+    }
+
+    if (opts.cancelLaneSeconds > 0.0) {
+        std::cout << "\n";
+        benchmarks::RunCancelPriorityBenchmark(opts.cancelLaneSeconds);
+    }
+
+    if (opts.deepBookOrders) {
+        std::cout << "\n";
+        benchmarks::RunDeepBookScenarios(iterations, opts.deepBookOrders);
+    }
+
+    if (opts.ipcSamples) {
+        std::cout << "\n";
+        benchmarks::RunIpcIngressBenchmark(opts.ipcSamples);
+    }
+
+    if (opts.l2Events) {
+        std::cout << "\n";
+        benchmarks::RunL2FeedBenchmark(opts.l2Events);
+    }
+
+    if (opts.fixMessages) {
+        std::cout << "\n";
+        benchmarks::RunFixCodecBenchmark(opts.fixMessages);
+    }
+
+    if (opts.policyEvents) {
+        std::cout << "\n";
+        benchmarks::RunBookPolicyBenchmark(opts.policyEvents);
+    }
+
+    if (opts.depthQueries) {
+        std::cout << "\n";
+        benchmarks::RunDepthQueryBenchmark(opts.depthQueries);
+    }
+
+    if (opts.massCancelRounds) {
+        std::cout << "\n";
+        benchmarks::RunMassCancelBenchmark(opts.massCancelRounds);
+    }
 
     return 0;
 }
@@ -5,11 +5,137 @@
 #if defined(__APPLE__)
 #include <unistd.h>
 #include <mach/mach.h>
+#include <sys/sysctl.h>
+#elif defined(__linux__)
+#include <dirent.h>
+#include <fstream>
+#include <sys/utsname.h>
+#include <unistd.h>
 #endif
 
 namespace benchmarks {
 
-SystemInfo QuerySystemInfo() noexcept {
+namespace {
+#if defined(__linux__)
+std::string ReadFirstLine(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    if (in)
+        std::getline(in, line);
+    return line;
+}
+
+std::uint64_t ReadU64(const std::string& path) {
+    const std::string s = ReadFirstLine(path);
+    try {
+        return s.empty() ? 0 : std::stoull(s);
+    } catch (...) {
+        return 0;
+    }
+}
+
+// sysfs cache sizes look like "48K" or "32768K" or "2M".
+std::uint64_t ParseCacheSize(const std::string& s) {
+    if (s.empty())
+        return 0;
+    std::uint64_t value = 0;
+    try {
+        value = std::stoull(s);
+    } catch (...) {
+        return 0;
+    }
+    switch (s.back()) {
+    case 'K': return value * 1024;
+    case 'M': return value * 1024 * 1024;
+    case 'G': return value * 1024 * 1024 * 1024;
+    default:  return value;
+    }
+}
+
+void ReadMeminfo(SystemInfo& info) {
+    std::ifstream in("/proc/meminfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        const auto colon = line.find(':');
+        if (colon == std::string::npos)
+            continue;
+        const std::string key = line.substr(0, colon);
+        std::uint64_t kb = 0;
+        try {
+            kb = std::stoull(line.substr(colon + 1));
+        } catch (...) {
+            continue;
+        }
+        if (key == "MemTotal")
+            info.totalMemoryBytes = kb * 1024;
+        else if (key == "MemAvailable")
+            info.availableMemoryBytes = kb * 1024;
+    }
+}
+
+void ReadCpuModel(SystemInfo& info) {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        // x86 uses "model name", most arm64 kernels only expose "CPU part"/"Hardware".
+        if (line.rfind("model name", 0) == 0 || line.rfind("Hardware", 0) == 0) {
+            const auto colon = line.find(':');
+            if (colon != std::string::npos && colon + 2 <= line.size()) {
+                info.cpuModel = line.substr(colon + 2);
+                return;
+            }
+        }
+    }
+}
+
+void ReadCaches(SystemInfo& info) {
+    const std::string base = "/sys/devices/system/cpu/cpu0/cache/index";
+    for (int idx = 0; idx < 8; ++idx) {
+        const std::string dir = base + std::to_string(idx);
+        const std::string level = ReadFirstLine(dir + "/level");
+        if (level.empty())
+            break;
+        const std::string type = ReadFirstLine(dir + "/type");
+        const std::uint64_t size = ParseCacheSize(ReadFirstLine(dir + "/size"));
+        if (level == "1" && type == "Data")
+            info.l1dCacheBytes = size;
+        else if (level == "2")
+            info.l2CacheBytes = size;
+        else if (level == "3")
+            info.l3CacheBytes = size;
+    }
+}
+
+void ReadHugePages(SystemInfo& info) {
+    const std::string base = "/sys/kernel/mm/hugepages";
+    if (DIR* dir = ::opendir(base.c_str())) {
+        while (const dirent* e = ::readdir(dir)) {
+            const std::string name = e->d_name;
+            if (name.rfind("hugepages-", 0) != 0)
+                continue;
+            HugePagePool pool;
+            try {
+                pool.pageSizeKb = std::stoull(name.substr(10));
+            } catch (...) {
+                continue;
+            }
+            pool.total = ReadU64(base + "/" + name + "/nr_hugepages");
+            pool.free = ReadU64(base + "/" + name + "/free_hugepages");
+            info.hugePagePools.push_back(pool);
+        }
+        ::closedir(dir);
+    }
+
+    const std::string thp = ReadFirstLine("/sys/kernel/mm/transparent_hugepage/enabled");
+    const auto open = thp.find('[');
+    const auto close = thp.find(']');
+    if (open != std::string::npos && close != std::string::npos && close > open)
+        info.transparentHugePages = thp.substr(open + 1, close - open - 1);
+}
+#endif
+}
+
+SystemInfo QuerySystemInfo() {
     SystemInfo info;
 
     const unsigned hc = std::thread::hardware_concurrency();
@@ -27,9 +153,30 @@ SystemInfo QuerySystemInfo() noexcept {
         const std::uint64_t inactiveBytes = static_cast<std::uint64_t>(vmStats.inactive_count) * static_cast<std::uint64_t>(info.pageSizeBytes);
         info.availableMemoryBytes = freeBytes + inactiveBytes;
     }
+
+    char brand[256] = {};
+    std::size_t brandLen = sizeof(brand);
+    if (sysctlbyname("machdep.cpu.brand_string", brand, &brandLen, nullptr, 0) == 0)
+        info.cpuModel = brand;
+#elif defined(__linux__)
+    const long ps = sysconf(_SC_PAGESIZE);
+    info.pageSizeBytes = ps > 0 ? static_cast<std::size_t>(ps) : static_cast<std::size_t>(4096);
+
+    ReadMeminfo(info);
+    ReadCpuModel(info);
+    ReadCaches(info);
+    ReadHugePages(info);
+
+    info.frequencyGovernor = ReadFirstLine("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+    info.maxFrequencyMhz = static_cast<std::uint32_t>(ReadU64("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq") / 1000);
+    info.isolatedCpus = ReadFirstLine("/sys/devices/system/cpu/isolated");
+    info.nohzFullCpus = ReadFirstLine("/sys/devices/system/cpu/nohz_full");
+
+    utsname uts{};
+    if (uname(&uts) == 0)
+        info.kernel = std::string(uts.sysname) + " " + uts.release;
 #else
     info.pageSizeBytes = 4096;
-    info.availableMemoryBytes = 0;
 #endif
 
     return info;
@@ -0,0 +1,434 @@
+#include "Benchmarks/ThroughputSweep.h"
+
+#include "Backpressure.h"
+#include "CpuTopology.h"
+#include "L3Book.h"
+#include "L3Feed.h"
+#include "MatchingEngine.h"
+#include "MemoryRegion.h"
+#include "NumaMemory.h"
+#include "OrderRingBuffer.h"
+#include "Producer.h"
+#include "ProducerChannel.h"
+#include "RiskStage.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace benchmarks {
+
+namespace {
+
+constexpr std::size_t kMaxRingSize = 16384;
+
+bool ParseOnOff(const std::string& s) {
+    if (s == "on")
+        return true;
+    if (s == "off")
+        return false;
+    throw std::invalid_argument(s);
+}
+
+template<typename T, typename Parse>
+void ParseList(std::string_view name, std::string_view value, std::vector<T>& out, Parse parse) {
+    std::vector<T> parsed;
+    std::size_t pos = 0;
+    while (pos <= value.size()) {
+        const std::size_t comma = std::min(value.find(',', pos), value.size());
+        const std::string item(value.substr(pos, comma - pos));
+        try {
+            parsed.push_back(static_cast<T>(parse(item)));
+        } catch (...) {
+            std::cerr << "Bad " << name << " value '" << item << "'\n";
+            return;
+        }
+        pos = comma + 1;
+    }
+    out = std::move(parsed);
+}
+
+double ParseSeconds(std::string_view name, std::string_view value, double fallback) {
+    try {
+        return std::stod(std::string(value));
+    } catch (...) {
+        std::cerr << "Bad " << name << " duration '" << value << "'\n";
+        return fallback;
+    }
+}
+
+std::size_t ClampRingSize(std::size_t ring) {
+    // Power of two like a real SPSCQueue, and no larger than the one the engine is built with.
+    ring = std::clamp<std::size_t>(ring, 64, kMaxRingSize);
+    return std::size_t{1} << (63 - std::countl_zero(static_cast<std::uint64_t>(ring)));
+}
+
+struct Snapshot {
+    std::uint64_t events = 0;
+    std::uint64_t produced = 0;
+    std::uint64_t idle = 0;
+    std::uint64_t busy = 0;
+    std::uint64_t retries = 0;
+    std::uint64_t creditWaits = 0;
+    std::uint64_t l3Messages = 0;
+    std::uint64_t l3Bytes = 0;
+    LatencyHistogram queueLatency;
+};
+
+// Reads the engine's L3 feed and rebuilds the book from it, as a downstream consumer would.
+class L3Consumer {
+public:
+    explicit L3Consumer(L3Feed& feed, const WaitStrategy& wait)
+        : feed_(feed), wait_(wait), buffer_(std::make_unique<std::uint8_t[]>(kBufferBytes)) {}
+
+    void run(const std::atomic<bool>& running) {
+        std::uint32_t spins = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            if (poll())
+                spins = 0;
+            else
+                wait_.idle(spins);
+        }
+        while (poll()) {
+        }
+    }
+
+    const L3Book& book() const { return book_; }
+
+private:
+    static constexpr std::size_t kBufferBytes = 1 << 16;
+
+    bool poll() {
+        const std::size_t n = feed_.read(buffer_.get() + carry_, kBufferBytes - carry_);
+        if (n == 0)
+            return false;
+        const std::size_t size = carry_ + n;
+        const std::size_t used = book_.Apply({ buffer_.get(), size });
+        carry_ = size - used;
+        std::memmove(buffer_.get(), buffer_.get() + used, carry_);
+        return true;
+    }
+
+    L3Feed& feed_;
+    WaitStrategy wait_;
+    std::unique_ptr<std::uint8_t[]> buffer_;
+    std::size_t carry_ = 0;
+    L3Book book_;
+};
+
+Snapshot Take(const MatchingEngine& engine,
+              const std::vector<std::unique_ptr<Producer>>& producers,
+              const std::vector<RegionPtr<Backpressure>>& credits) {
+    Snapshot s;
+    s.idle = engine.IdleLoops();
+    s.busy = engine.BusyRounds();
+    for (std::size_t i = 0; i < engine.ChannelCount(); ++i) {
+        s.events += engine.QueueStats(i).events;
+        s.queueLatency.merge(engine.QueueLatency(i));
+    }
+    for (const auto& p : producers) {
+        s.produced += p->ProducedEvents();
+        s.retries += p->EnqueueRetries();
+    }
+    for (const auto& c : credits)
+        s.creditWaits += c->wait_calls();
+    if (const L3Feed* feed = engine.L3Messages()) {
+        s.l3Messages = feed->messages();
+        s.l3Bytes = feed->bytes();
+    }
+    return s;
+}
+
+std::string Fraction(double v) {
+    std::ostringstream os;
+    os << v;
+    return os.str();
+}
+
+}
+
+std::size_t SweepPoint::CreditLimit() const {
+    const auto limit = static_cast<std::size_t>(static_cast<double>(ringSize - 1) * creditFraction);
+    return std::clamp<std::size_t>(limit, 1, ringSize - 1);
+}
+
+SweepOptions ParseSweepOptions(int argc, char** argv) {
+    SweepOptions opts;
+    const auto toSize = [](const std::string& s) { return std::stoull(s); };
+    const auto toDouble = [](const std::string& s) { return std::stod(s); };
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+
+        if (arg.rfind("--producers=", 0) == 0) {
+            ParseList("--producers", arg.substr(12), opts.producers, toSize);
+            continue;
+        }
+        if (arg.rfind("--burst=", 0) == 0) {
+            ParseList("--burst", arg.substr(8), opts.burstSizes, toSize);
+            continue;
+        }
+        if (arg.rfind("--ring=", 0) == 0) {
+            ParseList("--ring", arg.substr(7), opts.ringSizes, toSize);
+            continue;
+        }
+        if (arg.rfind("--credit=", 0) == 0) {
+            ParseList("--credit", arg.substr(9), opts.creditFractions, toDouble);
+            continue;
+        }
+        if (arg.rfind("--l3=", 0) == 0) {
+            ParseList("--l3", arg.substr(5), opts.l3Feed, ParseOnOff);
+            continue;
+        }
+        if (arg.rfind("--risk=", 0) == 0) {
+            ParseList("--risk", arg.substr(7), opts.riskStage, ParseOnOff);
+            continue;
+        }
+        if (arg.rfind("--warmup=", 0) == 0) {
+            opts.warmupSeconds = ParseSeconds("--warmup", arg.substr(9), opts.warmupSeconds);
+            continue;
+        }
+        if (arg.rfind("--seconds=", 0) == 0) {
+            opts.measureSeconds = ParseSeconds("--seconds", arg.substr(10), opts.measureSeconds);
+            continue;
+        }
+        if (arg.rfind("--wait=", 0) == 0) {
+            if (!ParseWaitStrategyKind(arg.substr(7), opts.wait))
+                std::cerr << "Unknown --wait strategy '" << arg.substr(7) << "', expected spin|yield|park\n";
+            continue;
+        }
+        if (arg.rfind("--workload=", 0) == 0) {
+            if (!ParseWorkloadPreset(arg.substr(11), opts.workload))
+                std::cerr << "Unknown --workload preset '" << arg.substr(11) << "', expected uniform|maker|taker\n";
+            continue;
+        }
+        if (arg.rfind("--csv=", 0) == 0) {
+            opts.csvPath = std::string(arg.substr(6));
+            continue;
+        }
+        if (arg.rfind("--json=", 0) == 0) {
+            opts.jsonPath = std::string(arg.substr(7));
+            continue;
+        }
+        std::cerr << "Ignoring unknown option " << arg << "\n";
+    }
+
+    return opts;
+}
+
+std::vector<SweepPoint> ExpandSweep(const SweepOptions& opts) {
+    std::vector<SweepPoint> points;
+    for (const std::size_t producers : opts.producers) {
+        if (producers == 0 || producers > MatchingEngine::MaxChannels) {
+            std::cerr << "Skipping producer count " << producers << " (1.." << MatchingEngine::MaxChannels << ")\n";
+            continue;
+        }
+        for (const std::uint32_t burst : opts.burstSizes)
+            for (const std::size_t ring : opts.ringSizes)
+                for (const double fraction : opts.creditFractions)
+                    for (const bool l3 : opts.l3Feed)
+                        for (const bool risk : opts.riskStage)
+                            points.push_back({ producers, burst ? burst : 1, ClampRingSize(ring),
+                                               std::clamp(fraction, 0.01, 1.0), l3, risk });
+    }
+    return points;
+}
+
+SweepResult RunSweepPoint(const SweepPoint& point, const SweepOptions& opts) {
+    const WaitStrategy wait(opts.wait);
+    const WorkloadConfig workload = MakeWorkload(opts.workload);
+    const CpuTopology topology = DiscoverCpuTopology();
+    // The risk thread is placed like one more producer: it takes the last producer slot.
+    const ThreadPlacement placement = PlanThreadPlacement(topology, point.producers + (point.riskStage ? 1 : 0));
+
+    // Declared before the engine so the rings outlive it: the engine's book and any events
+    // left in the rings release their orders back to the producers' pools on destruction.
+    std::vector<RegionPtr<OrderRingBuffer>> rings;
+    std::vector<RegionPtr<Backpressure>> credits;
+    std::vector<ProducerChannel> channels;
+    for (std::size_t i = 0; i < point.producers; ++i) {
+        const int node = NumaNodeOfCpu(placement.producerCpus[i]);
+        rings.push_back(MakeRequiredInRegion<OrderRingBuffer>("an order ring", { node, true }));
+        rings.back()->prefault();
+        credits.push_back(MakeRequiredInRegion<Backpressure>("a credit window", { node, false }, point.CreditLimit(), wait));
+
+        ProducerChannel channel;
+        channel.queue = rings.back().get();
+        channel.backpressure = credits.back().get();
+        channel.producerId = static_cast<std::uint32_t>(i);
+        channels.push_back(channel);
+    }
+
+    // Limits are left open: the sweep measures the cost of the extra hop and the checks.
+    RiskLimitTable limits;
+    std::unique_ptr<RiskStage> risk;
+    if (point.riskStage)
+        risk = std::make_unique<RiskStage>(channels, limits, placement.producerCpus[point.producers],
+                                           wait, point.burstSize);
+
+    auto engine = MakeRequiredInRegion<MatchingEngine>("the matching engine",
+                                                       { NumaNodeOfCpu(placement.engineCpu), false },
+                                                       risk ? risk->outputs() : channels, point.burstSize,
+                                                       placement.engineCpu, wait);
+    if (risk)
+        engine->EnableExecutionReports(&risk->reports());
+    std::unique_ptr<L3Consumer> l3Consumer;
+    std::atomic<bool> l3Running{true};
+    std::thread l3Thread;
+    if (point.l3Feed) {
+        engine->EnableL3Feed();
+        l3Consumer = std::make_unique<L3Consumer>(*engine->L3Messages(), wait);
+        l3Thread = std::thread(&L3Consumer::run, l3Consumer.get(), std::cref(l3Running));
+    }
+    engine->start();
+    if (risk)
+        risk->start();
+
+    std::atomic<bool> running{true};
+    std::vector<std::unique_ptr<Producer>> producers;
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < point.producers; ++i) {
+        producers.push_back(std::make_unique<Producer>(channels[i], running, static_cast<std::uint32_t>(i),
+                                                       placement.producerCpus[i], wait, workload));
+        threads.emplace_back(&Producer::run, producers.back().get());
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(opts.warmupSeconds));
+    const Snapshot before = Take(*engine, producers, credits);
+    const auto t0 = std::chrono::steady_clock::now();
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(opts.measureSeconds));
+    Snapshot after = Take(*engine, producers, credits);
+    const std::chrono::duration<double> measured = std::chrono::steady_clock::now() - t0;
+
+    // Producers first: one blocked on credits needs the engine (or the risk stage) to
+    // return them. The risk stage goes last, as the engine may be waiting on its reports.
+    running.store(false, std::memory_order_relaxed);
+    for (auto& t : threads)
+        t.join();
+    engine->stop();
+    if (risk)
+        risk->stop();
+    l3Running.store(false, std::memory_order_relaxed);
+    if (l3Thread.joinable())
+        l3Thread.join();
+
+    SweepResult r;
+    r.point = point;
+    r.workload = opts.workload;
+    r.seconds = measured.count();
+    r.events = after.events - before.events;
+    r.eventsPerSec = r.seconds > 0.0 ? static_cast<double>(r.events) / r.seconds : 0.0;
+    r.producedPerSec = r.seconds > 0.0 ? static_cast<double>(after.produced - before.produced) / r.seconds : 0.0;
+    const std::uint64_t idle = after.idle - before.idle;
+    const std::uint64_t rounds = idle + (after.busy - before.busy);
+    r.idleRatio = rounds ? static_cast<double>(idle) / static_cast<double>(rounds) : 0.0;
+    r.enqueueRetries = after.retries - before.retries;
+    r.creditWaits = after.creditWaits - before.creditWaits;
+    after.queueLatency.subtract(before.queueLatency);
+    r.queueLatency = ComputeLatencyPercentilesNs(after.queueLatency);
+    if (const L3Feed* feed = engine->L3Messages()) {
+        r.l3MessagesPerSec = r.seconds > 0.0 ? static_cast<double>(after.l3Messages - before.l3Messages) / r.seconds : 0.0;
+        r.l3BytesPerSec = r.seconds > 0.0 ? static_cast<double>(after.l3Bytes - before.l3Bytes) / r.seconds : 0.0;
+        r.l3Dropped = feed->dropped();
+        // With drops the rebuilt book is expected to diverge; the sequence gaps show it.
+        const L3Book& book = l3Consumer->book();
+        r.l3Errors = book.UnknownOrders() + book.PositionMismatches();
+        if (r.l3Dropped == 0)
+            r.l3Errors += book.Gaps() + (book.Size() != engine->OrderCount() ? 1 : 0);
+    }
+    if (risk)
+        r.riskRejected = risk->rejected();
+    return r;
+}
+
+void PrintSweepHeader(std::ostream& out) {
+    out << std::right << std::setw(5) << "prod" << std::setw(7) << "burst" << std::setw(7) << "ring"
+        << std::setw(7) << "credit" << std::setw(13) << "events/s" << std::setw(7) << "idle"
+        << std::setw(10) << "retries" << std::setw(10) << "crWaits"
+        << std::setw(11) << "p50 ns" << std::setw(11) << "p99 ns" << std::setw(12) << "p99.99 ns"
+        << std::setw(12) << "max ns" << std::setw(4) << "l3" << std::setw(13) << "l3 msg/s"
+        << std::setw(9) << "l3 MB/s" << std::setw(10) << "l3 drops" << std::setw(8) << "l3 errs"
+        << std::setw(6) << "risk" << std::setw(10) << "rejected" << "\n";
+}
+
+void PrintSweepRow(std::ostream& out, const SweepResult& r) {
+    const auto flags = out.flags();
+    out << std::right << std::setw(5) << r.point.producers << std::setw(7) << r.point.burstSize
+        << std::setw(7) << r.point.ringSize << std::setw(7) << r.point.CreditLimit()
+        << std::setw(13) << std::fixed << std::setprecision(0) << r.eventsPerSec
+        << std::setw(7) << std::setprecision(2) << r.idleRatio
+        << std::setw(10) << r.enqueueRetries << std::setw(10) << r.creditWaits
+        << std::setw(11) << r.queueLatency.p50 << std::setw(11) << r.queueLatency.p99
+        << std::setw(12) << r.queueLatency.p9999 << std::setw(12) << r.queueLatency.max
+        << std::setw(4) << (r.point.l3Feed ? "on" : "off") << std::setw(13) << std::setprecision(0) << r.l3MessagesPerSec
+        << std::setw(9) << std::setprecision(1) << r.l3BytesPerSec / 1e6
+        << std::setw(10) << r.l3Dropped << std::setw(8) << r.l3Errors
+        << std::setw(6) << (r.point.riskStage ? "on" : "off") << std::setw(10) << r.riskRejected << "\n";
+    out.flags(flags);
+}
+
+void WriteSweepCsv(std::ostream& out, const std::vector<SweepResult>& results) {
+    out << "workload,producers,burst_size,ring_size,credit_fraction,credit_limit,seconds,events,events_per_sec,"
+           "produced_per_sec,idle_ratio,enqueue_retries,credit_waits,"
+           "queue_p50_ns,queue_p99_ns,queue_p999_ns,queue_p9999_ns,queue_max_ns,queue_samples,"
+           "l3_feed,l3_messages_per_sec,l3_bytes_per_sec,l3_dropped,l3_errors,risk_stage,risk_rejected\n";
+    for (const auto& r : results) {
+        out << ToString(r.workload) << ',' << r.point.producers << ',' << r.point.burstSize << ',' << r.point.ringSize << ','
+            << Fraction(r.point.creditFraction) << ',' << r.point.CreditLimit() << ','
+            << r.seconds << ',' << r.events << ',' << r.eventsPerSec << ','
+            << r.producedPerSec << ',' << r.idleRatio << ',' << r.enqueueRetries << ',' << r.creditWaits << ','
+            << r.queueLatency.p50 << ',' << r.queueLatency.p99 << ',' << r.queueLatency.p999 << ','
+            << r.queueLatency.p9999 << ',' << r.queueLatency.max << ',' << r.queueLatency.count << ','
+            << (r.point.l3Feed ? 1 : 0) << ',' << r.l3MessagesPerSec << ',' << r.l3BytesPerSec << ','
+            << r.l3Dropped << ',' << r.l3Errors << ','
+            << (r.point.riskStage ? 1 : 0) << ',' << r.riskRejected << '\n';
+    }
+}
+
+void WriteSweepJson(std::ostream& out, const std::vector<SweepResult>& results) {
+    out << "[\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const SweepResult& r = results[i];
+        out << "  {\"workload\": \"" << ToString(r.workload) << "\""
+            << ", \"producers\": " << r.point.producers
+            << ", \"burst_size\": " << r.point.burstSize
+            << ", \"ring_size\": " << r.point.ringSize
+            << ", \"credit_fraction\": " << Fraction(r.point.creditFraction)
+            << ", \"credit_limit\": " << r.point.CreditLimit()
+            << ", \"seconds\": " << r.seconds
+            << ", \"events\": " << r.events
+            << ", \"events_per_sec\": " << r.eventsPerSec
+            << ", \"produced_per_sec\": " << r.producedPerSec
+            << ", \"idle_ratio\": " << r.idleRatio
+            << ", \"enqueue_retries\": " << r.enqueueRetries
+            << ", \"credit_waits\": " << r.creditWaits
+            << ", \"queue_latency_ns\": {\"p50\": " << r.queueLatency.p50
+            << ", \"p99\": " << r.queueLatency.p99
+            << ", \"p999\": " << r.queueLatency.p999
+            << ", \"p9999\": " << r.queueLatency.p9999
+            << ", \"max\": " << r.queueLatency.max
+            << ", \"samples\": " << r.queueLatency.count << "}"
+            << ", \"l3_feed\": " << (r.point.l3Feed ? "true" : "false")
+            << ", \"l3_messages_per_sec\": " << r.l3MessagesPerSec
+            << ", \"l3_bytes_per_sec\": " << r.l3BytesPerSec
+            << ", \"l3_dropped\": " << r.l3Dropped
+            << ", \"l3_errors\": " << r.l3Errors
+            << ", \"risk_stage\": " << (r.point.riskStage ? "true" : "false")
+            << ", \"risk_rejected\": " << r.riskRejected << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+}
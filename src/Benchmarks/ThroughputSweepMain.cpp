@@ -0,0 +1,46 @@
+#include "Benchmarks/ThroughputSweep.h"
+
+#include "TimeUtils.h"
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// Multi-threaded throughput over a grid of producer counts, burst sizes, ring sizes and
+// credit windows. Runs at normal priority: with more threads than cores a realtime policy
+// would starve whichever side is not running.
+int main(int argc, char** argv) {
+    const benchmarks::SweepOptions opts = benchmarks::ParseSweepOptions(argc, argv);
+    const std::vector<benchmarks::SweepPoint> points = benchmarks::ExpandSweep(opts);
+
+    // Calibrate before any producer stamps an event.
+    const auto& clock = ob::time::TscClock::instance();
+
+    std::cout << "Throughput sweep: " << points.size() << " points, "
+              << opts.warmupSeconds << " s warm-up + " << opts.measureSeconds << " s measured each, "
+              << "workload " << ToString(opts.workload) << ", wait strategy " << ToString(opts.wait) << ", latency stamps "
+              << (clock.uses_counter() ? "cycle counter" : "steady_clock") << "\n";
+    std::cout << "Latency is sampled enqueue -> dequeue over all rings; credit is the window in events.\n\n";
+
+    std::vector<benchmarks::SweepResult> results;
+    results.reserve(points.size());
+
+    benchmarks::PrintSweepHeader(std::cout);
+    for (const auto& point : points) {
+        results.push_back(benchmarks::RunSweepPoint(point, opts));
+        benchmarks::PrintSweepRow(std::cout, results.back());
+        std::cout.flush();
+    }
+
+    if (!opts.csvPath.empty()) {
+        std::ofstream csv(opts.csvPath);
+        benchmarks::WriteSweepCsv(csv, results);
+        std::cout << (csv ? "Wrote " : "Failed to write ") << opts.csvPath << "\n";
+    }
+    if (!opts.jsonPath.empty()) {
+        std::ofstream json(opts.jsonPath);
+        benchmarks::WriteSweepJson(json, results);
+        std::cout << (json ? "Wrote " : "Failed to write ") << opts.jsonPath << "\n";
+    }
+    return 0;
+}
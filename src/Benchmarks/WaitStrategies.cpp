@@ -0,0 +1,129 @@
+#include "Benchmarks/WaitStrategies.h"
+
+#include "Benchmarks/BenchPrinter.h"
+#include "Benchmarks/Percentiles.h"
+
+#include "CpuTopology.h"
+#include "ThreadPinning.h"
+#include "TimeUtils.h"
+#include "WaitStrategy.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <time.h>
+
+namespace benchmarks {
+
+namespace {
+
+constexpr auto kWakeInterval = std::chrono::microseconds(50);
+
+std::int64_t NowNs() {
+    return static_cast<std::int64_t>(ob::time::now_ns());
+}
+
+std::int64_t ThreadCpuNs() {
+    timespec ts{};
+    if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+        return 0;
+    return static_cast<std::int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+struct WakeResult {
+    LatencyPercentilesNs latency;
+    double cpuShare = 0.0;     // waiter CPU time / wall time, 1.0 = one full core
+    std::uint64_t parks = 0;
+};
+
+WakeResult RunOne(WaitStrategyKind kind, std::size_t samples, const ThreadPlacement& placement) {
+    const WaitStrategy wait(kind);
+    ParkingSpot spot;
+
+    alignas(64) std::atomic<std::uint64_t> seq{0};
+    alignas(64) std::atomic<std::int64_t> stampNs{0};
+    alignas(64) std::atomic<std::uint64_t> ack{0};
+
+    LatencyHistogram latencies;
+    double cpuShare = 0.0;
+
+    std::thread waiter([&] {
+        PinCurrentThreadToCpu(placement.engineCpu);
+        const std::int64_t cpu0 = ThreadCpuNs();
+        const std::int64_t wall0 = NowNs();
+
+        for (std::uint64_t seen = 0; seen < samples; ++seen) {
+            std::uint32_t spins = 0;
+            const auto published = [&] { return seq.load(std::memory_order_acquire) != seen; };
+            while (!published())
+                wait.idle(spins, &spot, published);
+
+            const std::int64_t observed = NowNs();
+            latencies.record(static_cast<std::uint64_t>(observed - stampNs.load(std::memory_order_relaxed)));
+            ack.store(seen + 1, std::memory_order_release);
+        }
+
+        const std::int64_t wall = NowNs() - wall0;
+        cpuShare = wall > 0 ? static_cast<double>(ThreadCpuNs() - cpu0) / static_cast<double>(wall) : 0.0;
+    });
+
+    std::thread waker([&] {
+        PinCurrentThreadToCpu(placement.producerCpus.empty() ? -1 : placement.producerCpus[0]);
+        for (std::uint64_t n = 1; n <= samples; ++n) {
+            std::this_thread::sleep_for(kWakeInterval);
+            stampNs.store(NowNs(), std::memory_order_relaxed);
+            seq.store(n, std::memory_order_release);
+            wait.notify(spot);
+            while (ack.load(std::memory_order_acquire) != n)
+                std::this_thread::yield();
+        }
+    });
+
+    waker.join();
+    waiter.join();
+
+    WakeResult r;
+    r.latency = ComputeLatencyPercentilesNs(latencies);
+    r.cpuShare = cpuShare;
+    r.parks = spot.parks();
+    return r;
+}
+
+}
+
+void RunWaitStrategyBenchmark(std::size_t samples) {
+    if (samples == 0)
+        return;
+
+    const CpuTopology topology = DiscoverCpuTopology();
+    const ThreadPlacement placement = PlanThreadPlacement(topology, 1);
+    const bool separateCores = placement.engineCpu >= 0 && !placement.producerCpus.empty()
+                               && placement.producerCpus[0] >= 0 && placement.producerCpus[0] != placement.engineCpu;
+
+    std::cout << "Wait strategies: " << samples << " wake-ups every "
+              << kWakeInterval.count() << " us, waiter on cpu " << placement.engineCpu
+              << ", waker on cpu " << (placement.producerCpus.empty() ? -1 : placement.producerCpus[0]) << "\n";
+
+    for (const WaitStrategyKind kind : { WaitStrategyKind::BusySpin, WaitStrategyKind::SpinYield, WaitStrategyKind::SpinPark }) {
+        // A busy-spinning waiter sharing a core with the waker (possibly both SCHED_FIFO)
+        // would never let the waker run.
+        if (kind == WaitStrategyKind::BusySpin && !separateCores) {
+            std::cout << "Wake-up " << ToString(kind) << ": skipped, needs two distinct cores\n";
+            continue;
+        }
+
+        const WakeResult r = RunOne(kind, samples, placement);
+        PrintLatencyStats(std::string("Wake-up ") + ToString(kind), r.latency);
+        std::cout << "  waiter CPU: " << std::fixed << std::setprecision(1) << (r.cpuShare * 100.0)
+                  << "% of one core, parks=" << r.parks << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+    }
+}
+
+}
@@ -0,0 +1,463 @@
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "CpuTopology.h"
+#include "MatchingEngine.h"
+#include "OrderEntry.h"
+#include "ShmIngress.h"
+#include "ThreadPinning.h"
+#include "TimeUtils.h"
+#include "WaitStrategy.h"
+
+// obgateway: accepts order-entry clients on a localhost TCP port (OrderEntry.h) and hands
+// each connection's requests to the engine through an ingress ring of its own
+// (/dev/shm/<prefix>.in.<producerId>, see ShmIngress.h).
+//
+// One thread runs an edge-triggered epoll loop over the listening socket and every
+// connection. A readable connection is drained with large recv() calls into its buffer and
+// its messages are decoded in place, straight into the WireEvents pushed onto its ring; the
+// acks of one batch leave in one send(). A full ring stops reading from that connection,
+// which turns into TCP backpressure on the client, and the connection is retried every loop.
+//
+// Usage: obgateway [--port=9000] [--prefix=orderbook] [--first-producer=1024] [--engine]
+//                  [--seconds=N]
+//   --first-producer  producer id of the first connection; keep it clear of in-process producers
+//   --engine          run a matching engine in this process to drain the rings, instead of
+//                     an Orderbook started with --ingress=<prefix>
+//   --seconds         stop after N seconds (default: until SIGINT or SIGTERM)
+
+namespace {
+
+struct Options {
+    std::uint16_t port = 9000;
+    std::string prefix = "orderbook";
+    std::uint32_t firstProducer = 1024;
+    bool engine = false;
+    double seconds = 0.0;
+};
+
+bool ParseOptions(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg.rfind("--port=", 0) == 0) {
+            opts.port = static_cast<std::uint16_t>(std::strtoul(std::string(arg.substr(7)).c_str(), nullptr, 10));
+        } else if (arg.rfind("--prefix=", 0) == 0) {
+            opts.prefix = std::string(arg.substr(9));
+        } else if (arg.rfind("--first-producer=", 0) == 0) {
+            opts.firstProducer = static_cast<std::uint32_t>(std::strtoul(std::string(arg.substr(17)).c_str(), nullptr, 10));
+        } else if (arg == "--engine") {
+            opts.engine = true;
+        } else if (arg.rfind("--seconds=", 0) == 0) {
+            opts.seconds = std::strtod(std::string(arg.substr(10)).c_str(), nullptr);
+        } else {
+            std::cerr << "Unknown argument " << arg
+                      << " (expected --port=, --prefix=, --first-producer=, --engine, --seconds=)\n";
+            return false;
+        }
+    }
+    if (opts.prefix.empty()) {
+        std::cerr << "obgateway: --prefix must not be empty\n";
+        return false;
+    }
+    return true;
+}
+
+std::atomic<bool> g_running{true};
+
+void OnSignal(int) {
+    g_running.store(false, std::memory_order_relaxed);
+}
+
+// Sized for many messages per recv(); a partial message at the end is moved to the front.
+constexpr std::size_t kInBytes = 64 * 1024;
+// Acks a client has not read yet; past this the gateway stops reading its requests.
+constexpr std::size_t kMaxPendingAckBytes = 256 * 1024;
+// Every Nth request is stamped for the engine's ingress latency histogram.
+constexpr std::uint64_t kSampleEvery = 64;
+// A closed connection's ring is kept until the engine has drained it, or this long.
+constexpr auto kRetireTimeout = std::chrono::seconds(2);
+
+struct Connection {
+    int fd = -1;
+    std::uint32_t producerId = 0;
+    IngressRing ring;
+    std::unique_ptr<std::uint8_t[]> in = std::make_unique<std::uint8_t[]>(kInBytes);
+    std::size_t inBegin = 0;
+    std::size_t inEnd = 0;
+    std::vector<std::uint8_t> out;          // acks not yet sent, from outSent on
+    std::size_t outSent = 0;
+    bool readable = false;                  // an edge was seen and recv() has not hit EAGAIN
+    bool stalled = false;                   // stopped on a full ring or unread acks
+    bool peerClosed = false;
+};
+
+struct GatewayStats {
+    std::uint64_t connections = 0;
+    std::uint64_t requests = 0;
+    std::uint64_t rejected = 0;
+    std::uint64_t stalls = 0;
+    std::uint64_t recvCalls = 0;
+    std::uint64_t sendCalls = 0;
+    std::uint64_t bytesIn = 0;
+};
+
+struct RetiredRing {
+    IngressRing ring;
+    std::chrono::steady_clock::time_point since;
+};
+
+class Gateway {
+public:
+    Gateway(const Options& opts, WaitStrategy wait) : opts_(opts), wait_(wait), nextProducer_(opts.firstProducer) {}
+
+    ~Gateway() {
+        for (auto& [fd, c] : connections_)
+            close(fd);
+        if (epoll_ >= 0)
+            close(epoll_);
+        if (listen_ >= 0)
+            close(listen_);
+    }
+
+    bool open() {
+        listen_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_ < 0)
+            return fail("socket");
+        const int one = 1;
+        setsockopt(listen_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(opts_.port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(listen_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0)
+            return fail("bind");
+        if (listen(listen_, 64) != 0)
+            return fail("listen");
+
+        epoll_ = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_ < 0)
+            return fail("epoll_create1");
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.fd = listen_;
+        if (epoll_ctl(epoll_, EPOLL_CTL_ADD, listen_, &ev) != 0)
+            return fail("epoll_ctl");
+        return true;
+    }
+
+    // Serves clients until SIGINT/SIGTERM or `deadline`, then closes every connection.
+    void run(std::chrono::steady_clock::time_point deadline) {
+        constexpr int kMaxEvents = 64;
+        epoll_event events[kMaxEvents];
+        std::uint32_t spins = 0;
+
+        while (g_running.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() < deadline) {
+            // A stalled connection has work epoll will not report again: poll instead of block.
+            const int n = epoll_wait(epoll_, events, kMaxEvents, stalled_ ? 0 : 100);
+            for (int i = 0; i < n; ++i) {
+                if (events[i].data.fd == listen_) {
+                    accept_all();
+                    continue;
+                }
+                const auto it = connections_.find(events[i].data.fd);
+                if (it == connections_.end())
+                    continue;
+                Connection& c = *it->second;
+                if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+                    c.readable = true;
+                if (!service(c))
+                    drop(c.fd);
+            }
+
+            stalled_ = 0;
+            for (auto it = connections_.begin(); it != connections_.end();) {
+                Connection& c = *it->second;
+                ++it;
+                if (c.stalled && !service(c))
+                    drop(c.fd);
+                else if (c.stalled)
+                    ++stalled_;
+            }
+            if (stalled_ && n == 0)
+                wait_.idle(spins);
+            else
+                spins = 0;
+
+            reap_retired(false);
+        }
+
+        while (!connections_.empty())
+            drop(connections_.begin()->first);
+    }
+
+    // Waits for the engine to drain what was left in the closed connections' rings.
+    void finish() {
+        const auto deadline = std::chrono::steady_clock::now() + kRetireTimeout;
+        while (!retired_.empty() && std::chrono::steady_clock::now() < deadline) {
+            reap_retired(false);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        reap_retired(true);
+    }
+
+    const GatewayStats& stats() const { return stats_; }
+
+private:
+    bool fail(const char* what) {
+        std::cerr << "obgateway: " << what << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    void accept_all() {
+        for (;;) {
+            const int fd = accept4(listen_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                    fail("accept4");
+                if (errno == EINTR)
+                    continue;
+                return;
+            }
+            const int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            auto c = std::make_unique<Connection>();
+            c->fd = fd;
+            c->producerId = nextProducer_++;
+            std::string error;
+            c->ring = IngressRing::Create(IngressSegmentName(opts_.prefix, c->producerId), c->producerId, 1, &error);
+            if (!c->ring.valid()) {
+                std::cerr << "obgateway: " << error << "\n";
+                close(fd);
+                continue;
+            }
+
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            ev.data.fd = fd;
+            if (epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+                fail("epoll_ctl");
+                close(fd);
+                continue;
+            }
+            ++stats_.connections;
+            std::cout << "obgateway: connection " << c->producerId << " -> /dev/shm/" << c->ring.name() << "\n";
+            connections_.emplace(fd, std::move(c));
+        }
+    }
+
+    // Decodes and queues what is buffered, reads more while the socket has it, then sends the
+    // acks. False once the connection is finished (peer gone and nothing left) or broken.
+    bool service(Connection& c) {
+        c.stalled = false;
+        for (;;) {
+            if (!decode(c))
+                return false;
+            if (c.stalled)
+                break;
+
+            // Keep the partial message, if any, at the front.
+            if (c.inBegin > 0) {
+                std::memmove(c.in.get(), c.in.get() + c.inBegin, c.inEnd - c.inBegin);
+                c.inEnd -= c.inBegin;
+                c.inBegin = 0;
+            }
+            if (!c.readable)
+                break;
+
+            const ssize_t r = recv(c.fd, c.in.get() + c.inEnd, kInBytes - c.inEnd, 0);
+            ++stats_.recvCalls;
+            if (r > 0) {
+                c.inEnd += static_cast<std::size_t>(r);
+                stats_.bytesIn += static_cast<std::uint64_t>(r);
+            } else if (r == 0) {
+                c.peerClosed = true;
+                c.readable = false;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                c.readable = false;
+            } else if (errno != EINTR) {
+                return false;
+            }
+        }
+
+        if (!flush(c))
+            return false;
+        return !(c.peerClosed && c.inBegin == c.inEnd && c.outSent == c.out.size());
+    }
+
+    bool decode(Connection& c) {
+        OrderEntryRequest request;
+        bool bad = false;
+        while (c.inBegin < c.inEnd) {
+            if (c.out.size() - c.outSent >= kMaxPendingAckBytes) {
+                stall(c);
+                return true;
+            }
+            const std::size_t size = DecodeOrderEntry(c.in.get() + c.inBegin, c.inEnd - c.inBegin,
+                                                      c.producerId, request, bad);
+            if (bad) {
+                std::cerr << "obgateway: connection " << c.producerId << " sent an unknown message type\n";
+                return false;
+            }
+            if (size == 0)
+                return true;
+
+            if (request.valid) {
+                if (stats_.requests % kSampleEvery == 0)
+                    request.event.enqueueNs = ob::time::steady_now_ns();
+                if (!c.ring.ring().push(request.event)) {
+                    stall(c);
+                    return true;
+                }
+            } else {
+                ++stats_.rejected;
+            }
+            ++stats_.requests;
+
+            const std::size_t at = c.out.size();
+            c.out.resize(at + OrderEntryAckSize);
+            EncodeAck(c.out.data() + at, request.valid ? AckStatus::Accepted : AckStatus::Rejected,
+                      request.clientOrderId, request.tag);
+            c.inBegin += size;
+        }
+        return true;
+    }
+
+    void stall(Connection& c) {
+        if (!c.stalled)
+            ++stats_.stalls;
+        c.stalled = true;
+    }
+
+    bool flush(Connection& c) {
+        while (c.outSent < c.out.size()) {
+            const ssize_t s = send(c.fd, c.out.data() + c.outSent, c.out.size() - c.outSent, MSG_NOSIGNAL);
+            ++stats_.sendCalls;
+            if (s > 0) {
+                c.outSent += static_cast<std::size_t>(s);
+            } else if (s < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return true;            // EPOLLOUT brings us back
+            } else if (s < 0 && errno == EINTR) {
+                continue;
+            } else {
+                return false;
+            }
+        }
+        c.out.clear();
+        c.outSent = 0;
+        return true;
+    }
+
+    void drop(int fd) {
+        const auto it = connections_.find(fd);
+        if (it == connections_.end())
+            return;
+        Connection& c = *it->second;
+        epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        c.ring.close();
+        std::cout << "obgateway: connection " << c.producerId << " closed\n";
+        retired_.push_back({ std::move(c.ring), std::chrono::steady_clock::now() });
+        connections_.erase(it);
+    }
+
+    // Unmapping a ring unlinks its name, so one the engine has not attached yet is kept until
+    // it has been drained.
+    void reap_retired(bool force) {
+        const auto now = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < retired_.size();) {
+            RetiredRing& r = retired_[i];
+            const bool expired = now - r.since >= kRetireTimeout;
+            if (force || r.ring.ring().empty() || expired) {
+                if (!r.ring.ring().empty())
+                    std::cerr << "obgateway: /dev/shm/" << r.ring.name() << " closed with "
+                              << r.ring.ring().available() << " events no engine drained\n";
+                retired_[i] = std::move(retired_.back());
+                retired_.pop_back();
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    const Options& opts_;
+    WaitStrategy wait_;
+    int listen_ = -1;
+    int epoll_ = -1;
+    std::uint32_t nextProducer_;
+    std::size_t stalled_ = 0;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+    std::vector<RetiredRing> retired_;
+    GatewayStats stats_;
+};
+
+}
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!ParseOptions(argc, argv, opts))
+        return 2;
+
+    signal(SIGINT, OnSignal);
+    signal(SIGTERM, OnSignal);
+
+    const WaitStrategy wait(WaitStrategyKind::SpinYield);
+    const CpuTopology topology = DiscoverCpuTopology();
+    const ThreadPlacement placement = PlanThreadPlacement(topology, 1);
+
+    Gateway gateway(opts, wait);
+    if (!gateway.open())
+        return 1;
+    std::cout << "obgateway: listening on 127.0.0.1:" << opts.port << ", rings /dev/shm/" << opts.prefix
+              << ".in.<id> from id " << opts.firstProducer << "\n";
+
+    // The engine gets no in-process channels: everything it drains comes from the rings.
+    std::vector<ProducerChannel> noChannels;
+    std::unique_ptr<MatchingEngine> engine;
+    if (opts.engine) {
+        engine = std::make_unique<MatchingEngine>(noChannels, 64, placement.engineCpu, wait);
+        engine->EnableIngress(opts.prefix);
+        engine->start();
+        std::cout << "obgateway: engine on cpu " << placement.engineCpu << "\n";
+    }
+
+    const auto deadline = opts.seconds > 0.0
+        ? std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              std::chrono::duration<double>(opts.seconds))
+        : std::chrono::steady_clock::time_point::max();
+
+    PinCurrentThreadToCpu(placement.producerCpus.empty() ? -1 : placement.producerCpus[0]);
+    gateway.run(deadline);
+    gateway.finish();
+
+    const GatewayStats& s = gateway.stats();
+    std::cout << "obgateway: " << s.connections << " connection(s), " << s.requests << " requests ("
+              << s.rejected << " rejected), " << s.bytesIn << " bytes in " << s.recvCalls << " recv / "
+              << s.sendCalls << " send calls, " << s.stalls << " stalls on a full ring or unread acks\n";
+    if (engine) {
+        engine->stop();
+        std::cout << "obgateway: engine processed " << engine->EventsProcessed() << " events, "
+                  << engine->OrderCount() << " orders resting\n";
+    }
+    return 0;
+}
@@ -0,0 +1,265 @@
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "LatencyHistogram.h"
+#include "OrderEntry.h"
+#include "TimeUtils.h"
+
+// obloadgen: order-entry load over loopback TCP against obgateway (OrderEntry.h). Each
+// connection is a thread with a blocking socket that keeps up to --window requests in
+// flight: it writes as many as the window allows in one send(), then reads whatever acks
+// have arrived. A request's tag is its send time, so every ack is one round-trip sample.
+//
+// The flow keeps a small book per connection: mostly passive adds around a fixed mid, a
+// cancel for each add once `kResting` are out, a modify every 8th step and a crossing
+// FillAndKill every 16th so that some requests match.
+//
+// Usage: obloadgen [--host=127.0.0.1] [--port=9000] [--connections=1] [--window=64]
+//                  [--warmup=seconds] [--seconds=seconds]
+
+namespace {
+
+struct Options {
+    std::string host = "127.0.0.1";
+    std::uint16_t port = 9000;
+    std::size_t connections = 1;
+    std::size_t window = 64;
+    double warmupSeconds = 0.5;
+    double measureSeconds = 5.0;
+};
+
+bool ParseOptions(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg.rfind("--host=", 0) == 0) {
+            opts.host = std::string(arg.substr(7));
+        } else if (arg.rfind("--port=", 0) == 0) {
+            opts.port = static_cast<std::uint16_t>(std::strtoul(std::string(arg.substr(7)).c_str(), nullptr, 10));
+        } else if (arg.rfind("--connections=", 0) == 0) {
+            opts.connections = std::strtoull(std::string(arg.substr(14)).c_str(), nullptr, 10);
+        } else if (arg.rfind("--window=", 0) == 0) {
+            opts.window = std::strtoull(std::string(arg.substr(9)).c_str(), nullptr, 10);
+        } else if (arg.rfind("--warmup=", 0) == 0) {
+            opts.warmupSeconds = std::strtod(std::string(arg.substr(9)).c_str(), nullptr);
+        } else if (arg.rfind("--seconds=", 0) == 0) {
+            opts.measureSeconds = std::strtod(std::string(arg.substr(10)).c_str(), nullptr);
+        } else {
+            std::cerr << "Unknown argument " << arg
+                      << " (expected --host=, --port=, --connections=, --window=, --warmup=, --seconds=)\n";
+            return false;
+        }
+    }
+    if (opts.connections == 0)
+        opts.connections = 1;
+    if (opts.window == 0)
+        opts.window = 1;
+    return true;
+}
+
+enum class Phase : int { Warmup, Measure, Stop };
+
+constexpr std::uint32_t kResting = 1000;
+constexpr Price kMid = 100;
+
+// Generates one connection's requests; ids start at 1 and only grow.
+class Flow {
+public:
+    explicit Flow(std::uint32_t seed) : rng_(seed) {}
+
+    std::uint8_t* next(std::uint8_t* p, std::uint64_t tag) {
+        const std::uint64_t step = step_++;
+        if ((step & 1) && nextId_ - cancelId_ > kResting) {
+            const std::uint32_t id = cancelId_++;
+            return EncodeCancelOrder(p, id, tag);
+        }
+        if ((step & 7) == 2 && nextId_ > 1) {
+            const std::uint32_t id = nextId_ - 1;
+            return EncodeModifyOrder(p, id, side(id), passive(side(id)), 1 + rng_() % 10, tag);
+        }
+        const std::uint32_t id = nextId_++;
+        const Side s = side(id);
+        if ((step & 15) == 4)
+            return EncodeNewOrder(p, OrderType::FillAndKill, id, s, s == Side::Buy ? kMid + 5 : kMid - 5,
+                                  1 + rng_() % 10, tag);
+        return EncodeNewOrder(p, OrderType::GoodTillCancel, id, s, passive(s), 1 + rng_() % 10, tag);
+    }
+
+private:
+    static Side side(std::uint32_t id) { return (id & 1) ? Side::Buy : Side::Sell; }
+
+    Price passive(Side s) {
+        const auto ticks = static_cast<Price>(rng_() % 10);
+        return s == Side::Buy ? kMid - 1 - ticks : kMid + 1 + ticks;
+    }
+
+    std::minstd_rand rng_;
+    std::uint64_t step_ = 0;
+    std::uint32_t nextId_ = 1;
+    std::uint32_t cancelId_ = 1;
+};
+
+struct ConnectionResult {
+    bool connected = false;
+    std::uint64_t acks = 0;             // measured phase
+    std::uint64_t rejected = 0;
+    LatencyHistogram roundTrip;
+};
+
+int Connect(const Options& opts) {
+    const int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+    const int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(opts.port);
+    if (inet_pton(AF_INET, opts.host.c_str(), &addr.sin_addr) != 1
+        || connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool SendAll(int fd, const std::uint8_t* p, std::size_t size) {
+    while (size) {
+        const ssize_t s = send(fd, p, size, MSG_NOSIGNAL);
+        if (s < 0 && errno == EINTR)
+            continue;
+        if (s <= 0)
+            return false;
+        p += s;
+        size -= static_cast<std::size_t>(s);
+    }
+    return true;
+}
+
+void RunConnection(const Options& opts, std::size_t index, const std::atomic<Phase>& phase, ConnectionResult& result) {
+    const int fd = Connect(opts);
+    if (fd < 0) {
+        std::cerr << "obloadgen: connect to " << opts.host << ":" << opts.port << ": " << std::strerror(errno) << "\n";
+        return;
+    }
+    result.connected = true;
+
+    Flow flow(static_cast<std::uint32_t>(index + 1));
+    std::vector<std::uint8_t> out(opts.window * OrderEntryMaxSize);
+    std::vector<std::uint8_t> in(64 * 1024);
+    std::size_t inSize = 0;
+    std::size_t inFlight = 0;
+
+    for (;;) {
+        const Phase now = phase.load(std::memory_order_relaxed);
+        if (now == Phase::Stop && inFlight == 0)
+            break;
+
+        if (now != Phase::Stop && inFlight < opts.window) {
+            std::uint8_t* p = out.data();
+            const std::uint64_t tag = ob::time::now_ns();
+            for (; inFlight < opts.window; ++inFlight)
+                p = flow.next(p, tag);
+            if (!SendAll(fd, out.data(), static_cast<std::size_t>(p - out.data())))
+                break;
+        }
+
+        const ssize_t r = recv(fd, in.data() + inSize, in.size() - inSize, 0);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+            break;
+        inSize += static_cast<std::size_t>(r);
+
+        const std::uint64_t received = ob::time::now_ns();
+        const bool measuring = phase.load(std::memory_order_relaxed) == Phase::Measure;
+        std::size_t at = 0;
+        AckStatus status{};
+        std::uint32_t id = 0;
+        std::uint64_t tag = 0;
+        while (const std::size_t n = DecodeAck(in.data() + at, inSize - at, status, id, tag)) {
+            at += n;
+            --inFlight;
+            if (!measuring)
+                continue;
+            ++result.acks;
+            result.rejected += status == AckStatus::Rejected;
+            result.roundTrip.record(received > tag ? received - tag : 0);
+        }
+        std::memmove(in.data(), in.data() + at, inSize - at);
+        inSize -= at;
+    }
+    close(fd);
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!ParseOptions(argc, argv, opts))
+        return 2;
+
+    // Calibrate before any thread stamps a request.
+    const auto& clock = ob::time::TscClock::instance();
+    std::cout << "obloadgen: " << opts.connections << " connection(s) to " << opts.host << ":" << opts.port
+              << ", window " << opts.window << ", " << opts.warmupSeconds << " s warm-up + "
+              << opts.measureSeconds << " s measured, stamps "
+              << (clock.uses_counter() ? "cycle counter" : "steady_clock") << "\n";
+
+    std::atomic<Phase> phase{Phase::Warmup};
+    std::vector<std::unique_ptr<ConnectionResult>> results;
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < opts.connections; ++i) {
+        results.push_back(std::make_unique<ConnectionResult>());
+        threads.emplace_back(RunConnection, std::cref(opts), i, std::cref(phase), std::ref(*results.back()));
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(opts.warmupSeconds));
+    phase.store(Phase::Measure, std::memory_order_relaxed);
+    const auto t0 = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(opts.measureSeconds));
+    phase.store(Phase::Stop, std::memory_order_relaxed);
+    const std::chrono::duration<double> measured = std::chrono::steady_clock::now() - t0;
+    for (auto& t : threads)
+        t.join();
+
+    std::uint64_t acks = 0;
+    std::uint64_t rejected = 0;
+    std::size_t connected = 0;
+    LatencyHistogram roundTrip;
+    for (const auto& r : results) {
+        connected += r->connected;
+        acks += r->acks;
+        rejected += r->rejected;
+        roundTrip.merge(r->roundTrip);
+    }
+    if (connected == 0)
+        return 1;
+
+    const double seconds = measured.count();
+    std::cout << "obloadgen: " << connected << " connected, " << acks << " acks (" << rejected << " rejected), "
+              << std::fixed << std::setprecision(0) << (seconds > 0.0 ? static_cast<double>(acks) / seconds : 0.0)
+              << " requests/s\n";
+    std::cout << "round trip ns: p50 " << roundTrip.quantile(0.50) << "  p99 " << roundTrip.quantile(0.99)
+              << "  p99.9 " << roundTrip.quantile(0.999) << "  p99.99 " << roundTrip.quantile(0.9999)
+              << "  max " << roundTrip.max() << "\n";
+    return 0;
+}
@@ -0,0 +1,311 @@
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+
+#include "LatencyHistogram.h"
+#include "Telemetry.h"
+#include "TimeUtils.h"
+
+// obstat: prints an Orderbook process's live statistics from its telemetry segment
+// (/dev/shm/<name>, see Telemetry.h). It only maps the segment read-only: the engine never
+// knows it is there, and it can poll at any interval.
+//
+// Usage: obstat [--name=orderbook] [--interval=ms] [--count=N] [--counters]
+//   --interval  period between lines, default 1000 ms
+//   --count     stop after N periods (default: until the engine stops)
+//   --counters  skip latency histograms; reads only the counter lines, not 35 KiB each
+
+namespace {
+
+struct Options {
+    std::string name = "orderbook";
+    std::uint64_t intervalMs = 1000;
+    std::uint64_t count = 0;
+    bool counters = false;
+};
+
+bool ParseOptions(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg.rfind("--name=", 0) == 0) {
+            opts.name = std::string(arg.substr(7));
+        } else if (arg.rfind("--interval=", 0) == 0) {
+            opts.intervalMs = std::strtoull(std::string(arg.substr(11)).c_str(), nullptr, 10);
+        } else if (arg.rfind("--count=", 0) == 0) {
+            opts.count = std::strtoull(std::string(arg.substr(8)).c_str(), nullptr, 10);
+        } else if (arg == "--counters") {
+            opts.counters = true;
+        } else {
+            std::cerr << "Unknown argument " << arg
+                      << " (expected --name=, --interval=ms, --count=N, --counters)\n";
+            return false;
+        }
+    }
+    if (opts.intervalMs == 0)
+        opts.intervalMs = 1;
+    return true;
+}
+
+std::uint64_t Load(const std::atomic<std::uint64_t>& field) {
+    return field.load(std::memory_order_relaxed);
+}
+
+struct ChannelSnapshot {
+    std::uint64_t events = 0;
+    std::uint64_t visits = 0;
+    std::uint64_t adds = 0;
+    std::uint64_t cancels = 0;
+    std::uint64_t modifies = 0;
+    std::uint64_t laneEvents = 0;
+    std::uint64_t overtakenAdds = 0;
+    std::uint64_t depth = 0;
+    std::uint64_t produced = 0;
+    std::uint64_t enqueueRetries = 0;
+    std::uint64_t poolWaitSpins = 0;
+    std::uint64_t creditLimit = 0;
+    std::uint64_t creditsInFlight = 0;
+    std::uint64_t creditWaitCalls = 0;
+    std::uint64_t creditWaitSpins = 0;
+    LatencyHistogram queueLatency;
+    LatencyHistogram cancelLatency;
+};
+
+struct Snapshot {
+    std::uint64_t takenNs = 0;
+    std::uint64_t publishNs = 0;
+    TelemetryState state = TelemetryState::Starting;
+    std::uint64_t events = 0;
+    std::uint64_t idleLoops = 0;
+    std::uint64_t busyRounds = 0;
+    std::uint64_t parks = 0;
+    std::uint64_t bookOps = 0;
+    std::uint64_t orders = 0;
+    std::uint64_t ingressRings = 0;
+    std::uint64_t ingressEvents = 0;
+    std::uint64_t levelChanges = 0;
+    std::uint64_t levelDeltas = 0;
+    std::uint64_t levelDeltasDropped = 0;
+    std::uint64_t l3Messages = 0;
+    std::uint64_t l3Bytes = 0;
+    std::uint64_t l3Dropped = 0;
+    LatencyHistogram ingressLatency;
+    std::vector<ChannelSnapshot> channels;
+    StageLatency stages;
+};
+
+void Take(const TelemetryRegion& region, bool histograms, Snapshot& out) {
+    const TelemetryHeader& header = region.header();
+    const EngineTelemetry& engine = region.engine();
+
+    out.takenNs = ob::time::steady_now_ns();
+    out.publishNs = Load(header.publishNs);
+    out.state = static_cast<TelemetryState>(header.state.load(std::memory_order_relaxed));
+    out.events = Load(engine.events);
+    out.idleLoops = Load(engine.idleLoops);
+    out.busyRounds = Load(engine.busyRounds);
+    out.parks = Load(engine.parks);
+    out.bookOps = Load(engine.bookOps);
+    out.orders = Load(engine.orders);
+    out.ingressRings = Load(engine.ingressRings);
+    out.ingressEvents = Load(engine.ingressEvents);
+    out.levelChanges = Load(engine.levelChanges);
+    out.levelDeltas = Load(engine.levelDeltas);
+    out.levelDeltasDropped = Load(engine.levelDeltasDropped);
+    out.l3Messages = Load(engine.l3Messages);
+    out.l3Bytes = Load(engine.l3Bytes);
+    out.l3Dropped = Load(engine.l3Dropped);
+    if (histograms)
+        out.ingressLatency = engine.ingressLatency;
+
+    out.channels.resize(region.channel_count());
+    for (std::size_t i = 0; i < out.channels.size(); ++i) {
+        const ChannelTelemetry& c = region.channel(i);
+        ChannelSnapshot& s = out.channels[i];
+        s.events = Load(c.events);
+        s.visits = Load(c.visits);
+        s.adds = Load(c.adds);
+        s.cancels = Load(c.cancels);
+        s.modifies = Load(c.modifies);
+        s.laneEvents = Load(c.laneEvents);
+        s.overtakenAdds = Load(c.overtakenAdds);
+        s.depth = Load(c.depth);
+        s.produced = Load(c.produced);
+        s.enqueueRetries = Load(c.enqueueRetries);
+        s.poolWaitSpins = Load(c.poolWaitSpins);
+        s.creditLimit = Load(c.creditLimit);
+        s.creditsInFlight = Load(c.creditsInFlight);
+        s.creditWaitCalls = Load(c.creditWaitCalls);
+        s.creditWaitSpins = Load(c.creditWaitSpins);
+        if (histograms) {
+            s.queueLatency = c.queueLatency;
+            s.cancelLatency = c.cancelLatency;
+        }
+    }
+    if (histograms && (header.flags & TelemetryFlagTracing))
+        out.stages = region.stages();
+}
+
+void PrintLatency(const char* name, const LatencyHistogram& now, const LatencyHistogram& last) {
+    LatencyHistogram h = now;
+    h.subtract(last);
+    std::cout << name << " n=" << h.count()
+              << " p50=" << h.quantile(0.5)
+              << " p99=" << h.quantile(0.99)
+              << " p99.99=" << h.quantile(0.9999)
+              << " max=" << h.max();
+}
+
+// One block of lines for the interval between `last` and `now`, in the format the engine's
+// in-process monitor used to print.
+void PrintInterval(const TelemetryRegion& region, const Snapshot& last, const Snapshot& now, bool histograms) {
+    const double seconds = static_cast<double>(now.takenNs - last.takenNs) / 1e9;
+    auto rate = [seconds](std::uint64_t a, std::uint64_t b) {
+        return seconds > 0.0 ? static_cast<double>(b - a) / seconds : 0.0;
+    };
+
+    std::uint64_t produced = 0;
+    std::uint64_t lastProduced = 0;
+    std::uint64_t depth = 0;
+    for (std::size_t i = 0; i < now.channels.size(); ++i) {
+        produced += now.channels[i].produced;
+        lastProduced += last.channels[i].produced;
+        depth += now.channels[i].depth;
+    }
+    const std::uint64_t rounds = (now.idleLoops - last.idleLoops) + (now.busyRounds - last.busyRounds);
+    const double idleRatio = rounds ? static_cast<double>(now.idleLoops - last.idleLoops) / static_cast<double>(rounds) : 0.0;
+    const double publishAgeMs = now.takenNs > now.publishNs
+        ? static_cast<double>(now.takenNs - now.publishNs) / 1e6 : 0.0;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << ToString(now.state)
+              << " ev/s=" << rate(last.events, now.events)
+              << " ops/s=" << rate(last.bookOps, now.bookOps)
+              << " prod/s=" << rate(lastProduced, produced)
+              << " qDepth=" << depth
+              << " orders=" << now.orders
+              << " idle=" << idleRatio
+              << " parks=" << (now.parks - last.parks)
+              << " publishAgeMs=" << publishAgeMs
+              << "\n";
+
+    for (std::size_t i = 0; i < now.channels.size(); ++i) {
+        const ChannelSnapshot& a = last.channels[i];
+        const ChannelSnapshot& b = now.channels[i];
+        const ChannelTelemetry& c = region.channel(i);
+        std::cout << "  q" << i << " producer=" << c.producerId << " w=" << c.weight
+                  << " ev/s=" << rate(a.events, b.events)
+                  << " add/s=" << rate(a.adds, b.adds)
+                  << " cancel/s=" << rate(a.cancels, b.cancels)
+                  << " modify/s=" << rate(a.modifies, b.modifies)
+                  << " visits=" << (b.visits - a.visits)
+                  << " laneCancels=" << (b.laneEvents - a.laneEvents)
+                  << " overtakenAdds=" << (b.overtakenAdds - a.overtakenAdds)
+                  << "\n    depth=" << b.depth
+                  << " credits=" << b.creditsInFlight << "/" << b.creditLimit
+                  << " bpWaitCalls=" << (b.creditWaitCalls - a.creditWaitCalls)
+                  << " bpWaitSpins=" << (b.creditWaitSpins - a.creditWaitSpins)
+                  << " poolWaitSpins=" << (b.poolWaitSpins - a.poolWaitSpins)
+                  << " enqueueRetries=" << (b.enqueueRetries - a.enqueueRetries)
+                  << "\n";
+        if (histograms) {
+            std::cout << "    ";
+            PrintLatency("queueLatNs", b.queueLatency, a.queueLatency);
+            std::cout << " | ";
+            PrintLatency("cancelLatNs", b.cancelLatency, a.cancelLatency);
+            std::cout << "\n";
+        }
+    }
+
+    if (now.ingressRings || now.ingressEvents != last.ingressEvents) {
+        std::cout << "  ingress rings=" << now.ingressRings
+                  << " ev/s=" << rate(last.ingressEvents, now.ingressEvents);
+        if (histograms) {
+            std::cout << " ";
+            PrintLatency("latNs", now.ingressLatency, last.ingressLatency);
+        }
+        std::cout << "\n";
+    }
+
+    if (now.levelChanges) {
+        std::cout << "  l2 changes/s=" << rate(last.levelChanges, now.levelChanges)
+                  << " deltas/s=" << rate(last.levelDeltas, now.levelDeltas)
+                  << " dropped=" << (now.levelDeltasDropped - last.levelDeltasDropped)
+                  << "\n";
+    }
+
+    if (now.l3Messages || now.l3Dropped) {
+        std::cout << "  l3 msg/s=" << rate(last.l3Messages, now.l3Messages)
+                  << " MB/s=" << rate(last.l3Bytes, now.l3Bytes) / 1e6
+                  << " dropped=" << (now.l3Dropped - last.l3Dropped)
+                  << "\n";
+    }
+
+    if (histograms && (region.header().flags & TelemetryFlagTracing)) {
+        std::cout << "  traceNs ";
+        PrintLatency("produce", now.stages.produce, last.stages.produce);
+        std::cout << " | ";
+        PrintLatency("queue", now.stages.queue, last.stages.queue);
+        std::cout << " | ";
+        PrintLatency("dispatch", now.stages.dispatch, last.stages.dispatch);
+        std::cout << " | ";
+        PrintLatency("match", now.stages.match, last.stages.match);
+        std::cout << " | ";
+        PrintLatency("total", now.stages.total, last.stages.total);
+        std::cout << "\n";
+    }
+    std::cout << std::flush;
+}
+
+bool WriterAlive(const TelemetryRegion& region) {
+    return kill(region.header().pid, 0) == 0 || errno == EPERM;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!ParseOptions(argc, argv, opts))
+        return 2;
+
+    std::string error;
+    const TelemetryRegion region = TelemetryRegion::Open(opts.name, &error);
+    if (!region.valid()) {
+        std::cerr << "obstat: " << error << "\n";
+        return 1;
+    }
+
+    const TelemetryHeader& header = region.header();
+    std::cout << "obstat: /dev/shm/" << region.name() << " pid " << header.pid
+              << ", " << header.channelCount << " channel(s)"
+              << ((header.flags & TelemetryFlagTracing) ? ", tracing on" : "")
+              << ", every " << opts.intervalMs << " ms\n";
+
+    const bool histograms = !opts.counters;
+    Snapshot last;
+    Snapshot now;
+    Take(region, histograms, last);
+
+    for (std::uint64_t n = 0; opts.count == 0 || n < opts.count; ++n) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(opts.intervalMs));
+        Take(region, histograms, now);
+        PrintInterval(region, last, now, histograms);
+        std::swap(last, now);
+
+        if (last.state == TelemetryState::Stopped)
+            break;
+        if (!WriterAlive(region)) {
+            std::cout << "obstat: writer pid " << header.pid << " is gone\n";
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,299 @@
+#include "CpuTopology.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace {
+
+constexpr const char* kSysCpu = "/sys/devices/system/cpu";
+
+std::string ReadFirstLine(const std::string& path)
+{
+    std::ifstream in(path);
+    std::string line;
+    if (in)
+        std::getline(in, line);
+    return line;
+}
+
+std::int32_t ReadInt(const std::string& path, std::int32_t fallback)
+{
+    const std::string s = ReadFirstLine(path);
+    std::int32_t value = fallback;
+    if (!s.empty())
+        std::from_chars(s.data(), s.data() + s.size(), value);
+    return value;
+}
+
+bool Contains(const std::vector<std::uint32_t>& v, std::uint32_t x)
+{
+    return std::find(v.begin(), v.end(), x) != v.end();
+}
+
+#if defined(__linux__)
+std::int32_t ReadL3Id(std::uint32_t cpu)
+{
+    const std::string base = std::string(kSysCpu) + "/cpu" + std::to_string(cpu) + "/cache/index";
+    std::int32_t best = -1;
+    std::int32_t bestLevel = 0;
+    for (int idx = 0; idx < 8; ++idx) {
+        const std::string dir = base + std::to_string(idx);
+        const std::int32_t level = ReadInt(dir + "/level", -1);
+        if (level < 0)
+            break;
+        if (level < bestLevel)
+            continue;
+        const auto shared = ParseCpuList(ReadFirstLine(dir + "/shared_cpu_list"));
+        if (shared.empty())
+            continue;
+        bestLevel = level;
+        best = static_cast<std::int32_t>(*std::min_element(shared.begin(), shared.end()));
+    }
+    return best;
+}
+#endif
+
+struct PhysicalCore {
+    std::vector<std::uint32_t> cpus;
+    std::int32_t packageId = -1;
+    std::int32_t l3Id = -1;
+    bool isolated = false;
+};
+
+std::vector<PhysicalCore> GroupPhysicalCores(const CpuTopology& topology)
+{
+    std::vector<PhysicalCore> cores;
+    std::vector<std::uint32_t> seen;
+    for (const auto& c : topology.cpus) {
+        if (Contains(seen, c.cpu))
+            continue;
+
+        PhysicalCore core;
+        core.packageId = c.packageId;
+        core.l3Id = c.l3Id;
+        core.isolated = true;
+        for (auto s : c.smtSiblings) {
+            const CpuInfo* sib = topology.Find(s);
+            if (!sib)
+                continue;
+            core.cpus.push_back(s);
+            core.isolated = core.isolated && sib->isolated;
+            seen.push_back(s);
+        }
+        if (core.cpus.empty()) {
+            core.cpus.push_back(c.cpu);
+            core.isolated = c.isolated;
+            seen.push_back(c.cpu);
+        }
+        cores.push_back(std::move(core));
+    }
+    return cores;
+}
+
+}
+
+const CpuInfo* CpuTopology::Find(std::uint32_t cpu) const
+{
+    for (const auto& c : cpus) {
+        if (c.cpu == cpu)
+            return &c;
+    }
+    return nullptr;
+}
+
+std::vector<std::uint32_t> ParseCpuList(std::string_view list)
+{
+    std::vector<std::uint32_t> out;
+    while (!list.empty()) {
+        const std::size_t comma = list.find(',');
+        std::string_view item = list.substr(0, comma);
+        list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+
+        while (!item.empty() && (item.back() == '\n' || item.back() == ' '))
+            item.remove_suffix(1);
+        if (item.empty())
+            continue;
+
+        std::uint32_t lo = 0;
+        std::uint32_t hi = 0;
+        const std::size_t dash = item.find('-');
+        const auto first = item.substr(0, dash);
+        if (std::from_chars(first.data(), first.data() + first.size(), lo).ec != std::errc{})
+            continue;
+        hi = lo;
+        if (dash != std::string_view::npos) {
+            const auto second = item.substr(dash + 1);
+            if (std::from_chars(second.data(), second.data() + second.size(), hi).ec != std::errc{})
+                continue;
+        }
+        for (std::uint32_t c = lo; c <= hi; ++c)
+            out.push_back(c);
+    }
+    return out;
+}
+
+CpuTopology DiscoverCpuTopology()
+{
+    CpuTopology topology;
+
+#if defined(__linux__)
+    const auto online = ParseCpuList(ReadFirstLine(std::string(kSysCpu) + "/online"));
+    const auto isolated = ParseCpuList(ReadFirstLine(std::string(kSysCpu) + "/isolated"));
+
+    // Isolated cpus are usually missing from the inherited affinity mask but can still be
+    // pinned to explicitly, so they stay eligible.
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool haveMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    for (auto cpu : online) {
+        const bool isIsolated = Contains(isolated, cpu);
+        if (haveMask && cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &allowed) && !isIsolated)
+            continue;
+
+        const std::string topo = std::string(kSysCpu) + "/cpu" + std::to_string(cpu) + "/topology";
+        CpuInfo info;
+        info.cpu = cpu;
+        info.coreId = ReadInt(topo + "/core_id", static_cast<std::int32_t>(cpu));
+        info.packageId = ReadInt(topo + "/physical_package_id", 0);
+        info.l3Id = ReadL3Id(cpu);
+        info.isolated = isIsolated;
+        info.smtSiblings = ParseCpuList(ReadFirstLine(topo + "/thread_siblings_list"));
+        if (info.smtSiblings.empty())
+            info.smtSiblings.push_back(cpu);
+        topology.cpus.push_back(std::move(info));
+    }
+    topology.fromSysfs = !topology.cpus.empty();
+#endif
+
+    if (topology.cpus.empty()) {
+        const unsigned hc = std::thread::hardware_concurrency();
+        const std::uint32_t n = hc ? hc : 1u;
+        for (std::uint32_t cpu = 0; cpu < n; ++cpu) {
+            CpuInfo info;
+            info.cpu = cpu;
+            info.coreId = static_cast<std::int32_t>(cpu);
+            info.packageId = 0;
+            info.l3Id = 0;
+            info.smtSiblings.push_back(cpu);
+            topology.cpus.push_back(std::move(info));
+        }
+    }
+
+    return topology;
+}
+
+ThreadPlacement PlanThreadPlacement(const CpuTopology& topology, std::size_t producerCount)
+{
+    ThreadPlacement placement;
+    placement.producerCpus.assign(producerCount, -1);
+
+    const auto cores = GroupPhysicalCores(topology);
+    if (cores.empty())
+        return placement;
+
+    // Engine core: first fully isolated core, else the highest core (cores are grouped in
+    // ascending cpu order, so that is the one furthest from cpu 0).
+    std::size_t engineCore = cores.size() - 1;
+    for (std::size_t i = 0; i < cores.size(); ++i) {
+        if (cores[i].isolated) {
+            engineCore = i;
+            break;
+        }
+    }
+
+    const PhysicalCore& engine = cores[engineCore];
+    placement.engineCpu = static_cast<int>(engine.cpus.front());
+    placement.reservedCpus.assign(engine.cpus.begin() + 1, engine.cpus.end());
+
+    // Producer candidates ranked by distance from the engine; within a rank, one cpu per
+    // physical core first so producers do not share an SMT pair while cores remain.
+    auto rank = [&](const PhysicalCore& core) {
+        int r = 0;
+        if (core.l3Id != engine.l3Id)
+            r += 2;
+        if (core.packageId != engine.packageId)
+            r += 4;
+        if (Contains(core.cpus, 0u))
+            r += 1;
+        return r;
+    };
+
+    std::vector<std::size_t> order;
+    for (std::size_t i = 0; i < cores.size(); ++i) {
+        if (i != engineCore)
+            order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return rank(cores[a]) < rank(cores[b]);
+    });
+
+    std::vector<int> candidates;
+    for (std::size_t begin = 0; begin < order.size();) {
+        std::size_t end = begin;
+        std::size_t maxThreads = 0;
+        while (end < order.size() && rank(cores[order[end]]) == rank(cores[order[begin]])) {
+            maxThreads = std::max(maxThreads, cores[order[end]].cpus.size());
+            ++end;
+        }
+        for (std::size_t t = 0; t < maxThreads; ++t) {
+            for (std::size_t k = begin; k < end; ++k) {
+                const auto& cpus = cores[order[k]].cpus;
+                if (t < cpus.size())
+                    candidates.push_back(static_cast<int>(cpus[t]));
+            }
+        }
+        begin = end;
+    }
+
+    if (candidates.empty())
+        return placement;
+
+    for (std::size_t p = 0; p < producerCount; ++p)
+        placement.producerCpus[p] = candidates[p % candidates.size()];
+
+    return placement;
+}
+
+void PrintThreadPlacement(std::ostream& os, const CpuTopology& topology, const ThreadPlacement& placement)
+{
+    auto describe = [&](int cpu) {
+        if (cpu < 0) {
+            os << "unpinned";
+            return;
+        }
+        os << "cpu " << cpu;
+        if (const CpuInfo* info = topology.Find(static_cast<std::uint32_t>(cpu))) {
+            os << " (core " << info->coreId
+               << ", package " << info->packageId
+               << ", L3 " << info->l3Id
+               << (info->isolated ? ", isolated" : "")
+               << ")";
+        }
+    };
+
+    os << "Thread placement (" << topology.cpus.size() << " cpus"
+       << (topology.fromSysfs ? ", sysfs topology" : ", topology unknown") << "):\n";
+    os << "  engine     -> ";
+    describe(placement.engineCpu);
+    os << "\n";
+    if (!placement.reservedCpus.empty()) {
+        os << "  reserved   ->";
+        for (auto c : placement.reservedCpus)
+            os << " " << c;
+        os << " (engine SMT siblings)\n";
+    }
+    for (std::size_t i = 0; i < placement.producerCpus.size(); ++i) {
+        os << "  producer " << i << " -> ";
+        describe(placement.producerCpus[i]);
+        os << "\n";
+    }
+}
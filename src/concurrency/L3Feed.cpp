@@ -0,0 +1,54 @@
+#include "L3Feed.h"
+
+#include "Telemetry.h"
+
+#include <algorithm>
+#include <cstring>
+
+L3Feed::L3Feed()
+    : ring_(std::make_unique<std::uint8_t[]>(RingBytes)) {
+    // Zero-filled by make_unique: the pages are touched before the engine starts.
+}
+
+void L3Feed::publish() noexcept {
+    const std::span<const std::uint8_t> burst = encoder_.Bytes();
+    if (burst.empty())
+        return;
+
+    const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail + burst.size() - headCache_ > RingBytes) {
+        headCache_ = head_.load(std::memory_order_acquire);
+        if (tail + burst.size() - headCache_ > RingBytes) {
+            TelemetryAdd(dropped_, encoder_.Messages());
+            encoder_.Clear();
+            return;
+        }
+    }
+
+    const std::size_t offset = static_cast<std::size_t>(tail & (RingBytes - 1));
+    const std::size_t first = std::min(burst.size(), RingBytes - offset);
+    std::memcpy(ring_.get() + offset, burst.data(), first);
+    std::memcpy(ring_.get(), burst.data() + first, burst.size() - first);
+    tail_.store(tail + burst.size(), std::memory_order_release);
+
+    TelemetryAdd(messages_, encoder_.Messages());
+    TelemetryAdd(bytes_, burst.size());
+    encoder_.Clear();
+}
+
+std::size_t L3Feed::read(std::uint8_t* out, std::size_t max) noexcept {
+    const std::uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head == tailCache_) {
+        tailCache_ = tail_.load(std::memory_order_acquire);
+        if (head == tailCache_)
+            return 0;
+    }
+
+    const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(tailCache_ - head, max));
+    const std::size_t offset = static_cast<std::size_t>(head & (RingBytes - 1));
+    const std::size_t first = std::min(n, RingBytes - offset);
+    std::memcpy(out, ring_.get() + offset, first);
+    std::memcpy(out + first, ring_.get(), n - first);
+    head_.store(head + n, std::memory_order_release);
+    return n;
+}
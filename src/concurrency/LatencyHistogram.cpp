@@ -0,0 +1,106 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+
+std::uint64_t LatencyHistogram::bucket_lowest(std::size_t index) noexcept
+{
+    if (index < SubBucketCount)
+        return index;
+    const std::size_t octave = index / SubBucketCount;          // >= 1
+    const std::size_t sub = index % SubBucketCount;
+    return static_cast<std::uint64_t>(SubBucketCount + sub) << (octave - 1);
+}
+
+std::uint64_t LatencyHistogram::bucket_highest(std::size_t index) noexcept
+{
+    if (index + 1 >= BucketCount)
+        return ~std::uint64_t{0};
+    if (index < SubBucketCount)
+        return index;
+    const std::size_t octave = index / SubBucketCount;
+    return bucket_lowest(index) + ((std::uint64_t{1} << (octave - 1)) - 1);
+}
+
+void LatencyHistogram::reset() noexcept
+{
+    for (auto& c : counts_)
+        c.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+    min_.store(NoMin, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::copy_from(const LatencyHistogram& other) noexcept
+{
+    for (std::size_t i = 0; i < BucketCount; ++i)
+        counts_[i].store(other.counts_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    count_.store(other.count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    sum_.store(other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    max_.store(other.max_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    min_.store(other.min_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) noexcept
+{
+    for (std::size_t i = 0; i < BucketCount; ++i) {
+        const std::uint64_t n = other.counts_[i].load(std::memory_order_relaxed);
+        if (n)
+            counts_[i].store(counts_[i].load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    count_.store(count() + other.count(), std::memory_order_relaxed);
+    sum_.store(sum() + other.sum(), std::memory_order_relaxed);
+    max_.store(std::max(max(), other.max()), std::memory_order_relaxed);
+    min_.store(std::min(min_.load(std::memory_order_relaxed), other.min_.load(std::memory_order_relaxed)),
+               std::memory_order_relaxed);
+}
+
+void LatencyHistogram::subtract(const LatencyHistogram& earlier) noexcept
+{
+    std::size_t lowest = BucketCount;
+    std::size_t highest = 0;
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < BucketCount; ++i) {
+        const std::uint64_t now = counts_[i].load(std::memory_order_relaxed);
+        const std::uint64_t before = earlier.counts_[i].load(std::memory_order_relaxed);
+        const std::uint64_t n = now > before ? now - before : 0;
+        counts_[i].store(n, std::memory_order_relaxed);
+        if (n) {
+            lowest = std::min(lowest, i);
+            highest = i;
+            total += n;
+        }
+    }
+    count_.store(total, std::memory_order_relaxed);
+    sum_.store(sum() > earlier.sum() ? sum() - earlier.sum() : 0, std::memory_order_relaxed);
+    if (total == 0) {
+        max_.store(0, std::memory_order_relaxed);
+        min_.store(NoMin, std::memory_order_relaxed);
+        return;
+    }
+    max_.store(std::min(max(), bucket_highest(highest)), std::memory_order_relaxed);
+    min_.store(std::max(min(), bucket_lowest(lowest)), std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::quantile(double q) const noexcept
+{
+    // Totals come from the buckets themselves so a concurrent writer cannot push the rank
+    // past what is visible.
+    std::uint64_t total = 0;
+    for (const auto& c : counts_)
+        total += c.load(std::memory_order_relaxed);
+    if (total == 0)
+        return 0;
+
+    q = std::clamp(q, 0.0, 1.0);
+    std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(total) + 0.5);
+    rank = std::clamp<std::uint64_t>(rank, 1, total);
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BucketCount; ++i) {
+        seen += counts_[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            return std::min(bucket_highest(i), max());
+    }
+    return max();
+}
@@ -0,0 +1,63 @@
+#include "LevelDeltaFeed.h"
+
+#include "Telemetry.h"
+
+#include <algorithm>
+
+LevelDeltaFeed::LevelDeltaFeed(bool conflate)
+    : conflate_(conflate) {
+    // A burst of maxBurst events touches at most a few levels per event.
+    pending_.reserve(ConflateSlots);
+    if (conflate_) {
+        conflated_.reserve(ConflateSlots / 2);
+        slots_.resize(ConflateSlots);
+    }
+    ring_.prefault();
+}
+
+// Walks the burst backwards so the first delta met for a level is its last one, then
+// restores forward order.
+void LevelDeltaFeed::conflate() noexcept {
+    if (++generation_ == 0) {
+        std::fill(slots_.begin(), slots_.end(), Slot{});
+        generation_ = 1;
+    }
+
+    conflated_.clear();
+    for (auto it = pending_.rbegin(); it != pending_.rend(); ++it) {
+        const std::uint64_t key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(it->price_)) << 1)
+            | (it->side_ == Side::Sell ? 1u : 0u);
+        std::size_t slot = static_cast<std::size_t>((key * 0x9E37'79B9'7F4A'7C15ull) >> 52) & (ConflateSlots - 1);
+        while (slots_[slot].generation == generation_ && slots_[slot].key != key)
+            slot = (slot + 1) & (ConflateSlots - 1);
+        if (slots_[slot].generation == generation_)
+            continue;
+        slots_[slot] = { key, generation_ };
+        conflated_.push_back(*it);
+    }
+
+    std::reverse(conflated_.begin(), conflated_.end());
+    pending_.swap(conflated_);
+}
+
+void LevelDeltaFeed::publish() noexcept {
+    if (pending_.empty())
+        return;
+
+    TelemetryAdd(changes_, pending_.size());
+    if (conflate_ && pending_.size() > 1 && pending_.size() <= ConflateSlots / 2)
+        conflate();
+    pending_.back().endOfBurst_ = true;
+
+    std::uint64_t dropped = 0;
+    for (LevelDelta& delta : pending_) {
+        delta.sequence_ = ++sequence_;
+        if (!ring_.push(delta))
+            ++dropped;
+    }
+
+    TelemetryAdd(published_, pending_.size());
+    if (dropped)
+        TelemetryAdd(dropped_, dropped);
+    pending_.clear();
+}
@@ -1,39 +1,118 @@
 #include "MatchingEngine.h"
 #include "ThreadPinning.h"
+#include "NumaMemory.h"
+#include "TimeUtils.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
 #include <thread>
 #include <iostream>
+#include <cstdlib>
+#include <string>
 
 namespace {
-inline void backoff(uint32_t& spins) noexcept {
-    if (spins < 128) {
-        ++spins;
-        asm volatile("" ::: "memory");
-        return;
+
+// The engine runs without exceptions in Release; a configuration it cannot run is reported
+// and ends the process.
+[[noreturn]] void EngineFatal(const std::string& message) {
+    std::cerr << "MatchingEngine: " << message << "\n";
+    std::abort();
+}
+
+}
+
+MatchingEngine::MatchingEngine(
+    std::vector<ProducerChannel>& channels,
+    uint32_t burstSize,
+    int cpu,
+    WaitStrategy wait,
+    const TelemetryRegion* telemetry)
+    : channels_(channels),
+      state_(channels.size()),
+      burstSize_(burstSize ? burstSize : 1),
+      maxBurst_(burstSize_ * 8),
+      cpu_(cpu),
+      wait_(wait),
+      ownTelemetry_(telemetry ? TelemetryRegion() : TelemetryRegion::Create({}, channels.size())),
+      telemetry_(telemetry ? telemetry : &ownTelemetry_)
+{
+    // A channel past the mask would never be drained, and shutdown would wait on it forever.
+    if (channels_.size() > MaxChannels)
+        EngineFatal(std::to_string(channels_.size()) + " producer channels, at most "
+                    + std::to_string(MaxChannels) + " supported");
+
+    // Every counter is written through the region from the first event on.
+    if (!telemetry_->valid())
+        EngineFatal("telemetry region could not be mapped");
+    if (telemetry_->channel_count() < channels_.size())
+        EngineFatal("telemetry region has " + std::to_string(telemetry_->channel_count())
+                    + " channels, the engine needs " + std::to_string(channels_.size()));
+    stats_ = &telemetry_->engine();
+#if OB_TRACING
+    stages_ = &telemetry_->stages();
+#endif
+
+    for (std::size_t i = 0; i < channels_.size(); ++i) {
+        channels_[i].backpressure->attach_consumer(&wake_);
+        state_[i].nextAddId = static_cast<OrderId>(channels_[i].producerId) << 32;
+        state_[i].stats = &telemetry_->channel(i);
+        state_[i].stats->producerId = channels_[i].producerId;
+        state_[i].stats->weight = channels_[i].weight;
+        hasCancelLanes_ = hasCancelLanes_ || channels_[i].cancelLane != nullptr;
     }
-    spins = 0;
-    std::this_thread::yield();
 }
+
+void MatchingEngine::EnableIngress(std::string prefix) {
+    ingressPrefix_ = std::move(prefix);
 }
 
+void MatchingEngine::EnableLevelDeltas(bool conflate) {
+    levelDeltas_ = std::make_unique<LevelDeltaFeed>(conflate);
+    orderbook_.SetLevelDeltaSink(levelDeltas_->pending());
+}
 
-MatchingEngine::MatchingEngine(
-    std::vector<OrderRingBuffer*>& queues,
-    Backpressure& backpressure,
-    uint32_t burstSize)
-    : queues_(queues),
-      backpressure_(backpressure),
-      burstSize_(burstSize)
-{}
+void MatchingEngine::EnableL3Feed() {
+    l3Feed_ = std::make_unique<L3Feed>();
+    orderbook_.SetL3Sink(l3Feed_->encoder());
+}
+
+void MatchingEngine::EnableExecutionReports(ExecutionReportRing* reports) {
+    reports_ = reports;
+}
 
 void MatchingEngine::start() {
     running_.store(true, std::memory_order_release);
     engineThread_ = std::thread(&MatchingEngine::run, this);
+    if (!ingressPrefix_.empty()) {
+        discovering_.store(true, std::memory_order_release);
+        discoveryThread_ = std::thread(&MatchingEngine::discover_ingress, this);
+    }
 }
 
+// The engine thread goes first: the discovery thread unmaps every ring it still owns on exit.
 void MatchingEngine::stop() {
     running_.store(false, std::memory_order_release);
+    wake_.notify();
     if (engineThread_.joinable())
         engineThread_.join();
+    discovering_.store(false, std::memory_order_release);
+    if (discoveryThread_.joinable())
+        discoveryThread_.join();
+}
+
+EngineQueueStats MatchingEngine::QueueStats(std::size_t channel) const {
+    EngineQueueStats out;
+    if (channel >= state_.size())
+        return out;
+    const ChannelTelemetry& stats = *state_[channel].stats;
+    out.weight = channels_[channel].weight;
+    out.events = stats.events.load(std::memory_order_relaxed);
+    out.visits = stats.visits.load(std::memory_order_relaxed);
+    out.laneEvents = stats.laneEvents.load(std::memory_order_relaxed);
+    out.overtakenAdds = stats.overtakenAdds.load(std::memory_order_relaxed);
+    return out;
 }
 
 void MatchingEngine::print() const{
@@ -64,60 +143,471 @@ void MatchingEngine::print() const{
                   << level.quantity_ << "\n";
     }
     std::cout << "============================================\n";
-    std::cout << "Event processed: " << eventsProcessed_ << "\n";
+    std::cout << "Event processed: " << EventsProcessed() << "\n";
     std::cout << "Orderbook total ops: " << orderbook_.TotalOps() << "\n"; 
 }
 
+bool MatchingEngine::has_work() const {
+    if (!running_.load(std::memory_order_acquire))
+        return true;
+    for (const auto& channel : channels_) {
+        if (!channel.queue->empty())
+            return true;
+        if (channel.cancelLane && !channel.cancelLane->empty())
+            return true;
+    }
+    for (const IngressRing* in : ingress_) {
+        if (!in->ring().empty())
+            return true;
+    }
+    return false;
+}
+
 void MatchingEngine::run() {
-    PinCurrentThreadToCore(0);
+    PinCurrentThreadToCpu(cpu_);
+    // Book levels and index nodes are allocated from here on; keep them on the engine's node.
+    PreferNumaNodeForCurrentThread(NumaNodeOfCpu(cpu_));
 
-    size_t index = 0;
-    EngineEvent event;
+    const std::size_t channelCount = channels_.size();
     uint32_t idleSpins = 0;
+    std::uint64_t rounds = 0;
+    std::uint64_t lastPublishNs = ob::time::steady_now_ns();
+
+    telemetry_->set_state(TelemetryState::Running);
+    publish(lastPublishNs);
 
     while (running_.load(std::memory_order_acquire)) {
-        auto* queue = queues_[index];
-        uint32_t processed = 0;
-
-        while (processed < burstSize_ && queue->pop(event)) {
-            processed++;
-            backpressure_.decrement();
-
-            switch (event.type) {
-                case EngineEventType::Add:
-                    orderbook_.AddOrder(
-                        std::move(std::get<OrderPointer>(event.payload))
-                    );
-                    break;
+        if ((++rounds & (PublishCheckRounds - 1)) == 0) {
+            const std::uint64_t now = ob::time::steady_now_ns();
+            if (now - lastPublishNs >= PublishIntervalNs) {
+                if (!ingressPrefix_.empty())
+                    poll_ingress();
+                publish(now);
+                lastPublishNs = now;
+            }
+        }
 
-                case EngineEventType::Cancel:
-                    orderbook_.CancelOrder(
-                        std::get<OrderId>(event.payload)
-                    );
-                    break;
+        // One pass over the rings' tails per round; empty rings are then skipped entirely.
+        std::uint64_t occupied = 0;
+        std::size_t backlog = 0;
+        for (std::size_t i = 0; i < channelCount; ++i) {
+            const std::size_t depth = channels_[i].queue->available();
+            const CancelLane* lane = channels_[i].cancelLane;
+            if (depth || (lane && !lane->empty())) {
+                occupied |= std::uint64_t{1} << i;
+                backlog += depth;
+            }
+        }
 
-                case EngineEventType::Modify:
-                    orderbook_.ModifyOrder(
-                        std::move(std::get<OrderModify>(event.payload))
-                    );
-                    break;
+        std::uint64_t ingressOccupied = 0;
+        for (std::size_t j = 0; j < ingress_.size(); ++j) {
+            const std::size_t depth = ingress_[j]->ring().available();
+            if (depth) {
+                ingressOccupied |= std::uint64_t{1} << j;
+                backlog += depth;
+            }
+        }
+
+        if ((occupied | ingressOccupied) == 0) {
+            TelemetryAdd(stats_->idleLoops, 1);
+            wait_.idle(idleSpins, &wake_, [this] { return has_work(); });
+            continue;
+        }
+        idleSpins = 0;
+        TelemetryAdd(stats_->busyRounds, 1);
+
+        // Deeper backlogs get longer bursts to amortise per-visit cost; every channel gets
+        // the same base so weights alone decide the split.
+        const std::size_t active = static_cast<std::size_t>(std::popcount(occupied) + std::popcount(ingressOccupied));
+        const uint32_t burst = static_cast<uint32_t>(
+            std::clamp<std::size_t>(backlog / active, burstSize_, maxBurst_));
+
+        while (occupied) {
+            const std::size_t i = static_cast<std::size_t>(std::countr_zero(occupied));
+            occupied &= occupied - 1;
+            if (hasCancelLanes_)
+                drain_cancel_lanes();
+            drain(i, burst);
+        }
+        while (ingressOccupied) {
+            const std::size_t j = static_cast<std::size_t>(std::countr_zero(ingressOccupied));
+            ingressOccupied &= ingressOccupied - 1;
+            if (hasCancelLanes_)
+                drain_cancel_lanes();
+            drain_ingress(j, burst);
+        }
+    }
+
+    publish(ob::time::steady_now_ns());
+    telemetry_->set_state(TelemetryState::Stopped);
+}
+
+// Fields that would cost something on every event (or need a look at the rings) are
+// sampled here instead.
+void MatchingEngine::publish(std::uint64_t nowNs) {
+    for (std::size_t i = 0; i < channels_.size(); ++i)
+        TelemetrySet(state_[i].stats->depth, channels_[i].queue->available());
+    TelemetrySet(stats_->parks, wake_.parks());
+    TelemetrySet(stats_->bookOps, orderbook_.TotalOps());
+    TelemetrySet(stats_->orders, orderbook_.Size());
+    TelemetrySet(stats_->ingressRings, ingress_.size());
+    if (levelDeltas_) {
+        TelemetrySet(stats_->levelChanges, levelDeltas_->changes());
+        TelemetrySet(stats_->levelDeltas, levelDeltas_->published());
+        TelemetrySet(stats_->levelDeltasDropped, levelDeltas_->dropped());
+    }
+    if (l3Feed_) {
+        TelemetrySet(stats_->l3Messages, l3Feed_->messages());
+        TelemetrySet(stats_->l3Bytes, l3Feed_->bytes());
+        TelemetrySet(stats_->l3Dropped, l3Feed_->dropped());
+    }
+    TelemetryAdd(stats_->publishes, 1);
+    telemetry_->header().publishNs.store(nowNs, std::memory_order_relaxed);
+}
 
-                case EngineEventType::Shutdown:
-                    shutdownsReceived_++;
-                    if (shutdownsReceived_ >= queues_.size())
-                        running_.store(false, std::memory_order_release);
+void MatchingEngine::flush_op_counts(ChannelState& st) {
+    ChannelTelemetry& stats = *st.stats;
+    if (st.adds) {
+        TelemetryAdd(stats.adds, st.adds);
+        st.adds = 0;
+    }
+    if (st.cancels) {
+        TelemetryAdd(stats.cancels, st.cancels);
+        st.cancels = 0;
+    }
+    if (st.modifies) {
+        TelemetryAdd(stats.modifies, st.modifies);
+        st.modifies = 0;
+    }
+}
+
+// Weighted round robin: a visit pops up to weight * burst events. A channel that runs dry
+// ends its visit early and carries nothing over to the next round.
+void MatchingEngine::drain(std::size_t channel, uint32_t burst) {
+    auto* queue = channels_[channel].queue;
+    auto* credits = channels_[channel].backpressure;
+    ChannelState& st = state_[channel];
+
+    const std::uint64_t quantum = static_cast<std::uint64_t>(burst) * channels_[channel].weight;
+
+    std::uint64_t processed = 0;
+    EngineEvent event;
+
+    while (processed < quantum && queue->pop(event)) {
+#if OB_TRACING
+        const std::uint64_t dequeued = TraceStamp();
+#endif
+        processed++;
+        credits->decrement();
+
+        // Only sampled events pay for a clock read.
+        if (event.enqueueNs) {
+            const std::uint64_t now = ob::time::now_ns();
+            st.stats->queueLatency.record(now > event.enqueueNs ? now - event.enqueueNs : 0);
+        }
+
+#if OB_TRACING
+        const std::uint64_t dispatched = TraceStamp();
+        process(channel, event);
+        record_trace(event.trace, dequeued, dispatched, TraceStamp());
+#else
+        process(channel, event);
+#endif
+    }
+    credits->flush();
+    end_burst();
+
+    // Published once per visit, not per event.
+    TelemetryAdd(st.stats->events, processed);
+    TelemetryAdd(st.stats->visits, 1);
+    flush_op_counts(st);
+    TelemetrySet(stats_->events, eventsLocal_);
+}
+
+// Same visit rules as drain(). Ingress events carry no credits and no lane bookkeeping: the
+// ring bounds what a gateway has in flight, and its cancels travel in order with its adds.
+void MatchingEngine::drain_ingress(std::size_t index, std::uint32_t burst) {
+    IngressRing& in = *ingress_[index];
+    WireRing& ring = in.ring();
+    const std::uint64_t quantum = static_cast<std::uint64_t>(burst) * in.header().weight;
+
+    std::uint64_t processed = 0;
+    WireEvent event;
+    while (processed < quantum && ring.pop(event)) {
+        processed++;
+        if (event.enqueueNs) {
+            const std::uint64_t now = ob::time::steady_now_ns();
+            stats_->ingressLatency.record(now > event.enqueueNs ? now - event.enqueueNs : 0);
+        }
+        process_wire(event);
+    }
+    end_burst();
+
+    TelemetryAdd(stats_->ingressEvents, processed);
+    TelemetrySet(stats_->events, eventsLocal_);
+}
+
+// Orders from another process cannot come out of that process's pool, so an add allocates
+// here. A wire Shutdown only means the gateway is done; it never stops the engine. The wire
+// format has no owner, so no wire event is a MassCancel.
+void MatchingEngine::process_wire(const WireEvent& event) {
+    switch (event.type) {
+        case EngineEventType::Add: {
+            Trades trades = orderbook_.AddOrder(std::make_shared<Order>(
+                event.order_type(), event.orderId, event.order_side(), event.price, event.quantity));
+            if (reports_)
+                report_execution(event.orderId, trades);
+            break;
+        }
+
+        case EngineEventType::Cancel:
+            orderbook_.CancelOrder(event.orderId);
+            if (reports_)
+                report_closed(event.orderId);
+            break;
+
+        case EngineEventType::Modify: {
+            Trades trades = orderbook_.ModifyOrder(
+                OrderModify{ event.orderId, event.order_side(), event.price, event.quantity });
+            if (reports_)
+                report_execution(event.orderId, trades);
+            break;
+        }
+
+        case EngineEventType::Shutdown:
+        case EngineEventType::MassCancel:
+            break;
+    }
+    eventsLocal_++;
+}
+
+// Engine thread, every publish: takes newly mapped rings and returns closed, drained ones.
+void MatchingEngine::poll_ingress() {
+    for (std::size_t j = 0; j < ingress_.size();) {
+        IngressRing* in = ingress_[j];
+        if (in->closed() && in->ring().empty() && ingressDetach_.push(in)) {
+            ingress_[j] = ingress_.back();
+            ingress_.pop_back();
+            continue;
+        }
+        ++j;
+    }
+
+    IngressRing* in = nullptr;
+    while (ingress_.size() < MaxIngress && ingressAttach_.pop(in))
+        ingress_.push_back(in);
+}
+
+// Discovery thread. Owns every mapped ring: a ring is unmapped only after the engine thread
+// handed it back, or once the engine thread has exited. Segments that are finished but still
+// present (a gateway that closed its ring and lives on) are remembered by inode so they are
+// not mapped again on every scan.
+void MatchingEngine::discover_ingress() {
+    struct Known {
+        std::uint64_t inode = 0;
+        std::unique_ptr<IngressRing> ring;      // null once finished
+    };
+    std::unordered_map<std::string, Known> known;
+    std::uint64_t sinceScanMs = IngressScanIntervalMs;
+
+    while (discovering_.load(std::memory_order_acquire)) {
+        IngressRing* done = nullptr;
+        while (ingressDetach_.pop(done)) {
+            const std::string name = done->name();
+            known[name].ring.reset();
+        }
+
+        if (sinceScanMs >= IngressScanIntervalMs) {
+            sinceScanMs = 0;
+            const std::vector<IngressSegmentId> found = IngressRing::Discover(ingressPrefix_);
+
+            // Forget finished segments that are gone; a segment that reappears is new.
+            std::erase_if(known, [&](const auto& entry) {
+                return !entry.second.ring && std::none_of(found.begin(), found.end(),
+                    [&](const IngressSegmentId& id) { return id.name == entry.first && id.inode == entry.second.inode; });
+            });
+
+            for (const IngressSegmentId& id : found) {
+                if (known.count(id.name))
+                    continue;
+                auto ring = std::make_unique<IngressRing>(IngressRing::Attach(id.name));
+                if (!ring->valid())
+                    continue;       // not constructed yet: next scan
+                if (ring->closed() && ring->ring().empty()) {
+                    known[id.name] = { id.inode, nullptr };
+                    continue;
+                }
+                if (!ingressAttach_.push(ring.get()))
+                    continue;       // engine has not taken the previous ones yet
+                known[id.name] = { id.inode, std::move(ring) };
+            }
+
+            // A gateway that died without closing its ring will never close it.
+            for (auto& [name, entry] : known) {
+                if (entry.ring && !entry.ring->closed() && !entry.ring->writer_alive())
+                    entry.ring->close();
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        sinceScanMs += 10;
+    }
+}
+
+// Runs before every normal burst. Bounded by one lane's capacity per lane so a producer
+// streaming cancels cannot hold the engine here forever.
+void MatchingEngine::drain_cancel_lanes() {
+    CancelRequest request;
+    for (std::size_t i = 0; i < channels_.size(); ++i) {
+        CancelLane* lane = channels_[i].cancelLane;
+        if (!lane)
+            continue;
+        const std::size_t n = lane->available();
+        if (n == 0)
+            continue;
+        std::uint64_t applied = 0;
+        for (; applied < n && lane->pop(request); ++applied)
+            apply_lane_cancel(i, request);
+        end_burst();
+        ChannelTelemetry& stats = *state_[i].stats;
+        TelemetryAdd(stats.laneEvents, applied);
+        TelemetryAdd(stats.cancels, applied);
+        TelemetrySet(stats_->events, eventsLocal_);
+    }
+}
+
+// A lane cancel can overtake the add it targets, which may still sit in the producer's ring.
+// Ids increase per producer, so anything at or past `nextAddId` has not been added yet: it
+// is tombstoned and the add is dropped on arrival. Everything else is a plain cancel.
+void MatchingEngine::apply_lane_cancel(std::size_t channel, const CancelRequest& request) {
+    ChannelState& st = state_[channel];
+    const OrderId id = request.orderId;
+
+    if ((id >> 32) == channels_[channel].producerId && id >= st.nextAddId) {
+        if (st.tombstones.size() >= MaxTombstones) {
+            // Ids the add stream has passed will never arrive (the producer gave them up).
+            std::erase_if(st.tombstones, [&](OrderId t) { return t < st.nextAddId; });
+        }
+        st.tombstones.insert(id);
+    } else {
+        orderbook_.CancelOrder(id);
+    }
+    if (reports_)
+        report_closed(id);
+
+    if (request.enqueueNs)
+        record_cancel_latency(st, request.enqueueNs);
+    eventsLocal_++;
+}
+
+void MatchingEngine::record_cancel_latency(ChannelState& st, std::uint64_t enqueueNs) {
+    const std::uint64_t now = ob::time::now_ns();
+    st.stats->cancelLatency.record(now > enqueueNs ? now - enqueueNs : 0);
+}
+
+#if OB_TRACING
+// Events no producer stamped (Shutdown pushed by main) are skipped so they do not drag the
+// low end of every stage to zero.
+void MatchingEngine::record_trace(const EventTrace& trace, std::uint64_t dequeued,
+                                  std::uint64_t dispatched, std::uint64_t matched) {
+    if (!trace.created)
+        return;
+    stages_->produce.record(TraceElapsedNs(trace.created, trace.enqueued));
+    stages_->queue.record(TraceElapsedNs(trace.enqueued, dequeued));
+    stages_->dispatch.record(TraceElapsedNs(dequeued, dispatched));
+    stages_->match.record(TraceElapsedNs(dispatched, matched));
+    stages_->total.record(TraceElapsedNs(trace.created, matched));
+}
+#endif
+
+void MatchingEngine::process(std::size_t channel, EngineEvent& event) {
+    switch (event.type) {
+        case EngineEventType::Add: {
+            auto& order = std::get<OrderPointer>(event.payload);
+            const OrderId id = order->GetOrderId();
+            ChannelState& st = state_[channel];
+            if (hasCancelLanes_) {
+                if ((id >> 32) == channels_[channel].producerId && id >= st.nextAddId)
+                    st.nextAddId = id + 1;
+                if (!st.tombstones.empty() && st.tombstones.erase(id)) {
+                    TelemetryAdd(st.stats->overtakenAdds, 1);
+                    // Closed again: an upstream stage may have seen this add after the lane cancel.
+                    if (reports_)
+                        report_closed(id);
                     break;
+                }
             }
-            eventsProcessed_++;
+            st.adds++;
+            Trades trades = orderbook_.AddOrder(std::move(order));
+            if (reports_)
+                report_execution(id, trades);
+            break;
+        }
+
+        case EngineEventType::Cancel: {
+            const OrderId id = std::get<OrderId>(event.payload);
+            orderbook_.CancelOrder(id);
+            if (reports_)
+                report_closed(id);
+            state_[channel].cancels++;
+            if (event.enqueueNs)
+                record_cancel_latency(state_[channel], event.enqueueNs);
+            break;
         }
 
-        index = (index + 1) % queues_.size();
+        case EngineEventType::Modify: {
+            state_[channel].modifies++;
+            const OrderId id = std::get<OrderModify>(event.payload).GetOrderId();
+            Trades trades = orderbook_.ModifyOrder(
+                std::move(std::get<OrderModify>(event.payload))
+            );
+            if (reports_)
+                report_execution(id, trades);
+            break;
+        }
 
-        if (processed == 0) {
-            idleLoops_.fetch_add(1, std::memory_order_relaxed);
-            backoff(idleSpins);
-        } else {
-            idleSpins = 0;
+        case EngineEventType::MassCancel: {
+            massCancelled_.clear();
+            orderbook_.MassCancel(std::get<MassCancelRequest>(event.payload),
+                                  reports_ ? &massCancelled_ : nullptr);
+            for (const OrderId id : massCancelled_)
+                report_closed(id);
+            state_[channel].cancels++;
+            break;
         }
+
+        case EngineEventType::Shutdown:
+            shutdownsReceived_++;
+            if (shutdownsReceived_ >= channels_.size())
+                running_.store(false, std::memory_order_release);
+            break;
     }
-}
\ No newline at end of file
+    eventsLocal_++;
+}
+
+// Both sides of every trade, then a close for `id` if the order that traded did not stay.
+void MatchingEngine::report_execution(OrderId id, const Trades& trades) {
+    for (const Trade& trade : trades) {
+        report({ trade.GetBidTrade().orderId_, trade.GetBidTrade().quantity_, Side::Buy,
+                 ExecutionReportType::Fill });
+        report({ trade.GetAskTrade().orderId_, trade.GetAskTrade().quantity_, Side::Sell,
+                 ExecutionReportType::Fill });
+    }
+    if (!orderbook_.Contains(id))
+        report_closed(id);
+}
+
+void MatchingEngine::report_closed(OrderId id) {
+    report({ id, 0, Side::Buy, ExecutionReportType::Closed });
+}
+
+// The consumer drains reports even while it waits for room in our rings, so waiting here
+// cannot deadlock; once stop() is called the remaining reports are dropped.
+void MatchingEngine::report(const ExecutionReport& report) {
+    std::uint32_t spins = 0;
+    while (!reports_->push(report)) {
+        if (!running_.load(std::memory_order_acquire))
+            return;
+        wait_.idle(spins);
+    }
+}
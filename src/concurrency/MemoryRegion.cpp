@@ -0,0 +1,211 @@
+#include "MemoryRegion.h"
+
+#include "NumaMemory.h"
+
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#if defined(__APPLE__) || defined(__unix__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::size_t BasePageSize() noexcept
+{
+#if defined(__APPLE__) || defined(__unix__)
+    const long ps = ::sysconf(_SC_PAGESIZE);
+    return ps > 0 ? static_cast<std::size_t>(ps) : 4096;
+#else
+    return 4096;
+#endif
+}
+
+std::size_t RoundUp(std::size_t bytes, std::size_t to) noexcept
+{
+    return (bytes + to - 1) / to * to;
+}
+
+const char* ReadThpMode() noexcept
+{
+#if defined(__linux__)
+    // Format: "always [madvise] never" with the active mode bracketed.
+    std::ifstream in("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string line;
+    if (!in || !std::getline(in, line))
+        return "unavailable";
+    if (line.find("[always]") != std::string::npos)
+        return "always";
+    if (line.find("[madvise]") != std::string::npos)
+        return "madvise";
+    if (line.find("[never]") != std::string::npos)
+        return "never";
+#endif
+    return "unavailable";
+}
+
+#if defined(__APPLE__) || defined(__unix__)
+void* MapAnonymous(std::size_t len, int extraFlags) noexcept
+{
+    void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extraFlags, -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+}
+
+// Maps len bytes starting on a huge-page boundary by over-mapping and trimming both ends.
+void* MapHugeAligned(std::size_t len) noexcept
+{
+    void* raw = MapAnonymous(len + kHugePageSize, 0);
+    if (!raw)
+        return nullptr;
+
+    const auto addr = reinterpret_cast<std::uintptr_t>(raw);
+    const auto aligned = (addr + kHugePageSize - 1) & ~(static_cast<std::uintptr_t>(kHugePageSize) - 1);
+    const std::size_t head = aligned - addr;
+    const std::size_t tail = kHugePageSize - head;
+    if (head)
+        ::munmap(raw, head);
+    if (tail)
+        ::munmap(reinterpret_cast<void*>(aligned + len), tail);
+    return reinterpret_cast<void*>(aligned);
+}
+#endif
+
+}
+
+const char* ToString(PageBacking backing) noexcept
+{
+    switch (backing) {
+    case PageBacking::Base:            return "4 KiB pages";
+    case PageBacking::TransparentHuge: return "transparent 2 MiB pages";
+    case PageBacking::HugeTlb:         return "hugetlbfs 2 MiB pages";
+    }
+    return "unknown";
+}
+
+HugePageSupport QueryHugePageSupport() noexcept
+{
+    HugePageSupport s;
+    s.thpMode = ReadThpMode();
+
+#if defined(__linux__)
+    std::ifstream in("/proc/meminfo");
+    std::string key;
+    std::uint64_t value = 0;
+    std::string unit;
+    while (in >> key >> value) {
+        if (key == "HugePages_Total:")
+            s.hugeTlbTotal = value;
+        else if (key == "HugePages_Free:")
+            s.hugeTlbFree = value;
+        else if (key == "Hugepagesize:")
+            s.hugePageSizeBytes = value * 1024;
+        if (in.peek() != '\n')
+            in >> unit;
+    }
+#endif
+
+    return s;
+}
+
+MemoryRegion::~MemoryRegion()
+{
+    Free(data_, bytes_);
+}
+
+MemoryRegion MemoryRegion::Allocate(std::size_t bytes, RegionOptions options) noexcept
+{
+    MemoryRegion region;
+    if (bytes == 0)
+        return region;
+
+    const std::size_t page = BasePageSize();
+    std::size_t len = RoundUp(bytes, page);
+    void* p = nullptr;
+    PageBacking backing = PageBacking::Base;
+
+#if defined(__APPLE__) || defined(__unix__)
+    if (options.hugePages) {
+        const std::size_t hugeLen = RoundUp(bytes, kHugePageSize);
+#if defined(MAP_HUGETLB)
+        if ((p = MapAnonymous(hugeLen, MAP_HUGETLB)) != nullptr) {
+            len = hugeLen;
+            backing = PageBacking::HugeTlb;
+        }
+#endif
+#if defined(MADV_HUGEPAGE)
+        if (!p && std::strcmp(ReadThpMode(), "never") != 0 && (p = MapHugeAligned(hugeLen)) != nullptr) {
+            len = hugeLen;
+            backing = ::madvise(p, len, MADV_HUGEPAGE) == 0 ? PageBacking::TransparentHuge : PageBacking::Base;
+        }
+#endif
+    }
+    if (!p && (p = MapAnonymous(len, 0)) == nullptr)
+        return region;
+#else
+    p = std::aligned_alloc(page, len);
+    if (!p)
+        return region;
+#endif
+
+    region.data_ = p;
+    region.bytes_ = len;
+    region.node_ = options.node;
+    region.backing_ = backing;
+    region.bound_ = BindMemoryToNumaNode(p, len, options.node);
+
+    // First touch; with the binding in place this faults every page in on the node. One
+    // write per base page also covers huge pages (the first write to each faults it in).
+    volatile std::uint8_t* bytesPtr = static_cast<volatile std::uint8_t*>(p);
+    for (std::size_t i = 0; i < len; i += page)
+        bytesPtr[i] = 0;
+
+    return region;
+}
+
+void MemoryRegion::Free(void* p, std::size_t bytes) noexcept
+{
+    if (!p)
+        return;
+#if defined(__APPLE__) || defined(__unix__)
+    ::munmap(p, bytes);
+#else
+    (void)bytes;
+    std::free(p);
+#endif
+}
+
+void* RegionArena::allocate(std::size_t bytes, std::size_t align) noexcept
+{
+    if (!chunks_.empty()) {
+        Chunk& c = chunks_.back();
+        const std::size_t offset = RoundUp(c.used, align);
+        if (offset + bytes <= c.region.size()) {
+            c.used = offset + bytes;
+            return static_cast<std::uint8_t*>(c.region.data()) + offset;
+        }
+    }
+
+    Chunk chunk;
+    chunk.region = MemoryRegion::Allocate(bytes > chunkBytes_ ? bytes : chunkBytes_, options_);
+    if (!chunk.region.data())
+        return nullptr;
+    chunk.used = bytes;
+    void* p = chunk.region.data();
+    chunks_.push_back(std::move(chunk));
+    return p;
+}
+
+std::size_t RegionArena::reservedBytes() const noexcept
+{
+    std::size_t total = 0;
+    for (const auto& c : chunks_)
+        total += c.region.size();
+    return total;
+}
+
+PageBacking RegionArena::backing() const noexcept
+{
+    return chunks_.empty() ? PageBacking::Base : chunks_.front().region.backing();
+}
@@ -0,0 +1,137 @@
+#include "NumaMemory.h"
+
+#include <string>
+#include <sys/stat.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+// From <linux/mempolicy.h>; spelled out so the build does not need libnuma headers.
+constexpr int kMpolDefault = 0;
+constexpr int kMpolPreferred = 1;
+constexpr int kMpolBind = 2;
+constexpr unsigned kMpolMfMove = 1u << 1;
+constexpr int kMaxNodes = 1024;
+constexpr std::size_t kMaskWords = kMaxNodes / (8 * sizeof(unsigned long));
+
+bool DirectoryExists(const std::string& path)
+{
+    struct stat st{};
+    return ::stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+long Mbind(void* addr, std::size_t len, int mode, const unsigned long* mask, unsigned long maxnode, unsigned flags)
+{
+    return ::syscall(SYS_mbind, addr, len, mode, mask, maxnode, flags);
+}
+
+long SetMempolicy(int mode, const unsigned long* mask, unsigned long maxnode)
+{
+    return ::syscall(SYS_set_mempolicy, mode, mask, maxnode);
+}
+
+void MakeNodeMask(int node, unsigned long (&mask)[kMaskWords])
+{
+    for (auto& w : mask)
+        w = 0;
+    const std::size_t bits = 8 * sizeof(unsigned long);
+    mask[static_cast<std::size_t>(node) / bits] |= 1ul << (static_cast<std::size_t>(node) % bits);
+}
+#endif
+
+}
+
+int NumaNodeCount() noexcept
+{
+#if defined(__linux__)
+    static const int count = [] {
+        int n = 0;
+        while (n < kMaxNodes && DirectoryExists("/sys/devices/system/node/node" + std::to_string(n)))
+            ++n;
+        return n > 0 ? n : 1;
+    }();
+    return count;
+#else
+    return 1;
+#endif
+}
+
+bool NumaAvailable() noexcept
+{
+#if defined(__linux__)
+    static const bool available = [] {
+        if (NumaNodeCount() < 2)
+            return false;
+        // get_mempolicy would do, but a zero-length mbind is the cheapest probe that also
+        // catches seccomp/container filters refusing the syscall.
+        return Mbind(nullptr, 0, 0, nullptr, 0, 0) == 0;
+    }();
+    return available;
+#else
+    return false;
+#endif
+}
+
+int NumaNodeOfCpu(int cpu) noexcept
+{
+    if (cpu < 0)
+        return -1;
+#if defined(__linux__)
+    const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/node";
+    const int nodes = NumaNodeCount();
+    for (int n = 0; n < nodes; ++n) {
+        if (DirectoryExists(base + std::to_string(n)))
+            return n;
+    }
+    return nodes == 1 ? 0 : -1;
+#else
+    return 0;
+#endif
+}
+
+int CurrentNumaNode() noexcept
+{
+#if defined(__linux__)
+    return NumaNodeOfCpu(::sched_getcpu());
+#else
+    return 0;
+#endif
+}
+
+bool PreferNumaNodeForCurrentThread(int node) noexcept
+{
+#if defined(__linux__)
+    if (!NumaAvailable())
+        return false;
+    if (node < 0)
+        return SetMempolicy(kMpolDefault, nullptr, 0) == 0;
+    unsigned long mask[kMaskWords];
+    MakeNodeMask(node, mask);
+    return SetMempolicy(kMpolPreferred, mask, kMaxNodes) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+bool BindMemoryToNumaNode(void* addr, std::size_t bytes, int node) noexcept
+{
+#if defined(__linux__)
+    if (node < 0 || !NumaAvailable())
+        return false;
+    unsigned long mask[kMaskWords];
+    MakeNodeMask(node, mask);
+    return Mbind(addr, bytes, kMpolBind, mask, kMaxNodes, kMpolMfMove) == 0;
+#else
+    (void)addr;
+    (void)bytes;
+    (void)node;
+    return false;
+#endif
+}
@@ -1,20 +1,16 @@
 #include "Producer.h"
 #include "ThreadPinning.h"
+#include "NumaMemory.h"
+#include "TimeUtils.h"
 
-namespace {
-inline void backoff(uint32_t& spins) noexcept {
-    if (spins < 64) {
-        ++spins;
-        asm volatile("" ::: "memory");
-        return;
-    }
-    spins = 0;
-    std::this_thread::yield();
-}
-}
+#include <chrono>
 
-Producer::OrderPool::OrderPool()
-    : storage_(std::make_unique<Storage[]>(PoolSize))
+// The slab is a placed region where one can be mapped, and plain heap memory otherwise.
+Producer::OrderPool::OrderPool(int node, WaitStrategy wait)
+    : region_(MemoryRegion::Allocate(sizeof(Storage) * PoolSize, { node, true }))
+    , heap_(region_.data() ? nullptr : std::make_unique<Storage[]>(PoolSize))
+    , storage_(region_.data() ? static_cast<Storage*>(region_.data()) : heap_.get())
+    , wait_(wait)
 {
     for (std::size_t i = 0; i < PoolSize; ++i)
     {
@@ -48,56 +44,134 @@ void Producer::OrderPool::release(Order* p) noexcept
         return;
     uint32_t spins = 0;
     while (!freelist_.push(p)) {
-        backoff(spins);
+        wait_.idle(spins);
     }
 }
 
 Producer::Producer(
-    OrderRingBuffer& queue,
-    Backpressure& backpressure,
+    const ProducerChannel& channel,
     std::atomic<bool>& running,
-    uint32_t producer_id
+    uint32_t producer_id,
+    int cpu,
+    WaitStrategy wait,
+    const WorkloadConfig& workload
 )
-    : queue_(queue)
-    , backpressure_(backpressure)
+    : queue_(*channel.queue)
+    , backpressure_(*channel.backpressure)
+    , cancelLane_(channel.cancelLane)
     , running_(running)
     , producer_id_(producer_id)
-    , rng_state_(producer_id ? producer_id : 1u)
-    , pool_(std::make_shared<OrderPool>())
+    , cpu_(cpu)
+    , wait_(wait)
+    , workload_(workload, producer_id)
 {
-}
-
-uint32_t Producer::next_u32() noexcept {
-    uint32_t x = rng_state_;
-    x ^= x << 13;
-    x ^= x >> 17;
-    x ^= x << 5;
-    rng_state_ = x;
-    return x;
+    // The pool (slab and freelist) is written by this producer on every add, so it lives on
+    // the producer's node even though the constructor runs on main's thread.
+    const int node = NumaNodeOfCpu(cpu_);
+    if (auto local = MakeInRegion<OrderPool>({ node, true }, node, wait_))
+        pool_ = std::move(local);
+    else
+        pool_ = std::make_shared<OrderPool>(node, wait_);
 }
 
 void Producer::run() {
-    PinCurrentThreadToCore(producer_id_ + 1);
+    PinCurrentThreadToCpu(cpu_);
+    PreferNumaNodeForCurrentThread(NumaNodeOfCpu(cpu_));
 
+    if (workload_.config().pacing == ArrivalPacing::Unpaced) {
+        while (running_.load(std::memory_order_relaxed)) {
+            produce_event();
+        }
+        return;
+    }
+
+    // Open loop: arrival times follow the schedule, not the pipeline, so a slow engine shows
+    // up as queueing instead of silently lowering the offered rate.
+    std::uint64_t nextArrival = ob::time::now_ns();
     while (running_.load(std::memory_order_relaxed)) {
+        nextArrival += workload_.next_gap_ns();
+        wait_for_arrival(nextArrival);
+        const std::uint64_t now = ob::time::now_ns();
+        if (now > nextArrival + MaxPacingLagNs)
+            nextArrival = now;
         produce_event();
     }
 }
 
-void Producer::produce_event() {
-    const int event_type = static_cast<int>(next_u32() % 3u);
-    const Side side = ((next_u32() & 1u) == 0u) ? Side::Buy : Side::Sell;
-    switch (event_type) {
-    case 0: {
-        const Price price = static_cast<Price>(90 + (next_u32() % 21u));
-        const Quantity qty = static_cast<Quantity>(1 + (next_u32() % 100u));
-        const OrderId id = (static_cast<OrderId>(producer_id_) << 32) | static_cast<OrderId>(order_seq_++);
-
-        id_ring_[id_ring_pos_] = id;
-        id_ring_pos_ = (id_ring_pos_ + 1) & (IdRingSize - 1);
-        if (id_ring_count_ < IdRingSize)
-            ++id_ring_count_;
+// Sleeps off long gaps and spins through the last stretch, where a sleep would overshoot.
+void Producer::wait_for_arrival(std::uint64_t deadlineNs) {
+    constexpr std::uint64_t kSpinWindowNs = 100'000;
+    uint32_t spins = 0;
+    for (;;) {
+        const std::uint64_t now = ob::time::now_ns();
+        if (now >= deadlineNs || !running_.load(std::memory_order_relaxed))
+            return;
+        const std::uint64_t remaining = deadlineNs - now;
+        if (remaining > 2 * kSpinWindowNs)
+            std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - kSpinWindowNs));
+        else
+            wait_.idle(spins);
+    }
+}
+
+bool Producer::sample_latency() noexcept {
+    if (++sampleCounter_ < LatencySampleEvery)
+        return false;
+    sampleCounter_ = 0;
+    return true;
+}
+
+void Producer::enqueue(EngineEvent& ev) {
+    if (sample_latency())
+        ev.enqueueNs = ob::time::now_ns();
+    backpressure_.wait_if_needed();
+    uint32_t spins = 0;
+#if OB_TRACING
+    ev.trace.enqueued = TraceStamp();
+#endif
+    while (!queue_.push(ev)) {
+        enqueueRetries_.fetch_add(1, std::memory_order_relaxed);
+        backpressure_.wait_if_needed();
+        wait_.idle(spins);
+#if OB_TRACING
+        ev.trace.enqueued = TraceStamp();
+#endif
+    }
+    backpressure_.increment();
+    producedEvents_.fetch_add(1, std::memory_order_relaxed);
+}
 
+// The lane bypasses the credit window: a cancel must not wait for the adds it should
+// overtake to drain. Its own capacity bounds what can be outstanding.
+void Producer::enqueue_cancel(OrderId id) {
+    if (!cancelLane_) {
+        EngineEvent ev = EngineEvent::MakeCancel(id);
+#if OB_TRACING
+        ev.trace.created = TraceStamp();
+#endif
+        enqueue(ev);
+        return;
+    }
+
+    const CancelRequest request{ id, sample_latency() ? ob::time::now_ns() : 0 };
+    uint32_t spins = 0;
+    while (!cancelLane_->push(request)) {
+        if (!running_.load(std::memory_order_relaxed))
+            return;
+        enqueueRetries_.fetch_add(1, std::memory_order_relaxed);
+        wait_.idle(spins);
+    }
+    backpressure_.notify_consumer();
+    producedEvents_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Producer::produce_event() {
+#if OB_TRACING
+    const std::uint64_t created = TraceStamp();
+#endif
+    const WorkloadOp op = workload_.next();
+    switch (op.op) {
+    case OrderOp::Add: {
         Order* raw = nullptr;
         bool fromPool = true;
         uint32_t allocSpins = 0;
@@ -106,7 +180,7 @@ void Producer::produce_event() {
             if (!running_.load(std::memory_order_relaxed))
                 return;
             poolWaitSpins_.fetch_add(1, std::memory_order_relaxed);
-            backoff(allocSpins);
+            wait_.idle(allocSpins);
 
             if (++allocFails >= 1024) {
                 fromPool = false;
@@ -115,75 +189,31 @@ void Producer::produce_event() {
             }
         }
 
-        raw->Reset(OrderType::GoodTillCancel, id, side, price, qty);
+        raw->Reset(op.type, op.id, op.side, op.price, op.quantity);
 
         auto order = fromPool
             ? OrderPointer(raw, [pool = pool_](Order* p) { pool->release(p); })
             : OrderPointer(raw, [](Order* p) { delete p; });
 
         EngineEvent ev = EngineEvent::MakeAdd(std::move(order));
-        backpressure_.wait_if_needed();
-        uint32_t spins = 0;
-        while (!queue_.push(ev)) {
-            enqueueRetries_.fetch_add(1, std::memory_order_relaxed);
-            backpressure_.wait_if_needed();
-            backoff(spins);
-        }
-        backpressure_.increment();
-        producedEvents_.fetch_add(1, std::memory_order_relaxed);
+#if OB_TRACING
+        ev.trace.created = created;
+#endif
+        enqueue(ev);
         break;
     }
 
-    case 1: {
-        OrderId id{ next_u32() };
-        if (id_ring_count_ > 0)
-        {
-            const std::size_t offset = static_cast<std::size_t>(next_u32() % id_ring_count_);
-            const std::size_t idx = (id_ring_pos_ - 1 - offset) & (IdRingSize - 1);
-            id = id_ring_[idx];
-        }
-        EngineEvent ev = EngineEvent::MakeCancel(id);
-        backpressure_.wait_if_needed();
-        uint32_t spins = 0;
-        while (!queue_.push(ev)) {
-            enqueueRetries_.fetch_add(1, std::memory_order_relaxed);
-            backpressure_.wait_if_needed();
-            backoff(spins);
-        }
-        backpressure_.increment();
-        producedEvents_.fetch_add(1, std::memory_order_relaxed);
+    case OrderOp::Cancel:
+        enqueue_cancel(op.id);
         break;
-    }
 
-    case 2: {
-        OrderId id{ next_u32() };
-        if (id_ring_count_ > 0)
-        {
-            const std::size_t offset = static_cast<std::size_t>(next_u32() % id_ring_count_);
-            const std::size_t idx = (id_ring_pos_ - 1 - offset) & (IdRingSize - 1);
-            id = id_ring_[idx];
-        }
-        OrderModify mod{
-            id,
-            ((next_u32() & 1u) == 0u) ? Side::Buy : Side::Sell,
-            static_cast<Price>(90 + (next_u32() % 21u)),
-            static_cast<Quantity>(1 + (next_u32() % 100u))
-        };
-
-        EngineEvent ev = EngineEvent::MakeModify(std::move(mod));
-        backpressure_.wait_if_needed();
-        uint32_t spins = 0;
-        while (!queue_.push(ev)) {
-            enqueueRetries_.fetch_add(1, std::memory_order_relaxed);
-            backpressure_.wait_if_needed();
-            backoff(spins);
-        }
-        backpressure_.increment();
-        producedEvents_.fetch_add(1, std::memory_order_relaxed);
+    case OrderOp::Modify: {
+        EngineEvent ev = EngineEvent::MakeModify(OrderModify{ op.id, op.side, op.price, op.quantity });
+#if OB_TRACING
+        ev.trace.created = created;
+#endif
+        enqueue(ev);
         break;
     }
-
-    default:
-        break;
     }
 }
@@ -0,0 +1,264 @@
+#include "RiskStage.h"
+#include "NumaMemory.h"
+#include "ThreadPinning.h"
+
+#include <algorithm>
+
+void RiskLimitTable::set(std::uint32_t account, const RiskLimits& limits) noexcept {
+    if (account >= MaxAccounts)
+        return;
+    Entry& e = entries_[account];
+    e.maxOrderQuantity.store(limits.maxOrderQuantity, std::memory_order_relaxed);
+    e.maxOpenNotional.store(limits.maxOpenNotional, std::memory_order_relaxed);
+    e.maxPosition.store(limits.maxPosition, std::memory_order_relaxed);
+}
+
+void RiskLimitTable::set_all(const RiskLimits& limits) noexcept {
+    for (std::uint32_t account = 0; account < MaxAccounts; ++account)
+        set(account, limits);
+}
+
+RiskLimits RiskLimitTable::get(std::uint32_t account) const noexcept {
+    RiskLimits limits;
+    if (account >= MaxAccounts)
+        return limits;
+    const Entry& e = entries_[account];
+    limits.maxOrderQuantity = e.maxOrderQuantity.load(std::memory_order_relaxed);
+    limits.maxOpenNotional = e.maxOpenNotional.load(std::memory_order_relaxed);
+    limits.maxPosition = e.maxPosition.load(std::memory_order_relaxed);
+    return limits;
+}
+
+RiskStage::RiskStage(std::vector<ProducerChannel>& inputs, const RiskLimitTable& limits, int cpu,
+                     WaitStrategy wait, std::uint32_t burstSize)
+    : inputs_(inputs),
+      limits_(limits),
+      cpu_(cpu),
+      wait_(wait),
+      burstSize_(burstSize ? burstSize : 1)
+{
+    // The output rings and the report ring are written by this stage and the engine
+    // respectively; both sit on the stage's node, which the engine reads from anyway.
+    const int node = NumaNodeOfCpu(cpu_);
+    reports_ = MakeRequiredInRegion<ExecutionReportRing>("the execution report ring", { node, true });
+    reports_->prefault();
+
+    for (ProducerChannel& in : inputs_) {
+        in.backpressure->attach_consumer(&wake_);
+
+        rings_.push_back(MakeRequiredInRegion<OrderRingBuffer>("an order ring", { node, true }));
+        rings_.back()->prefault();
+        credits_.push_back(MakeRequiredInRegion<Backpressure>("a credit window", { node, false }, in.backpressure->limit(), wait_));
+
+        ProducerChannel out = in;
+        out.queue = rings_.back().get();
+        out.backpressure = credits_.back().get();
+        outputs_.push_back(out);
+    }
+}
+
+void RiskStage::start() {
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&RiskStage::run, this);
+}
+
+void RiskStage::stop() {
+    running_.store(false, std::memory_order_release);
+    wake_.notify();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+std::uint64_t RiskStage::accepted() const {
+    std::uint64_t n = 0;
+    for (const RiskAccountStats& s : stats_)
+        n += s.accepted.load(std::memory_order_relaxed);
+    return n;
+}
+
+std::uint64_t RiskStage::rejected() const {
+    std::uint64_t n = 0;
+    for (const RiskAccountStats& s : stats_)
+        n += s.rejected.load(std::memory_order_relaxed);
+    return n;
+}
+
+bool RiskStage::has_work() const {
+    if (!running_.load(std::memory_order_acquire) || !reports_->empty())
+        return true;
+    for (const ProducerChannel& in : inputs_) {
+        if (!in.queue->empty())
+            return true;
+    }
+    return false;
+}
+
+void RiskStage::run() {
+    PinCurrentThreadToCpu(cpu_);
+    PreferNumaNodeForCurrentThread(NumaNodeOfCpu(cpu_));
+
+    std::uint32_t idleSpins = 0;
+    while (running_.load(std::memory_order_acquire)) {
+        std::size_t done = drain_reports();
+        for (std::size_t i = 0; i < inputs_.size(); ++i) {
+            done += drain(i);
+            // Lane cancels go straight to the engine, but the producer woke this stage.
+            if (inputs_[i].cancelLane && !inputs_[i].cancelLane->empty())
+                outputs_[i].backpressure->notify_consumer();
+        }
+
+        if (done == 0)
+            wait_.idle(idleSpins, &wake_, [this] { return has_work(); });
+        else
+            idleSpins = 0;
+    }
+    drain_reports();
+}
+
+std::size_t RiskStage::drain(std::size_t channel) {
+    ProducerChannel& in = inputs_[channel];
+    const std::uint32_t account = in.producerId;
+
+    std::size_t processed = 0;
+    EngineEvent event;
+    while (processed < burstSize_ && in.queue->pop(event)) {
+        ++processed;
+        in.backpressure->decrement();
+        if (check(event, account))
+            forward(channel, event);
+    }
+    in.backpressure->flush();
+    return processed;
+}
+
+bool RiskStage::check(EngineEvent& event, std::uint32_t account) {
+    switch (event.type) {
+        case EngineEventType::Add: {
+            const OrderPointer& order = std::get<OrderPointer>(event.payload);
+            return admit(account, order->GetOrderId(), order->GetSide(), order->GetPrice(),
+                         order->GetRemainingQuantity());
+        }
+
+        case EngineEventType::Modify: {
+            const OrderModify& modify = std::get<OrderModify>(event.payload);
+            return admit(account, modify.GetOrderId(), modify.GetSide(), modify.GetPrice(),
+                         modify.GetQuantity());
+        }
+
+        case EngineEventType::Cancel:
+        case EngineEventType::MassCancel:
+        case EngineEventType::Shutdown:
+            return true;
+    }
+    return true;
+}
+
+// A modify is checked as its replacement: the order's open quantity is released and the new
+// one reserved, as the engine's cancel-and-add will do.
+bool RiskStage::admit(std::uint32_t account, OrderId id, Side side, Price price, Quantity quantity) {
+    if (account >= RiskLimitTable::MaxAccounts)
+        return false;
+
+    Account& a = accounts_[account];
+    const RiskLimits limits = limits_.get(account);
+
+    const auto it = live_.find(id);
+    const LiveOrder* previous = it != live_.end() ? &it->second : nullptr;
+
+    std::int64_t notional = a.openNotional + static_cast<std::int64_t>(price) * quantity;
+    std::int64_t buys = a.openBuyQuantity + (side == Side::Buy ? quantity : 0);
+    std::int64_t sells = a.openSellQuantity + (side == Side::Sell ? quantity : 0);
+    if (previous) {
+        notional -= static_cast<std::int64_t>(previous->price) * previous->remaining;
+        (previous->side == Side::Buy ? buys : sells) -= previous->remaining;
+    }
+
+    const bool ok = quantity <= limits.maxOrderQuantity
+        && notional <= limits.maxOpenNotional
+        && a.position + buys <= limits.maxPosition
+        && sells - a.position <= limits.maxPosition;
+    if (!ok) {
+        ++a.rejected;
+        publish(account);
+        return false;
+    }
+
+    a.openNotional = notional;
+    a.openBuyQuantity = buys;
+    a.openSellQuantity = sells;
+    ++a.accepted;
+    if (previous)
+        it->second = { side, price, quantity };
+    else
+        live_.insert({ id, { side, price, quantity } });
+    publish(account);
+    return true;
+}
+
+// Waits for room downstream without ever blocking the engine: it may itself be waiting for
+// room in the report ring, so reports are drained while the output is full.
+void RiskStage::forward(std::size_t channel, EngineEvent& event) {
+    ProducerChannel& out = outputs_[channel];
+    std::uint32_t spins = 0;
+    while (!out.backpressure->has_credit() || !out.queue->push(std::move(event))) {
+        if (drain_reports() == 0)
+            wait_.idle(spins);
+    }
+    out.backpressure->increment();
+}
+
+std::size_t RiskStage::drain_reports() {
+    std::size_t n = 0;
+    ExecutionReport report;
+    while (reports_->pop(report)) {
+        apply_report(report);
+        ++n;
+    }
+    return n;
+}
+
+// Fills move the position whether or not this stage still tracks the order (it may have
+// been released early by a modify, or come from a path that bypasses the stage).
+void RiskStage::apply_report(const ExecutionReport& report) {
+    const auto account = static_cast<std::uint32_t>(report.orderId >> 32);
+    if (account >= RiskLimitTable::MaxAccounts)
+        return;
+
+    const auto it = live_.find(report.orderId);
+    if (report.type == ExecutionReportType::Fill) {
+        Account& a = accounts_[account];
+        a.position += report.side == Side::Buy ? static_cast<std::int64_t>(report.quantity)
+                                               : -static_cast<std::int64_t>(report.quantity);
+        if (it != live_.end()) {
+            release(it->second, account, std::min(report.quantity, it->second.remaining));
+            if (it->second.remaining == 0)
+                live_.erase(it);
+        }
+        publish(account);
+        return;
+    }
+
+    if (it != live_.end()) {
+        release(it->second, account, it->second.remaining);
+        live_.erase(it);
+        publish(account);
+    }
+}
+
+void RiskStage::release(LiveOrder& order, std::uint32_t account, Quantity quantity) {
+    Account& a = accounts_[account];
+    a.openNotional -= static_cast<std::int64_t>(order.price) * quantity;
+    (order.side == Side::Buy ? a.openBuyQuantity : a.openSellQuantity) -= quantity;
+    order.remaining -= quantity;
+}
+
+void RiskStage::publish(std::uint32_t account) {
+    const Account& a = accounts_[account];
+    RiskAccountStats& s = stats_[account];
+    s.openNotional.store(a.openNotional, std::memory_order_relaxed);
+    s.openBuyQuantity.store(a.openBuyQuantity, std::memory_order_relaxed);
+    s.openSellQuantity.store(a.openSellQuantity, std::memory_order_relaxed);
+    s.position.store(a.position, std::memory_order_relaxed);
+    s.accepted.store(a.accepted, std::memory_order_relaxed);
+    s.rejected.store(a.rejected, std::memory_order_relaxed);
+}
@@ -0,0 +1,100 @@
+#include "SharedMemory.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+std::string ShmPath(std::string_view name) {
+    std::string path = "/";
+    path.append(name);
+    return path;
+}
+
+void SetError(std::string* error, std::string_view name, const char* what) {
+    if (!error)
+        return;
+    *error = "/dev/shm/";
+    error->append(name);
+    error->append(": ");
+    error->append(what);
+}
+}
+
+SharedMemory::~SharedMemory() {
+    if (!data_)
+        return;
+    munmap(data_, bytes_);
+    if (owner_ && !name_.empty())
+        shm_unlink(ShmPath(name_).c_str());
+}
+
+// O_EXCL after an unlink: a leftover segment is replaced, never reused with whatever size
+// and contents it had.
+SharedMemory SharedMemory::Create(std::string_view name, std::size_t bytes, std::string* error) noexcept {
+    SharedMemory shm;
+    const std::string path = ShmPath(name);
+    shm_unlink(path.c_str());
+    const int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        SetError(error, name, std::strerror(errno));
+        return shm;
+    }
+    void* p = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) == 0)
+        p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int err = errno;
+    close(fd);
+    if (p == MAP_FAILED) {
+        shm_unlink(path.c_str());
+        SetError(error, name, std::strerror(err));
+        return shm;
+    }
+    shm.data_ = p;
+    shm.bytes_ = bytes;
+    shm.name_.assign(name);
+    shm.owner_ = true;
+    return shm;
+}
+
+SharedMemory SharedMemory::Anonymous(std::size_t bytes) noexcept {
+    SharedMemory shm;
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        return shm;
+    shm.data_ = p;
+    shm.bytes_ = bytes;
+    shm.owner_ = true;
+    return shm;
+}
+
+SharedMemory SharedMemory::Open(std::string_view name, bool writable, std::string* error) noexcept {
+    SharedMemory shm;
+    const int fd = shm_open(ShmPath(name).c_str(), writable ? O_RDWR : O_RDONLY, 0);
+    if (fd < 0) {
+        SetError(error, name, std::strerror(errno));
+        return shm;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        SetError(error, name, "empty or unreadable segment");
+        return shm;
+    }
+    const std::size_t bytes = static_cast<std::size_t>(st.st_size);
+    void* p = mmap(nullptr, bytes, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    const int err = errno;
+    close(fd);
+    if (p == MAP_FAILED) {
+        SetError(error, name, std::strerror(err));
+        return shm;
+    }
+    shm.data_ = p;
+    shm.bytes_ = bytes;
+    shm.name_.assign(name);
+    return shm;
+}
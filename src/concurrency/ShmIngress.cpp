@@ -0,0 +1,80 @@
+#include "ShmIngress.h"
+
+#include <cerrno>
+#include <new>
+
+#include <dirent.h>
+#include <signal.h>
+#include <unistd.h>
+
+std::string IngressSegmentName(std::string_view prefix, std::uint32_t producerId) {
+    std::string name(prefix);
+    name.append(".in.");
+    name.append(std::to_string(producerId));
+    return name;
+}
+
+IngressRing IngressRing::Create(std::string_view name, std::uint32_t producerId, std::uint32_t weight,
+                                std::string* error) noexcept {
+    IngressRing ring;
+    ring.memory_ = SharedMemory::Create(name, sizeof(IngressSegment), error);
+    if (!ring.memory_.valid())
+        return ring;
+
+    auto* segment = new (ring.memory_.data()) IngressSegment();
+    segment->header.producerId = producerId;
+    segment->header.weight = weight ? weight : 1;
+    segment->header.pid = static_cast<std::int32_t>(getpid());
+    segment->ring.prefault();
+    segment->header.magic.store(IngressMagic, std::memory_order_release);
+    return ring;
+}
+
+IngressRing IngressRing::Attach(std::string_view name, std::string* error) noexcept {
+    IngressRing ring;
+    SharedMemory memory = SharedMemory::Open(name, true, error);
+    if (!memory.valid())
+        return ring;
+
+    const char* problem = nullptr;
+    const auto* header = static_cast<const IngressHeader*>(memory.data());
+    if (memory.size() != sizeof(IngressSegment))
+        problem = "has the wrong size for an ingress ring";
+    else if (header->magic.load(std::memory_order_acquire) != IngressMagic)
+        problem = "has no ingress magic (not constructed yet, or not an ingress ring)";
+    else if (header->version != IngressVersion)
+        problem = "has a different ingress version";
+    if (problem) {
+        if (error) {
+            *error = "/dev/shm/";
+            error->append(name);
+            error->append(" ");
+            error->append(problem);
+        }
+        return ring;
+    }
+
+    ring.memory_ = std::move(memory);
+    return ring;
+}
+
+std::vector<IngressSegmentId> IngressRing::Discover(std::string_view prefix) {
+    std::vector<IngressSegmentId> found;
+    std::string match(prefix);
+    match.append(".in.");
+
+    DIR* dir = opendir("/dev/shm");
+    if (!dir)
+        return found;
+    while (const dirent* entry = readdir(dir)) {
+        const std::string_view name = entry->d_name;
+        if (name.size() > match.size() && name.substr(0, match.size()) == match)
+            found.push_back({ std::string(name), static_cast<std::uint64_t>(entry->d_ino) });
+    }
+    closedir(dir);
+    return found;
+}
+
+bool IngressRing::writer_alive() const noexcept {
+    return kill(header().pid, 0) == 0 || errno == EPERM;
+}
@@ -0,0 +1,96 @@
+#include "Telemetry.h"
+#include "TimeUtils.h"
+
+#include <new>
+
+#include <unistd.h>
+
+namespace {
+constexpr std::size_t kEngineOffset = sizeof(TelemetryHeader);
+constexpr std::size_t kStagesOffset = kEngineOffset + sizeof(EngineTelemetry);
+constexpr std::size_t kChannelsOffset = (kStagesOffset + sizeof(StageLatency) + 63) & ~std::size_t{63};
+}
+
+const char* ToString(TelemetryState state) {
+    switch (state) {
+        case TelemetryState::Starting: return "starting";
+        case TelemetryState::Running: return "running";
+        case TelemetryState::Stopped: return "stopped";
+    }
+    return "unknown";
+}
+
+std::size_t TelemetryRegion::BytesFor(std::size_t channelCount) noexcept {
+    return kChannelsOffset + channelCount * sizeof(ChannelTelemetry);
+}
+
+EngineTelemetry& TelemetryRegion::engine() const noexcept {
+    return *reinterpret_cast<EngineTelemetry*>(static_cast<char*>(memory_.data()) + kEngineOffset);
+}
+
+StageLatency& TelemetryRegion::stages() const noexcept {
+    return *reinterpret_cast<StageLatency*>(static_cast<char*>(memory_.data()) + kStagesOffset);
+}
+
+ChannelTelemetry& TelemetryRegion::channel(std::size_t index) const noexcept {
+    return reinterpret_cast<ChannelTelemetry*>(static_cast<char*>(memory_.data()) + kChannelsOffset)[index];
+}
+
+TelemetryRegion TelemetryRegion::Create(std::string_view name, std::size_t channelCount) noexcept {
+    TelemetryRegion region;
+    const std::size_t bytes = BytesFor(channelCount);
+
+    if (!name.empty())
+        region.memory_ = SharedMemory::Create(name, bytes);
+    if (!region.memory_.valid())
+        region.memory_ = SharedMemory::Anonymous(bytes);
+    if (!region.memory_.valid())
+        return region;
+
+    // The mapping is zero-filled; the objects still have to be constructed (histogram
+    // minimums start at all-ones).
+    auto* header = new (region.memory_.data()) TelemetryHeader();
+    new (&region.engine()) EngineTelemetry();
+    new (&region.stages()) StageLatency();
+    for (std::size_t i = 0; i < channelCount; ++i)
+        new (&region.channel(i)) ChannelTelemetry();
+
+    header->flags = OB_TRACING ? TelemetryFlagTracing : 0;
+    header->totalBytes = bytes;
+    header->channelCount = static_cast<std::uint32_t>(channelCount);
+    header->pid = static_cast<std::int32_t>(getpid());
+    header->startNs = ob::time::steady_now_ns();
+    header->publishNs.store(header->startNs, std::memory_order_relaxed);
+    header->magic.store(TelemetryMagic, std::memory_order_release);
+    return region;
+}
+
+TelemetryRegion TelemetryRegion::Open(std::string_view name, std::string* error) noexcept {
+    TelemetryRegion region;
+    SharedMemory memory = SharedMemory::Open(name, false, error);
+    if (!memory.valid())
+        return region;
+
+    const char* problem = nullptr;
+    const auto* header = static_cast<const TelemetryHeader*>(memory.data());
+    if (memory.size() < sizeof(TelemetryHeader))
+        problem = "is not a telemetry segment (too small)";
+    else if (header->magic.load(std::memory_order_acquire) != TelemetryMagic)
+        problem = "has no telemetry magic (not built yet, or not a telemetry segment)";
+    else if (header->version != TelemetryVersion)
+        problem = "has a different telemetry version";
+    else if (header->totalBytes != memory.size() || BytesFor(header->channelCount) != memory.size())
+        problem = "has a size that does not match its layout";
+    if (problem) {
+        if (error) {
+            *error = "/dev/shm/";
+            error->append(name);
+            error->append(" ");
+            error->append(problem);
+        }
+        return region;
+    }
+
+    region.memory_ = std::move(memory);
+    return region;
+}
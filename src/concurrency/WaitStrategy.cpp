@@ -0,0 +1,72 @@
+#include "WaitStrategy.h"
+
+#include <climits>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+// Upper bound on one sleep. Every wake-up path notifies, this only keeps a missed notify
+// (e.g. a peer that exited without one) from hanging a thread forever.
+constexpr long kParkTimeoutNs = 1'000'000;
+
+long Futex(std::atomic<std::uint32_t>* addr, int op, std::uint32_t val, const timespec* timeout)
+{
+    return ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr), op, val, timeout, nullptr, 0);
+}
+#endif
+
+}
+
+const char* ToString(WaitStrategyKind kind)
+{
+    switch (kind) {
+    case WaitStrategyKind::BusySpin:  return "busy-spin";
+    case WaitStrategyKind::SpinYield: return "spin-yield";
+    case WaitStrategyKind::SpinPark:  return "spin-park";
+    }
+    return "unknown";
+}
+
+bool ParseWaitStrategyKind(std::string_view name, WaitStrategyKind& out)
+{
+    if (name == "spin")
+        out = WaitStrategyKind::BusySpin;
+    else if (name == "yield")
+        out = WaitStrategyKind::SpinYield;
+    else if (name == "park")
+        out = WaitStrategyKind::SpinPark;
+    else
+        return false;
+    return true;
+}
+
+void ParkingSpot::sleep(std::uint32_t epoch) noexcept
+{
+    parks_.fetch_add(1, std::memory_order_relaxed);
+#if defined(__linux__)
+    static_assert(sizeof(epoch_) == sizeof(std::uint32_t), "futex word must be 32 bits");
+    const timespec timeout{ 0, kParkTimeoutNs };
+    // Returns at once with EAGAIN when the epoch already moved on.
+    (void)Futex(&epoch_, FUTEX_WAIT_PRIVATE, epoch, &timeout);
+#else
+    epoch_.wait(epoch, std::memory_order_acquire);
+#endif
+}
+
+void ParkingSpot::wake() noexcept
+{
+    wakes_.fetch_add(1, std::memory_order_relaxed);
+    epoch_.fetch_add(1, std::memory_order_release);
+#if defined(__linux__)
+    (void)Futex(&epoch_, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr);
+#else
+    epoch_.notify_all();
+#endif
+}
@@ -0,0 +1,263 @@
+#include "Workload.h"
+
+#include <algorithm>
+#include <cmath>
+
+const char* ToString(WorkloadPreset preset)
+{
+    switch (preset) {
+    case WorkloadPreset::Uniform:     return "uniform";
+    case WorkloadPreset::MarketMaker: return "market-maker";
+    case WorkloadPreset::Taker:       return "taker";
+    }
+    return "unknown";
+}
+
+const char* ToString(ArrivalPacing pacing)
+{
+    switch (pacing) {
+    case ArrivalPacing::Unpaced: return "unpaced";
+    case ArrivalPacing::Poisson: return "poisson";
+    case ArrivalPacing::Bursty:  return "bursty";
+    }
+    return "unknown";
+}
+
+bool ParseWorkloadPreset(std::string_view name, WorkloadPreset& out)
+{
+    if (name == "uniform")
+        out = WorkloadPreset::Uniform;
+    else if (name == "maker")
+        out = WorkloadPreset::MarketMaker;
+    else if (name == "taker")
+        out = WorkloadPreset::Taker;
+    else
+        return false;
+    return true;
+}
+
+bool ParseArrivalPacing(std::string_view name, ArrivalPacing& out)
+{
+    if (name == "unpaced")
+        out = ArrivalPacing::Unpaced;
+    else if (name == "poisson")
+        out = ArrivalPacing::Poisson;
+    else if (name == "bursty")
+        out = ArrivalPacing::Bursty;
+    else
+        return false;
+    return true;
+}
+
+WorkloadConfig MakeWorkload(WorkloadPreset preset)
+{
+    WorkloadConfig c;
+    switch (preset) {
+    case WorkloadPreset::Uniform:
+        c.legacyPrices = true;
+        c.targetLiveOrders = false;
+        break;
+
+    // Quotes close to the touch, most of them pulled or repriced before they trade; a
+    // trickle of takers and a slowly drifting mid.
+    case WorkloadPreset::MarketMaker:
+        c.addWeight = 0.45;
+        c.cancelWeight = 0.40;
+        c.modifyWeight = 0.15;
+        c.aggressiveFraction = 0.05;
+        c.passiveDepthTicks = 2.0;
+        c.midMoveProbability = 0.01;
+        c.maxQuantity = 10;
+        break;
+
+    // Half the adds take liquidity, often through more than one level; the rest refill a
+    // deeper book that is cancelled less.
+    case WorkloadPreset::Taker:
+        c.addWeight = 0.70;
+        c.cancelWeight = 0.20;
+        c.modifyWeight = 0.10;
+        c.aggressiveFraction = 0.50;
+        c.passiveDepthTicks = 4.0;
+        c.aggressiveDepthTicks = 3;
+        c.midMoveProbability = 0.02;
+        c.maxQuantity = 50;
+        break;
+    }
+    return c;
+}
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadConfig& config, std::uint32_t producerId)
+    : config_(config)
+    , producerId_(producerId)
+    , rng_(0x9E3779B97F4A7C15ull * (producerId + 1))
+    , mid_(std::max(config.startMid, config.minPrice + config.halfSpreadTicks + 1))
+{
+    const double add = std::max(config_.addWeight, 0.0);
+    const double cancel = std::max(config_.cancelWeight, 0.0);
+    const double modify = std::max(config_.modifyWeight, 0.0);
+    const double total = add + cancel + modify;
+    addCut_ = total > 0.0 ? add / total : 1.0;
+    cancelCut_ = total > 0.0 ? (add + cancel) / total : 1.0;
+
+    config_.maxQuantity = std::max(config_.maxQuantity, config_.minQuantity);
+    live_.reserve(config_.targetLiveOrders ? MaxLiveOrders : RecentIds);
+}
+
+// xorshift64*: cheap, and good enough that the op mix and price shape come out as configured.
+std::uint64_t WorkloadGenerator::next_u64() noexcept
+{
+    rng_ ^= rng_ >> 12;
+    rng_ ^= rng_ << 25;
+    rng_ ^= rng_ >> 27;
+    return rng_ * 0x2545F4914F6CDD1Dull;
+}
+
+double WorkloadGenerator::next_unit() noexcept
+{
+    return static_cast<double>(next_u64() >> 11) * 0x1.0p-53;
+}
+
+std::uint32_t WorkloadGenerator::next_below(std::uint32_t n) noexcept
+{
+    return n ? static_cast<std::uint32_t>(((next_u64() >> 32) * n) >> 32) : 0;
+}
+
+// Number of failures before the first success with p = 1 / (1 + mean), i.e. mean `mean`.
+Price WorkloadGenerator::geometric_ticks(double mean) noexcept
+{
+    if (mean <= 0.0)
+        return 0;
+    const double u = 1.0 - next_unit();          // (0, 1]
+    const double p = 1.0 / (1.0 + mean);
+    return static_cast<Price>(std::floor(std::log(u) / std::log1p(-p)));
+}
+
+void WorkloadGenerator::move_mid() noexcept
+{
+    if (config_.midMoveProbability <= 0.0 || next_unit() >= config_.midMoveProbability)
+        return;
+    const Price floor = config_.minPrice + config_.halfSpreadTicks + 1;
+    mid_ = (next_u64() & 1) ? mid_ + 1 : std::max<Price>(mid_ - 1, floor);
+}
+
+Price WorkloadGenerator::passive_price(Side side) noexcept
+{
+    const Price away = config_.halfSpreadTicks + geometric_ticks(config_.passiveDepthTicks);
+    return side == Side::Buy ? std::max<Price>(mid_ - away, config_.minPrice) : mid_ + away;
+}
+
+Price WorkloadGenerator::aggressive_price(Side side) noexcept
+{
+    const Price through = config_.halfSpreadTicks + static_cast<Price>(
+        next_below(static_cast<std::uint32_t>(std::max<Price>(config_.aggressiveDepthTicks, 0)) + 1));
+    return side == Side::Buy ? mid_ + through : std::max<Price>(mid_ - through, config_.minPrice);
+}
+
+Quantity WorkloadGenerator::next_quantity() noexcept
+{
+    return config_.minQuantity + static_cast<Quantity>(next_below(config_.maxQuantity - config_.minQuantity + 1));
+}
+
+WorkloadOp WorkloadGenerator::make_add()
+{
+    WorkloadOp op;
+    op.op = OrderOp::Add;
+    op.id = (static_cast<OrderId>(producerId_) << 32) | static_cast<OrderId>(seq_++);
+    op.side = (next_u64() & 1) ? Side::Sell : Side::Buy;
+    op.quantity = next_quantity();
+
+    if (config_.legacyPrices) {
+        op.price = static_cast<Price>(90 + next_below(21));
+    } else if (config_.aggressiveFraction > 0.0 && next_unit() < config_.aggressiveFraction) {
+        op.type = OrderType::FillAndKill;
+        op.price = aggressive_price(op.side);
+        return op;                                // never rests, so never a cancel target
+    } else {
+        op.price = passive_price(op.side);
+    }
+
+    if (config_.targetLiveOrders) {
+        live_.push_back({ op.id, op.side });
+    } else if (live_.size() < RecentIds) {
+        live_.push_back({ op.id, op.side });
+    } else {
+        live_[recentPos_] = { op.id, op.side };
+        recentPos_ = (recentPos_ + 1) & (RecentIds - 1);
+    }
+    return op;
+}
+
+// Live targeting removes a cancelled order by swapping the last one into its slot; the
+// recent-id ring keeps everything, as the original generator did.
+bool WorkloadGenerator::pick_target(LiveOrder& out, bool remove)
+{
+    if (live_.empty())
+        return false;
+    const std::size_t i = next_below(static_cast<std::uint32_t>(live_.size()));
+    out = live_[i];
+    if (remove && config_.targetLiveOrders) {
+        live_[i] = live_.back();
+        live_.pop_back();
+    }
+    return true;
+}
+
+WorkloadOp WorkloadGenerator::next()
+{
+    move_mid();
+
+    // A full live set is shrunk by a cancel, whatever the weights (cancelWeight may be 0).
+    const bool full = config_.targetLiveOrders && live_.size() >= MaxLiveOrders;
+    const double r = next_unit();
+    if (!full && r < addCut_)
+        return make_add();
+
+    const bool cancel = full || r < cancelCut_;
+    LiveOrder target{};
+    if (!pick_target(target, cancel))
+        return make_add();                        // nothing to cancel or modify yet
+
+    WorkloadOp op;
+    op.id = target.id;
+    if (cancel) {
+        op.op = OrderOp::Cancel;
+        return op;
+    }
+
+    op.op = OrderOp::Modify;
+    if (config_.legacyPrices) {
+        op.side = (next_u64() & 1) ? Side::Sell : Side::Buy;
+        op.price = static_cast<Price>(90 + next_below(21));
+    } else {
+        op.side = target.side;
+        op.price = passive_price(target.side);
+    }
+    op.quantity = next_quantity();
+    return op;
+}
+
+std::uint64_t WorkloadGenerator::next_gap_ns()
+{
+    if (config_.pacing == ArrivalPacing::Unpaced || config_.ratePerSec <= 0.0)
+        return 0;
+
+    const auto exponential = [this](double meanNs) {
+        return static_cast<std::uint64_t>(-std::log(1.0 - next_unit()) * meanNs);
+    };
+    const double meanNs = 1e9 / config_.ratePerSec;
+
+    if (config_.pacing == ArrivalPacing::Poisson)
+        return exponential(meanNs);
+
+    // Bursty: arrivals inside a burst come burstFactor times faster; the silence between
+    // bursts makes up the difference so the long-run rate stays ratePerSec.
+    const double factor = std::max(config_.burstFactor, 1.0);
+    const double burstMeanNs = meanNs / factor;
+    if (burstLeft_ > 0) {
+        --burstLeft_;
+        return exponential(burstMeanNs);
+    }
+    const double meanEvents = std::max(config_.meanBurstEvents, 1.0);
+    burstLeft_ = static_cast<std::uint64_t>(geometric_ticks(meanEvents - 1.0));
+    return exponential(meanEvents * (meanNs - burstMeanNs)) + exponential(burstMeanNs);
+}
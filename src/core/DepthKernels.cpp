@@ -0,0 +1,212 @@
+#include "DepthKernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+#define OB_DEPTH_AVX512 1
+#elif defined(__AVX2__)
+#define OB_DEPTH_AVX2 1
+#endif
+
+namespace {
+
+#if OB_DEPTH_AVX512 || OB_DEPTH_AVX2
+// Sum of four 64-bit lanes.
+inline std::uint64_t Reduce(__m256i v)
+{
+    const __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return static_cast<std::uint64_t>(_mm_cvtsi128_si64(sum))
+         + static_cast<std::uint64_t>(_mm_extract_epi64(sum, 1));
+}
+#endif
+
+#if OB_DEPTH_AVX512
+constexpr std::size_t Lanes = 16;
+
+// GCC 12's unmasked forms of these (and _mm512_reduce_add_epi64) pass an _mm*_undefined_*()
+// source that -Wmaybe-uninitialized flags wherever they are inlined, LTO included (GCC PR
+// 105593). With every lane selected, the zero-masked forms compile to the same instructions.
+constexpr __mmask8 AllLanes = 0xFF;
+
+inline __m256i LowHalf(__m512i v) { return _mm512_maskz_extracti64x4_epi64(AllLanes, v, 0); }
+inline __m256i HighHalf(__m512i v) { return _mm512_maskz_extracti64x4_epi64(AllLanes, v, 1); }
+inline __m512i WidenUnsigned(__m256i v) { return _mm512_maskz_cvtepu32_epi64(AllLanes, v); }
+inline __m512i WidenSigned(__m256i v) { return _mm512_maskz_cvtepi32_epi64(AllLanes, v); }
+
+// Sum of eight 64-bit lanes: the 256-bit halves added, then reduced as in the AVX2 build.
+inline std::uint64_t Reduce(__m512i v)
+{
+    return Reduce(_mm256_add_epi64(LowHalf(v), HighHalf(v)));
+}
+
+// Sum of 16 quantities, widened to 64 bits.
+inline std::uint64_t BlockSum(const Quantity* q)
+{
+    const __m512i v = _mm512_loadu_si512(q);
+    return Reduce(_mm512_add_epi64(WidenUnsigned(LowHalf(v)), WidenUnsigned(HighHalf(v))));
+}
+#elif OB_DEPTH_AVX2
+constexpr std::size_t Lanes = 8;
+
+inline __m256i WidenSum(__m256i v)
+{
+    const __m256i lo = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v));
+    const __m256i hi = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1));
+    return _mm256_add_epi64(lo, hi);
+}
+
+// Sum of 8 quantities, widened to 64 bits.
+inline std::uint64_t BlockSum(const Quantity* q)
+{
+    return Reduce(WidenSum(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(q))));
+}
+
+// Four signed price * unsigned quantity products. _mm256_mul_epu32 reads a negative price
+// as price + 2^32, so quantity << 32 is taken back off for those lanes.
+inline __m256i Products(__m128i prices, __m128i quantities)
+{
+    const __m256i p = _mm256_cvtepi32_epi64(prices);
+    const __m256i q = _mm256_cvtepu32_epi64(quantities);
+    const __m256i negative = _mm256_cmpgt_epi64(_mm256_setzero_si256(), p);
+    const __m256i correction = _mm256_and_si256(_mm256_slli_epi64(q, 32), negative);
+    return _mm256_sub_epi64(_mm256_mul_epu32(p, q), correction);
+}
+#endif
+
+}
+
+const char* DepthKernelIsa()
+{
+#if OB_DEPTH_AVX512
+    return "AVX-512";
+#elif OB_DEPTH_AVX2
+    return "AVX2";
+#else
+    return "scalar";
+#endif
+}
+
+std::uint64_t SumQuantitiesScalar(const Quantity* quantities, std::size_t count)
+{
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i)
+        sum += quantities[i];
+    return sum;
+}
+
+std::int64_t SumNotionalScalar(const Price* prices, const Quantity* quantities, std::size_t count)
+{
+    std::int64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i)
+        sum += static_cast<std::int64_t>(prices[i]) * static_cast<std::int64_t>(quantities[i]);
+    return sum;
+}
+
+DepthThreshold FindDepthThresholdScalar(const Quantity* quantities, std::size_t count, std::uint64_t target)
+{
+    if (target == 0)
+        return { };
+    std::uint64_t sum = 0;
+    for (std::size_t i = count; i > 0; --i)
+    {
+        sum += quantities[i - 1];
+        if (sum >= target)
+            return { count - i + 1, sum };
+    }
+    return { count, sum };
+}
+
+std::uint64_t SumQuantities(const Quantity* quantities, std::size_t count)
+{
+    // Two accumulators so that consecutive adds do not wait on each other.
+#if OB_DEPTH_AVX512
+    __m512i acc0 = _mm512_setzero_si512();
+    __m512i acc1 = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + Lanes <= count; i += Lanes)
+    {
+        const __m512i v = _mm512_loadu_si512(quantities + i);
+        acc0 = _mm512_add_epi64(acc0, WidenUnsigned(LowHalf(v)));
+        acc1 = _mm512_add_epi64(acc1, WidenUnsigned(HighHalf(v)));
+    }
+    return Reduce(_mm512_add_epi64(acc0, acc1))
+         + SumQuantitiesScalar(quantities + i, count - i);
+#elif OB_DEPTH_AVX2
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 2 * Lanes <= count; i += 2 * Lanes)
+    {
+        acc0 = _mm256_add_epi64(acc0, WidenSum(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(quantities + i))));
+        acc1 = _mm256_add_epi64(acc1, WidenSum(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(quantities + i + Lanes))));
+    }
+    return Reduce(_mm256_add_epi64(acc0, acc1)) + SumQuantitiesScalar(quantities + i, count - i);
+#else
+    return SumQuantitiesScalar(quantities, count);
+#endif
+}
+
+std::int64_t SumNotional(const Price* prices, const Quantity* quantities, std::size_t count)
+{
+#if OB_DEPTH_AVX512
+    // An unsigned 32x32 multiply per lane, corrected for negative prices as in the AVX2
+    // build, instead of the multi-uop 64-bit mullo.
+    __m512i acc0 = _mm512_setzero_si512();
+    __m512i acc1 = _mm512_setzero_si512();
+    std::size_t i = 0;
+    const auto products = [](const Price* p, const Quantity* q)
+    {
+        const __m512i p64 = WidenSigned(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+        const __m512i q64 = WidenUnsigned(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(q)));
+        const __m512i product = _mm512_maskz_mul_epu32(AllLanes, p64, q64);
+        const __mmask8 negative = _mm512_cmplt_epi64_mask(p64, _mm512_setzero_si512());
+        return _mm512_mask_sub_epi64(product, negative, product, _mm512_maskz_slli_epi64(AllLanes, q64, 32));
+    };
+    for (; i + 16 <= count; i += 16)
+    {
+        acc0 = _mm512_add_epi64(acc0, products(prices + i, quantities + i));
+        acc1 = _mm512_add_epi64(acc1, products(prices + i + 8, quantities + i + 8));
+    }
+    return static_cast<std::int64_t>(Reduce(_mm512_add_epi64(acc0, acc1)))
+         + SumNotionalScalar(prices + i, quantities + i, count - i);
+#elif OB_DEPTH_AVX2
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        acc0 = _mm256_add_epi64(acc0, Products(_mm_loadu_si128(reinterpret_cast<const __m128i*>(prices + i)),
+                                               _mm_loadu_si128(reinterpret_cast<const __m128i*>(quantities + i))));
+        acc1 = _mm256_add_epi64(acc1, Products(_mm_loadu_si128(reinterpret_cast<const __m128i*>(prices + i + 4)),
+                                               _mm_loadu_si128(reinterpret_cast<const __m128i*>(quantities + i + 4))));
+    }
+    return static_cast<std::int64_t>(Reduce(_mm256_add_epi64(acc0, acc1)))
+         + SumNotionalScalar(prices + i, quantities + i, count - i);
+#else
+    return SumNotionalScalar(prices, quantities, count);
+#endif
+}
+
+DepthThreshold FindDepthThreshold(const Quantity* quantities, std::size_t count, std::uint64_t target)
+{
+#if OB_DEPTH_AVX512 || OB_DEPTH_AVX2
+    // Whole blocks from the back while the target lies beyond them, then the block that
+    // reaches it level by level.
+    std::uint64_t sum = 0;
+    std::size_t end = count;
+    while (end >= Lanes)
+    {
+        const std::uint64_t block = BlockSum(quantities + end - Lanes);
+        if (sum + block >= target)
+            break;
+        sum += block;
+        end -= Lanes;
+    }
+    const DepthThreshold rest = FindDepthThresholdScalar(quantities, end, target - sum);
+    return { count - end + rest.levels_, sum + rest.cumulative_ };
+#else
+    return FindDepthThresholdScalar(quantities, count, target);
+#endif
+}
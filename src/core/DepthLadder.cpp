@@ -0,0 +1,72 @@
+#include "DepthLadder.h"
+
+#include <algorithm>
+
+std::size_t DepthLadder::Position(Price price) const
+{
+    // Most changes are at the touch: check the back before searching.
+    const std::size_t count = prices_.size();
+    if (count == 0 || Better(price, prices_.back()))
+        return count;
+    if (prices_.back() == price)
+        return count - 1;
+
+    const auto it = std::lower_bound(prices_.begin(), prices_.end(), price,
+        [this](Price level, Price p) { return Better(p, level); });
+    return static_cast<std::size_t>(it - prices_.begin());
+}
+
+void DepthLadder::Set(Price price, Quantity quantity)
+{
+    const std::size_t i = Position(price);
+    const bool exists = i < prices_.size() && prices_[i] == price;
+    if (quantity == 0)
+    {
+        if (exists)
+        {
+            prices_.erase(prices_.begin() + static_cast<std::ptrdiff_t>(i));
+            quantities_.erase(quantities_.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        return;
+    }
+
+    if (exists)
+    {
+        quantities_[i] = quantity;
+        return;
+    }
+    prices_.insert(prices_.begin() + static_cast<std::ptrdiff_t>(i), price);
+    quantities_.insert(quantities_.begin() + static_cast<std::ptrdiff_t>(i), quantity);
+}
+
+std::uint64_t DepthLadder::DepthTo(Price price) const
+{
+    // Levels at `price` or better are the ones from its position to the back.
+    const std::size_t first = Position(price);
+    return SumQuantities(quantities_.data() + first, prices_.size() - first);
+}
+
+DepthThreshold DepthLadder::LevelsFor(std::uint64_t quantity) const
+{
+    return FindDepthThreshold(quantities_.data(), quantities_.size(), quantity);
+}
+
+FillEstimate DepthLadder::EstimateFill(std::uint64_t quantity) const
+{
+    const std::size_t count = prices_.size();
+    const DepthThreshold threshold = FindDepthThreshold(quantities_.data(), count, quantity);
+    if (threshold.levels_ == 0)
+        return { };
+
+    // Every level but the last is taken whole; the last only for what is still missing.
+    const std::size_t last = count - threshold.levels_;
+    const std::uint64_t before = threshold.cumulative_ - quantities_[last];
+    const std::uint64_t fromLast = std::min<std::uint64_t>(quantities_[last], quantity - before);
+
+    FillEstimate estimate;
+    estimate.quantity_ = before + fromLast;
+    estimate.notional_ = SumNotional(prices_.data() + last + 1, quantities_.data() + last + 1, threshold.levels_ - 1)
+                       + static_cast<std::int64_t>(prices_[last]) * static_cast<std::int64_t>(fromLast);
+    estimate.levels_ = threshold.levels_;
+    return estimate;
+}
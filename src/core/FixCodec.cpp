@@ -0,0 +1,631 @@
+#include "FixCodec.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+constexpr std::string_view BeginString = "8=FIX.4.4" "\x01";
+constexpr std::size_t TrailerSize = 7;                      // "10=ddd" SOH
+constexpr std::size_t MaskWords = FixMaxMessageSize / 64;
+
+// Bit i of each bitmap is set where the body's byte i is '=' or SOH.
+struct DelimiterMasks
+{
+    std::uint64_t equals_[MaskWords];
+    std::uint64_t soh_[MaskWords];
+};
+
+#if defined(__ARM_NEON) && !defined(__SSE2__)
+// 16 compare results (0x00/0xFF) to a 16-bit mask, one bit per byte.
+inline std::uint64_t NeonMask(uint8x16_t cmp)
+{
+    static const uint8x16_t weights = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    const uint8x16_t bits = vandq_u8(cmp, weights);
+    return static_cast<std::uint64_t>(vaddv_u8(vget_low_u8(bits)))
+         | static_cast<std::uint64_t>(vaddv_u8(vget_high_u8(bits))) << 8;
+}
+#endif
+
+void BuildMasks(const char* p, std::size_t size, DelimiterMasks& masks)
+{
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i eq = _mm256_set1_epi8('=');
+    const __m256i soh = _mm256_set1_epi8(FixSoh);
+    for (; i + 64 <= size; i += 64)
+    {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + 32));
+        const auto lo = [](__m256i v, __m256i c)
+        {
+            return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, c))));
+        };
+        masks.equals_[i / 64] = lo(a, eq) | lo(b, eq) << 32;
+        masks.soh_[i / 64] = lo(a, soh) | lo(b, soh) << 32;
+    }
+#elif defined(__SSE2__)
+    const __m128i eq = _mm_set1_epi8('=');
+    const __m128i soh = _mm_set1_epi8(FixSoh);
+    for (; i + 64 <= size; i += 64)
+    {
+        std::uint64_t e = 0;
+        std::uint64_t s = 0;
+        for (std::size_t k = 0; k < 64; k += 16)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + k));
+            e |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, eq)))) << k;
+            s |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, soh)))) << k;
+        }
+        masks.equals_[i / 64] = e;
+        masks.soh_[i / 64] = s;
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t eq = vdupq_n_u8('=');
+    const uint8x16_t soh = vdupq_n_u8(FixSoh);
+    for (; i + 64 <= size; i += 64)
+    {
+        std::uint64_t e = 0;
+        std::uint64_t s = 0;
+        for (std::size_t k = 0; k < 64; k += 16)
+        {
+            const uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t*>(p + i + k));
+            e |= NeonMask(vceqq_u8(v, eq)) << k;
+            s |= NeonMask(vceqq_u8(v, soh)) << k;
+        }
+        masks.equals_[i / 64] = e;
+        masks.soh_[i / 64] = s;
+    }
+#endif
+
+    // The last partial block, byte by byte.
+    if (i < size)
+    {
+        masks.equals_[i / 64] = 0;
+        masks.soh_[i / 64] = 0;
+    }
+    for (; i < size; ++i)
+    {
+        const std::uint64_t bit = std::uint64_t{ 1 } << (i & 63);
+        if (p[i] == '=')
+            masks.equals_[i / 64] |= bit;
+        else if (p[i] == FixSoh)
+            masks.soh_[i / 64] |= bit;
+    }
+}
+
+// Position of the first set bit at or after `from`, or `size` if there is none.
+std::size_t FindNext(const std::uint64_t* mask, std::size_t size, std::size_t from)
+{
+    if (from >= size)
+        return size;
+    std::size_t word = from / 64;
+    std::uint64_t bits = mask[word] & (~std::uint64_t{ 0 } << (from & 63));
+    const std::size_t words = (size + 63) / 64;
+    while (bits == 0)
+    {
+        if (++word == words)
+            return size;
+        bits = mask[word];
+    }
+    return std::min(word * 64 + static_cast<std::size_t>(std::countr_zero(bits)), size);
+}
+
+std::uint32_t Checksum(const char* p, std::size_t size)
+{
+    std::uint64_t sum = 0;
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(v, _mm_setzero_si128()));
+    }
+    sum = static_cast<std::uint64_t>(_mm_cvtsi128_si64(acc))
+        + static_cast<std::uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)));
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= size; i += 16)
+        sum += vaddlvq_u8(vld1q_u8(reinterpret_cast<const std::uint8_t*>(p + i)));
+#endif
+    for (; i < size; ++i)
+        sum += static_cast<std::uint8_t>(p[i]);
+    return static_cast<std::uint32_t>(sum % 256);
+}
+
+bool ParseUnsigned(std::string_view value, std::uint64_t& out)
+{
+    if (value.empty() || value.size() > 19)
+        return false;
+    std::uint64_t v = 0;
+    for (const char c : value)
+    {
+        const unsigned digit = static_cast<unsigned>(c - '0');
+        if (digit > 9)
+            return false;
+        v = v * 10 + digit;
+    }
+    out = v;
+    return true;
+}
+
+// "-12.50" with 2 decimals -> -1250. Digits past `decimals` must be zeros.
+bool ParsePrice(std::string_view value, int decimals, Price& out)
+{
+    bool negative = false;
+    if (!value.empty() && value.front() == '-')
+    {
+        negative = true;
+        value.remove_prefix(1);
+    }
+    const std::size_t dot = value.find('.');
+    const std::string_view whole = value.substr(0, dot);
+    std::string_view fraction = dot == std::string_view::npos ? std::string_view{ } : value.substr(dot + 1);
+
+    std::uint64_t ticks = 0;
+    if (whole.size() > 10 || !ParseUnsigned(whole, ticks))
+        return false;
+    for (int d = 0; d < decimals; ++d)
+    {
+        unsigned digit = 0;
+        if (!fraction.empty())
+        {
+            digit = static_cast<unsigned>(fraction.front() - '0');
+            fraction.remove_prefix(1);
+            if (digit > 9)
+                return false;
+        }
+        ticks = ticks * 10 + digit;
+    }
+    for (const char c : fraction)
+    {
+        if (c != '0')
+            return false;
+    }
+
+    if (ticks > static_cast<std::uint64_t>(std::numeric_limits<Price>::max()))
+        return false;
+    out = negative ? -static_cast<Price>(ticks) : static_cast<Price>(ticks);
+    return true;
+}
+
+// Whole numbers; "100.00" is accepted.
+bool ParseQuantity(std::string_view value, Quantity& out)
+{
+    const std::size_t dot = value.find('.');
+    if (dot != std::string_view::npos)
+    {
+        if (value.find_first_not_of('0', dot + 1) != std::string_view::npos)
+            return false;
+        value = value.substr(0, dot);
+    }
+    std::uint64_t v = 0;
+    if (!ParseUnsigned(value, v) || v > std::numeric_limits<Quantity>::max())
+        return false;
+    out = static_cast<Quantity>(v);
+    return true;
+}
+
+bool ParseSide(std::string_view value, Side& out)
+{
+    if (value == "1")
+        out = Side::Buy;
+    else if (value == "2")
+        out = Side::Sell;
+    else
+        return false;
+    return true;
+}
+
+char* Put(char* p, std::string_view text)
+{
+    std::memcpy(p, text.data(), text.size());
+    return p + text.size();
+}
+
+char* PutUnsigned(char* p, std::uint64_t value)
+{
+    return std::to_chars(p, p + 20, value).ptr;
+}
+
+// `tagEq` is "<tag>=".
+char* PutField(char* p, std::string_view tagEq, std::string_view value)
+{
+    p = Put(p, tagEq);
+    p = Put(p, value);
+    *p = FixSoh;
+    return p + 1;
+}
+
+char* PutField(char* p, std::string_view tagEq, std::uint64_t value)
+{
+    p = Put(p, tagEq);
+    p = PutUnsigned(p, value);
+    *p = FixSoh;
+    return p + 1;
+}
+
+char* PutField(char* p, std::string_view tagEq, char value)
+{
+    p = Put(p, tagEq);
+    *p++ = value;
+    *p = FixSoh;
+    return p + 1;
+}
+
+char SideChar(Side side)
+{
+    return side == Side::Buy ? '1' : '2';
+}
+
+std::size_t CopyTruncated(std::string_view from, char* to, std::size_t capacity)
+{
+    const std::size_t n = std::min(from.size(), capacity);
+    std::memcpy(to, from.data(), n);
+    return n;
+}
+
+// Fields seen while walking a body, before the message type says which are required.
+struct Fields
+{
+    char msgType_{ };
+    char ordType_{ };
+    char timeInForce_{ '0' };
+    bool haveClOrdId_{ };
+    bool haveOrigClOrdId_{ };
+    bool haveSide_{ };
+    bool haveQuantity_{ };
+    bool havePrice_{ };
+};
+
+FixDecodeResult Fail(FixStatus status, std::size_t size, std::uint32_t tag = 0)
+{
+    return { status, size, tag };
+}
+
+}
+
+OrderPointer FixMessage::ToOrder() const
+{
+    if (orderType_ == OrderType::Market)
+        return std::make_shared<Order>(clOrdId_, side_, quantity_);
+    return std::make_shared<Order>(orderType_, clOrdId_, side_, price_, quantity_);
+}
+
+FixDecoder::FixDecoder(int priceDecimals)
+    : priceDecimals_{ std::clamp(priceDecimals, 0, 9) }
+{
+}
+
+FixDecodeResult FixDecoder::Decode(std::string_view bytes, FixMessage& out) const
+{
+    // "8=FIX.4.4|9=<len>|", then the body, then "10=ddd|".
+    const std::size_t begin = std::min(bytes.size(), BeginString.size());
+    if (bytes.substr(0, begin) != BeginString.substr(0, begin))
+        return Fail(FixStatus::Malformed, 0);
+    if (bytes.size() < BeginString.size() + 2)
+        return Fail(FixStatus::Incomplete, 0);
+    if (bytes.substr(BeginString.size(), 2) != "9=")
+        return Fail(FixStatus::Malformed, 0);
+
+    std::size_t p = BeginString.size() + 2;
+    std::size_t bodyLength = 0;
+    for (;; ++p)
+    {
+        if (p == bytes.size())
+            return Fail(FixStatus::Incomplete, 0);
+        if (bytes[p] == FixSoh)
+            break;
+        const unsigned digit = static_cast<unsigned>(bytes[p] - '0');
+        if (digit > 9 || p - BeginString.size() - 2 >= 5)
+            return Fail(FixStatus::Malformed, 0);
+        bodyLength = bodyLength * 10 + digit;
+    }
+    const std::size_t bodyStart = p + 1;
+    if (bodyStart == BeginString.size() + 3 || bodyLength == 0
+        || bodyStart + bodyLength + TrailerSize > FixMaxMessageSize)
+        return Fail(FixStatus::Malformed, 0);
+    const std::size_t size = bodyStart + bodyLength + TrailerSize;
+    if (bytes.size() < size)
+        return Fail(FixStatus::Incomplete, 0);
+
+    const std::string_view trailer = bytes.substr(bodyStart + bodyLength, TrailerSize);
+    std::uint64_t checksum = 0;
+    if (trailer.substr(0, 3) != "10=" || trailer.back() != FixSoh || !ParseUnsigned(trailer.substr(3, 3), checksum))
+        return Fail(FixStatus::Malformed, 0);
+    if (checksum != Checksum(bytes.data(), bodyStart + bodyLength))
+        return Fail(FixStatus::BadChecksum, size);
+
+    const char* body = bytes.data() + bodyStart;
+    if (body[bodyLength - 1] != FixSoh)
+        return Fail(FixStatus::Malformed, 0);
+    DelimiterMasks masks;
+    BuildMasks(body, bodyLength, masks);
+
+    out = FixMessage{ };
+    Fields fields;
+    std::size_t at = 0;
+    while (at < bodyLength)
+    {
+        const std::size_t eq = FindNext(masks.equals_, bodyLength, at);
+        const std::size_t soh = FindNext(masks.soh_, bodyLength, at);
+        std::uint64_t tag = 0;
+        if (eq >= soh || !ParseUnsigned({ body + at, eq - at }, tag))
+            return Fail(FixStatus::Malformed, 0);
+        const std::string_view value{ body + eq + 1, soh - eq - 1 };
+        at = soh + 1;
+
+        bool ok = true;
+        switch (tag)
+        {
+        case 35:
+            ok = value.size() == 1;
+            fields.msgType_ = ok ? value[0] : '\0';
+            break;
+        case 34:
+            ok = ParseUnsigned(value, out.seqNum_);
+            break;
+        case 49:
+            out.senderCompId_ = value;
+            break;
+        case 56:
+            out.targetCompId_ = value;
+            break;
+        case 55:
+            out.symbol_ = value;
+            break;
+        case 11:
+            ok = fields.haveClOrdId_ = ParseUnsigned(value, out.clOrdId_);
+            break;
+        case 41:
+            ok = fields.haveOrigClOrdId_ = ParseUnsigned(value, out.origClOrdId_);
+            break;
+        case 54:
+            ok = fields.haveSide_ = ParseSide(value, out.side_);
+            break;
+        case 38:
+            ok = fields.haveQuantity_ = ParseQuantity(value, out.quantity_);
+            break;
+        case 44:
+            ok = fields.havePrice_ = ParsePrice(value, priceDecimals_, out.price_);
+            break;
+        case 40:
+            ok = value.size() == 1;
+            fields.ordType_ = ok ? value[0] : '\0';
+            break;
+        case 59:
+            ok = value.size() == 1;
+            fields.timeInForce_ = ok ? value[0] : '\0';
+            break;
+        default:
+            break;
+        }
+        if (!ok)
+            return Fail(FixStatus::BadValue, size, static_cast<std::uint32_t>(tag));
+    }
+
+    switch (fields.msgType_)
+    {
+    case 'D':
+    case 'F':
+    case 'G':
+        out.type_ = static_cast<FixMsgType>(fields.msgType_);
+        break;
+    case '\0':
+        return Fail(FixStatus::MissingField, size, 35);
+    default:
+        return Fail(FixStatus::Unsupported, size, 35);
+    }
+
+    if (!fields.haveClOrdId_)
+        return Fail(FixStatus::MissingField, size, 11);
+    if (!fields.haveSide_)
+        return Fail(FixStatus::MissingField, size, 54);
+    if (out.type_ != FixMsgType::NewOrderSingle && !fields.haveOrigClOrdId_)
+        return Fail(FixStatus::MissingField, size, 41);
+    if (out.type_ == FixMsgType::OrderCancelRequest)
+        return { FixStatus::Ok, size, 0 };
+
+    if (!fields.haveQuantity_)
+        return Fail(FixStatus::MissingField, size, 38);
+    if (out.quantity_ == 0)
+        return Fail(FixStatus::BadValue, size, 38);
+    if (fields.ordType_ == '1')
+    {
+        out.orderType_ = OrderType::Market;
+        return { FixStatus::Ok, size, 0 };
+    }
+    if (fields.ordType_ == '\0')
+        return Fail(FixStatus::MissingField, size, 40);
+    if (fields.ordType_ != '2')
+        return Fail(FixStatus::Unsupported, size, 40);
+    if (!fields.havePrice_)
+        return Fail(FixStatus::MissingField, size, 44);
+    if (out.price_ <= 0)
+        return Fail(FixStatus::BadValue, size, 44);
+
+    switch (fields.timeInForce_)
+    {
+    case '0':
+        out.orderType_ = OrderType::GoodForDay;
+        break;
+    case '1':
+        out.orderType_ = OrderType::GoodTillCancel;
+        break;
+    case '3':
+        out.orderType_ = OrderType::FillAndKill;
+        break;
+    case '4':
+        out.orderType_ = OrderType::FillOrKill;
+        break;
+    default:
+        return Fail(FixStatus::Unsupported, size, 59);
+    }
+    return { FixStatus::Ok, size, 0 };
+}
+
+FixEncoder::FixEncoder(std::string_view senderCompId, std::string_view targetCompId, int priceDecimals)
+    : priceDecimals_{ std::clamp(priceDecimals, 0, 9) }
+{
+    senderSize_ = CopyTruncated(senderCompId, sender_.data(), sender_.size());
+    targetSize_ = CopyTruncated(targetCompId, target_.data(), target_.size());
+}
+
+void FixEncoder::SetSendingTime(std::string_view sendingTime)
+{
+    sendingTimeSize_ = CopyTruncated(sendingTime, sendingTime_.data(), sendingTime_.size());
+}
+
+char* FixEncoder::BeginBody(FixMsgType type)
+{
+    char* p = buffer_.data() + HeaderRoom;
+    p = PutField(p, "35=", static_cast<char>(type));
+    p = PutField(p, "49=", std::string_view{ sender_.data(), senderSize_ });
+    p = PutField(p, "56=", std::string_view{ target_.data(), targetSize_ });
+    p = PutField(p, "34=", ++seqNum_);
+    if (sendingTimeSize_)
+        p = PutField(p, "52=", std::string_view{ sendingTime_.data(), sendingTimeSize_ });
+    return p;
+}
+
+std::string_view FixEncoder::Finish(char* end)
+{
+    char* body = buffer_.data() + HeaderRoom;
+    const auto bodyLength = static_cast<std::uint64_t>(end - body);
+
+    char length[8];
+    const char* lengthEnd = std::to_chars(length, length + sizeof(length), bodyLength).ptr;
+    const std::size_t lengthSize = static_cast<std::size_t>(lengthEnd - length);
+    char* start = body - (BeginString.size() + 2 + lengthSize + 1);
+    char* p = Put(start, BeginString);
+    p = Put(p, "9=");
+    p = Put(p, { length, lengthSize });
+    *p = FixSoh;
+
+    const std::uint32_t checksum = Checksum(start, static_cast<std::size_t>(end - start));
+    end = Put(end, "10=");
+    *end++ = static_cast<char>('0' + checksum / 100);
+    *end++ = static_cast<char>('0' + checksum / 10 % 10);
+    *end++ = static_cast<char>('0' + checksum % 10);
+    *end++ = FixSoh;
+    return { start, static_cast<std::size_t>(end - start) };
+}
+
+char* FixEncoder::PutPrice(char* p, std::uint32_t tag, Price price) const
+{
+    p = PutUnsigned(p, tag);
+    *p++ = '=';
+    std::uint64_t ticks = static_cast<std::uint64_t>(price < 0 ? -static_cast<std::int64_t>(price) : price);
+    if (price < 0)
+        *p++ = '-';
+    if (priceDecimals_ == 0)
+    {
+        p = PutUnsigned(p, ticks);
+    }
+    else
+    {
+        std::uint64_t scale = 1;
+        for (int d = 0; d < priceDecimals_; ++d)
+            scale *= 10;
+        p = PutUnsigned(p, ticks / scale);
+        *p++ = '.';
+        std::uint64_t fraction = ticks % scale;
+        for (int d = priceDecimals_ - 1; d >= 0; --d)
+        {
+            p[d] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        p += priceDecimals_;
+    }
+    *p = FixSoh;
+    return p + 1;
+}
+
+char* FixEncoder::PutOrderType(char* p, OrderType type) const
+{
+    switch (type)
+    {
+    case OrderType::Market:
+        return PutField(p, "40=", '1');
+    case OrderType::GoodTillCancel:
+        return PutField(PutField(p, "40=", '2'), "59=", '1');
+    case OrderType::FillAndKill:
+        return PutField(PutField(p, "40=", '2'), "59=", '3');
+    case OrderType::FillOrKill:
+        return PutField(PutField(p, "40=", '2'), "59=", '4');
+    case OrderType::GoodForDay:
+        break;
+    }
+    return PutField(PutField(p, "40=", '2'), "59=", '0');
+}
+
+std::string_view FixEncoder::ExecutionReport(const FixExecutionReport& report, std::string_view symbol)
+{
+    char* p = BeginBody(FixMsgType::ExecutionReport);
+    p = PutField(p, "37=", report.orderId_);
+    p = PutField(p, "11=", report.clOrdId_);
+    p = PutField(p, "17=", report.execId_);
+    p = PutField(p, "150=", static_cast<char>(report.execType_));
+    p = PutField(p, "39=", static_cast<char>(report.ordStatus_));
+    p = PutField(p, "55=", symbol.substr(0, 64));
+    p = PutField(p, "54=", SideChar(report.side_));
+    if (report.execType_ == FixExecType::Trade)
+    {
+        p = PutField(p, "32=", std::uint64_t{ report.lastQty_ });
+        p = PutPrice(p, 31, report.lastPx_);
+    }
+    p = PutField(p, "151=", std::uint64_t{ report.leavesQty_ });
+    p = PutField(p, "14=", std::uint64_t{ report.cumQty_ });
+    p = PutPrice(p, 6, report.avgPx_);
+    return Finish(p);
+}
+
+std::string_view FixEncoder::NewOrderSingle(OrderId clOrdId, Side side, OrderType type, Price price,
+                                            Quantity quantity, std::string_view symbol)
+{
+    char* p = BeginBody(FixMsgType::NewOrderSingle);
+    p = PutField(p, "11=", clOrdId);
+    p = PutField(p, "55=", symbol.substr(0, 64));
+    p = PutField(p, "54=", SideChar(side));
+    p = PutField(p, "38=", std::uint64_t{ quantity });
+    p = PutOrderType(p, type);
+    if (type != OrderType::Market)
+        p = PutPrice(p, 44, price);
+    return Finish(p);
+}
+
+std::string_view FixEncoder::OrderCancelRequest(OrderId clOrdId, OrderId origClOrdId, Side side,
+                                                std::string_view symbol)
+{
+    char* p = BeginBody(FixMsgType::OrderCancelRequest);
+    p = PutField(p, "41=", origClOrdId);
+    p = PutField(p, "11=", clOrdId);
+    p = PutField(p, "55=", symbol.substr(0, 64));
+    p = PutField(p, "54=", SideChar(side));
+    return Finish(p);
+}
+
+std::string_view FixEncoder::OrderCancelReplaceRequest(OrderId clOrdId, OrderId origClOrdId, Side side,
+                                                       OrderType type, Price price, Quantity quantity,
+                                                       std::string_view symbol)
+{
+    char* p = BeginBody(FixMsgType::OrderCancelReplaceRequest);
+    p = PutField(p, "41=", origClOrdId);
+    p = PutField(p, "11=", clOrdId);
+    p = PutField(p, "55=", symbol.substr(0, 64));
+    p = PutField(p, "54=", SideChar(side));
+    p = PutField(p, "38=", std::uint64_t{ quantity });
+    p = PutOrderType(p, type);
+    if (type != OrderType::Market)
+        p = PutPrice(p, 44, price);
+    return Finish(p);
+}
@@ -0,0 +1,64 @@
+#include "L2Book.h"
+
+#include <algorithm>
+
+namespace {
+
+template<typename Levels>
+void ApplyLevel(Levels& levels, const LevelDelta& delta)
+{
+    if (delta.count_ == 0)
+        levels.erase(delta.price_);
+    else
+        levels[delta.price_] = { delta.quantity_, delta.count_ };
+}
+
+template<typename Levels>
+LevelInfos CollectLevels(const Levels& levels, std::size_t depth)
+{
+    LevelInfos infos;
+    infos.reserve(std::min(depth, levels.size()));
+    for (const auto& [price, level] : levels)
+    {
+        if (infos.size() == depth)
+            break;
+        infos.push_back({ price, level.quantity_ });
+    }
+    return infos;
+}
+
+}
+
+void L2Book::Apply(const LevelDelta& delta)
+{
+    // Unsequenced deltas (straight from an Orderbook sink) are applied as they come.
+    if (delta.sequence_)
+    {
+        if (lastSequence_ && delta.sequence_ != lastSequence_ + 1)
+            ++gaps_;
+        lastSequence_ = delta.sequence_;
+    }
+
+    if (delta.side_ == Side::Buy)
+        ApplyLevel(bids_, delta);
+    else
+        ApplyLevel(asks_, delta);
+}
+
+void L2Book::Clear()
+{
+    bids_.clear();
+    asks_.clear();
+    lastSequence_ = 0;
+    gaps_ = 0;
+}
+
+OrderbookLevelInfos L2Book::GetOrderInfos() const
+{
+    return GetOrderInfos(LevelCount());
+}
+
+OrderbookLevelInfos L2Book::GetOrderInfos(std::size_t depth) const
+{
+    return { CollectLevels(bids_, depth), CollectLevels(asks_, depth) };
+}
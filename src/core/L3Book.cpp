@@ -0,0 +1,127 @@
+#include "L3Book.h"
+
+std::size_t L3Book::Apply(std::span<const std::uint8_t> bytes)
+{
+    std::size_t consumed = 0;
+    L3Message message;
+    while (const std::size_t size = L3Decode(bytes.subspan(consumed), message))
+    {
+        Apply(message);
+        consumed += size;
+    }
+    return consumed;
+}
+
+void L3Book::Apply(const L3Message& message)
+{
+    ++messages_;
+    if (lastSequence_ && message.sequence_ != lastSequence_ + 1)
+        ++gaps_;
+    lastSequence_ = message.sequence_;
+
+    switch (message.type_)
+    {
+    case L3MessageType::Add:
+        Rest(message);
+        break;
+
+    case L3MessageType::Replace:
+    {
+        const auto it = orders_.find(message.orderId_);
+        if (it == orders_.end())
+            ++unknownOrders_;
+        else
+            Remove(message.orderId_, it->second);
+        Rest(message);
+        break;
+    }
+
+    case L3MessageType::Cancel:
+    {
+        const auto it = orders_.find(message.orderId_);
+        if (it == orders_.end())
+        {
+            ++unknownOrders_;
+            break;
+        }
+        Remove(message.orderId_, it->second);
+        break;
+    }
+
+    case L3MessageType::Execute:
+    {
+        const auto it = orders_.find(message.orderId_);
+        if (it == orders_.end() || it->second.quantity_ < message.quantity_)
+        {
+            ++unknownOrders_;
+            break;
+        }
+        it->second.quantity_ -= message.quantity_;
+        if (it->second.quantity_ == 0)
+            Remove(message.orderId_, it->second);
+        break;
+    }
+    }
+}
+
+void L3Book::Rest(const L3Message& message)
+{
+    if (orders_.contains(message.orderId_))
+    {
+        ++unknownOrders_;
+        return;
+    }
+
+    Queue& queue = (message.side_ == Side::Buy) ? bids_[message.price_] : asks_[message.price_];
+    if (queue.size() != message.position_)
+        ++positionMismatches_;
+    queue.push_back(message.orderId_);
+    orders_.insert({ message.orderId_, { message.side_, message.price_, message.quantity_, std::prev(queue.end()) } });
+}
+
+// `entry` refers into orders_ and is gone after the erase.
+void L3Book::Remove(OrderId orderId, const Entry& entry)
+{
+    const Side side = entry.side_;
+    const Price price = entry.price_;
+    const Queue::iterator location = entry.location_;
+    orders_.erase(orderId);
+
+    if (side == Side::Buy)
+    {
+        auto level = bids_.find(price);
+        level->second.erase(location);
+        if (level->second.empty())
+            bids_.erase(level);
+    }
+    else
+    {
+        auto level = asks_.find(price);
+        level->second.erase(location);
+        if (level->second.empty())
+            asks_.erase(level);
+    }
+}
+
+OrderbookLevelInfos L3Book::GetOrderInfos() const
+{
+    LevelInfos bidInfos, askInfos;
+    bidInfos.reserve(bids_.size());
+    askInfos.reserve(asks_.size());
+
+    auto CreateLevelInfo = [this](Price price, const Queue& queue)
+    {
+        Quantity quantity{ 0 };
+        for (const OrderId id : queue)
+            quantity += orders_.at(id).quantity_;
+        return LevelInfo{ price, quantity };
+    };
+
+    for (const auto& [price, queue] : bids_)
+        bidInfos.push_back(CreateLevelInfo(price, queue));
+
+    for (const auto& [price, queue] : asks_)
+        askInfos.push_back(CreateLevelInfo(price, queue));
+
+    return { bidInfos, askInfos };
+}
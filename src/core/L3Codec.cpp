@@ -0,0 +1,70 @@
+#include "L3Codec.h"
+
+namespace {
+
+template<typename T>
+const std::uint8_t* Get(const std::uint8_t* p, T& value)
+{
+    std::memcpy(&value, p, sizeof(T));
+    return p + sizeof(T);
+}
+
+}
+
+std::size_t L3MessageSize(std::uint8_t type)
+{
+    switch (static_cast<L3MessageType>(type))
+    {
+    case L3MessageType::Add:
+    case L3MessageType::Replace:
+        return L3AddSize;
+    case L3MessageType::Cancel:
+        return L3CancelSize;
+    case L3MessageType::Execute:
+        return L3ExecuteSize;
+    }
+    return 0;
+}
+
+L3Encoder::L3Encoder(std::size_t reserveBytes)
+    : bytes_(reserveBytes < L3MaxMessageSize ? L3MaxMessageSize : reserveBytes)
+{
+}
+
+std::size_t L3Decode(std::span<const std::uint8_t> bytes, L3Message& out)
+{
+    if (bytes.empty())
+        return 0;
+    const std::size_t size = L3MessageSize(bytes[0]);
+    if (size == 0 || bytes.size() < size)
+        return 0;
+
+    out = L3Message{};
+    out.type_ = static_cast<L3MessageType>(bytes[0]);
+    const std::uint8_t* p = Get(bytes.data() + 1, out.sequence_);
+
+    switch (out.type_)
+    {
+    case L3MessageType::Add:
+    case L3MessageType::Replace:
+    {
+        std::uint8_t side{};
+        p = Get(p, side);
+        out.side_ = static_cast<Side>(side);
+        p = Get(p, out.orderId_);
+        p = Get(p, out.price_);
+        p = Get(p, out.quantity_);
+        Get(p, out.position_);
+        break;
+    }
+    case L3MessageType::Cancel:
+        Get(p, out.orderId_);
+        break;
+    case L3MessageType::Execute:
+        p = Get(p, out.orderId_);
+        p = Get(p, out.quantity_);
+        Get(p, out.price_);
+        break;
+    }
+    return size;
+}
@@ -1,8 +1,10 @@
 #include "Orderbook.h"
 
+#include <algorithm>
 #include <numeric>
 
-void Orderbook::CancelOrderInternal(OrderId orderId)
+template<typename Policy>
+void BasicOrderbook<Policy>::CancelOrderInternal(OrderId orderId)
 {
 	++cancelCount_;
 
@@ -29,10 +31,15 @@ void Orderbook::CancelOrderInternal(OrderId orderId)
             bids_.erase(price);
     }
 
+    if (l3Sink_ && !l3Replacing_)
+        l3Sink_->Cancel(orderId);
+
+    UnlinkOwner(order.get());
     OnOrderCancelled(order);
 }
 
-void Orderbook::OnOrderCancelled(OrderPointer order)
+template<typename Policy>
+void BasicOrderbook<Policy>::OnOrderCancelled(OrderPointer order)
 {
     UpdateLevelData(order->GetSide(),
                     order->GetPrice(),
@@ -40,7 +47,8 @@ void Orderbook::OnOrderCancelled(OrderPointer order)
                     LevelData::Action::Remove);
 }
 
-void Orderbook::OnOrderAdded(OrderPointer order)
+template<typename Policy>
+void BasicOrderbook<Policy>::OnOrderAdded(OrderPointer order)
 {
     UpdateLevelData(order->GetSide(),
                     order->GetPrice(),
@@ -48,7 +56,8 @@ void Orderbook::OnOrderAdded(OrderPointer order)
                     LevelData::Action::Add);
 }
 
-void Orderbook::OnOrderMatched(Side side, Price price, Quantity quantity, bool isFullyFilled)
+template<typename Policy>
+void BasicOrderbook<Policy>::OnOrderMatched(Side side, Price price, Quantity quantity, bool isFullyFilled)
 {
     UpdateLevelData(side,
                     price,
@@ -57,67 +66,74 @@ void Orderbook::OnOrderMatched(Side side, Price price, Quantity quantity, bool i
                                   : LevelData::Action::Match);
 }
 
-void Orderbook::UpdateLevelData(Side side, Price price, Quantity quantity, LevelData::Action action)
+template<typename Policy>
+void BasicOrderbook<Policy>::LinkOwner(Order* order)
+{
+    if (order->GetOwnerId() == 0)
+        return;
+
+    auto& head = owners_[order->GetOwnerId()];
+    order->GetOwnerLinks() = { nullptr, head };
+    if (head)
+        head->GetOwnerLinks().prev_ = order;
+    head = order;
+}
+
+template<typename Policy>
+void BasicOrderbook<Policy>::UnlinkOwner(Order* order)
+{
+    if (order->GetOwnerId() == 0)
+        return;
+
+    auto& links = order->GetOwnerLinks();
+    if (links.next_)
+        links.next_->GetOwnerLinks().prev_ = links.prev_;
+    if (links.prev_)
+        links.prev_->GetOwnerLinks().next_ = links.next_;
+    else if (links.next_)
+        owners_[order->GetOwnerId()] = links.next_;
+    else
+        owners_.erase(order->GetOwnerId());
+    links = { };
+}
+
+template<typename Policy>
+void BasicOrderbook<Policy>::UpdateLevelData(Side side, Price price, Quantity quantity, LevelData::Action action, std::int32_t orders)
 {
     auto& bookData = (side == Side::Buy) ? bidData_ : askData_;
     auto& data = bookData[price];
 
     data.count_ += (action == LevelData::Action::Add)
-                     ? 1
-                     : (action == LevelData::Action::Remove ? -1 : 0);
+                     ? orders
+                     : (action == LevelData::Action::Remove ? -orders : 0);
 
     if (action == LevelData::Action::Remove || action == LevelData::Action::Match)
         data.quantity_ -= quantity;
     else
         data.quantity_ += quantity;
 
+    (side == Side::Buy ? bidLadder_ : askLadder_).Set(price, data.count_ ? data.quantity_ : Quantity{ 0 });
+
+    if (deltaSink_)
+        deltaSink_->push_back({ 0, price, data.count_ ? data.quantity_ : Quantity{ 0 },
+                                static_cast<std::uint32_t>(data.count_), side, false });
+
     if (data.count_ == 0)
         bookData.erase(price);
 }
 
-bool Orderbook::CanFullyFill(Side side, Price price, Quantity quantity) const
+template<typename Policy>
+bool BasicOrderbook<Policy>::CanFullyFill(Side side, Price price, Quantity quantity) const
 {
     if (!CanMatch(side, price))
         return false;
 
-    if (side == Side::Buy)
-    {
-        for (const auto& [askPrice, orders] : asks_)
-        {
-            if (askPrice > price)
-                break;
-
-            const auto it = askData_.find(askPrice);
-            if (it == askData_.end())
-                continue;
-
-            if (quantity <= it->second.quantity_)
-                return true;
-
-            quantity -= it->second.quantity_;
-        }
-        return false;
-    }
-
-    for (const auto& [bidPrice, orders] : bids_)
-    {
-        if (bidPrice < price)
-            break;
-
-        const auto it = bidData_.find(bidPrice);
-        if (it == bidData_.end())
-            continue;
-
-        if (quantity <= it->second.quantity_)
-            return true;
-
-        quantity -= it->second.quantity_;
-    }
-
-    return false;
+    const auto& opposite = side == Side::Buy ? askLadder_ : bidLadder_;
+    return opposite.DepthTo(price) >= quantity;
 }
 
-bool Orderbook::CanMatch(Side side, Price price) const
+template<typename Policy>
+bool BasicOrderbook<Policy>::CanMatch(Side side, Price price) const
 {
     if (side == Side::Buy)
         return !asks_.empty() && price >= asks_.begin()->first;
@@ -125,15 +141,19 @@ bool Orderbook::CanMatch(Side side, Price price) const
         return !bids_.empty() && price <= bids_.begin()->first;
 }
 
-Trades Orderbook::MatchOrders()
+template<typename Policy>
+Trades BasicOrderbook<Policy>::MatchOrders()
 {
     Trades trades;
     trades.reserve(orders_.size());
 
     while (!bids_.empty() && !asks_.empty())
     {
-        auto& [bidPrice, bids] = *bids_.begin();
-        auto& [askPrice, asks] = *asks_.begin();
+        // Prices by value: erasing an emptied level below destroys the entry they come from.
+        const Price bidPrice = bids_.begin()->first;
+        const Price askPrice = asks_.begin()->first;
+        auto& bids = bids_.begin()->second;
+        auto& asks = asks_.begin()->second;
 
         if (bidPrice < askPrice)
             break;
@@ -152,16 +172,24 @@ Trades Orderbook::MatchOrders()
 
 			++executeCount_;
 
+            if (l3Sink_)
+            {
+                l3Sink_->Execute(bid->GetOrderId(), quantity, bid->GetPrice());
+                l3Sink_->Execute(ask->GetOrderId(), quantity, ask->GetPrice());
+            }
+
             if (bid->IsFilled())
             {
                 bids.pop_front();
                 orders_.erase(bid->GetOrderId());
+                UnlinkOwner(bid.get());
             }
 
             if (ask->IsFilled())
             {
                 asks.pop_front();
                 orders_.erase(ask->GetOrderId());
+                UnlinkOwner(ask.get());
             }
 
             trades.push_back(Trade{
@@ -189,7 +217,8 @@ Trades Orderbook::MatchOrders()
     return trades;
 }
 
-Trades Orderbook::AddOrder(OrderPointer order)
+template<typename Policy>
+Trades BasicOrderbook<Policy>::AddOrder(OrderPointer order)
 {
 	++addCount_;
 
@@ -216,56 +245,170 @@ Trades Orderbook::AddOrder(OrderPointer order)
                       order->GetInitialQuantity()))
         return { };
 
-    OrderPointers::iterator iterator;
+    typename OrderQueue::Handle location;
+    std::size_t position;
 
     if (order->GetSide() == Side::Buy)
     {
         auto& orders = bids_[order->GetPrice()];
-        orders.push_back(order);
-        iterator = std::prev(orders.end());
+        position = orders.size();
+        location = orders.push_back(order);
     }
     else
     {
         auto& orders = asks_[order->GetPrice()];
-        orders.push_back(order);
-        iterator = std::prev(orders.end());
+        position = orders.size();
+        location = orders.push_back(order);
+    }
+
+    if (l3Sink_)
+    {
+        const auto queuePosition = static_cast<std::uint32_t>(position);
+        if (l3Replacing_)
+            l3Sink_->Replace(order->GetOrderId(), order->GetSide(), order->GetPrice(),
+                             order->GetRemainingQuantity(), queuePosition);
+        else
+            l3Sink_->Add(order->GetOrderId(), order->GetSide(), order->GetPrice(),
+                         order->GetRemainingQuantity(), queuePosition);
+        l3Replacing_ = false;
     }
 
-    orders_.insert({ order->GetOrderId(), { order, iterator } });
+    orders_.emplace(order->GetOrderId(), OrderEntry{ order, location });
+    LinkOwner(order.get());
     OnOrderAdded(order);
 
     return MatchOrders();
 }
 
-void Orderbook::CancelOrder(OrderId orderId)
+template<typename Policy>
+void BasicOrderbook<Policy>::CancelOrder(OrderId orderId)
 {
     CancelOrderInternal(orderId);
 }
 
-Trades Orderbook::ModifyOrder(OrderModify order)
+template<typename Policy>
+Trades BasicOrderbook<Policy>::ModifyOrder(OrderModify order)
 {
 	++modifyCount_;
 
     if (!orders_.contains(order.GetOrderId()))
         return { };
 
-    auto orderType = orders_.at(order.GetOrderId()).order_->GetOrderType();
+    const auto& resting = *orders_.at(order.GetOrderId()).order_;
+    const auto orderType = resting.GetOrderType();
+    const auto ownerId = resting.GetOwnerId();
+
+    // The add clears l3Replacing_ once the order rests; if it never does, the order is simply
+    // gone and the feed reports a cancel.
+    l3Replacing_ = l3Sink_ != nullptr;
     CancelOrder(order.GetOrderId());
-    return AddOrder(order.ToOrderPointer(orderType));
+    Trades trades = AddOrder(order.ToOrderPointer(orderType, ownerId));
+    if (l3Replacing_)
+    {
+        l3Replacing_ = false;
+        l3Sink_->Cancel(order.GetOrderId());
+    }
+    return trades;
+}
+
+template<typename Policy>
+std::size_t BasicOrderbook<Policy>::MassCancel(const MassCancelRequest& request, OrderIds* cancelled)
+{
+    ++cancelCount_;
+
+    if (request.ownerId_ == 0)
+        return 0;
+
+    const auto owner = owners_.find(request.ownerId_);
+    if (owner == owners_.end())
+        return 0;
+
+    // Orders leave their queues as the owner's list is walked; the level totals, ladders and
+    // deltas are settled afterwards, once per level rather than once per order.
+    touched_.clear();
+    std::size_t removed = 0;
+    Order* next = owner->second;
+    while (next)
+    {
+        Order* order = next;
+        auto& links = order->GetOwnerLinks();
+        next = links.next_;
+        if (!request.Matches(*order))
+            continue;
+
+        const OrderId orderId = order->GetOrderId();
+        const Side side = order->GetSide();
+        const Price price = order->GetPrice();
+
+        // An owner's orders at one level were usually added together: search the newest first.
+        auto found = std::find_if(touched_.rbegin(), touched_.rend(),
+            [&](const TouchedLevel& t) { return t.price_ == price && t.side_ == side; });
+        if (found == touched_.rend())
+        {
+            OrderQueue* orders = side == Side::Buy ? &bids_.at(price) : &asks_.at(price);
+            touched_.push_back(TouchedLevel{ side, price, orders, 0, 0, false });
+            found = touched_.rbegin();
+        }
+        TouchedLevel& level = *found;
+        level.quantity_ += order->GetRemainingQuantity();
+        ++level.count_;
+
+        // Unlinked here rather than by UnlinkOwner: the head is already in hand.
+        if (next)
+            next->GetOwnerLinks().prev_ = links.prev_;
+        if (links.prev_)
+            links.prev_->GetOwnerLinks().next_ = next;
+        else
+            owner->second = next;
+        links = { };
+
+        if (l3Sink_)
+            l3Sink_->Cancel(orderId);
+        if (cancelled)
+            cancelled->push_back(orderId);
+        ++removed;
+
+        // Last: the index may hold the order's final reference.
+        level.orders_->erase(orders_.at(orderId).location_);
+        orders_.erase(orderId);
+    }
+
+    if (!owner->second)
+        owners_.erase(owner);
+
+    // Emptiness first: erasing a flat level moves the queues the other entries point at.
+    for (auto& level : touched_)
+    {
+        UpdateLevelData(level.side_, level.price_, level.quantity_, LevelData::Action::Remove, level.count_);
+        level.emptied_ = level.orders_->empty();
+    }
+    for (const auto& level : touched_)
+    {
+        if (!level.emptied_)
+            continue;
+        if (level.side_ == Side::Buy)
+            bids_.erase(level.price_);
+        else
+            asks_.erase(level.price_);
+    }
+
+    return removed;
 }
 
-std::size_t Orderbook::Size() const
+template<typename Policy>
+std::size_t BasicOrderbook<Policy>::Size() const
 {
     return orders_.size();
 }
 
-OrderbookLevelInfos Orderbook::GetOrderInfos() const
+template<typename Policy>
+OrderbookLevelInfos BasicOrderbook<Policy>::GetOrderInfos() const
 {
     LevelInfos bidInfos, askInfos;
     bidInfos.reserve(bids_.size());
     askInfos.reserve(asks_.size());
 
-    auto CreateLevelInfos = [](Price price, const OrderPointers& orders)
+    auto CreateLevelInfos = [](Price price, const OrderQueue& orders)
     {
         return LevelInfo{
             price,
@@ -285,4 +428,33 @@ OrderbookLevelInfos Orderbook::GetOrderInfos() const
         askInfos.push_back(CreateLevelInfos(price, orders));
 
     return { bidInfos, askInfos };
-}
\ No newline at end of file
+}
+
+template<typename Policy>
+OrderbookLevelInfos BasicOrderbook<Policy>::GetOrderInfos(std::size_t depth) const
+{
+    LevelInfos bidInfos, askInfos;
+    bidInfos.reserve(std::min(depth, bids_.size()));
+    askInfos.reserve(std::min(depth, asks_.size()));
+
+    for (const auto& [price, orders] : bids_)
+    {
+        if (bidInfos.size() == depth)
+            break;
+        bidInfos.push_back({ price, bidData_.at(price).quantity_ });
+    }
+
+    for (const auto& [price, orders] : asks_)
+    {
+        if (askInfos.size() == depth)
+            break;
+        askInfos.push_back({ price, askData_.at(price).quantity_ });
+    }
+
+    return { bidInfos, askInfos };
+}
+
+template class BasicOrderbook<DefaultOrderbookPolicy>;
+template class BasicOrderbook<PooledOrderbookPolicy>;
+template class BasicOrderbook<FlatLevelsOrderbookPolicy>;
+template class BasicOrderbook<FlatOrderbookPolicy>;
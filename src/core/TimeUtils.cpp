@@ -0,0 +1,73 @@
+#include "TimeUtils.h"
+
+#include <cmath>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace ob::time {
+
+namespace {
+
+bool CounterIsInvariant() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(0x80000000u, &eax, &ebx, &ecx, &edx) || eax < 0x80000007u)
+        return false;
+    if (!__get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx))
+        return false;
+    return (edx & (1u << 8)) != 0;
+#elif defined(__aarch64__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+}
+
+const TscClock& TscClock::instance() {
+    static const TscClock clock;
+    return clock;
+}
+
+TscClock::TscClock() {
+    invariant_ = CounterIsInvariant();
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+    counter_ = invariant_;
+#endif
+    if (!counter_)
+        return;
+
+    // Bracket a ~20 ms sleep with both clocks; take the tighter of two rounds so a
+    // preemption between the paired reads does not skew the rate.
+    double best = 0.0;
+    std::uint64_t bestSpread = ~std::uint64_t{0};
+    for (int round = 0; round < 2; ++round) {
+        const std::uint64_t s0 = steady_now_ns();
+        const std::uint64_t c0 = read_counter();
+        const std::uint64_t s0b = steady_now_ns();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const std::uint64_t s1 = steady_now_ns();
+        const std::uint64_t c1 = read_counter();
+        const std::uint64_t s1b = steady_now_ns();
+
+        const std::uint64_t spread = (s0b - s0) + (s1b - s1);
+        const double ns = static_cast<double>((s1 + s1b) / 2 - (s0 + s0b) / 2);
+        if (ns > 0.0 && c1 > c0 && spread < bestSpread) {
+            bestSpread = spread;
+            best = static_cast<double>(c1 - c0) / ns;
+        }
+    }
+
+    if (best <= 0.0) {
+        counter_ = false;
+        return;
+    }
+    ticksPerNs_ = best;
+    mult_ = static_cast<std::uint64_t>(std::llround(std::ldexp(1.0 / best, static_cast<int>(Shift))));
+}
+
+}